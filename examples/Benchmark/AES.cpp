@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/crypto.h>
+
+using namespace slib;
+
+/*
+	AES and AES_GCM: known answer tests and throughput
+
+	vectors: FIPS-197 Appendix C (AES-128/192/256), GCM specification test cases 2, 3, 4 (AES-128)
+	throughput: ECB blocks, CTR, CBC and GCM over the message sizes, on the path selected by CPUID
+*/
+
+#define SIZE_THROUGHPUT_TOTAL (128 << 20)
+
+static Memory Hex(const char* sz)
+{
+	String s = sz;
+	Memory mem = Memory::create(s.getLength() / 2);
+	if (mem.isNotNull()) {
+		s.parseHexString(mem.getData());
+	}
+	return mem;
+}
+
+static sl_bool EqualsBytes(const void* data, const Memory& expected)
+{
+	return Base::equalsMemory(data, expected.getData(), expected.getSize());
+}
+
+static sl_uint32 g_nFailed = 0;
+
+static void Check(const char* name, sl_bool flagPassed)
+{
+	Println("  %s: %s", name, flagPassed ? "passed" : "FAILED");
+	if (!flagPassed) {
+		g_nFailed++;
+	}
+}
+
+static void CheckBlock(const char* name, const char* key, const char* plain, const char* cipher)
+{
+	Memory k = Hex(key);
+	Memory p = Hex(plain);
+	Memory c = Hex(cipher);
+	AES aes;
+	aes.setKey(k.getData(), (sl_uint32)(k.getSize()));
+	char out[16];
+	aes.encryptBlock(p.getData(), out);
+	sl_bool flagPassed = EqualsBytes(out, c);
+	aes.decryptBlock(c.getData(), out);
+	flagPassed = flagPassed && EqualsBytes(out, p);
+	Check(name, flagPassed);
+}
+
+static void CheckGCM(const char* name, const char* key, const char* iv, const char* plain, const char* aad, const char* cipher, const char* tag)
+{
+	Memory k = Hex(key);
+	Memory n = Hex(iv);
+	Memory p = Hex(plain);
+	Memory a = Hex(aad);
+	Memory c = Hex(cipher);
+	Memory t = Hex(tag);
+	AES_GCM gcm;
+	gcm.setKey(k.getData(), (sl_uint32)(k.getSize()));
+	char out[64];
+	char outTag[16];
+	sl_bool flagPassed = gcm.encrypt(n.getData(), n.getSize(), a.getData(), a.getSize(), p.getData(), out, p.getSize(), outTag);
+	flagPassed = flagPassed && EqualsBytes(out, c) && EqualsBytes(outTag, t);
+	flagPassed = flagPassed && gcm.decrypt(n.getData(), n.getSize(), a.getData(), a.getSize(), c.getData(), out, c.getSize(), t.getData());
+	flagPassed = flagPassed && EqualsBytes(out, p);
+	// modified tag must be rejected
+	outTag[0] ^= 1;
+	flagPassed = flagPassed && !(gcm.check(n.getData(), n.getSize(), a.getData(), a.getSize(), c.getData(), c.getSize(), outTag));
+	Check(name, flagPassed);
+}
+
+static void RunVectors()
+{
+	Println("vectors");
+	CheckBlock("FIPS-197 C.1 AES-128", "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a");
+	CheckBlock("FIPS-197 C.2 AES-192", "000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff", "dda97ca4864cdfe06eaf70a0ec0d7191");
+	CheckBlock("FIPS-197 C.3 AES-256", "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff", "8ea2b7ca516745bfeafc49904b496089");
+	CheckGCM("GCM test case 2", "00000000000000000000000000000000", "000000000000000000000000",
+		"00000000000000000000000000000000", "",
+		"0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf");
+	CheckGCM("GCM test case 3", "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+		"d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255", "",
+		"42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985", "4d5c2af327cd64a62cf35abd2ba6fab4");
+	CheckGCM("GCM test case 4", "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+		"d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39", "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+		"42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", "5bc94fbc3221a5db94fae95ae7121a47");
+}
+
+static String Throughput(sl_uint32 dt)
+{
+	if (!dt) {
+		dt = 1;
+	}
+	return String::fromUint64((sl_uint64)SIZE_THROUGHPUT_TOTAL / 1000 / dt);
+}
+
+static void RunThroughput()
+{
+	Println("throughput (MB/s), AES-128, AES-NI: %s, PCLMULQDQ: %s", CPU::isAESNISupported() ? "yes" : "no", CPU::isPCLMULQDQSupported() ? "yes" : "no");
+	sl_uint8 key[16] = {0};
+	sl_uint8 iv[16] = {0};
+	sl_uint8 tag[16];
+	AES aes;
+	aes.setKey(key, 16);
+	AES_GCM gcm;
+	gcm.setKey(key, 16);
+	Memory input = Memory::create((1 << 20) + 16);
+	Memory output = Memory::create((1 << 20) + 16);
+	Base::zeroMemory(input.getData(), input.getSize());
+	sl_uint8* src = (sl_uint8*)(input.getData());
+	sl_uint8* dst = (sl_uint8*)(output.getData());
+	sl_size sizes[] = {16, 64, 1024, 16384, 1 << 20};
+	for (sl_size iSize = 0; iSize < sizeof(sizes) / sizeof(sl_size); iSize++) {
+		sl_size size = sizes[iSize];
+		sl_size nLoop = SIZE_THROUGHPUT_TOTAL / size;
+		sl_uint32 t = System::getTickCount();
+		for (sl_size i = 0; i < nLoop; i++) {
+			aes.encryptBlocks(src, dst, size);
+		}
+		String sECB = Throughput(System::getTickCount() - t);
+		t = System::getTickCount();
+		for (sl_size i = 0; i < nLoop; i++) {
+			aes.encrypt_CTR(iv, i, 0, src, size, dst);
+		}
+		String sCTR = Throughput(System::getTickCount() - t);
+		t = System::getTickCount();
+		for (sl_size i = 0; i < nLoop; i++) {
+			aes.encrypt_CBC_PKCS7Padding(iv, src, size, dst);
+		}
+		String sCBC = Throughput(System::getTickCount() - t);
+		t = System::getTickCount();
+		for (sl_size i = 0; i < nLoop; i++) {
+			gcm.encrypt(iv, 12, sl_null, 0, src, dst, size, tag);
+		}
+		String sGCM = Throughput(System::getTickCount() - t);
+		t = System::getTickCount();
+		for (sl_size i = 0; i < nLoop; i++) {
+			gcm.decrypt(iv, 12, sl_null, 0, dst, src, size, tag);
+		}
+		String sGCMDecrypt = Throughput(System::getTickCount() - t);
+		Println("  %d bytes: ECB %s, CTR %s, CBC %s, GCM encrypt %s, GCM decrypt %s", size, sECB, sCTR, sCBC, sGCM, sGCMDecrypt);
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	RunVectors();
+	RunThroughput();
+	return g_nFailed ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Contention of HashMap (one lock) vs ConcurrentHashMap (sharded locks) at 1~64 threads
+
+	Every thread runs 90% get, 5% put and 5% remove on random keys of a shared map.
+	The total count of the operations is fixed, and divided to the threads.
+*/
+
+#define COUNT_OPERATIONS 4000000
+#define COUNT_KEYS 65536
+
+static sl_uint64 NextRandom(sl_uint64& state)
+{
+	// xorshift64
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+template <class MAP>
+static void RunWorker(MAP* map, sl_uint32 index, sl_uint32 count)
+{
+	sl_uint64 state = 0x9E3779B97F4A7C15ULL * (index + 1);
+	sl_uint64 value;
+	for (sl_uint32 i = 0; i < count; i++) {
+		sl_uint64 r = NextRandom(state);
+		sl_uint64 key = (r >> 8) % COUNT_KEYS;
+		sl_uint32 op = (sl_uint32)(r & 255) % 100;
+		if (op < 90) {
+			map->get(key, &value);
+		} else if (op < 95) {
+			map->put(key, r);
+		} else {
+			map->remove(key);
+		}
+	}
+}
+
+template <class MAP>
+static sl_uint32 Run(MAP* map, sl_uint32 nThreads)
+{
+	for (sl_uint64 key = 0; key < COUNT_KEYS; key += 2) {
+		map->put(key, key);
+	}
+	sl_uint32 countPerThread = COUNT_OPERATIONS / nThreads;
+	List< Ref<Thread> > threads;
+	sl_uint32 t = System::getTickCount();
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		threads.add_NoLock(Thread::start([map, i, countPerThread]() {
+			RunWorker(map, i, countPerThread);
+		}));
+	}
+	ListElements< Ref<Thread> > list(threads);
+	for (sl_size i = 0; i < list.count; i++) {
+		list[i]->finishAndWait();
+	}
+	return System::getTickCount() - t;
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("%d operations on %d keys (90%% get, 5%% put, 5%% remove)", COUNT_OPERATIONS, COUNT_KEYS);
+	for (sl_uint32 nThreads = 1; nThreads <= 64; nThreads <<= 1) {
+		sl_uint32 tHashMap;
+		{
+			HashMap<sl_uint64, sl_uint64> map;
+			tHashMap = Run(&map, nThreads);
+		}
+		sl_uint32 tConcurrent;
+		{
+			ConcurrentHashMap<sl_uint64, sl_uint64> map;
+			tConcurrent = Run(&map, nThreads);
+		}
+		Println("%d threads: HashMap %d ms, ConcurrentHashMap %d ms", nThreads, tHashMap, tConcurrent);
+	}
+	return 0;
+}
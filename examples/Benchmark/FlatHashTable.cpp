@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	HashTable (chained nodes) vs FlatHashTable (open addressing)
+
+	insert: `count` random keys
+	hit/miss: `count` lookups of the inserted keys / of absent keys
+	remove: all the keys
+*/
+
+#define COUNT_TOTAL_OPERATIONS 4000000
+
+static sl_uint64 NextRandom(sl_uint64& state)
+{
+	// xorshift64
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+template <class KT>
+static KT MakeKey(sl_uint64 n);
+
+template <>
+sl_uint64 MakeKey<sl_uint64>(sl_uint64 n)
+{
+	return n;
+}
+
+template <>
+String MakeKey<String>(sl_uint64 n)
+{
+	return "session-" + String::fromUint64(n, 16);
+}
+
+template <class TABLE, class KT>
+static void Run(const char* name, const List<KT>& keys, const List<KT>& keysAbsent)
+{
+	sl_size count = keys.getCount();
+	sl_uint32 nRepeat = (sl_uint32)(COUNT_TOTAL_OPERATIONS / count);
+	if (!nRepeat) {
+		nRepeat = 1;
+	}
+	const KT* k = keys.getData();
+	const KT* ka = keysAbsent.getData();
+	sl_uint32 tInsert = 0, tHit = 0, tMiss = 0, tRemove = 0;
+	sl_size sum = 0;
+	for (sl_uint32 iRepeat = 0; iRepeat < nRepeat; iRepeat++) {
+		TABLE table;
+		sl_uint32 t = System::getTickCount();
+		for (sl_size i = 0; i < count; i++) {
+			table.put(k[i], i);
+		}
+		sl_uint32 t2 = System::getTickCount();
+		tInsert += t2 - t;
+		for (sl_size i = 0; i < count; i++) {
+			if (table.getItemPointer(k[i])) {
+				sum++;
+			}
+		}
+		t = System::getTickCount();
+		tHit += t - t2;
+		for (sl_size i = 0; i < count; i++) {
+			if (table.getItemPointer(ka[i])) {
+				sum++;
+			}
+		}
+		t2 = System::getTickCount();
+		tMiss += t2 - t;
+		for (sl_size i = 0; i < count; i++) {
+			table.remove(k[i]);
+		}
+		tRemove += System::getTickCount() - t2;
+	}
+	Println("    %s: insert %d ms, hit %d ms, miss %d ms, remove %d ms (%d)", name, tInsert, tHit, tMiss, tRemove, sum / nRepeat);
+}
+
+template <class KT>
+static void RunKeys(const char* nameKey, sl_size count)
+{
+	List<KT> keys;
+	List<KT> keysAbsent;
+	sl_uint64 state = 88172645463325252ULL;
+	for (sl_size i = 0; i < count; i++) {
+		sl_uint64 r = NextRandom(state);
+		// even: inserted, odd: absent
+		keys.add_NoLock(MakeKey<KT>(r & ~((sl_uint64)1)));
+		keysAbsent.add_NoLock(MakeKey<KT>(r | 1));
+	}
+	Println("  %s keys, count=%d", nameKey, count);
+	Run< HashTable<KT, sl_size> >("HashTable    ", keys, keysAbsent);
+	Run< FlatHashTable<KT, sl_size> >("FlatHashTable", keys, keysAbsent);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("%d operations per phase", COUNT_TOTAL_OPERATIONS);
+	sl_size listCounts[] = {1000, 100000, 1000000};
+	for (sl_size i = 0; i < sizeof(listCounts) / sizeof(sl_size); i++) {
+		RunKeys<sl_uint64>("sl_uint64", listCounts[i]);
+		RunKeys<String>("String", listCounts[i]);
+	}
+	return 0;
+}
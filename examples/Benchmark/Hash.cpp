@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Distribution quality and throughput of the hash functions
+
+	The former functions are copied here as the reference:
+		OldRehash: xor-shift Rehash
+		OldHashBytes: Adler-32 based HashBytes
+		OldHashString: `hash * 31 + ch` of String
+
+	distribution: keys mapped to 65536 buckets by the low bits (as HashTable does), reporting the maximum bucket load
+		and the ratio of the sum of squared loads to the uniform random mapping (1.0 is random, larger is worse)
+	avalanche: the worst bias of an output bit when one input bit is flipped (0 is ideal, 50 is the worst)
+	throughput: MB/s over the message sizes
+*/
+
+#define COUNT_BUCKETS 65536
+#define COUNT_KEYS 262144
+#define COUNT_AVALANCHE_SAMPLES 20000
+#define SIZE_THROUGHPUT_TOTAL (256 << 20)
+
+static sl_uint32 OldRehash(sl_uint32 x)
+{
+	return x ^ (x >> 4) ^ (x >> 7) ^ (x >> 12) ^ (x >> 16) ^ (x >> 19) ^ (x >> 20) ^ (x >> 24) ^ (x >> 27);
+}
+
+static sl_uint32 OldHashBytes(const void* _buf, sl_size n)
+{
+	const sl_uint8* buf = (const sl_uint8*)_buf;
+	sl_uint32 a = 1, b = 0;
+	for (sl_size i = 0; i < n; i++) {
+		a = (a + buf[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	return OldRehash((b << 16) | a);
+}
+
+static sl_uint32 OldHashString(const void* _buf, sl_size n)
+{
+	const sl_uint8* buf = (const sl_uint8*)_buf;
+	sl_uint32 hash = 0;
+	for (sl_size i = 0; i < n; i++) {
+		hash = hash * 31 + buf[i];
+	}
+	return OldRehash(hash);
+}
+
+static sl_uint32 NewHashBytes(const void* buf, sl_size n)
+{
+	return (sl_uint32)(HashBytes64(buf, n, GetHashSeed()));
+}
+
+static sl_uint64 NextRandom(sl_uint64& state)
+{
+	// xorshift64
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+static sl_uint32 g_buckets[COUNT_BUCKETS];
+
+static void PrintDistribution(const char* name, const sl_uint32* hashes)
+{
+	Base::zeroMemory(g_buckets, sizeof(g_buckets));
+	for (sl_uint32 i = 0; i < COUNT_KEYS; i++) {
+		g_buckets[hashes[i] & (COUNT_BUCKETS - 1)]++;
+	}
+	sl_uint32 nMax = 0;
+	double sumSquares = 0;
+	for (sl_uint32 i = 0; i < COUNT_BUCKETS; i++) {
+		sl_uint32 n = g_buckets[i];
+		if (n > nMax) {
+			nMax = n;
+		}
+		sumSquares += (double)n * n;
+	}
+	// expected sum of squared loads for the uniform random mapping
+	double load = (double)COUNT_KEYS / COUNT_BUCKETS;
+	double expected = COUNT_BUCKETS * (load * load + load * (1.0 - 1.0 / COUNT_BUCKETS));
+	Println("    %s: max load %d, ratio %s", name, nMax, String::fromDouble(sumSquares / expected, 2));
+}
+
+typedef sl_uint32 (*IntHashFunction)(sl_uint64 key);
+
+static sl_uint32 OldHashInt(sl_uint64 key)
+{
+	return OldRehash((sl_uint32)(key ^ (key >> 32)));
+}
+
+static sl_uint32 NewHashInt(sl_uint64 key)
+{
+	return Hash64(key);
+}
+
+typedef sl_uint32 (*BytesHashFunction)(const void* buf, sl_size n);
+
+static void BenchmarkDistribution()
+{
+	Println("distribution: %d keys, %d buckets", COUNT_KEYS, COUNT_BUCKETS);
+	sl_uint32* hashes = new sl_uint32[COUNT_KEYS];
+	const char* namesInt[] = {"sequential ids", "ids * 4096", "IPv4 10.x.y.z", "random"};
+	for (sl_uint32 iKind = 0; iKind < 4; iKind++) {
+		Println("  %s", namesInt[iKind]);
+		IntHashFunction fns[] = {OldHashInt, NewHashInt};
+		const char* names[] = {"old Rehash", "Mix64     "};
+		for (sl_uint32 iFn = 0; iFn < 2; iFn++) {
+			sl_uint64 state = 88172645463325252ULL;
+			for (sl_uint32 i = 0; i < COUNT_KEYS; i++) {
+				sl_uint64 key;
+				switch (iKind) {
+					case 0:
+						key = i;
+						break;
+					case 1:
+						key = (sl_uint64)i << 12;
+						break;
+					case 2:
+						key = 0x0A000000 | ((i & 0xFF) << 16) | (i >> 8);
+						break;
+					default:
+						key = NextRandom(state);
+						break;
+				}
+				hashes[i] = fns[iFn](key);
+			}
+			PrintDistribution(names[iFn], hashes);
+		}
+	}
+	{
+		Println("  strings \"user:<n>\"");
+		BytesHashFunction fns[] = {OldHashString, OldHashBytes, NewHashBytes};
+		const char* names[] = {"old String  ", "old Adler-32", "HashBytes64 "};
+		for (sl_uint32 iFn = 0; iFn < 3; iFn++) {
+			for (sl_uint32 i = 0; i < COUNT_KEYS; i++) {
+				String s = "user:" + String::fromUint32(i);
+				hashes[i] = fns[iFn](s.getData(), s.getLength());
+			}
+			PrintDistribution(names[iFn], hashes);
+		}
+	}
+	delete[] hashes;
+}
+
+static void BenchmarkAvalanche()
+{
+	Println("avalanche: 16-byte input, %d samples", COUNT_AVALANCHE_SAMPLES);
+	BytesHashFunction fns[] = {OldHashString, OldHashBytes, NewHashBytes};
+	const char* names[] = {"old String  ", "old Adler-32", "HashBytes64 "};
+	for (sl_uint32 iFn = 0; iFn < 3; iFn++) {
+		// flips[input bit][output bit]
+		static sl_uint32 flips[128][32];
+		Base::zeroMemory(flips, sizeof(flips));
+		sl_uint64 state = 88172645463325252ULL;
+		for (sl_uint32 iSample = 0; iSample < COUNT_AVALANCHE_SAMPLES; iSample++) {
+			sl_uint64 input[2];
+			input[0] = NextRandom(state);
+			input[1] = NextRandom(state);
+			sl_uint32 h = fns[iFn](input, 16);
+			for (sl_uint32 iBit = 0; iBit < 128; iBit++) {
+				sl_uint64 flipped[2] = {input[0], input[1]};
+				flipped[iBit >> 6] ^= (sl_uint64)1 << (iBit & 63);
+				sl_uint32 d = h ^ fns[iFn](flipped, 16);
+				for (sl_uint32 oBit = 0; oBit < 32; oBit++) {
+					flips[iBit][oBit] += (d >> oBit) & 1;
+				}
+			}
+		}
+		double worst = 0;
+		for (sl_uint32 iBit = 0; iBit < 128; iBit++) {
+			for (sl_uint32 oBit = 0; oBit < 32; oBit++) {
+				double bias = Math::abs((double)(flips[iBit][oBit]) / COUNT_AVALANCHE_SAMPLES - 0.5) * 100;
+				if (bias > worst) {
+					worst = bias;
+				}
+			}
+		}
+		Println("    %s: worst bias %s%%", names[iFn], String::fromDouble(worst, 2));
+	}
+}
+
+static volatile sl_uint32 g_sum = 0;
+
+static void BenchmarkThroughput()
+{
+	Println("throughput (MB/s)");
+	Memory mem = Memory::create((1 << 20) + 64);
+	sl_uint8* data = (sl_uint8*)(mem.getData());
+	for (sl_uint32 i = 0; i < (1 << 20) + 64; i++) {
+		data[i] = (sl_uint8)(i * 131 + 7);
+	}
+	BytesHashFunction fns[] = {OldHashString, OldHashBytes, NewHashBytes};
+	const char* names[] = {"old String  ", "old Adler-32", "HashBytes64 "};
+	sl_size sizes[] = {8, 16, 32, 64, 256, 4096, 1 << 20};
+	for (sl_size iSize = 0; iSize < sizeof(sizes) / sizeof(sl_size); iSize++) {
+		sl_size size = sizes[iSize];
+		sl_size nLoop = SIZE_THROUGHPUT_TOTAL / size;
+		String line = "  " + String::fromSize(size) + " bytes:";
+		for (sl_uint32 iFn = 0; iFn < 3; iFn++) {
+			sl_uint32 sum = 0;
+			sl_uint32 t = System::getTickCount();
+			for (sl_size i = 0; i < nLoop; i++) {
+				// varying the offset keeps the calls from being hoisted
+				sum += fns[iFn](data + (i & 63), size);
+			}
+			sl_uint32 dt = System::getTickCount() - t;
+			if (!dt) {
+				dt = 1;
+			}
+			line += String(" ") + names[iFn] + " " + String::fromUint64((sl_uint64)SIZE_THROUGHPUT_TOTAL / 1000 / dt);
+			g_sum += sum;
+		}
+		Println("%s", line);
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	BenchmarkDistribution();
+	BenchmarkAvalanche();
+	BenchmarkThroughput();
+	return 0;
+}
@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	JsonReader/JsonWriter vs the Variant DOM (Json::parseJson, toJsonString) on an export of records
+
+	The time and the growth of the peak resident memory (VmHWM, Linux) are reported for each phase.
+	The streaming phases run first, so they do not reuse the memory released by the DOM phases.
+	The memory kept by the allocators after `parseJson` is reused by `toJsonString`, so the growth of the last phase is a lower bound.
+*/
+
+#define COUNT_RECORDS 200000
+
+class CountingWriter : public IWriter
+{
+public:
+	sl_uint64 size;
+
+public:
+	CountingWriter(): size(0) {}
+
+public:
+	sl_reg write(const void* buf, sl_size _size) override
+	{
+		size += _size;
+		return _size;
+	}
+
+};
+
+static sl_uint64 ReadStatus(const char* name)
+{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	// the size of the proc files is reported as 0, so `readAllTextUTF8()` can not be used
+	Ref<File> file = File::openForRead("/proc/self/status");
+	if (file.isNull()) {
+		return 0;
+	}
+	char buf[4096];
+	sl_reg n = file->read(buf, sizeof(buf));
+	if (n <= 0) {
+		return 0;
+	}
+	String status(buf, n);
+	sl_reg index = status.indexOf(name);
+	if (index >= 0) {
+		sl_reg end = status.indexOf('\n', index);
+		String line = status.substring(index + Base::getStringLength(name), end).trim();
+		return line.substring(0, line.indexOf(' ')).parseUint64() << 10;
+	}
+#endif
+	return 0;
+}
+
+class MemoryMeter
+{
+public:
+	sl_uint64 base;
+	sl_uint32 tick;
+
+public:
+	MemoryMeter()
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// resets VmHWM to the current resident size
+		File::writeAllTextUTF8("/proc/self/clear_refs", "5");
+#endif
+		base = ReadStatus("VmRSS:");
+		tick = System::getTickCount();
+	}
+
+	void print(const char* name)
+	{
+		sl_uint32 dt = System::getTickCount() - tick;
+		sl_uint64 peak = ReadStatus("VmHWM:");
+		Println("  %s: %d ms, peak memory +%d MB", name, dt, (peak > base ? peak - base : 0) >> 20);
+	}
+
+};
+
+template <class WRITER>
+static void WriteRecordsStreaming(WRITER* writer, sl_bool flagArray)
+{
+	JsonWriter json;
+	json.setOutput(writer);
+	if (flagArray) {
+		json.beginArray();
+	}
+	for (sl_uint32 i = 0; i < COUNT_RECORDS; i++) {
+		json.beginObject();
+		json.writeKey("id");
+		json.writeUint32(i);
+		json.writeKey("name");
+		json.writeString("user-" + String::fromUint32(i));
+		json.writeKey("email");
+		json.writeString("user" + String::fromUint32(i) + "@example.com");
+		json.writeKey("amount");
+		json.writeInt64((sl_int64)i * 37 % 10000);
+		json.writeKey("active");
+		json.writeBoolean((i & 1) == 0);
+		json.writeKey("tags");
+		json.beginArray();
+		json.writeString("alpha");
+		json.writeString("beta");
+		json.endArray();
+		json.endObject();
+	}
+	if (flagArray) {
+		json.endArray();
+	}
+	json.flush();
+}
+
+static Json BuildRecordsDom()
+{
+	Json list = Json::createList();
+	for (sl_uint32 i = 0; i < COUNT_RECORDS; i++) {
+		Json record = Json::createMap();
+		record.putItem("id", i);
+		record.putItem("name", "user-" + String::fromUint32(i));
+		record.putItem("email", "user" + String::fromUint32(i) + "@example.com");
+		record.putItem("amount", (sl_int64)i * 37 % 10000);
+		record.putItem("active", (i & 1) == 0);
+		Json tags = Json::createList();
+		tags.addElement("alpha");
+		tags.addElement("beta");
+		record.putItem("tags", tags);
+		list.addElement(record);
+	}
+	return list;
+}
+
+static sl_int64 SumAmountsStreaming(JsonReader& reader)
+{
+	sl_int64 sum = 0;
+	for (;;) {
+		JsonToken token = reader.next();
+		if (token == JsonToken::End || token == JsonToken::Error) {
+			break;
+		}
+		if (token == JsonToken::Key && reader.getDepth() <= 2 && reader.getStringLength() == 6 && Base::equalsMemory(reader.getStringData(), "amount", 6)) {
+			reader.next();
+			sum += reader.getInt64();
+		}
+	}
+	return sum;
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("%d records", COUNT_RECORDS);
+	
+	Memory ndjson;
+	Memory array;
+	{
+		MemoryWriter writer;
+		WriteRecordsStreaming(&writer, sl_false);
+		ndjson = writer.getData();
+	}
+	{
+		MemoryWriter writer;
+		WriteRecordsStreaming(&writer, sl_true);
+		array = writer.getData();
+	}
+	Println("input: NDJSON %d MB, array %d MB", ndjson.getSize() >> 20, array.getSize() >> 20);
+	
+	Println("write (streaming)");
+	{
+		MemoryMeter meter;
+		CountingWriter writer;
+		WriteRecordsStreaming(&writer, sl_true);
+		meter.print("JsonWriter");
+	}
+	
+	Println("read (sum of \"amount\")");
+	{
+		MemoryMeter meter;
+		JsonReader reader;
+		reader.setInput(ndjson);
+		sl_int64 sum = SumAmountsStreaming(reader);
+		meter.print("JsonReader over Memory");
+		Println("    sum=%d", sum);
+	}
+	{
+		MemoryMeter meter;
+		MemoryReader input(ndjson);
+		JsonReader reader;
+		reader.setInput(&input, 65536);
+		sl_int64 sum = SumAmountsStreaming(reader);
+		meter.print("JsonReader over IReader (64KB chunks)");
+		Println("    sum=%d", sum);
+	}
+	{
+		MemoryMeter meter;
+		JsonReader reader;
+		reader.setInput(ndjson);
+		sl_int64 sum = 0;
+		while (reader.next() == JsonToken::BeginObject) {
+			Json record = reader.readValue();
+			sum += record["amount"].getInt64();
+		}
+		meter.print("JsonReader readValue per record");
+		Println("    sum=%d", sum);
+	}
+	{
+		MemoryMeter meter;
+		Json json = Json::parseJsonUtf8(array);
+		sl_int64 sum = 0;
+		sl_size n = json.getElementsCount();
+		for (sl_size i = 0; i < n; i++) {
+			sum += json[i]["amount"].getInt64();
+		}
+		meter.print("DOM parseJson");
+		Println("    sum=%d", sum);
+	}
+	
+	Println("write (DOM)");
+	{
+		MemoryMeter meter;
+		String s = BuildRecordsDom().toJsonString();
+		meter.print("DOM toJsonString");
+	}
+	return 0;
+}
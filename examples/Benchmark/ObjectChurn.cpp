@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network.h>
+
+using namespace slib;
+
+/*
+	Per-object allocation cost of Referable/Object and the object churn of HttpService
+
+	allocator: SlabAllocator vs Base::createMemory on the sizes of the small objects (1 and 4 threads)
+	object: Object created and released, with and without locking it once
+	http: keep-alive requests on a loopback HttpService; compare the library built with and without SLIB_NO_SLAB_ALLOCATOR
+*/
+
+#define COUNT_ALLOC 2000000
+#define COUNT_OBJECTS 2000000
+#define COUNT_REQUESTS 20000
+#define HTTP_PORT 18123
+
+static const sl_size g_sizes[] = {32, 48, 64, 96, 128, 192, 256, 512};
+#define COUNT_SIZES (sizeof(g_sizes) / sizeof(sl_size))
+
+class SampleObject : public Object
+{
+public:
+	sl_uint64 values[4];
+};
+
+static void AllocSlab(sl_uint32 count)
+{
+	void* blocks[COUNT_SIZES];
+	for (sl_uint32 i = 0; i < count; i++) {
+		for (sl_size k = 0; k < COUNT_SIZES; k++) {
+			blocks[k] = SlabAllocator::allocate(g_sizes[k]);
+		}
+		for (sl_size k = 0; k < COUNT_SIZES; k++) {
+			SlabAllocator::free(blocks[k], g_sizes[k]);
+		}
+	}
+}
+
+static void AllocMalloc(sl_uint32 count)
+{
+	void* blocks[COUNT_SIZES];
+	for (sl_uint32 i = 0; i < count; i++) {
+		for (sl_size k = 0; k < COUNT_SIZES; k++) {
+			blocks[k] = Base::createMemory(g_sizes[k]);
+		}
+		for (sl_size k = 0; k < COUNT_SIZES; k++) {
+			Base::freeMemory(blocks[k]);
+		}
+	}
+}
+
+static sl_uint32 RunThreads(void (*fn)(sl_uint32), sl_uint32 nThreads)
+{
+	sl_uint32 countPerThread = COUNT_ALLOC / COUNT_SIZES / nThreads;
+	sl_uint32 t = System::getTickCount();
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		threads.add_NoLock(Thread::start([fn, countPerThread]() {
+			fn(countPerThread);
+		}));
+	}
+	ListElements< Ref<Thread> > list(threads);
+	for (sl_size i = 0; i < list.count; i++) {
+		list[i]->finishAndWait();
+	}
+	return System::getTickCount() - t;
+}
+
+static void BenchmarkAllocator()
+{
+	Println("allocator: %d blocks of 32~512 bytes", COUNT_ALLOC);
+	sl_uint32 listThreads[] = {1, 4};
+	for (sl_uint32 i = 0; i < sizeof(listThreads) / sizeof(sl_uint32); i++) {
+		sl_uint32 tSlab = RunThreads(AllocSlab, listThreads[i]);
+		sl_uint32 tMalloc = RunThreads(AllocMalloc, listThreads[i]);
+		Println("  %d threads: SlabAllocator %d ms, createMemory %d ms", listThreads[i], tSlab, tMalloc);
+	}
+}
+
+static void BenchmarkObject()
+{
+	Println("object: %d objects (%d bytes)", COUNT_OBJECTS, sizeof(SampleObject));
+	sl_uint32 t = System::getTickCount();
+	for (sl_uint32 i = 0; i < COUNT_OBJECTS; i++) {
+		Ref<SampleObject> object = new SampleObject;
+	}
+	sl_uint32 tCreate = System::getTickCount() - t;
+	t = System::getTickCount();
+	for (sl_uint32 i = 0; i < COUNT_OBJECTS; i++) {
+		Ref<SampleObject> object = new SampleObject;
+		ObjectLocker lock(object.get());
+	}
+	sl_uint32 tLock = System::getTickCount() - t;
+	Println("  create/release %d ms, create/lock/release %d ms", tCreate, tLock);
+}
+
+static void BenchmarkHttpService()
+{
+	HttpServiceParam param;
+	param.addressBind = IPv4Address(127, 0, 0, 1);
+	param.port = HTTP_PORT;
+	param.onRequest = [](HttpService*, HttpServiceContext* context) {
+		context->setResponseContentType(ContentTypes::TextPlain);
+		context->write("ok", 2);
+		return sl_true;
+	};
+	Ref<HttpService> service = HttpService::create(param);
+	if (service.isNull()) {
+		Println("http: failed to start the service");
+		return;
+	}
+	Ref<Socket> socket = Socket::openTcp();
+	if (socket.isNull() || !(socket->connectAndWait(SocketAddress(IPv4Address(127, 0, 0, 1), HTTP_PORT), 3000))) {
+		Println("http: failed to connect");
+		return;
+	}
+	socket->setNonBlockingMode(sl_false);
+	static const char request[] = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\nUser-Agent: benchmark\r\nAccept: */*\r\n\r\n";
+	char buf[4096];
+	sl_size sizeResponse = 0;
+	sl_uint32 t = System::getTickCount();
+	for (sl_uint32 i = 0; i < COUNT_REQUESTS; i++) {
+		if (socket->send(request, sizeof(request) - 1) != sizeof(request) - 1) {
+			Println("http: send failed");
+			return;
+		}
+		sl_size sizeReceived = 0;
+		for (;;) {
+			sl_int32 n = socket->receive(buf + sizeReceived, (sl_uint32)(sizeof(buf) - sizeReceived));
+			if (n <= 0) {
+				Println("http: receive failed");
+				return;
+			}
+			sizeReceived += n;
+			if (sizeResponse) {
+				if (sizeReceived >= sizeResponse) {
+					break;
+				}
+			} else {
+				// the body is "ok"
+				sl_reg sizeHeader = HttpHeaderScanner::findHeaderEnd(buf, sizeReceived);
+				if (sizeHeader > 0 && sizeReceived >= (sl_size)sizeHeader + 2) {
+					sizeResponse = sizeHeader + 2;
+					break;
+				}
+			}
+		}
+	}
+	sl_uint32 dt = System::getTickCount() - t;
+	if (!dt) {
+		dt = 1;
+	}
+	Println("http: %d keep-alive requests %d ms (%d req/s), slabs reserved %d KB", COUNT_REQUESTS, dt, (sl_uint64)COUNT_REQUESTS * 1000 / dt, SlabAllocator::getReservedSize() >> 10);
+	service->release();
+}
+
+int main(int argc, const char * argv[])
+{
+	BenchmarkAllocator();
+	BenchmarkObject();
+	BenchmarkHttpService();
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/crypto.h>
+
+using namespace slib;
+
+/*
+	SHA1/SHA256/SHA512 throughput from 64 bytes to 1 MB, on the path selected by CPUID
+
+	single: one message per call
+	hashMany: 16 independent messages per call (SHA256), checked against the single results
+*/
+
+#define SIZE_THROUGHPUT_TOTAL (128 << 20)
+#define COUNT_MESSAGES 16
+
+typedef void (*HashFunction)(const void* input, sl_size n, void* output);
+
+static sl_uint32 MeasureSingle(HashFunction fn, const sl_uint8* data, sl_size size)
+{
+	sl_uint8 output[64];
+	sl_size nLoop = SIZE_THROUGHPUT_TOTAL / size;
+	sl_uint32 t = System::getTickCount();
+	for (sl_size i = 0; i < nLoop; i++) {
+		fn(data + (i & 15) * 64, size, output);
+	}
+	return System::getTickCount() - t;
+}
+
+static String Throughput(sl_uint32 dt)
+{
+	if (!dt) {
+		dt = 1;
+	}
+	return String::fromUint64((sl_uint64)SIZE_THROUGHPUT_TOTAL / 1000 / dt);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("throughput (MB/s), SHA-NI: %s, AVX2: %s", CPU::isSHASupported() ? "yes" : "no", CPU::isAVX2Supported() ? "yes" : "no");
+	sl_size sizeMax = 1 << 20;
+	Memory mem = Memory::create(sizeMax + COUNT_MESSAGES * 64);
+	sl_uint8* data = (sl_uint8*)(mem.getData());
+	for (sl_size i = 0; i < mem.getSize(); i++) {
+		data[i] = (sl_uint8)(i * 131 + 7);
+	}
+	sl_bool flagMatched = sl_true;
+	sl_size sizes[] = {64, 256, 1024, 4096, 65536, 1 << 20};
+	for (sl_size iSize = 0; iSize < sizeof(sizes) / sizeof(sl_size); iSize++) {
+		sl_size size = sizes[iSize];
+		String sSHA1 = Throughput(MeasureSingle(SHA1::hash, data, size));
+		String sSHA256 = Throughput(MeasureSingle(SHA256::hash, data, size));
+		String sSHA512 = Throughput(MeasureSingle(SHA512::hash, data, size));
+		
+		const void* inputs[COUNT_MESSAGES];
+		sl_size sizesInput[COUNT_MESSAGES];
+		for (sl_uint32 k = 0; k < COUNT_MESSAGES; k++) {
+			inputs[k] = data + k * 64;
+			sizesInput[k] = size;
+		}
+		sl_uint8 outputs[COUNT_MESSAGES * 32];
+		sl_size nLoop = SIZE_THROUGHPUT_TOTAL / size / COUNT_MESSAGES;
+		if (!nLoop) {
+			nLoop = 1;
+		}
+		sl_uint32 t = System::getTickCount();
+		for (sl_size i = 0; i < nLoop; i++) {
+			CryptoHash::hashMany(CryptoHashType::SHA256, inputs, sizesInput, COUNT_MESSAGES, outputs);
+		}
+		String sMany = Throughput(System::getTickCount() - t);
+		for (sl_uint32 k = 0; k < COUNT_MESSAGES; k++) {
+			sl_uint8 output[32];
+			SHA256::hash(inputs[k], size, output);
+			if (!(Base::equalsMemory(output, outputs + k * 32, 32))) {
+				flagMatched = sl_false;
+			}
+		}
+		Println("  %d bytes: SHA1 %s, SHA256 %s, SHA512 %s, SHA256 hashMany(%d) %s", size, sSHA1, sSHA256, sSHA512, COUNT_MESSAGES, sMany);
+	}
+	Println("hashMany results %s", flagMatched ? "matched" : "MISMATCHED");
+	return flagMatched ? 0 : 1;
+}
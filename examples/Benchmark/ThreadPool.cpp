@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Throughput of ThreadPool in the Shared and WorkStealing modes.
+ 
+	flat: every task is submitted from the main thread
+	nested: each root task submits its children from the worker thread
+*/
+
+#define COUNT_TASKS 1000000
+#define COUNT_ROOTS 1000
+
+static sl_int32 g_countDone = 0;
+static Ref<Event> g_eventDone;
+
+static void DoneTask(sl_int32 total)
+{
+	if (Base::interlockedIncrement32(&g_countDone) == total) {
+		g_eventDone->set();
+	}
+}
+
+static sl_uint32 RunFlat(ThreadPool* pool)
+{
+	g_countDone = 0;
+	sl_uint32 t = System::getTickCount();
+	for (sl_int32 i = 0; i < COUNT_TASKS; i++) {
+		pool->addTask([]() {
+			DoneTask(COUNT_TASKS);
+		});
+	}
+	g_eventDone->wait();
+	return System::getTickCount() - t;
+}
+
+static sl_uint32 RunNested(ThreadPool* pool)
+{
+	g_countDone = 0;
+	sl_uint32 t = System::getTickCount();
+	Ref<ThreadPool> refPool = pool;
+	for (sl_int32 i = 0; i < COUNT_ROOTS; i++) {
+		pool->addTask([refPool]() {
+			for (sl_int32 k = 0; k < COUNT_TASKS / COUNT_ROOTS; k++) {
+				refPool->addTask([]() {
+					DoneTask(COUNT_TASKS);
+				});
+			}
+		});
+	}
+	g_eventDone->wait();
+	return System::getTickCount() - t;
+}
+
+static void RunMode(const char* name, ThreadPoolMode mode, sl_uint32 nThreads)
+{
+	Ref<ThreadPool> pool = ThreadPool::create(nThreads, nThreads, mode);
+	if (pool.isNull()) {
+		Println("%s: failed to create the pool", name);
+		return;
+	}
+	// warm up
+	RunFlat(pool.get());
+	sl_uint32 tFlat = RunFlat(pool.get());
+	sl_uint32 tNested = RunNested(pool.get());
+	Println("%s (%d threads): flat %d ms, nested %d ms", name, nThreads, tFlat, tNested);
+	pool->release();
+}
+
+int main(int argc, const char * argv[])
+{
+	g_eventDone = Event::create();
+	sl_uint32 nCpus = CPU::getProcessorsCount();
+	if (!nCpus) {
+		nCpus = 1;
+	}
+	Println("%d tasks", COUNT_TASKS);
+	sl_uint32 listThreads[] = {1, nCpus, nCpus * 4};
+	for (sl_uint32 i = 0; i < sizeof(listThreads) / sizeof(sl_uint32); i++) {
+		RunMode("Shared", ThreadPoolMode::Shared, listThreads[i]);
+		RunMode("WorkStealing", ThreadPoolMode::WorkStealing, listThreads[i]);
+	}
+	return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <slib/core.h>
+#include <slib/network.h>
+
+using namespace slib;
+
+/*
+	UDP on the loopback: per-packet sendTo/receiveFrom vs sendToBatch/receiveFromBatch (sendmmsg/recvmmsg)
+
+	The datagrams are sent in rounds small enough to fit in the receive buffer,
+	and each round is drained before the next one, so no datagram is dropped.
+	The send and receive times are measured separately.
+
+	Then the same rounds go through AsyncUdpSocket on both sides (batch count 1 vs SIZE_BATCH, and a round sent by
+	`sendSegments()` as one GSO datagram, which the kernel may reject and the socket splits), measuring the round trip time.
+*/
+
+#define COUNT_DATAGRAMS 500000
+#define SIZE_DATAGRAM 64
+#define SIZE_ROUND 128
+#define SIZE_BATCH 32
+#define UDP_PORT 18124
+#define UDP_PORT_ASYNC 18125
+
+struct Result
+{
+	sl_uint32 timeSend;
+	sl_uint32 timeReceive;
+	sl_uint32 countReceived;
+};
+
+static sl_uint32 Drain(Socket* receiver, sl_bool flagBatch, sl_uint32 count)
+{
+	char buf[SIZE_BATCH][SIZE_DATAGRAM];
+	SocketDatagram datagrams[SIZE_BATCH];
+	SocketAddress address;
+	sl_uint32 nReceived = 0;
+	while (nReceived < count) {
+		if (flagBatch) {
+			for (sl_uint32 k = 0; k < SIZE_BATCH; k++) {
+				datagrams[k].data = buf[k];
+				datagrams[k].size = SIZE_DATAGRAM;
+			}
+			sl_int32 n = receiver->receiveFromBatch(datagrams, SIZE_BATCH);
+			if (n <= 0) {
+				break;
+			}
+			nReceived += n;
+		} else {
+			if (receiver->receiveFrom(address, buf[0], SIZE_DATAGRAM) <= 0) {
+				break;
+			}
+			nReceived++;
+		}
+	}
+	return nReceived;
+}
+
+static Result Run(Socket* sender, Socket* receiver, sl_bool flagBatch)
+{
+	char buf[SIZE_DATAGRAM] = {0};
+	SocketAddress addressTarget(IPv4Address(127, 0, 0, 1), UDP_PORT);
+	SocketDatagram datagrams[SIZE_BATCH];
+	for (sl_uint32 k = 0; k < SIZE_BATCH; k++) {
+		datagrams[k].address = addressTarget;
+		datagrams[k].data = buf;
+		datagrams[k].size = SIZE_DATAGRAM;
+	}
+	Result result;
+	result.timeSend = 0;
+	result.timeReceive = 0;
+	result.countReceived = 0;
+	for (sl_uint32 iRound = 0; iRound < COUNT_DATAGRAMS / SIZE_ROUND; iRound++) {
+		sl_uint32 t = System::getTickCount();
+		if (flagBatch) {
+			sl_uint32 nSent = 0;
+			while (nSent < SIZE_ROUND) {
+				sl_int32 n = sender->sendToBatch(datagrams, SLIB_MIN(SIZE_BATCH, SIZE_ROUND - nSent));
+				if (n <= 0) {
+					break;
+				}
+				nSent += n;
+			}
+		} else {
+			for (sl_uint32 k = 0; k < SIZE_ROUND; k++) {
+				sender->sendTo(addressTarget, buf, SIZE_DATAGRAM);
+			}
+		}
+		sl_uint32 t2 = System::getTickCount();
+		result.countReceived += Drain(receiver, flagBatch, SIZE_ROUND);
+		result.timeSend += t2 - t;
+		result.timeReceive += System::getTickCount() - t2;
+	}
+	return result;
+}
+
+class AsyncReceiver : public Referable
+{
+public:
+	Ref<Event> eventRound;
+	sl_uint32 countReceived;
+	sl_uint32 countRound;
+
+public:
+	AsyncReceiver()
+	{
+		eventRound = Event::create();
+		countReceived = 0;
+		countRound = 0;
+	}
+
+	void onReceiveBatch(AsyncUdpSocket*, SocketDatagram* datagrams, sl_uint32 count)
+	{
+		countReceived += count;
+		countRound += count;
+		if (countRound >= SIZE_ROUND) {
+			countRound = 0;
+			eventRound->set();
+		}
+	}
+};
+
+enum class AsyncMode
+{
+	PerPacket, Batch, Segments
+};
+
+static sl_uint32 RunAsync(AsyncMode mode, sl_uint32& countReceived)
+{
+	sl_uint32 batchCount = mode == AsyncMode::PerPacket ? 1 : SIZE_BATCH;
+	Ref<AsyncReceiver> receiver = new AsyncReceiver;
+	AsyncUdpSocketParam paramReceiver;
+	paramReceiver.bindAddress = SocketAddress(IPv4Address(127, 0, 0, 1), UDP_PORT_ASYNC);
+	paramReceiver.batchCount = batchCount;
+	paramReceiver.packetSize = SIZE_DATAGRAM * batchCount;
+	paramReceiver.onReceiveBatch = SLIB_FUNCTION_REF(AsyncReceiver, onReceiveBatch, receiver);
+	Ref<AsyncUdpSocket> socketReceiver = AsyncUdpSocket::create(paramReceiver);
+	AsyncUdpSocketParam paramSender;
+	paramSender.batchCount = batchCount;
+	Ref<AsyncUdpSocket> socketSender = AsyncUdpSocket::create(paramSender);
+	if (socketReceiver.isNull() || socketSender.isNull()) {
+		Println("Failed to open the async sockets");
+		countReceived = 0;
+		return 0;
+	}
+	socketReceiver->setReceiveBufferSize(1 << 20);
+	SocketAddress addressTarget(IPv4Address(127, 0, 0, 1), UDP_PORT_ASYNC);
+	Memory datagram = Memory::create(SIZE_DATAGRAM);
+	Memory round = Memory::create(SIZE_DATAGRAM * SIZE_ROUND);
+	Base::zeroMemory(datagram.getData(), SIZE_DATAGRAM);
+	Base::zeroMemory(round.getData(), SIZE_DATAGRAM * SIZE_ROUND);
+	sl_uint32 t = System::getTickCount();
+	for (sl_uint32 iRound = 0; iRound < COUNT_DATAGRAMS / SIZE_ROUND; iRound++) {
+		if (mode == AsyncMode::Segments) {
+			socketSender->sendSegments(addressTarget, round, SIZE_DATAGRAM);
+		} else {
+			for (sl_uint32 k = 0; k < SIZE_ROUND; k++) {
+				socketSender->sendTo(addressTarget, datagram);
+			}
+		}
+		if (!(receiver->eventRound->wait(1000))) {
+			// lost datagrams
+			receiver->countRound = 0;
+		}
+	}
+	sl_uint32 time = System::getTickCount() - t;
+	countReceived = receiver->countReceived;
+	socketSender->close();
+	socketReceiver->close();
+	return time;
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<Socket> receiver = Socket::openUdp();
+	Ref<Socket> sender = Socket::openUdp();
+	if (receiver.isNull() || sender.isNull()) {
+		Println("Failed to open the sockets");
+		return -1;
+	}
+	if (!(receiver->bind(SocketAddress(IPv4Address(127, 0, 0, 1), UDP_PORT)))) {
+		Println("Failed to bind the port %d", UDP_PORT);
+		return -1;
+	}
+	receiver->setOption_ReceiveBufferSize(1 << 20);
+	receiver->setNonBlockingMode(sl_true);
+	
+	Println("%d datagrams of %d bytes, batch %d", COUNT_DATAGRAMS, SIZE_DATAGRAM, SIZE_BATCH);
+	for (sl_uint32 i = 0; i < 2; i++) {
+		Result r1 = Run(sender.get(), receiver.get(), sl_false);
+		Result r2 = Run(sender.get(), receiver.get(), sl_true);
+		Println("per-packet: send %d ms, receive %d ms, received %d", r1.timeSend, r1.timeReceive, r1.countReceived);
+		Println("batch:      send %d ms, receive %d ms, received %d", r2.timeSend, r2.timeReceive, r2.countReceived);
+	}
+	for (sl_uint32 i = 0; i < 2; i++) {
+		sl_uint32 n1, n2, n3;
+		sl_uint32 t1 = RunAsync(AsyncMode::PerPacket, n1);
+		sl_uint32 t2 = RunAsync(AsyncMode::Batch, n2);
+		sl_uint32 t3 = RunAsync(AsyncMode::Segments, n3);
+		Println("async per-packet: %d ms, received %d", t1, n1);
+		Println("async batch:      %d ms, received %d", t2, n2);
+		Println("async segments:   %d ms, received %d", t3, n3);
+	}
+	return 0;
+}
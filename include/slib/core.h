@@ -39,9 +39,12 @@
 
 #include "core/spin_lock.h"
 #include "core/mutex.h"
+#include "core/slab_allocator.h"
 #include "core/string.h"
 #include "core/string_buffer.h"
 #include "core/memory.h"
+#include "core/memory_pool.h"
+#include "core/mapped_file.h"
 #include "core/time.h"
 #include "core/variant.h"
 
@@ -53,11 +56,13 @@
 
 #include "core/red_black_tree.h"
 #include "core/hash_table.h"
+#include "core/flat_hash_table.h"
 #include "core/btree.h"
 #include "core/array.h"
 #include "core/array2d.h"
 #include "core/list.h"
 #include "core/map.h"
+#include "core/concurrent_hash_map.h"
 #include "core/linked_list.h"
 #include "core/queue.h"
 #include "core/queue_channel.h"
@@ -70,6 +75,7 @@
 #include "core/animation.h"
 
 #include "core/system.h"
+#include "core/cpu.h"
 #include "core/event.h"
 #include "core/thread.h"
 #include "core/thread_pool.h"
@@ -83,6 +89,7 @@
 #include "core/dispatch.h"
 #include "core/dispatch_loop.h"
 #include "core/timer.h"
+#include "core/timer_wheel.h"
 
 #include "core/app.h"
 #include "core/service.h"
@@ -95,6 +102,7 @@
 #include "core/setting.h"
 
 #include "core/json.h"
+#include "core/json_io.h"
 #include "core/xml.h"
 #include "core/base64.h"
 
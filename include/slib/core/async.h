@@ -30,6 +30,7 @@ namespace slib
 	};
 
 	class AsyncIoLoop;
+	class AsyncIoLoopGroup;
 	class AsyncIoInstance;
 	class AsyncIoObject;
 	class AsyncStreamInstance;
@@ -73,14 +74,42 @@ namespace slib
 
 		sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms) override;
 
+		Ref<TimerWheelTask> setTimeout(const Function<void()>& callback, sl_uint64 delay_ms) override;
+
+		// number of the instances currently attached to this loop
+		sl_uint32 getInstancesCount();
+
+		// binds the loop thread to one logical processor (Linux, Windows); -1 releases the binding
+		sl_bool setCpuAffinity(sl_int32 cpuIndex);
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// sl_true when the completions are processed on io_uring (kernel 5.6 or later); otherwise the loop runs on epoll only
+		sl_bool isUringEnabled();
+
+		// `callback` is called on the loop thread with the result (transferred bytes, or negative errno). `offset`: -1 for the current position
+		sl_bool submitUringRead(sl_file handle, void* data, sl_uint32 size, sl_int64 offset, const Function<void(sl_int32 result)>& callback);
+
+		sl_bool submitUringWrite(sl_file handle, const void* data, sl_uint32 size, sl_int64 offset, const Function<void(sl_int32 result)>& callback);
+
+		// one-shot poll: `callback` is called with the signaled events (POLLIN, POLLOUT, ...)
+		sl_bool submitUringPoll(sl_file handle, sl_uint32 events, const Function<void(sl_int32 result)>& callback);
+
+		// reads and writes inside the registered buffers are submitted as fixed-buffer operations
+		sl_bool registerUringBuffers(const Memory* buffers, sl_uint32 count);
+
+		void unregisterUringBuffers();
+#endif
+
 	protected:
 		sl_bool m_flagInit;
 		sl_bool m_flagRunning;
 		void* m_handle;
+		sl_int32 m_nInstances;
 
 		Ref<Thread> m_thread;
 
 		LinkedQueue< Function<void()> > m_queueTasks;
+		Ref<TimerWheel> m_timeTasks;
 	
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesOrder;
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesClosing;
@@ -97,7 +126,55 @@ namespace slib
 	protected:
 		void _stepBegin();
 		void _stepEnd();
+		sl_int32 _getTimeout();
+	
+	};
+	
+	enum class AsyncIoLoopSelection
+	{
+		RoundRobin = 0,
+		LeastLoaded = 1
+	};
 	
+	// N loops, each running on its own thread
+	class SLIB_EXPORT AsyncIoLoopGroup : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	private:
+		AsyncIoLoopGroup();
+		
+		~AsyncIoLoopGroup();
+		
+	public:
+		static Ref<AsyncIoLoopGroup> create(sl_uint32 nLoops, sl_bool flagAutoStart = sl_true);
+		
+	public:
+		void release();
+		
+		void start();
+		
+		sl_bool isRunning();
+		
+		sl_uint32 getLoopsCount();
+		
+		Ref<AsyncIoLoop> getLoop(sl_uint32 index);
+		
+		Ref<AsyncIoLoop> getNextLoop();
+		
+		Ref<AsyncIoLoop> getLeastLoadedLoop();
+		
+		Ref<AsyncIoLoop> selectLoop(AsyncIoLoopSelection selection);
+		
+		// binds the loop `i` to the logical processor `i % CPU::getProcessorsCount()`
+		sl_bool pinLoopsToCpus();
+		
+	protected:
+		Ref<AsyncIoLoop>* m_loops;
+		sl_uint32 m_nLoops;
+		sl_int32 m_indexNext;
+		sl_bool m_flagRunning;
+		
 	};
 	
 	
@@ -230,6 +307,13 @@ namespace slib
 		Function<void(AsyncStreamResult*)> callback;
 		sl_bool flagRead;
 
+		// source of the zero-copy write (`data` is null)
+		Ref<File> file;
+		sl_uint64 offsetFile;
+
+		// source of the vectored write (`data` is null), the sent bytes are removed from the front
+		Ref<MemoryQueue> queue;
+
 	protected:
 		AsyncStreamRequest(void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback, sl_bool flagRead);
 	
@@ -238,6 +322,11 @@ namespace slib
 
 		static Ref<AsyncStreamRequest> createWrite(void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback);
 
+		static Ref<AsyncStreamRequest> createSendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback);
+
+		// moves the chunks of `queue` to the request
+		static Ref<AsyncStreamRequest> createWriteVector(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback);
+
 	public:
 		void runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError);
 
@@ -258,6 +347,12 @@ namespace slib
 
 		virtual sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject);
 
+		// returns sl_false when the instance can't transfer from a file descriptor directly
+		virtual sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback);
+
+		// returns sl_false when the instance can't gather the chunks in one write
+		virtual sl_bool writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -309,6 +404,15 @@ namespace slib
 
 		virtual sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) = 0;
 
+		// zero-copy write from `file` (sendfile), returns sl_false when it is not supported by the stream
+		virtual sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback);
+
+		/*
+			gathering write of the chunks in `queue` (writev), returns sl_false when it is not supported by the stream.
+			On success, the chunks are moved from `queue` to the request, and `result->size` is the total size of the written chunks.
+		*/
+		virtual sl_bool writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -339,6 +443,10 @@ namespace slib
 
 		sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
 
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback) override;
+
+		sl_bool writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback) override;
+
 		sl_bool isSeekable() override;
 
 		sl_bool seek(sl_uint64 pos) override;
@@ -497,6 +605,16 @@ namespace slib
 
 		static Ref<AsyncStream> openIOCP(const String& path, FileMode mode);
 #endif
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		/*
+			completion-based file stream on the io_uring of `loop`, falls back to `open()` when the loop has no ring.
+			`create()` and `open()` without a dispatcher also run on the ring of the default loop when it is available.
+		*/
+		static Ref<AsyncStream> openUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop);
+
+		static Ref<AsyncStream> openUring(const String& path, FileMode mode);
+#endif
 	
 	public:
 		void close() override;
@@ -509,11 +627,20 @@ namespace slib
 
 		sl_uint64 getSize() override;
 	
+		sl_bool read(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
+
+		sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
+
+		sl_bool addTask(const Function<void()>& callback) override;
+	
 	public:
 		Ref<File> getFile();
 	
 	protected:
 		void processRequest(AsyncStreamRequest* request) override;
+
+		// attaches a completion-based instance on the io_uring of `loop`, instead of the dispatcher. returns sl_false when the loop has no ring
+		sl_bool _initializeUring(const Ref<AsyncIoLoop>& loop);
 	
 	private:
 		AtomicRef<File> m_file;
@@ -647,6 +774,8 @@ namespace slib
 
 		AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size);
 
+		AsyncOutputBufferElement(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+
 		~AsyncOutputBufferElement();
 	
 	public:
@@ -658,17 +787,28 @@ namespace slib
 		sl_bool addHeader(const Memory& header);
 
 		void setBody(AsyncStream* stream, sl_uint64 size);
+
+		void setFileBody(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
 	
 		MemoryQueue& getHeader();
 	
 		Ref<AsyncStream> getBody();
 	
 		sl_uint64 getBodySize();
+
+		Ref<File> getFileBody();
+
+		sl_uint64 getFileBodyOffset();
+
+		// consumes `size` bytes from the front of the file body
+		void skipFileBody(sl_uint64 size);
 	
 	protected:
 		MemoryQueue m_header;
 		sl_uint64 m_sizeBody;
 		AtomicRef<AsyncStream> m_body;
+		AtomicRef<File> m_fileBody;
+		sl_uint64 m_offsetFileBody;
 
 	};
 	
@@ -686,14 +826,28 @@ namespace slib
 
 		sl_bool write(const Memory& mem);
 
+		// `size` can be SLIB_UINT64_MAX for the stream which is ended by an empty read
 		sl_bool copyFrom(AsyncStream* stream, sl_uint64 size);
 	
 		sl_bool copyFromFile(const String& path);
 
 		sl_bool copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 
+		// the body is sent by sendfile when the output stream supports it, otherwise it is copied through AsyncFile
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+
+		sl_bool sendFile(const String& path, sl_uint64 offset, sl_uint64 size);
+
+		sl_bool sendFile(const String& path);
+
 		sl_uint64 getOutputLength() const;
 	
+		// moves the written memory to `output` and clears the buffer, fails (without change) when the buffer contains a stream or file body
+		sl_bool popMemory(MemoryQueue& output);
+	
+		// moves all the elements to `output` and clears the buffer
+		void popElements(LinkedQueue< Ref<AsyncOutputBufferElement> >& output);
+	
 	protected:
 		sl_uint64 m_lengthOutput;
 		LinkedQueue< Ref<AsyncOutputBufferElement> > m_queueOutput;
@@ -769,6 +923,8 @@ namespace slib
 
 		void _write(sl_bool flagCompleted);
 
+		void _copyBody(const Ref<AsyncStream>& body, sl_uint64 size);
+
 	protected:
 		Ref<AsyncStream> m_streamOutput;
 		sl_uint32 m_bufferSize;
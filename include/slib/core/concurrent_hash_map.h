@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+#define CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+
+#include "definition.h"
+
+#include "hash_table.h"
+#include "mutex.h"
+#include "list.h"
+
+/*
+	Hash map shared by many threads
+
+	The items are distributed to the shards by the hash of the key, and every shard is a `HashTable` guarded by its own mutex,
+	so the threads accessing the different shards do not contend on one lock (`HashMap` locks the whole map).
+	`forEach()`, `getAllKeys()` and `getAllValues()` lock all the shards in the order of the index, and see a consistent snapshot.
+	The callbacks (`computeIfAbsent()`, `forEach()`) are called while the shard is locked, so they must not access the map.
+*/
+
+#define SLIB_CONCURRENT_HASH_MAP_DEFAULT_SHARD_COUNT 64
+
+namespace slib
+{
+
+	template <class KT, class VT, class HASH, class KEY_EQUALS>
+	class ConcurrentHashMapShard
+	{
+	public:
+		Mutex lock;
+		HashTable<KT, VT, HASH, KEY_EQUALS> table;
+		// keeps the locks of the neighbor shards on the different cache lines
+		sl_uint8 padding[64];
+
+	public:
+		ConcurrentHashMapShard(const HASH& hash, const KEY_EQUALS& key_equals) noexcept;
+
+	};
+
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT ConcurrentHashMap
+	{
+	public:
+		// `shardCount` is rounded up to the power of 2 (0: SLIB_CONCURRENT_HASH_MAP_DEFAULT_SHARD_COUNT)
+		ConcurrentHashMap(sl_uint32 shardCount = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+
+		ConcurrentHashMap(const ConcurrentHashMap& other) = delete;
+
+		~ConcurrentHashMap() noexcept;
+
+	public:
+		ConcurrentHashMap& operator=(const ConcurrentHashMap& other) = delete;
+
+	public:
+		sl_uint32 getShardCount() const noexcept;
+
+		// sum of the counts of the shards, which are not locked at once
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		sl_bool get(const KT& key, VT* _out = sl_null) const noexcept;
+
+		VT getValue(const KT& key) const noexcept;
+
+		VT getValue(const KT& key, const VT& def) const noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, MapPutMode mode = MapPutMode::Default) noexcept;
+
+		// `creator(key)` is called when the key is not found, and the created value is added
+		template <class CREATOR>
+		VT computeIfAbsent(const KT& key, const CREATOR& creator) noexcept;
+
+		// the removed value is destroyed after the shard is unlocked
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		sl_size removeAll() noexcept;
+
+		// `callback(const KT& key, VT& value)`
+		template <class CALLBACK>
+		void forEach(const CALLBACK& callback) const noexcept;
+
+		List<KT> getAllKeys() const noexcept;
+
+		List<VT> getAllValues() const noexcept;
+
+	private:
+		typedef ConcurrentHashMapShard<KT, VT, HASH, KEY_EQUALS> Shard;
+
+		Shard* _getShard(const KT& key) const noexcept;
+
+		void _lockAll() const noexcept;
+
+		void _unlockAll() const noexcept;
+
+	private:
+		Shard* m_shards;
+		sl_uint32 m_shardCount;
+		sl_uint32 m_shardShift;
+		HASH m_hash;
+		KEY_EQUALS m_equals;
+
+	};
+
+}
+
+#include "detail/concurrent_hash_map.inc"
+
+#endif
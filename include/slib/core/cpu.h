@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CPU
+#define CHECKHEADER_SLIB_CORE_CPU
+
+#include "definition.h"
+
+/*
+	Instruction set extensions of the running processor
+
+	The features are detected by CPUID once, and are used to select the accelerated code paths at runtime.
+	Every feature function returns `sl_false` on non-x86 processors.
+*/
+
+namespace slib
+{
+
+	class SLIB_EXPORT CPU
+	{
+	public:
+		static sl_bool isSSE41Supported();
+
+		static sl_bool isAVX2Supported();
+
+		static sl_bool isAESNISupported();
+
+		static sl_bool isPCLMULQDQSupported();
+
+		static sl_bool isSHASupported();
+
+		// number of the logical processors available to the process
+		static sl_uint32 getProcessorsCount();
+
+	};
+
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "definition.h"
 
 #include "timer.h"
+#include "timer_wheel.h"
 
 namespace slib
 {
@@ -49,6 +50,12 @@ namespace slib
 	public:
 		virtual sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms = 0) = 0;
 
+		// default implementation waits on the shared `TimerWheel`, and dispatches the callback when expired
+		virtual Ref<TimerWheelTask> setTimeout(const Function<void()>& callback, sl_uint64 delay_ms);
+
+	protected:
+		void _dispatchExpired(const Function<void()>& callback);
+
 	};
 
 }
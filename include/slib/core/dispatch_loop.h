@@ -45,6 +45,8 @@ namespace slib
 
 		sl_bool dispatch(const Function<void()>& task, sl_uint64 delay_ms = 0) override;
 
+		Ref<TimerWheelTask> setTimeout(const Function<void()>& task, sl_uint64 delay_ms) override;
+
 		sl_bool addTimer(const Ref<Timer>& timer);
 		
 		void removeTimer(const Ref<Timer>& timer);
@@ -60,13 +62,7 @@ namespace slib
 
 		LinkedQueue< Function<void()> > m_queueTasks;
 
-		struct TimeTask
-		{
-			sl_uint64 time;
-			Function<void()> task;
-		};
-		RedBlackTree<sl_uint64, TimeTask> m_timeTasks;
-		Mutex m_lockTimeTasks;
+		Ref<TimerWheel> m_timeTasks;
 
 		class TimerTask
 		{
@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_FLAT_HASH_TABLE
+#define CHECKHEADER_SLIB_CORE_FLAT_HASH_TABLE
+
+#include "definition.h"
+
+#include "constants.h"
+#include "pair.h"
+#include "hash.h"
+#include "compare.h"
+#include "list.h"
+#include "object.h"
+
+/*
+	Open addressing hash table
+
+	The items are stored in one array of slots without the separate nodes.
+	Every slot has a control byte: empty, deleted, or 7 bits of the hash of the key in the slot.
+	A lookup compares the control bytes of a group of slots at once (16 slots by SSE2, or 8 slots by 64-bit arithmetic),
+	and compares the keys only in the slots whose control bytes match.
+	The table grows when 7/8 of the slots are used.
+
+	Differences from `HashTable`:
+		- The keys are unique (`MapPutMode::AddAlways` works as `MapPutMode::AddOrReplace`)
+		- The items are iterated in the order of the slots, not in the order of the insertion
+		- The pointers to the items are invalidated when the table grows
+*/
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define SLIB_FLAT_HASH_TABLE_USE_SSE2
+#	include <emmintrin.h>
+#	define SLIB_FLAT_HASH_TABLE_GROUP_WIDTH 16
+#else
+#	define SLIB_FLAT_HASH_TABLE_GROUP_WIDTH 8
+#endif
+
+namespace slib
+{
+
+	template <class KT, class VT>
+	class SLIB_EXPORT FlatHashTablePosition
+	{
+	public:
+		FlatHashTablePosition(const sl_int8* ctrl, Pair<KT, VT>* slot, sl_size index, sl_size capacity) noexcept;
+
+	public:
+		Pair<KT, VT>& operator*() const noexcept;
+
+		sl_bool operator==(const FlatHashTablePosition& other) const noexcept;
+
+		sl_bool operator!=(const FlatHashTablePosition& other) const noexcept;
+
+		FlatHashTablePosition& operator++() noexcept;
+
+	private:
+		void _skipEmpty() noexcept;
+
+	private:
+		const sl_int8* m_ctrl;
+		Pair<KT, VT>* m_slot;
+		sl_size m_index;
+		sl_size m_capacity;
+
+	};
+
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT FlatHashTable
+	{
+	public:
+		FlatHashTable() noexcept;
+
+		FlatHashTable(sl_size capacity) noexcept;
+
+		template <class HASH_ARG>
+		FlatHashTable(sl_size capacity, HASH_ARG&& hash) noexcept;
+
+		template <class HASH_ARG, class KEY_EQUALS_ARG>
+		FlatHashTable(sl_size capacity, HASH_ARG&& hash, KEY_EQUALS_ARG&& key_equals) noexcept;
+
+		FlatHashTable(const FlatHashTable& other) = delete;
+
+		FlatHashTable(FlatHashTable&& other) noexcept;
+
+		~FlatHashTable() noexcept;
+
+	public:
+		FlatHashTable& operator=(const FlatHashTable& other) = delete;
+
+		FlatHashTable& operator=(FlatHashTable&& other) noexcept;
+
+	public:
+		sl_size getCount() const noexcept;
+
+		sl_size getCapacity() const noexcept;
+
+		Pair<KT, VT>* find(const KT& key) const noexcept;
+
+		sl_bool get(const KT& key, VT* outValue = sl_null) const noexcept;
+
+		VT* getItemPointer(const KT& key) const noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, MapPutMode mode = MapPutMode::Default, Pair<KT, VT>** ppItem = sl_null) noexcept;
+
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		sl_size removeAll() noexcept;
+
+		// prepares the slots for `count` items
+		sl_bool reserve(sl_size count) noexcept;
+
+		sl_bool copyFrom(const FlatHashTable<KT, VT, HASH, KEY_EQUALS>* other) noexcept;
+
+		FlatHashTablePosition<KT, VT> begin() const noexcept;
+
+		FlatHashTablePosition<KT, VT> end() const noexcept;
+
+	private:
+		typedef Pair<KT, VT> Slot;
+
+		sl_bool _find(const KT& key, sl_uint32 hash, sl_size& outIndex) const noexcept;
+
+		sl_size _findSlotToInsert(sl_uint32 hash) const noexcept;
+
+		void _setControl(sl_size index, sl_int8 h) noexcept;
+
+		sl_bool _rehash(sl_size capacity) noexcept;
+
+		void _free() noexcept;
+
+	private:
+		sl_int8* m_ctrl;
+		Slot* m_slots;
+		sl_size m_capacity;
+		sl_size m_count;
+		// count of the empty slots available before growing
+		sl_size m_growthLeft;
+		HASH m_hash;
+		KEY_EQUALS m_equals;
+
+	};
+
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT FlatHashMap final : public Object
+	{
+	public:
+		FlatHashTable<KT, VT, HASH, KEY_EQUALS> table;
+
+	public:
+		FlatHashMap() noexcept;
+
+		FlatHashMap(sl_size capacity) noexcept;
+
+		FlatHashMap(sl_size capacity, const HASH& hash, const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+
+		FlatHashMap(const FlatHashMap& other) = delete;
+
+		~FlatHashMap() noexcept;
+
+	public:
+		FlatHashMap& operator=(const FlatHashMap& other) = delete;
+
+		VT operator[](const KT& key) const noexcept;
+
+	public:
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		VT* getItemPointer(const KT& key) const noexcept;
+
+		sl_bool get_NoLock(const KT& key, VT* _out = sl_null) const noexcept;
+
+		sl_bool get(const KT& key, VT* _out = sl_null) const noexcept;
+
+		VT getValue_NoLock(const KT& key) const noexcept;
+
+		VT getValue(const KT& key) const noexcept;
+
+		VT getValue_NoLock(const KT& key, const VT& def) const noexcept;
+
+		VT getValue(const KT& key, const VT& def) const noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool put_NoLock(KEY&& key, VALUE&& value, MapPutMode mode = MapPutMode::Default) noexcept;
+
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, MapPutMode mode = MapPutMode::Default) noexcept;
+
+		sl_bool remove_NoLock(const KT& key, VT* outValue = sl_null) noexcept;
+
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		sl_size removeAll_NoLock() noexcept;
+
+		sl_size removeAll() noexcept;
+
+		Pair<KT, VT>* find_NoLock(const KT& key) const noexcept;
+
+		Pair<KT, VT>* find(const KT& key) const noexcept;
+
+		List<KT> getAllKeys_NoLock() const noexcept;
+
+		List<KT> getAllKeys() const noexcept;
+
+		List<VT> getAllValues_NoLock() const noexcept;
+
+		List<VT> getAllValues() const noexcept;
+
+		FlatHashTablePosition<KT, VT> begin() const noexcept;
+
+		FlatHashTablePosition<KT, VT> end() const noexcept;
+
+	};
+
+}
+
+#include "detail/flat_hash_table.inc"
+
+#endif
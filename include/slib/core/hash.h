@@ -19,18 +19,46 @@ namespace slib
 	template <class T>
 	class Hash;
 
+	constexpr sl_uint32 _priv_Hash_xorShift32(sl_uint32 x, sl_uint32 n) noexcept
+	{
+		return x ^ (x >> n);
+	}
+
+	constexpr sl_uint64 _priv_Hash_xorShift64(sl_uint64 x, sl_uint32 n) noexcept
+	{
+		return x ^ (x >> n);
+	}
+
+	// every bit of the input affects every bit of the output (lowbias32)
+	constexpr sl_uint32 Mix32(sl_uint32 x) noexcept
+	{
+		return _priv_Hash_xorShift32(_priv_Hash_xorShift32(_priv_Hash_xorShift32(x, 16) * 0x7feb352d, 15) * 0x846ca68b, 16);
+	}
+
+	// every bit of the input affects every bit of the output (finalizer of MurmurHash3)
+	constexpr sl_uint64 Mix64(sl_uint64 x) noexcept
+	{
+		return _priv_Hash_xorShift64(_priv_Hash_xorShift64(_priv_Hash_xorShift64(x, 33) * SLIB_UINT64(0xff51afd7ed558ccd), 33) * SLIB_UINT64(0xc4ceb9fe1a85ec53), 33);
+	}
+
 	constexpr sl_uint32 Rehash(sl_uint32 x) noexcept
 	{
-		return x ^ (x >> 4) ^ (x >> 7) ^ (x >> 12) ^ (x >> 16) ^ (x >> 19) ^ (x >> 20) ^ (x >> 24) ^ (x >> 27);
+		return Mix32(x);
 	}
 
 	constexpr sl_uint32 Hash64(sl_uint64 x) noexcept
 	{
-		return Rehash((sl_uint32)(x ^ (x >> 32)));
+		return (sl_uint32)(Mix64(x));
 	}
 
 	sl_uint32 HashBytes(const void* buf, sl_size n) noexcept;
 
+	// based on wyhash (public domain), reads 48 bytes per step
+	sl_uint64 HashBytes64(const void* buf, sl_size n, sl_uint64 seed = 0) noexcept;
+
+	// random seed generated once per process, to be passed to `HashBytes64()` against the hash flooding
+	sl_uint64 GetHashSeed() noexcept;
+
 	template <>
 	class Hash<char>
 	{
@@ -105,14 +133,14 @@ namespace slib
 	class Hash<long>
 	{
 	public:
-		constexpr sl_uint32 operator()(long v) const noexcept { return Rehash((sl_uint32)v);}
+		constexpr sl_uint32 operator()(long v) const noexcept { return sizeof(long) > 4 ? Hash64((sl_uint64)v) : Rehash((sl_uint32)v);}
 	};
 
 	template <>
 	class Hash<unsigned long>
 	{
 	public:
-		constexpr sl_uint32 operator()(unsigned long v) const noexcept { return Rehash((sl_uint32)v);}
+		constexpr sl_uint32 operator()(unsigned long v) const noexcept { return sizeof(unsigned long) > 4 ? Hash64((sl_uint64)v) : Rehash((sl_uint32)v);}
 	};
 
 	template <>
@@ -0,0 +1,257 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_JSON_IO
+#define CHECKHEADER_SLIB_CORE_JSON_IO
+
+#include "definition.h"
+
+#include "json.h"
+#include "io.h"
+#include "list.h"
+
+/*
+	Streaming JSON reader and writer
+
+	`JsonReader` is a pull cursor: every `next()` returns one token without building the `Variant` tree,
+	and the memory used is bounded by the longest string and the nesting depth.
+	Consecutive top-level values (NDJSON) are returned one after another, and `readValue()` materializes
+	only the current value when the DOM is needed for each record.
+	The accepted syntax is same as `Json::parseJson()` (comments, single-quoted strings, unquoted keys, trailing commas).
+
+	`JsonWriter` writes the tokens through a fixed-size buffer into `IWriter` or `AsyncOutputBuffer`,
+	and separates consecutive top-level values by a new line (NDJSON).
+*/
+
+namespace slib
+{
+
+	class AsyncOutputBuffer;
+
+	enum class JsonToken
+	{
+		None = 0,
+		BeginObject = 1,
+		EndObject = 2,
+		BeginArray = 3,
+		EndArray = 4,
+		// name of the object member, `getString()` returns the name and the next token is the value
+		Key = 5,
+		String = 6,
+		Number = 7,
+		Boolean = 8,
+		Null = 9,
+		// no more value in the input
+		End = 10,
+		Error = 11
+	};
+
+	class SLIB_EXPORT JsonReader
+	{
+	public:
+		JsonReader();
+
+		~JsonReader();
+
+	public:
+		// the text is not copied, and must be valid while reading
+		void setInput(const void* data, sl_size size);
+
+		void setInput(const String& text);
+
+		void setInput(const Memory& mem);
+
+		// the text is read in the chunks of `sizeBuffer` bytes
+		void setInput(IReader* reader, sl_size sizeBuffer = 65536);
+
+		void setSupportComments(sl_bool flag);
+
+	public:
+		JsonToken next();
+
+		JsonToken getToken();
+
+		// number of the opened objects and arrays
+		sl_size getDepth();
+
+		// `Key`, `String` tokens: unescaped text (valid until `next()`), `Number` token: source text
+		const sl_char8* getStringData();
+
+		sl_size getStringLength();
+
+		String getString();
+
+		sl_bool getBoolean();
+
+		// `Number` token: returns `sl_false` if the number has fraction or exponent, or overflows
+		sl_bool getInt64(sl_int64* _out);
+
+		sl_int64 getInt64(sl_int64 def = 0);
+
+		double getDouble(double def = 0);
+
+		// materializes the value starting at the current token (the whole object or array for the `Begin` tokens)
+		Json readValue();
+
+		// skips the value starting at the current token
+		sl_bool skipValue();
+
+		sl_bool isError();
+
+		String getErrorMessage();
+
+		// offset from the beginning of the input
+		sl_uint64 getErrorPosition();
+
+	protected:
+		void _reset();
+
+		sl_bool _fill();
+
+		sl_bool _peek(sl_char8& ch);
+
+		sl_bool _skipSpaceAndComments(sl_char8& ch);
+
+		JsonToken _readValue(sl_char8 first);
+
+		sl_bool _readString(sl_char8 chEnd);
+
+		// `flagIdentifier`: unquoted key, otherwise literal or number
+		void _readToken(sl_bool flagIdentifier);
+
+		JsonToken _readBareToken();
+
+		sl_bool _appendValue(const sl_char8* data, sl_size size);
+
+		sl_bool _appendUtf8(sl_uint32 code);
+
+		JsonToken _setError(const char* message);
+
+	protected:
+		const sl_char8* m_data;
+		sl_size m_pos;
+		sl_size m_end;
+		sl_uint64 m_offsetData;
+		Memory m_input;
+		String m_inputText;
+		IReader* m_reader;
+		Memory m_bufferInput;
+		sl_bool m_flagSupportComments;
+
+		JsonToken m_token;
+		// `sl_true` for object, `sl_false` for array
+		List<sl_bool> m_stack;
+		sl_bool m_flagNeedComma;
+		sl_bool m_flagExpectValue;
+
+		const sl_char8* m_value;
+		sl_size m_lenValue;
+		Memory m_bufferValue;
+		sl_bool m_valueBoolean;
+		sl_bool m_flagValueInteger;
+		sl_int64 m_valueInt64;
+		double m_valueDouble;
+
+		String m_errorMessage;
+		sl_uint64 m_errorPosition;
+
+	};
+
+	class SLIB_EXPORT JsonWriter
+	{
+	public:
+		JsonWriter();
+
+		~JsonWriter();
+
+	public:
+		void setOutput(IWriter* writer);
+
+		// the buffered text is added to `output` as `Memory` chunks
+		void setOutput(AsyncOutputBuffer* output);
+
+		void setBufferSize(sl_size size);
+
+	public:
+		sl_bool beginObject();
+
+		sl_bool endObject();
+
+		sl_bool beginArray();
+
+		sl_bool endArray();
+
+		sl_bool writeKey(const sl_char8* key, sl_size len);
+
+		sl_bool writeKey(const String& key);
+
+		sl_bool writeString(const sl_char8* str, sl_size len);
+
+		sl_bool writeString(const String& str);
+
+		sl_bool writeInt32(sl_int32 value);
+
+		sl_bool writeUint32(sl_uint32 value);
+
+		sl_bool writeInt64(sl_int64 value);
+
+		sl_bool writeUint64(sl_uint64 value);
+
+		// NaN and infinity are written as `null`
+		sl_bool writeDouble(double value);
+
+		sl_bool writeBoolean(sl_bool value);
+
+		sl_bool writeNull();
+
+		// writes the tree of `Variant` (list, map and map list) as one value
+		sl_bool writeValue(const Json& value);
+
+		// writes the buffered text to the output
+		sl_bool flush();
+
+		sl_bool isError();
+
+		// number of the opened objects and arrays
+		sl_size getDepth();
+
+	protected:
+		sl_bool _beginValue();
+
+		void _endValue();
+
+		sl_bool _write(const void* data, sl_size size);
+
+		sl_bool _writeChar(sl_char8 ch);
+
+		sl_bool _writeEscaped(const sl_char8* str, sl_size len);
+
+		sl_bool _writeUnsigned(sl_uint64 value, sl_bool flagNegative);
+
+	protected:
+		IWriter* m_writer;
+		AsyncOutputBuffer* m_output;
+
+		Memory m_buffer;
+		sl_size m_sizeBuffer;
+		sl_size m_posBuffer;
+
+		// `sl_true` for object, `sl_false` for array
+		List<sl_bool> m_stack;
+		sl_bool m_flagNeedComma;
+		sl_bool m_flagExpectValue;
+		sl_bool m_flagWrittenTopValue;
+		sl_bool m_flagError;
+
+	};
+
+}
+
+#endif
@@ -17,11 +17,18 @@
 #include "object.h"
 #include "list.h"
 #include "variant.h"
+#include "memory.h"
+#include "time.h"
 
 namespace slib
 {
 
 	class LoggerSet;
+	class AsyncFileLogger;
+	class AsyncFileLoggerParam;
+	class File;
+	class Thread;
+	class Event;
 	
 	class SLIB_EXPORT Console
 	{
@@ -61,6 +68,10 @@ namespace slib
 
 		static Ref<Logger> createFileLogger(const String& fileName);
 
+		static Ref<Logger> createAsyncFileLogger(const String& fileName);
+
+		static Ref<Logger> createAsyncFileLogger(const AsyncFileLoggerParam& param);
+
 		static void logGlobal(const String& tag, const String& content);
 
 		static void logGlobalError(const String& tag, const String& content);
@@ -84,6 +95,112 @@ namespace slib
 	
 	};
 	
+	enum class LogOverflowPolicy
+	{
+		// the line is discarded when the queue is full
+		Drop = 0,
+		// the caller waits until the writer thread makes a room
+		Block = 1
+	};
+	
+	class SLIB_EXPORT AsyncFileLoggerParam
+	{
+	public:
+		String fileName;
+		
+		// number of the lines buffered between the callers and the writer thread (rounded up to a power of 2)
+		sl_uint32 queueSize; // default: 8192
+		LogOverflowPolicy overflowPolicy; // default: Drop
+		
+		// the file is rotated when it grows over this size (0: no limit)
+		sl_uint64 maxFileSize; // default: 0
+		// the file is rotated at this interval (0: never)
+		sl_uint32 rotationInterval; // seconds, default: 0
+		// rotated files are named `fileName.1` (newest) ~ `fileName.N`
+		sl_uint32 maxBackupCount; // default: 5
+		
+	public:
+		AsyncFileLoggerParam();
+		
+		~AsyncFileLoggerParam();
+		
+	};
+	
+	/*
+		The callers push the lines into a bounded lock-free ring (multi-producer, single-consumer),
+		and one writer thread formats them and writes them in batches to a file kept open.
+	*/
+	class SLIB_EXPORT AsyncFileLogger : public Logger
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		AsyncFileLogger();
+		
+		~AsyncFileLogger();
+		
+	public:
+		static Ref<AsyncFileLogger> create(const AsyncFileLoggerParam& param);
+		
+		static Ref<AsyncFileLogger> create(const String& fileName);
+		
+	public:
+		void log(const String& tag, const String& content) override;
+		
+		// waits until the lines logged before this call are written
+		void flush();
+		
+		// writes the remaining lines and stops the writer thread; the lines logged after this call are discarded
+		void release();
+		
+		// number of the lines discarded by `LogOverflowPolicy::Drop`
+		sl_uint64 getDroppedLinesCount();
+		
+	protected:
+		sl_bool _push(const String& tag, const String& content);
+		
+		void _runThread();
+		
+		sl_bool _processBatch();
+		
+		void _writeLine(const String& tag, const String& content);
+		
+		void _write(const void* data, sl_size size);
+		
+		void _writeBuffer();
+		
+		sl_bool _openFile();
+		
+		void _rotate();
+		
+	protected:
+		struct Slot;
+		
+		AsyncFileLoggerParam m_param;
+		
+		Slot* m_slots;
+		sl_reg m_mask;
+		sl_reg m_posEnqueue;
+		sl_reg m_posDequeue;
+		sl_reg m_posWritten;
+		sl_int32 m_flagWriterSleeping;
+		sl_int64 m_nDropped;
+		sl_bool m_flagReleased;
+		
+		Ref<Thread> m_thread;
+		Ref<Event> m_eventWrite;
+		Ref<Event> m_eventWritten;
+		
+		Ref<File> m_file;
+		sl_uint64 m_sizeFile;
+		Time m_timeOpened;
+		Memory m_bufWrite;
+		sl_size m_sizeBufWrite;
+		String m_timeFormatted;
+		sl_int64 m_secondsFormatted;
+		
+	};
+	
 	class SLIB_EXPORT LoggerSet : public Logger
 	{
 	public:
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MAPPED_FILE
+#define CHECKHEADER_SLIB_CORE_MAPPED_FILE
+
+#include "definition.h"
+
+#include "memory.h"
+#include "string.h"
+
+/*
+	Memory-mapped file
+
+	The pages of the file are loaded on demand by the system, and are shared with the page cache instead of being copied to the heap.
+	The mapping is released when the `MappedFile` (and every `Memory` returned by `getMemory()`) is freed.
+*/
+
+namespace slib
+{
+
+	enum class MappedFileMode
+	{
+		// the pages must not be written
+		Read = 0,
+		// the writes are shared with the file
+		ReadWrite = 1,
+		// the written pages are copied and the file is not changed
+		CopyOnWrite = 2
+	};
+
+	enum class MappedFileAdvice
+	{
+		Normal = 0,
+		Sequential = 1,
+		Random = 2,
+		// starts to read the pages ahead
+		WillNeed = 3,
+		// the pages can be dropped (reloaded from the file on the next access)
+		DontNeed = 4,
+		// transparent huge pages (Linux only)
+		HugePage = 5
+	};
+
+	class SLIB_EXPORT MappedFile : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	private:
+		MappedFile();
+
+		~MappedFile();
+
+	public:
+		// `size`: 0 maps to the end of the file. Empty files can not be mapped.
+		static Ref<MappedFile> open(const String& filePath, MappedFileMode mode = MappedFileMode::Read, sl_uint64 offset = 0, sl_size size = 0);
+
+	public:
+		void close();
+
+		sl_bool isOpened() const;
+
+		void* getData() const;
+
+		sl_size getSize() const;
+
+		MappedFileMode getMode() const;
+
+		// the returned memory keeps the mapping alive
+		Memory getMemory();
+
+		Memory getMemory(sl_size offset, sl_size size);
+
+		sl_bool advise(MappedFileAdvice advice, sl_size offset = 0, sl_size size = SLIB_SIZE_MAX);
+
+		// writes the modified pages to the file (`MappedFileMode::ReadWrite`)
+		sl_bool flush(sl_bool flagWait = sl_true);
+
+	protected:
+		void* m_data;
+		sl_size m_size;
+		// start of the mapping (aligned to the allocation granularity)
+		void* m_base;
+		sl_size m_sizeBase;
+		MappedFileMode m_mode;
+		sl_reg m_handle;
+		sl_reg m_handleMapping;
+
+	};
+
+}
+
+#endif
@@ -98,6 +98,9 @@ namespace slib
 
 		static Memory createStatic(const void* buf, sl_size size, Referable* refer);
 
+		// maps the file to the memory (see `MappedFile`), and the mapping is released with the memory. `flagWritable`: the written pages are not saved to the file
+		static Memory createMapped(const String& filePath, sl_bool flagWritable = sl_false);
+
 	public:
 		void* getData() const;
 
@@ -198,6 +201,11 @@ namespace slib
 		
 		sl_bool addStatic(const void* buf, sl_size size);
 		
+		// copies `buf` into a buffer of `MemoryPool`
+		sl_bool addNew_NoLock(const void* buf, sl_size size);
+		
+		sl_bool addNew(const void* buf, sl_size size);
+		
 		void link_NoLock(MemoryQueue& buf);
 		
 		void link(MemoryQueue& buf);
@@ -214,6 +222,14 @@ namespace slib
 	
 		sl_size pop(void* buf, sl_size size);
 		
+		// removes `size` bytes from the front of the queue without copying, returns the removed size
+		sl_size skip_NoLock(sl_size size);
+		
+		sl_size skip(sl_size size);
+		
+		// fills `chunks` from the front of the queue without popping (`refer` is not set), returns the count of the filled chunks
+		sl_uint32 getChunks_NoLock(MemoryData* chunks, sl_uint32 maxCount) const;
+		
 		Memory merge_NoLock() const;
 	
 		Memory merge() const;
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MEMORY_POOL
+#define CHECKHEADER_SLIB_CORE_MEMORY_POOL
+
+#include "definition.h"
+
+#include "memory.h"
+
+/*
+	Global pool of I/O buffers
+
+	The buffers are grouped by the power-of-two size classes from 256 bytes to `SLIB_MEMORY_POOL_MAX_SIZE`.
+	The buffer of a `Memory` created by `MemoryPool::create()` is recycled when the `Memory` is freed:
+	it is kept in the cache of the freeing thread first, and then in the shared list of the size class,
+	until the shared lists reach `getMaxCachedSize()`.
+	Larger sizes are passed to `Memory::create()`.
+*/
+
+#define SLIB_MEMORY_POOL_MAX_SIZE 1048576
+
+namespace slib
+{
+
+	class SLIB_EXPORT MemoryPoolStatistics
+	{
+	public:
+		// `create()` calls served by a recycled buffer
+		sl_uint64 countHit;
+		// `create()` calls allocating a new buffer
+		sl_uint64 countMiss;
+		// `create()` calls larger than `SLIB_MEMORY_POOL_MAX_SIZE`
+		sl_uint64 countOversized;
+		// buffers freed to the system because the shared lists are full
+		sl_uint64 countDiscarded;
+		// bytes kept in the shared lists (the thread caches are not included)
+		sl_size sizeCached;
+
+	public:
+		MemoryPoolStatistics();
+
+	};
+
+	class SLIB_EXPORT MemoryPool
+	{
+	public:
+		static Memory create(sl_size size);
+
+		static Memory create(const void* data, sl_size size);
+
+		static void getStatistics(MemoryPoolStatistics& statistics);
+
+		// default: 64MB
+		static sl_size getMaxCachedSize();
+
+		static void setMaxCachedSize(sl_size size);
+
+		// frees the buffers in the shared lists
+		static void clear();
+
+	};
+
+}
+
+#endif
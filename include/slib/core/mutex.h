@@ -16,6 +16,7 @@
 namespace slib
 {
 	
+	// The native mutex is created on the first locking
 	class SLIB_EXPORT Mutex
 	{
 	public:
@@ -43,7 +44,7 @@ namespace slib
 		mutable void* m_pObject;
 
 	private:
-		void _init() noexcept;
+		void* _create() const noexcept;
 
 		void _free() noexcept;
 
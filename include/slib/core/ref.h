@@ -50,6 +50,16 @@ namespace slib
 
 		void makeNeverFree() noexcept;
 
+	public:
+		// allocated by `SlabAllocator` (returns null on failure)
+		static void* operator new(sl_size_t size) noexcept;
+
+		static void operator delete(void* ptr, sl_size_t size) noexcept;
+
+		static void* operator new(sl_size_t size, void* place) noexcept;
+
+		static void operator delete(void* ptr, void* place) noexcept;
+
 	public:
 		static sl_object_type ObjectType() noexcept;
 		
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_SLAB_ALLOCATOR
+#define CHECKHEADER_SLIB_CORE_SLAB_ALLOCATOR
+
+#include "definition.h"
+
+/*
+	Allocator for small blocks (used by `Referable::operator new`)
+
+	The blocks up to `SLIB_SLAB_ALLOCATOR_MAX_SIZE` bytes are served from size classes of 16 bytes, carved from 64KB slabs.
+	Every thread caches some free blocks per size class, so allocating and freeing on a thread take no lock;
+	the blocks move between the thread cache and the shared list of the class in batches.
+	The slabs are never returned to the system, the freed blocks are reused in the same size class.
+	The larger blocks are allocated by `Base::createMemory()`.
+
+	Define `SLIB_NO_SLAB_ALLOCATOR` (or build with AddressSanitizer) to pass all the blocks to `Base::createMemory()`.
+*/
+
+#define SLIB_SLAB_ALLOCATOR_MAX_SIZE 512
+
+namespace slib
+{
+
+	class SLIB_EXPORT SlabAllocator
+	{
+	public:
+		static void* allocate(sl_size size) noexcept;
+
+		// `size` should be same as the size passed to `allocate()`
+		static void free(void* ptr, sl_size size) noexcept;
+
+		// total bytes of the slabs
+		static sl_size getReservedSize() noexcept;
+
+	};
+
+}
+
+#endif
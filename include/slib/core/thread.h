@@ -68,6 +68,11 @@ namespace slib
 		ThreadPriority getPriority();
 	
 		void setPriority(ThreadPriority priority);
+
+		sl_int32 getCpuAffinity();
+
+		// binds the thread to one logical processor (Linux, Windows); -1 releases the binding
+		sl_bool setCpuAffinity(sl_int32 cpuIndex);
 	
 		sl_bool isRunning();
 
@@ -106,6 +111,7 @@ namespace slib
 	private:
 		void* m_handle;
 		ThreadPriority m_priority;
+		sl_int32 m_cpuAffinity;
 	
 		sl_bool m_flagRequestStop;
 		sl_bool m_flagRunning;
@@ -125,6 +131,7 @@ namespace slib
 		void _nativeStart(sl_uint32 stackSize);
 		void _nativeClose();
 		void _nativeSetPriority();
+		sl_bool _nativeSetCpuAffinity();
 	
 	public:
 		void _run();
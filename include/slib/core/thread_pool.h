@@ -20,6 +20,14 @@
 namespace slib
 {
 	
+	enum class ThreadPoolMode
+	{
+		// all workers share one task queue guarded by the pool's lock
+		Shared = 0,
+		// each worker owns a deque, idle workers steal from the others
+		WorkStealing = 1
+	};
+	
 	class SLIB_EXPORT ThreadPool : public Dispatcher
 	{
 		SLIB_DECLARE_OBJECT
@@ -30,7 +38,7 @@ namespace slib
 		~ThreadPool();
 
 	public:
-		static Ref<ThreadPool> create(sl_uint32 minThreads = 0, sl_uint32 maxThreads = 30);
+		static Ref<ThreadPool> create(sl_uint32 minThreads = 0, sl_uint32 maxThreads = 30, ThreadPoolMode mode = ThreadPoolMode::Shared);
 	
 	public:
 		void release();
@@ -38,6 +46,8 @@ namespace slib
 		sl_bool isRunning();
 
 		sl_uint32 getThreadsCount();
+		
+		ThreadPoolMode getMode();
 	
 		sl_bool addTask(const Function<void()>& task);
 
@@ -50,12 +60,34 @@ namespace slib
 	
 	protected:
 		void onRunWorker();
+		
+	protected:
+		class StealingWorker;
+		
+		sl_bool _initStealingWorkers();
+		
+		sl_bool _startStealingWorker();
+		
+		sl_bool _addTaskStealing(const Function<void()>& task);
+		
+		sl_bool _popTaskStealing(StealingWorker* worker, Function<void()>& task);
+		
+		void _wakeStealingWorker();
+		
+		void _runStealingWorker(StealingWorker* worker);
 	
 	protected:
 		CList< Ref<Thread> > m_threadWorkers;
 		LinkedQueue< Function<void()> > m_tasks;
 	
 		sl_bool m_flagRunning;
+		ThreadPoolMode m_mode;
+		
+		StealingWorker** m_stealingWorkers;
+		sl_uint32 m_nStealingWorkers;
+		sl_int32 m_nStealingWorkersStarted;
+		sl_int32 m_nStealingWorkersParked;
+		sl_int32 m_indexStealingSubmit;
 
 	};
 
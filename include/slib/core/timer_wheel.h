@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_TIMER_WHEEL
+#define CHECKHEADER_SLIB_CORE_TIMER_WHEEL
+
+#include "definition.h"
+
+#include "object.h"
+#include "function.h"
+#include "time.h"
+#include "thread.h"
+
+/*
+	Hierarchical timer wheel (1 millisecond tick)
+
+	Level 0 has 256 slots of 1 tick, level 1~4 have 64 slots each and cover 2^14, 2^20, 2^26, 2^32 ticks.
+	Inserting and canceling a task are O(1); the tasks of an upper level are cascaded down when the lower level wraps.
+*/
+
+#define SLIB_TIMER_WHEEL_LEVEL0_BITS 8
+#define SLIB_TIMER_WHEEL_LEVEL_BITS 6
+#define SLIB_TIMER_WHEEL_LEVEL0_SIZE (1 << SLIB_TIMER_WHEEL_LEVEL0_BITS)
+#define SLIB_TIMER_WHEEL_LEVEL_SIZE (1 << SLIB_TIMER_WHEEL_LEVEL_BITS)
+#define SLIB_TIMER_WHEEL_LEVELS 5
+
+namespace slib
+{
+
+	class TimerWheel;
+
+	class SLIB_EXPORT TimerWheelTask : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		TimerWheelTask();
+
+		~TimerWheelTask();
+
+	public:
+		// returns sl_true if the task was removed before being fired
+		sl_bool cancel();
+
+		sl_bool isPending();
+
+		const Function<void()>& getTask();
+
+	protected:
+		Function<void()> m_task;
+		sl_uint64 m_timeExpire;
+		WeakRef<TimerWheel> m_wheel;
+
+		// links in the slot; `m_slot` is null when the task is not scheduled
+		TimerWheelTask** m_slot;
+		TimerWheelTask* m_prev;
+		TimerWheelTask* m_next;
+
+		friend class TimerWheel;
+	};
+
+	class SLIB_EXPORT TimerWheel : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		TimerWheel();
+
+		~TimerWheel();
+
+	public:
+		// The tasks are fired by the thread calling `process()`
+		static Ref<TimerWheel> create();
+
+		// The tasks are fired on the own thread of the wheel. Tasks should be short (dispatch the real work)
+		static Ref<TimerWheel> createWithThread();
+
+		// Shared wheel running on its own thread
+		static Ref<TimerWheel> getDefault();
+
+		static void releaseDefault();
+
+	public:
+		void release();
+
+		Ref<TimerWheelTask> add(const Function<void()>& task, sl_uint64 delay_ms);
+
+		sl_bool cancel(TimerWheelTask* task);
+
+		sl_size getCount();
+
+		sl_uint64 getElapsedMilliseconds();
+
+		// fires expired tasks, and returns the milliseconds until the next check (negative: no pending task)
+		sl_int32 process();
+
+	protected:
+		void _insert(TimerWheelTask* task);
+
+		void _unlink(TimerWheelTask* task);
+
+		void _cascade(sl_uint32 level);
+
+		void _advance(sl_uint64 now, TimerWheelTask*& expired);
+
+		sl_int32 _getTimeout();
+
+		void _runThread();
+
+	protected:
+		TimeCounter m_timeCounter;
+		Mutex m_lockWheel;
+
+		sl_uint64 m_tickCurrent;
+		sl_size m_nTasks;
+		TimerWheelTask* m_slots[SLIB_TIMER_WHEEL_LEVEL0_SIZE + (SLIB_TIMER_WHEEL_LEVELS - 1) * SLIB_TIMER_WHEEL_LEVEL_SIZE];
+
+		Ref<Thread> m_thread;
+		Ref<Event> m_eventWake;
+		sl_uint64 m_tickWake;
+
+	};
+
+}
+
+#endif
@@ -23,6 +23,9 @@
 
 	User Key Size - 128 bits (16 bytes), 192 bits (24 bytes), 256 bits (32 bytes)
 	Block Size - 128 bits (16 bytes)
+
+	AES-NI instructions are used when the processor supports them (detected at runtime).
+	`encryptBlocks`, `decryptBlocks` and CTR mode process 8 blocks in parallel on AES-NI.
 */
 
 namespace slib
@@ -87,6 +90,10 @@ namespace slib
 		sl_uint32 m_roundKeyEnc[64];
 		sl_uint32 m_roundKeyDec[64];
 		sl_uint32 m_nCountRounds;
+		// round keys in the byte order of AES-NI instructions
+		sl_uint8 m_roundKeyEncNI[240];
+		sl_uint8 m_roundKeyDecNI[240];
+		sl_bool m_flagNI;
 
 	};
 	
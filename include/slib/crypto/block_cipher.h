@@ -16,6 +16,8 @@
 #include "../core/memory.h"
 
 #define SLIB_CRYPTO_BLOCK_CIPHER_BLOCK_MAX_LEN 128
+// CTR mode encrypts the counters of this size at once (8 blocks of AES)
+#define SLIB_CRYPTO_BLOCK_CIPHER_CTR_BATCH_LEN 128
 
 
 namespace slib
@@ -25,6 +25,9 @@
 GCM is constructed from an approved symmetric key block cipher with a block size of 128 bits,
 such as the Advanced Encryption Standard (AES) algorithm
 
+GHASH is calculated by PCLMULQDQ (carry-less multiplication) when the processor supports it,
+reducing 4 blocks at once by the powers of H. Otherwise, Shoup's 4-bit table is used.
+
 */
 
 namespace slib
@@ -34,6 +37,8 @@ namespace slib
 	{
 	public:
 		Uint128 M[16]; // Shoup's, 4-bit table
+		sl_uint8 HP[4][16]; // H, H^2, H^3, H^4 (byte-reflected) for PCLMULQDQ
+		sl_bool flagCLMUL;
 	
 	public:
 		void generateTable(const void* H /* 16 bytes */);
@@ -19,6 +19,8 @@
 	SHA1 - Secure Hash Algorithm
 
 	Output: 160bits (20 bytes)
+
+	SHA extensions (SHA-NI) are used when the processor supports them (detected at runtime).
 */
 
 namespace slib
@@ -56,6 +58,8 @@ namespace slib
 		sl_uint32 getSize() const override;
 	
 	private:
+		void _updateSections(const sl_uint8* input, sl_size nSections);
+
 		void _updateSection(const sl_uint8* input);
 	
 	private:
@@ -23,6 +23,9 @@
 		SHA256 - 256bits (32 bytes)
 		SHA384 - 384bits (48 bytes)
 		SHA512 - 512bits (64 bytes)
+
+	SHA224/SHA256 use SHA extensions (SHA-NI) when the processor supports them (detected at runtime),
+	Otherwise, `hashMany` hashes 8 messages in parallel by AVX2.
 */
 
 namespace slib
@@ -43,7 +46,7 @@ namespace slib
 
 		void _finish();
 
-		void _updateSection(const sl_uint8* input);
+		void _updateSections(const sl_uint8* input, sl_size nSections);
 	
 	protected:
 		sl_size sizeTotalInput;
@@ -64,6 +67,10 @@ namespace slib
 
 		void finish(void* output) override;
 	
+	public:
+		// `output`: count * hash size
+		static void hashMany(const void* const* inputs, const sl_size* sizes, sl_uint32 count, void* output);
+
 	public: /* common functions for CryptoHash */
 		static void hash(const void* input, sl_size n, void* output);
 
@@ -98,6 +105,9 @@ namespace slib
 	public:
 		static sl_uint32 make32bitChecksum(const void* input, sl_size n);
 
+		// `output`: count * hash size
+		static void hashMany(const void* const* inputs, const sl_size* sizes, sl_uint32 count, void* output);
+
 	public: /* common functions for CryptoHash */
 		static void hash(const void* input, sl_size n, void* output);
 
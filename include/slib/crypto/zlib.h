@@ -20,6 +20,8 @@
 namespace slib
 {
 	
+	class ThreadPool;
+	
 	class SLIB_EXPORT GzipParam
 	{
 	public:
@@ -77,6 +79,15 @@ namespace slib
 	
 		Memory compress(const void* data, sl_size size, sl_bool flagFinish);
 	
+		/*
+			sync flush: the output until now is aligned to byte boundary, so it can be decompressed before the stream is finished
+			returns
+				<0: Error
+				=0: Flushed
+				>0: The output is full (call again)
+		*/
+		sl_int32 flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed);
+	
 		void abort();
 	
 	private:
@@ -116,10 +127,17 @@ namespace slib
 			const void* input, sl_uint32 sizeInputAvailable, sl_uint32& sizeInputPassed,
 			void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed);
 
+		// decompresses the whole stream: returns null when the input ends before the end of the stream
 		Memory decompress(const void* data, sl_size size);
 	
+		// decompresses a part of the stream: returns the output of the given input, and the stream continues with the next part
+		Memory decompressPart(const void* data, sl_size size);
+	
 		void abort();
 	
+	private:
+		Memory _decompress(const void* data, sl_size size, sl_bool flagPart);
+		
 	private:
 		sl_uint8 m_stream[128]; // bigger than sizeof(z_stream)
 		sl_bool m_flagStarted;
@@ -159,6 +177,21 @@ namespace slib
 
 		static Memory compressGzip(const void* data, sl_size size, sl_int32 level = 6);
 	
+		/*
+			Parallel compress (pigz style)
+
+			The input is split into the blocks of `sizeBlock` bytes (default: 128KB), and the blocks are deflated
+			on `threadPool` and on the calling thread. Each block is primed with the last 32KB of the former block
+			as the dictionary, and is byte-aligned by a sync flush, so the outputs are concatenated into one deflate
+			stream that is decompressed by any inflater. The check values of the blocks are combined for the trailer.
+			`threadPool` can be null (compressed on the calling thread).
+		*/
+		static Memory compressParallel(const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level = 6, sl_size sizeBlock = 0);
+	
+		static Memory compressRawParallel(const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level = 6, sl_size sizeBlock = 0);
+	
+		static Memory compressGzipParallel(const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level = 6, sl_size sizeBlock = 0);
+	
 		/*
 			Decompress
 		*/
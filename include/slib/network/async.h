@@ -135,6 +135,7 @@ namespace slib
 		sl_bool flagIPv6; // default: false
 		sl_bool flagAutoStart; // default: true
 		sl_bool flagLogError; // default: true
+		sl_bool flagReusePort; // default: false, set SO_REUSEPORT to share the port between several listeners
 		Ref<AsyncIoLoop> ioLoop;
 		
 		Ptr<IAsyncTcpServerListener> listener;
@@ -204,6 +205,9 @@ namespace slib
 	public:
 		virtual void onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& address, void* data, sl_uint32 sizeReceived) = 0;
 		
+		// called with the datagrams received together, default implementation calls `onReceiveFrom()` for each datagram
+		virtual void onReceiveBatch(AsyncUdpSocket* socket, SocketDatagram* datagrams, sl_uint32 count);
+		
 	};
 	
 	
@@ -218,10 +222,15 @@ namespace slib
 		sl_bool flagAutoStart; // default: true
 		sl_bool flagLogError; // default: true
 		sl_uint32 packetSize; // default: 65536
+		// datagrams received or sent by a system call (recvmmsg, sendmmsg), default: 1
+		sl_uint32 batchCount;
+		// receives the coalesced datagrams by UDP GRO (Linux), the datagrams are split before the callbacks. default: false
+		sl_bool flagGro;
 		Ref<AsyncIoLoop> ioLoop;
 		
 		Ptr<IAsyncUdpSocketListener> listener;
 		Function<void(AsyncUdpSocket*, const SocketAddress&, void*, sl_uint32)> onReceiveFrom;
+		Function<void(AsyncUdpSocket*, SocketDatagram*, sl_uint32)> onReceiveBatch;
 		
 	public:
 		AsyncUdpSocketParam();
@@ -264,17 +273,21 @@ namespace slib
 		
 		sl_bool sendTo(const SocketAddress& addressTo, const Memory& mem);
 		
+		// sends `mem` as the datagrams of `segmentSize` bytes (the last one can be shorter), by UDP GSO on Linux
+		sl_bool sendSegments(const SocketAddress& addressTo, const Memory& mem, sl_uint32 segmentSize);
+		
 	protected:
 		Ref<AsyncUdpSocketInstance> _getIoInstance();
 		
-		void _onReceive(const SocketAddress& address, void* data, sl_uint32 sizeReceived);
+		void _onReceive(SocketDatagram* datagrams, sl_uint32 count);
 		
 	protected:
-		static Ref<AsyncUdpSocketInstance> _createInstance(const Ref<Socket>& socket, sl_uint32 packetSize);
+		static Ref<AsyncUdpSocketInstance> _createInstance(const Ref<Socket>& socket, sl_uint32 packetSize, sl_uint32 batchCount);
 		
 	protected:
 		Ptr<IAsyncUdpSocketListener> m_listener;
 		Function<void(AsyncUdpSocket*, const SocketAddress&, void*, sl_uint32)> m_onReceiveFrom;
+		Function<void(AsyncUdpSocket*, SocketDatagram*, sl_uint32)> m_onReceiveBatch;
 		
 		friend class AsyncUdpSocketInstance;
 		
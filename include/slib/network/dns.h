@@ -17,6 +17,9 @@
 #include "async.h"
 
 #include "../core/string.h"
+#include "../core/hash_table.h"
+#include "../core/mutex.h"
+#include "../core/time.h"
 #include "../crypto/aes.h"
 
 /********************************************************************
@@ -391,6 +394,8 @@ namespace slib
 		
 		sl_uint16 id;
 		
+		DnsResponseCode responseCode;
+		
 		struct Question
 		{
 			String name;
@@ -402,6 +407,7 @@ namespace slib
 		{
 			String name;
 			IPAddress address;
+			sl_uint32 TTL;
 		};
 		List<Address> addresses;
 		
@@ -409,6 +415,7 @@ namespace slib
 		{
 			String name;
 			String alias;
+			sl_uint32 TTL;
 		};
 		List<Alias> aliases;
 		
@@ -433,6 +440,9 @@ namespace slib
 		
 		static Memory buildHostAddressAnswerPacket(sl_uint16 id, const String& hostName, const IPv4Address& hostAddress);
 		
+		// answer without the records, such as `NameError` or `ServerFailure`
+		static Memory buildErrorAnswerPacket(sl_uint16 id, const String& hostName, DnsResponseCode code);
+		
 	};
 	
 	
@@ -494,6 +504,159 @@ namespace slib
 		
 	};
 	
+	
+	/*
+		Caching resolver of the host addresses
+
+		The answers are cached by the host name for the TTL of the records (limited to [`minTTL`, `maxTTL`]),
+		and "not found" answers are cached for `negativeTTL`.
+		The concurrent lookups of a host name share one question to the server,
+		and the least recently used entries are evicted when the cache exceeds `maxCacheCount`.
+	*/
+	
+	class SLIB_EXPORT DnsResolverParam
+	{
+	public:
+		SocketAddress serverAddress; // default: 8.8.8.8:53
+		
+		sl_uint32 maxCacheCount; // default: 10000
+		sl_uint32 minTTL; // seconds, default: 0
+		sl_uint32 maxTTL; // seconds, default: 86400
+		sl_uint32 negativeTTL; // seconds, default: 30
+		
+		sl_uint32 timeout; // milliseconds, default: 2000
+		sl_uint32 retryCount; // default: 2
+		
+		Ref<AsyncIoLoop> ioLoop;
+		
+	public:
+		DnsResolverParam();
+		
+		~DnsResolverParam();
+		
+	};
+	
+	class SLIB_EXPORT DnsResolverResult
+	{
+	public:
+		String hostName;
+		// addresses of the host (following the aliases), empty when the host is not found or on error
+		List<IPAddress> addresses;
+		// records of the answer section, with the remaining TTL when the result is cached
+		List<DnsResponseRecord> records;
+		// answer packet referred by `records`
+		Memory message;
+		DnsResponseCode responseCode;
+		// no answer from the server after the retries
+		sl_bool flagTimeout;
+		sl_bool flagCached;
+		
+	public:
+		DnsResolverResult();
+		
+		~DnsResolverResult();
+		
+	};
+	
+	class SLIB_EXPORT DnsResolverCacheEntry : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+		
+	public:
+		DnsResolverCacheEntry();
+		
+		~DnsResolverCacheEntry();
+		
+	public:
+		// lower case
+		String hostName;
+		List<IPAddress> addresses;
+		List<DnsResponseRecord> records;
+		Memory message;
+		DnsResponseCode responseCode;
+		
+	protected:
+		sl_uint64 m_tickExpire;
+		DnsResolverCacheEntry* m_prev;
+		DnsResolverCacheEntry* m_next;
+		
+		friend class DnsResolver;
+	};
+	
+	class SLIB_EXPORT DnsResolver : public Object, public IAsyncUdpSocketListener
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		DnsResolver();
+		
+		~DnsResolver();
+		
+	public:
+		static Ref<DnsResolver> create(const DnsResolverParam& param);
+		
+	public:
+		// the pending lookups are completed with `ServerFailure`
+		void release();
+		
+		SocketAddress getServerAddress();
+		
+		// `callback` is called on the I/O loop, or on the calling thread when the result is cached
+		void resolve(const String& hostName, const Function<void(DnsResolverResult*)>& callback);
+		
+		// returns sl_false when the host name is not cached (or expired)
+		sl_bool getCachedResult(const String& hostName, DnsResolverResult& result);
+		
+		void removeAllCache();
+		
+		sl_size getCacheCount();
+		
+	protected:
+		void onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& address, void* data, sl_uint32 sizeReceive) override;
+		
+	protected:
+		Ref<DnsResolverCacheEntry> _getCache(const String& name, sl_uint64 now);
+		
+		void _putCache(const Ref<DnsResolverCacheEntry>& entry, sl_uint32 TTL);
+		
+		void _addCacheEntry(DnsResolverCacheEntry* entry);
+		
+		void _removeCacheEntry(DnsResolverCacheEntry* entry);
+		
+		sl_uint16 _newQueryId();
+		
+		void _sendQuestion(const String& name, sl_uint16 id);
+		
+		void _onTimeout(String name, sl_uint16 id);
+		
+		void _complete(const String& name, DnsResolverResult& result);
+		
+	protected:
+		DnsResolverParam m_param;
+		Ref<AsyncUdpSocket> m_udp;
+		Ref<AsyncIoLoop> m_ioLoop;
+		
+		Mutex m_lock;
+		HashTable< String, Ref<DnsResolverCacheEntry> > m_cache;
+		// most recently used at front
+		DnsResolverCacheEntry* m_front;
+		DnsResolverCacheEntry* m_back;
+		
+		struct Query
+		{
+			sl_uint16 id;
+			sl_uint32 nRetries;
+			Ref<TimerWheelTask> taskTimeout;
+			List< Function<void(DnsResolverResult*)> > callbacks;
+		};
+		// in-flight questions by the host name
+		HashTable<String, Query> m_queries;
+		HashTable<sl_uint16, String> m_queryNames;
+		
+		TimeCounter m_timeCounter;
+		
+	};
+	
 	class DnsServer;
 	
 	class SLIB_EXPORT DnsResolveHostParam
@@ -553,6 +716,12 @@ namespace slib
 		
 		sl_bool flagAutoStart;
 		
+		// datagrams received or sent by a system call, default: 32
+		sl_uint32 batchCount;
+		
+		// optional, answers the questions (not encrypted) through the caching resolver. The server address of the resolver is used as `defaultForwardAddress`
+		Ref<DnsResolver> resolver;
+		
 		Ref<AsyncIoLoop> ioLoop;
 		
 		Ptr<IDnsServerListener> listener;
@@ -602,6 +771,10 @@ namespace slib
 		
 		Memory _buildHostAddressAnswerPacket(sl_uint16 id, const String& hostName, const IPv4Address& hostAddress, sl_bool flagEncrypt);
 		
+		Memory _buildErrorAnswerPacket(sl_uint16 id, const String& hostName, DnsResponseCode code, sl_bool flagEncrypt);
+		
+		void _onResolve(SocketAddress clientAddress, sl_uint16 id, String hostName, sl_bool flagEncrypted, DnsResolverResult* result);
+		
 	protected:
 		void onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& address, void* data, sl_uint32 sizeReceive) override;
 		
@@ -623,6 +796,7 @@ namespace slib
 		
 		SocketAddress m_defaultForwardAddress;
 		sl_bool m_flagEncryptDefaultForward;
+		Ref<DnsResolver> m_resolver;
 		
 		sl_uint16 m_lastForwardId;
 		
@@ -28,6 +28,7 @@
 
 #include "http_common.h"
 #include "http_service.h"
+#include "http_client.h"
 
 #endif
 
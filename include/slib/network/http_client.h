@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_HTTP_CLIENT
+#define CHECKHEADER_SLIB_NETWORK_HTTP_CLIENT
+
+#include "definition.h"
+
+#include "http_common.h"
+#include "http_io.h"
+
+#include "../core/thread_pool.h"
+#include "../core/mutex.h"
+
+/*
+	Event-driven HTTP/1.1 client
+
+	The requests are processed on one AsyncIoLoop, without blocking any thread (except the name resolution, which runs on a thread pool).
+	The connections are pooled per host (`host:port`): a completed keep-alive connection is reused by the next request to the same host,
+	and the requests exceeding `maxConnectionsPerHost` wait in the queue of the host until a connection is freed.
+	The callbacks of the requests are called on the loop thread.
+*/
+
+namespace slib
+{
+
+	class HttpClient;
+	class _HttpClientHost;
+	class _HttpClientConnection;
+
+	class SLIB_EXPORT HttpClientContext : public Object, public HttpRequest, public HttpResponse
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		HttpClientContext();
+
+		~HttpClientContext();
+
+	public:
+		String getUrl() const;
+
+		String getHostName() const;
+
+		sl_uint16 getPort() const;
+
+		const Memory& getRequestBody() const;
+
+		Memory getResponseContent() const;
+
+		// bytes delivered to `onReceiveContent` (decompressed size when the content is encoded)
+		sl_uint64 getReceivedContentSize() const;
+
+		sl_bool isCompleted() const;
+
+		sl_bool isError() const;
+
+		String getErrorMessage() const;
+
+		// no more callbacks are called after cancelling
+		void cancel();
+
+		sl_bool isCancelled() const;
+
+	protected:
+		void _onResponse();
+
+		void _onReceiveContent(const void* data, sl_size size, const Memory& mem);
+
+		void _onComplete(sl_bool flagError, const String& errorMessage);
+
+	protected:
+		String m_url;
+		String m_host;
+		sl_uint16 m_port;
+		Memory m_requestBody;
+
+		sl_bool m_flagStoreResponseContent;
+		MemoryQueue m_bufResponseContent;
+		sl_uint64 m_sizeContentReceived;
+
+		Function<void(HttpClientContext*)> m_onResponse;
+		Function<void(HttpClientContext*, const void*, sl_size)> m_onReceiveContent;
+		Function<void(HttpClientContext*)> m_onComplete;
+
+		sl_bool m_flagCompleted;
+		sl_bool m_flagError;
+		sl_bool m_flagCancelled;
+		// resent once when a reused connection was closed by the server before responding
+		sl_bool m_flagRetried;
+		AtomicString m_errorMessage;
+
+		AtomicWeakRef<_HttpClientConnection> m_connection;
+
+		friend class HttpClient;
+		friend class _HttpClientConnection;
+
+	};
+
+	class SLIB_EXPORT HttpClientRequestParam
+	{
+	public:
+		HttpMethod method; // default: GET
+		// http://host[:port]/path[?query]
+		String url;
+		Map<String, String> requestHeaders;
+		Memory requestBody;
+
+		sl_bool flagStoreResponseContent; // default: true
+
+		Function<void(HttpClientContext*)> onResponse;
+		Function<void(HttpClientContext*, const void*, sl_size)> onReceiveContent;
+		// called once, after the content is received or on the error
+		Function<void(HttpClientContext*)> onComplete;
+
+	public:
+		HttpClientRequestParam();
+
+		HttpClientRequestParam(const HttpClientRequestParam& other);
+
+		~HttpClientRequestParam();
+
+	};
+
+	class SLIB_EXPORT HttpClientParam
+	{
+	public:
+		Ref<AsyncIoLoop> ioLoop; // default: AsyncIoLoop::getDefault()
+
+		// connections (active, connecting and idle) per host
+		sl_uint32 maxConnectionsPerHost; // default: 16
+		// the connection is closed after this number of requests (0: unlimited)
+		sl_uint32 maxRequestsPerConnection; // default: 0
+
+		sl_uint32 connectTimeout; // milliseconds, default: 10000
+		// fails the request when nothing is received for this duration while waiting for the response
+		sl_uint32 readTimeout; // milliseconds, default: 30000
+		// closes the idle pooled connection after this duration
+		sl_uint32 keepAliveTimeout; // milliseconds, default: 30000
+
+		sl_uint32 bufferSize; // default: 65536
+
+		// sends `Accept-Encoding: gzip, deflate` (when not specified) and decodes the encoded content
+		sl_bool flagDecompress; // default: true
+
+		sl_bool flagLogError; // default: true
+
+	public:
+		HttpClientParam();
+
+		HttpClientParam(const HttpClientParam& other);
+
+		~HttpClientParam();
+
+	};
+
+	class SLIB_EXPORT HttpClient : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		HttpClient();
+
+		~HttpClient();
+
+	public:
+		static Ref<HttpClient> create(const HttpClientParam& param);
+
+		static Ref<HttpClient> create();
+
+		// shared by `UrlRequest`
+		static Ref<HttpClient> getDefault();
+
+	public:
+		void release();
+
+		sl_bool isRunning();
+
+		Ref<AsyncIoLoop> getAsyncIoLoop();
+
+		const HttpClientParam& getParam();
+
+		// returns null when the url is not valid (only `http` scheme is supported)
+		Ref<HttpClientContext> send(const HttpClientRequestParam& param);
+
+		Ref<HttpClientContext> send(HttpMethod method, const String& url, const Function<void(HttpClientContext*)>& onComplete);
+
+		sl_uint32 getConnectionsCount();
+
+		sl_uint32 getIdleConnectionsCount();
+
+	protected:
+		void _processContext(const Ref<HttpClientContext>& context);
+
+		Ref<_HttpClientHost> _getHost(const String& name, sl_uint16 port);
+
+		Ref<_HttpClientConnection> _createConnection(_HttpClientHost* host);
+
+		void _startConnection(const Ref<_HttpClientConnection>& connection);
+
+		void _onConnectionFree(_HttpClientConnection* connection);
+
+		void _onConnectionClosed(_HttpClientConnection* connection);
+
+	protected:
+		HttpClientParam m_param;
+		Ref<AsyncIoLoop> m_ioLoop;
+		sl_bool m_flagRunning;
+
+		Mutex m_lock;
+		Map< String, Ref<_HttpClientHost> > m_hosts;
+		sl_uint32 m_nConnections;
+		sl_uint32 m_nIdleConnections;
+
+		// name resolution (blocking)
+		AtomicRef<ThreadPool> m_threadPoolResolve;
+
+		friend class _HttpClientConnection;
+
+	};
+
+}
+
+#endif
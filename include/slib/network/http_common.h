@@ -39,6 +39,8 @@
 #include "../core/string.h"
 #include "../core/content_type.h"
 #include "../core/map.h"
+#include "../core/memory.h"
+#include "../core/time.h"
 
 namespace slib
 {
@@ -68,6 +70,7 @@ namespace slib
 		NotModified = 304,
 		UseProxy = 305,
 		TemporaryRedirect = 307,
+		PermanentRedirect = 308,
 		
 		// Client Error
 		BadRequest = 400,
@@ -151,6 +154,17 @@ namespace slib
 		static const String& Origin;
 		static const String& AccessControlAllowOrigin;
 		
+		static const String& ETag;
+		static const String& IfNoneMatch;
+		static const String& Vary;
+		static const String& LastModified;
+		static const String& IfModifiedSince;
+		
+		static const String& Connection;
+		static const String& KeepAlive;
+		
+		static const String& Location;
+		
 	public:
 		
 		/*
@@ -161,6 +175,115 @@ namespace slib
 		 */
 		static sl_reg parseHeaders(Map<String, String>& outMap, const void* headers, sl_size size);
 		
+		// IMF-fixdate in GMT (Sun, 06 Nov 1994 08:49:37 GMT)
+		static String formatDate(const Time& time);
+		
+		// accepts IMF-fixdate, RFC 850 and asctime formats (RFC 7231)
+		static sl_bool parseDate(const String& str, Time* _out);
+		
+	};
+	
+	
+	/*
+		Single-pass tokenizer of the HTTP header section
+	
+		Line ends are located by SSE2/AVX2 compares (16/32 bytes per step, scalar fallback on other CPUs).
+		The request line and the header fields are kept as offsets into the scanned buffer, and the strings are created only when they are requested.
+	*/
+	class SLIB_EXPORT HttpHeaderScanner
+	{
+	public:
+		struct Token
+		{
+			sl_uint32 offset;
+			sl_uint32 length;
+		};
+		
+		struct Field
+		{
+			Token name;
+			Token value;
+			// value contains '%' (needs URI decoding)
+			sl_bool flagEncoded;
+		};
+		
+	public:
+		HttpHeaderScanner();
+		
+		HttpHeaderScanner(const HttpHeaderScanner& other);
+		
+		~HttpHeaderScanner();
+		
+	public:
+		HttpHeaderScanner& operator=(const HttpHeaderScanner& other);
+		
+	public:
+		// returns the size of the header section including [CR][LF][CR][LF], or -1 when the terminator is not found
+		static sl_reg findHeaderEnd(const void* data, sl_size size);
+		
+		/*
+		 Returns
+		 <0: error
+		 =0: incomplete packet
+		 >0: size of the headers (ending with [CR][LF][CR][LF])
+		 
+		 `data` must be alive until the scanner is cleared
+		 */
+		sl_reg scanHeaders(const void* data, sl_size size);
+		
+		// same as `scanHeaders()`, but starts with the request line
+		sl_reg scanRequest(const void* data, sl_size size);
+		
+		void clear();
+		
+		const sl_char8* getData() const;
+		
+		const Token& getMethod() const;
+		
+		const Token& getPath() const;
+		
+		// length is zero when the URI doesn't have a query
+		const Token& getQuery() const;
+		
+		const Token& getVersion() const;
+		
+		String getString(const Token& token) const;
+		
+		sl_size getFieldCount() const;
+		
+		const Field& getField(sl_size index) const;
+		
+		String getFieldName(sl_size index) const;
+		
+		String getFieldValue(sl_size index) const;
+		
+		// case-insensitive, returns -1 when not found
+		sl_reg indexOfField(const String& name, sl_size start = 0) const;
+		
+		// searches backward from `start` (-1: from the last field)
+		sl_reg lastIndexOfField(const String& name, sl_reg start = -1) const;
+		
+		void putFields(Map<String, String>& outMap) const;
+		
+	protected:
+		sl_reg _scanFields(sl_size pos, sl_size size);
+		
+		sl_bool _equalsFieldName(const Field& field, const String& name) const;
+		
+		sl_bool _addField(const Field& field);
+		
+	protected:
+		const sl_char8* m_data;
+		Token m_method;
+		Token m_path;
+		Token m_query;
+		Token m_version;
+		
+		Field m_fieldsInline[32];
+		Field* m_fields;
+		sl_size m_nFields;
+		sl_size m_nFieldsCapacity;
+		
 	};
 	
 	
@@ -297,6 +420,16 @@ namespace slib
 		 */
 		sl_reg parseRequestPacket(const void* packet, sl_size size);
 		
+		/*
+			The header fields are kept as views over `packet` and materialized into the map by the first modification or `getRequestHeaders()`.
+			The duplicated field resolves to the last one in both states.
+			The const getters may materialize the map without locking: an `HttpRequest` must be accessed by one thread at a time.
+		*/
+		sl_reg parseRequestPacket(const Memory& packet);
+		
+	protected:
+		void _materializeRequestHeaders() const;
+		
 	protected:
 		HttpMethod m_method;
 		String m_methodText;
@@ -305,7 +438,10 @@ namespace slib
 		String m_query;
 		String m_requestVersion;
 		
-		Map<String, String> m_requestHeaders;
+		mutable Map<String, String> m_requestHeaders;
+		mutable HttpHeaderScanner m_requestHeaderScanner;
+		mutable Memory m_requestHeaderPacket;
+		mutable sl_bool m_flagRequestHeadersPending;
 		Map<String, String> m_parameters;
 		Map<String, String> m_queryParameters;
 		Map<String, String> m_postParameters;
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_HTTP_FILE_CACHE
+#define CHECKHEADER_SLIB_NETWORK_HTTP_FILE_CACHE
+
+#include "definition.h"
+
+#include "../core/object.h"
+#include "../core/string.h"
+#include "../core/memory.h"
+#include "../core/time.h"
+#include "../core/mutex.h"
+#include "../core/hash_table.h"
+
+/*
+	Cache of the static file responses, bounded by the total bytes (LRU)
+
+	Each entry keeps the content, a gzip variant (when it is smaller) and a strong ETag per variant.
+	The modified time of the file is checked again only after `revalidateInterval`, so the cache hits and the conditional requests don't touch the disk.
+	The files larger than `maxFileSize` are remembered with their sizes and modified times in the same way, so they are not checked on every request.
+*/
+
+namespace slib
+{
+
+	class SLIB_EXPORT HttpFileCacheParam
+	{
+	public:
+		sl_uint64 maxTotalSize; // default: 64MB
+		sl_uint64 maxFileSize; // default: 1MB
+		sl_uint32 revalidateInterval; // milliseconds, default: 1000
+
+		sl_bool flagCompress; // default: true
+		sl_uint32 minCompressSize; // default: 256
+		sl_int32 compressLevel; // default: 6
+
+	public:
+		HttpFileCacheParam();
+
+		~HttpFileCacheParam();
+
+	};
+
+	class SLIB_EXPORT HttpFileCacheEntry : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		HttpFileCacheEntry();
+
+		~HttpFileCacheEntry();
+
+	public:
+		String path;
+		Time timeModified;
+		Memory content;
+		String etag;
+		// empty when compression doesn't reduce the size
+		Memory contentGzip;
+		String etagGzip;
+
+	protected:
+		sl_uint64 m_tickValidated;
+		HttpFileCacheEntry* m_prev;
+		HttpFileCacheEntry* m_next;
+
+		friend class HttpFileCache;
+	};
+
+	class SLIB_EXPORT HttpFileCache : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		HttpFileCache();
+
+		~HttpFileCache();
+
+	public:
+		static Ref<HttpFileCache> create(const HttpFileCacheParam& param);
+
+	public:
+		// returns null when the file doesn't exist or is too big to be cached.
+		// For the too big file, `pSizeLarge` and `pTimeModifiedLarge` receive its attributes (`*pSizeLarge` is not changed otherwise)
+		Ref<HttpFileCacheEntry> get(const String& path, sl_uint64* pSizeLarge = sl_null, Time* pTimeModifiedLarge = sl_null);
+
+		void remove(const String& path);
+
+		void removeAll();
+
+		sl_size getCount();
+
+		sl_uint64 getTotalSize();
+
+	protected:
+		Ref<HttpFileCacheEntry> _load(const String& path, sl_uint64 now, sl_uint64* pSizeLarge, Time* pTimeModifiedLarge);
+
+		void _add(HttpFileCacheEntry* entry);
+
+		void _remove(HttpFileCacheEntry* entry);
+
+		void _moveToFront(HttpFileCacheEntry* entry);
+
+		static sl_uint64 _getEntrySize(HttpFileCacheEntry* entry);
+
+	protected:
+		HttpFileCacheParam m_param;
+
+		Mutex m_lock;
+		HashTable< String, Ref<HttpFileCacheEntry> > m_table;
+		// most recently used at front
+		HttpFileCacheEntry* m_front;
+		HttpFileCacheEntry* m_back;
+		sl_uint64 m_sizeTotal;
+
+		struct LargeFile
+		{
+			sl_uint64 size;
+			Time timeModified;
+			sl_uint64 tickValidated;
+		};
+		HashTable<String, LargeFile> m_tableLarge;
+
+		TimeCounter m_timeCounter;
+
+	};
+
+}
+
+#endif
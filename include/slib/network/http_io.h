@@ -43,6 +43,13 @@ namespace slib
 		
 		void copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 		
+		// zero-copy body (sendfile) when the connection supports it
+		void sendFile(const String& path);
+		
+		void sendFile(const String& path, sl_uint64 offset, sl_uint64 size);
+		
+		void sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+		
 		sl_uint64 getOutputLength() const;
 		
 	protected:
@@ -111,6 +118,12 @@ namespace slib
 	public:
 		sl_bool isDecompressing();
 		
+		/*
+			Decodes the content read by the caller itself, for the readers created with null `io`.
+			The listener is notified (with the data following the content) before the last part is returned.
+		*/
+		Memory decode(void* data, sl_uint32 size, Referable* refData = sl_null);
+		
 	protected:
 		sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* ref) override;
 		
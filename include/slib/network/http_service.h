@@ -15,15 +15,19 @@
 
 #include "http_common.h"
 #include "http_io.h"
+#include "http_file_cache.h"
 #include "socket_address.h"
 
 #include "../core/thread_pool.h"
+#include "../core/queue.h"
+#include "../core/concurrent_hash_map.h"
 
 namespace slib
 {
 
 	class HttpService;
 	class HttpServiceConnection;
+	class HttpServiceParam;
 	
 	class SLIB_EXPORT HttpServiceContext : public Object, public HttpRequest, public HttpResponse, public HttpOutputBuffer
 	{
@@ -66,6 +70,13 @@ namespace slib
 		
 		void completeResponse();
 		
+		// parameters captured from the path by the router (`:name`, `*name` segments)
+		const Map<String, String>& getPathParameters() const;
+		
+		String getPathParameter(const String& name) const;
+		
+		void setPathParameter(const String& name, const String& value);
+		
 	public:
 		SLIB_BOOLEAN_PROPERTY(ClosingConnection);
 		SLIB_BOOLEAN_PROPERTY(ProcessingByThread);
@@ -77,6 +88,15 @@ namespace slib
 		MemoryQueue m_requestBodyBuffer;
 		AtomicMemory m_requestBody;
 		sl_bool m_flagAsynchronousResponse;
+		Map<String, String> m_pathParameters;
+		
+		// header of the completed response, held until the former responses are written
+		Memory m_responsePacket;
+		sl_bool m_flagResponseCompleted;
+		
+	protected:
+		// response filter: compresses the buffered body by gzip when the client accepts it
+		void _compressResponse(const HttpServiceParam& param);
 		
 	private:
 		WeakRef<HttpServiceConnection> m_connection;
@@ -118,9 +138,10 @@ namespace slib
 		
 		void sendConnectResponse_Successed();
 		
-		void sendConnectResponse_Failed();
+		// completes the queued `context` by the failure response, or queues a new response when `context` is null
+		void sendConnectResponse_Failed(HttpServiceContext* context = sl_null);
 		
-		void sendProxyResponse_Failed();
+		void sendProxyResponse_Failed(HttpServiceContext* context = sl_null);
 		
 	public:
 		SLIB_PROPERTY(SocketAddress, LocalAddress)
@@ -139,15 +160,40 @@ namespace slib
 		Memory m_bufRead;
 		sl_bool m_flagReading;
 		
+		// dispatched contexts in the order of the requests
+		Mutex m_lockResponses;
+		LinkedQueue< Ref<HttpServiceContext> > m_queueContexts;
+		// input remained while the pipeline is full
+		Memory m_dataPending;
+		sl_uint32 m_nRequests;
+		sl_bool m_flagAcceptingRequests;
+		sl_bool m_flagClosingAfterOutput;
+		sl_bool m_flagOutputWriting;
+		
+		sl_uint32 m_tickLastActive;
+		AtomicRef<TimerWheelTask> m_taskIdle;
+		
 	protected:
 		void _read();
 		
 		void _processInput(const void* data, sl_uint32 size);
 		
+		void _resumeInput();
+		
+		sl_bool _dispatchContext(const Ref<HttpServiceContext>& context);
+		
 		void _processContext(const Ref<HttpServiceContext>& context);
 		
 		void _completeResponse(HttpServiceContext* context);
 		
+		void _writeResponses();
+		
+		void _sendErrorResponse(HttpServiceContext* context, const String& packet, sl_bool flagClose);
+		
+		void _setIdleTimeout(sl_uint32 timeout);
+		
+		void _onIdleTimeout();
+		
 	protected:
 		void onReadStream(AsyncStreamResult* result);
 		
@@ -201,12 +247,40 @@ namespace slib
 		sl_uint32 maxThreadsCount;
 		sl_bool flagProcessByThreads;
 		
+		sl_uint32 ioLoopsCount; // default: 1
+		// RoundRobin or LeastLoaded, used when the accepted connections are distributed by one listener
+		AsyncIoLoopSelection ioLoopSelection; // default: RoundRobin
+		// open one SO_REUSEPORT listener per loop (Unix), instead of distributing the accepted connections
+		sl_bool flagListenPerIoLoop; // default: false
+		// binds the loop `i` to the logical processor `i % CPU::getProcessorsCount()` (Linux, Windows)
+		sl_bool flagPinIoLoopsToCpus; // default: false
+		
 		sl_bool flagUseAsset;
 		String prefixAsset;
 		
+		// caches the responses of `processFile()` in memory, with gzip variants and ETag validation
+		sl_bool flagUseFileCache; // default: false
+		HttpFileCacheParam fileCacheParam;
+		
 		sl_uint64 maxRequestHeadersSize;
 		sl_uint64 maxRequestBodySize;
 		
+		// closes the connection when nothing is received and no response is pending for this duration (0: never)
+		sl_uint32 keepAliveTimeout; // milliseconds, default: 60000
+		// the last response is sent with `Connection: close` (0: unlimited)
+		sl_uint32 maxRequestsPerConnection; // default: 0
+		// requests parsed from the buffered input while the former responses are not completed; the later responses are held to keep the order
+		sl_uint32 maxPipelinedRequests; // default: 16
+		
+		/*
+			compresses the responses by gzip when the request's `Accept-Encoding` allows it.
+			the body (including stream and file bodies) is compressed on the thread pool while it is written, and framed in chunked transfer encoding.
+			skipped for HTTP/1.0 requests, the responses having `Content-Encoding` or `Content-Range` header, and the types other than text, JSON, JavaScript and XML.
+		*/
+		sl_bool flagCompressResponse; // default: false
+		sl_uint32 minCompressResponseSize; // default: 1024
+		sl_int32 compressResponseLevel; // default: 6
+		
 		sl_bool flagAllowCrossOrigin;
 		sl_bool flagAlwaysRespondAcceptRangesHeader;
 		
@@ -243,6 +317,8 @@ namespace slib
 		
 		Ref<AsyncIoLoop> getAsyncIoLoop();
 		
+		Ref<AsyncIoLoopGroup> getAsyncIoLoopGroup();
+		
 		Ref<ThreadPool> getThreadPool();
 		
 		const HttpServiceParam& getParam();
@@ -260,6 +336,10 @@ namespace slib
 		
 		sl_bool processRangeRequest(const Ref<HttpServiceContext>& context, sl_uint64 totalLength, const String& range, sl_uint64& outStart, sl_uint64& outLength);
 		
+		sl_bool processCachedFile(const Ref<HttpServiceContext>& context, const Ref<HttpFileCacheEntry>& entry);
+		
+		Ref<HttpFileCache> getFileCache();
+		
 		virtual Ref<HttpServiceConnection> addConnection(const Ref<AsyncStream>& stream, const SocketAddress& remoteAddress, const SocketAddress& localAddress);
 		
 		virtual void closeConnection(HttpServiceConnection* connection);
@@ -292,10 +372,12 @@ namespace slib
 		
 	protected:
 		AtomicRef<AsyncIoLoop> m_ioLoop;
+		AtomicRef<AsyncIoLoopGroup> m_ioLoopGroup;
 		AtomicRef<ThreadPool> m_threadPool;
+		Ref<HttpFileCache> m_fileCache;
 		sl_bool m_flagRunning;
 		
-		HashMap< HttpServiceConnection*, Ref<HttpServiceConnection> > m_connections;
+		ConcurrentHashMap< HttpServiceConnection*, Ref<HttpServiceConnection> > m_connections;
 		
 		CList< Ptr<IHttpServiceProcessor> > m_processors;
 		AtomicList< Ptr<IHttpServiceProcessor> > m_processorsCached;
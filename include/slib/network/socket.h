@@ -20,6 +20,12 @@
 typedef int sl_socket;
 #define SLIB_SOCKET_INVALID_HANDLE (-1)
 
+// maximum count of the buffers sent by `Socket::sendVector()` at once. The vectors are built on the stack of the sending thread, so the count is kept far below IOV_MAX (1024)
+#define SLIB_SOCKET_SEND_VECTOR_MAX_COUNT 64
+
+// maximum count of the datagrams received or sent by `Socket::receiveFromBatch()` and `Socket::sendToBatch()` at once
+#define SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT 128
+
 namespace slib
 {
 
@@ -117,6 +123,22 @@ namespace slib
 		
 	};
 	
+	class MemoryData;
+	
+	class SLIB_EXPORT SocketDatagram
+	{
+	public:
+		SocketAddress address;
+		void* data;
+		// receiving: size of `data` before the call, and size of the received data after the call
+		sl_uint32 size;
+		// UDP GSO/GRO: size of the datagrams coalesced in `data` (0: `data` is one datagram)
+		sl_uint32 segmentSize;
+		
+	public:
+		SocketDatagram();
+		
+	};
 	
 	class SLIB_EXPORT Socket : public Referable
 	{
@@ -187,12 +209,21 @@ namespace slib
 		
 		sl_int32 send(const void* buf, sl_uint32 size);
 		
+		// sends the buffers in one system call (writev, WSASend), the count is limited to `SLIB_SOCKET_SEND_VECTOR_MAX_COUNT`
+		sl_int32 sendVector(const MemoryData* buffers, sl_uint32 count);
+		
 		sl_int32 receive(void* buf, sl_uint32 size);
 		
 		sl_int32 sendTo(const SocketAddress& address, const void* buf, sl_uint32 size);
 		
 		sl_int32 receiveFrom(SocketAddress& address, void* buf, sl_uint32 size);
 		
+		// returns the count of the received datagrams (recvmmsg), 0 when the socket would block
+		sl_int32 receiveFromBatch(SocketDatagram* datagrams, sl_uint32 count);
+		
+		// returns the count of the sent datagrams (sendmmsg), 0 when the socket would block
+		sl_int32 sendToBatch(const SocketDatagram* datagrams, sl_uint32 count);
+		
 		sl_int32 sendPacket(const void* buf, sl_uint32 size, const L2PacketInfo& info);
 		
 		sl_int32 receivePacket(const void* buf, sl_uint32 size, L2PacketInfo& info);
@@ -239,6 +270,9 @@ namespace slib
 		
 		sl_bool getOption_TcpNoDelay() const;
 		
+		// receives the coalesced datagrams (Linux only, see `SocketDatagram::segmentSize`)
+		sl_bool setOption_UdpGro(sl_bool flagEnable);
+		
 		sl_bool setOption_IpTTL(sl_uint32 ttl); // max - 255
 		
 		sl_uint32 getOption_IpTTL() const;
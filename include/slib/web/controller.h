@@ -23,7 +23,20 @@ namespace slib
 {
 
 	typedef Function<Variant(SWEB_HANDLER_PARAMS_LIST)> WebHandler;
-
+	
+	class _WebRouteNode;
+	
+	/*
+		The handlers are compiled into a segment tree per method on `registerHandler()`.
+	 
+		Segments of the path:
+			name   : matches the same segment
+			:name  : matches any non-empty segment, captured as a path parameter
+			*name  : matches the rest of the path (only as the last segment), captured as a path parameter
+	 
+		Exact segments take priority over `:param`, and `:param` over `*wildcard`.
+		The lookup walks the request path in place without allocation; only the captured values are copied to the context.
+	*/
 	class WebController : public Object, public IHttpServiceProcessor
 	{
 		SLIB_DECLARE_OBJECT
@@ -31,20 +44,20 @@ namespace slib
 	protected:
 		WebController();
 		
+		~WebController();
+		
 	public:
 		static Ref<WebController> create();
 		
 	public:
+		// Handlers should be registered before the service starts; the routes are read without locking
 		void registerHandler(HttpMethod method, const String& path, const WebHandler& handler);
 		
 	protected:
 		sl_bool onHttpRequest(const Ref<HttpServiceContext>& context) override;
 		
 	protected:
-		static String _getHandlerSignature(HttpMethod method, const String& path);
-		
-	protected:
-		TreeMap<String, WebHandler> m_handlers;
+		Ref<_WebRouteNode> m_routes[(int)(HttpMethod::TRACE) + 1];
 		
 		friend class WebModule;
 		
@@ -90,6 +103,7 @@ namespace SWEB_MODULE_##NAME { \
 	slib::Variant NAME(SWEB_HANDLER_PARAMS_LIST)
 
 #define SWEB_STRING_PARAM(NAME) slib::String NAME = context->getParameter(#NAME);
+#define SWEB_PATH_PARAM(NAME) slib::String NAME = context->getPathParameter(#NAME);
 #define SWEB_INT_PARAM(NAME, ...) sl_int32 NAME = context->getParameter(#NAME).parseInt32(10, ##__VA_ARGS__);
 #define SWEB_INT64_PARAM(NAME, ...) sl_int64 NAME = context->getParameter(#NAME).parseInt64(10, ##__VA_ARGS__);
 #define SWEB_FLOAT_PARAM(NAME, ...) float NAME = context->getParameter(#NAME).parseFloat(##__VA_ARGS__);
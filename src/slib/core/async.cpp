@@ -10,8 +10,13 @@
 
 #include "slib/core/async.h"
 
+#include "slib/core/cpu.h"
+#include "slib/core/memory_pool.h"
 #include "slib/core/safe_static.h"
 
+// maximum size of one sendfile request issued by AsyncOutput
+#define ASYNC_OUTPUT_SEND_FILE_SIZE 0x40000000
+
 namespace slib
 {
 
@@ -26,6 +31,7 @@ namespace slib
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
 		m_handle = sl_null;
+		m_nInstances = 0;
 	}
 
 	AsyncIoLoop::~AsyncIoLoop()
@@ -57,6 +63,11 @@ namespace slib
 			Ref<AsyncIoLoop> ret = new AsyncIoLoop;
 			if (ret.isNotNull()) {
 				ret->m_handle = handle;
+				ret->m_timeTasks = TimerWheel::create();
+				if (ret->m_timeTasks.isNull()) {
+					_native_closeHandle(handle);
+					return sl_null;
+				}
 				ret->m_thread = Thread::create(SLIB_FUNCTION_CLASS(AsyncIoLoop, _native_runLoop, ret.get()));
 				if (ret->m_thread.isNotNull()) {
 					ret->m_flagInit = sl_true;
@@ -93,6 +104,8 @@ namespace slib
 		m_queueInstancesClosing.removeAll();
 		m_queueInstancesClosed.removeAll();
 		
+		m_timeTasks->release();
+		
 	}
 
 	void AsyncIoLoop::start()
@@ -129,7 +142,22 @@ namespace slib
 
 	sl_bool AsyncIoLoop::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
 	{
-		return addTask(callback);
+		if (delay_ms == 0) {
+			return addTask(callback);
+		}
+		return setTimeout(callback, delay_ms).isNotNull();
+	}
+
+	Ref<TimerWheelTask> AsyncIoLoop::setTimeout(const Function<void()>& callback, sl_uint64 delay_ms)
+	{
+		if (!m_flagInit) {
+			return sl_null;
+		}
+		Ref<TimerWheelTask> ret = m_timeTasks->add(callback, delay_ms);
+		if (ret.isNotNull()) {
+			wake();
+		}
+		return ret;
 	}
 
 	void AsyncIoLoop::wake()
@@ -146,7 +174,10 @@ namespace slib
 		if (m_handle) {
 			if (instance && instance->isOpened()) {
 				ObjectLocker lock(this);
-				return _native_attachInstance(instance, mode);
+				if (_native_attachInstance(instance, mode)) {
+					Base::interlockedIncrement32(&m_nInstances);
+					return sl_true;
+				}
 			}
 		}
 		return sl_false;
@@ -182,7 +213,7 @@ namespace slib
 			LinkedQueue< Function<void()> > tasks;
 			tasks.merge(&m_queueTasks);
 			Function<void()> task;
-			while (m_queueTasks.pop(&task)) {
+			while (tasks.pop_NoLock(&task)) {
 				task();
 			}
 		}
@@ -200,18 +231,175 @@ namespace slib
 		}
 	}
 
+	sl_uint32 AsyncIoLoop::getInstancesCount()
+	{
+		sl_int32 n = m_nInstances;
+		return n > 0 ? (sl_uint32)n : 0;
+	}
+
+	sl_bool AsyncIoLoop::setCpuAffinity(sl_int32 cpuIndex)
+	{
+		if (m_thread.isNotNull()) {
+			return m_thread->setCpuAffinity(cpuIndex);
+		}
+		return sl_false;
+	}
+
+	sl_int32 AsyncIoLoop::_getTimeout()
+	{
+		if (m_queueTasks.isNotEmpty()) {
+			return 0;
+		}
+		return m_timeTasks->process();
+	}
+
 	void AsyncIoLoop::_stepEnd()
 	{
 		Ref<AsyncIoInstance> instance;
 		while (m_queueInstancesClosing.pop(&instance)) {
 			if (instance.isNotNull() && instance->isOpened()) {
 				_native_detachInstance(instance.get());
+				Base::interlockedDecrement32(&m_nInstances);
 				instance->close();
 				m_queueInstancesClosed.push(instance);
 			}
 		}
 	}
 
+/*************************************
+			AsyncIoLoopGroup
+*************************************/
+
+	SLIB_DEFINE_OBJECT(AsyncIoLoopGroup, Object)
+
+	AsyncIoLoopGroup::AsyncIoLoopGroup()
+	{
+		m_loops = sl_null;
+		m_nLoops = 0;
+		m_indexNext = 0;
+		m_flagRunning = sl_false;
+	}
+
+	AsyncIoLoopGroup::~AsyncIoLoopGroup()
+	{
+		release();
+		if (m_loops) {
+			NewHelper< Ref<AsyncIoLoop> >::free(m_loops, m_nLoops);
+		}
+	}
+
+	Ref<AsyncIoLoopGroup> AsyncIoLoopGroup::create(sl_uint32 nLoops, sl_bool flagAutoStart)
+	{
+		if (nLoops == 0) {
+			nLoops = 1;
+		}
+		Ref<AsyncIoLoop>* loops = NewHelper< Ref<AsyncIoLoop> >::create(nLoops);
+		if (!loops) {
+			return sl_null;
+		}
+		Ref<AsyncIoLoopGroup> ret = new AsyncIoLoopGroup;
+		if (ret.isNotNull()) {
+			ret->m_loops = loops;
+			ret->m_nLoops = nLoops;
+			for (sl_uint32 i = 0; i < nLoops; i++) {
+				loops[i] = AsyncIoLoop::create(sl_false);
+				if (loops[i].isNull()) {
+					return sl_null;
+				}
+			}
+			if (flagAutoStart) {
+				ret->start();
+			}
+			return ret;
+		}
+		NewHelper< Ref<AsyncIoLoop> >::free(loops, nLoops);
+		return sl_null;
+	}
+
+	void AsyncIoLoopGroup::release()
+	{
+		ObjectLocker lock(this);
+		for (sl_uint32 i = 0; i < m_nLoops; i++) {
+			if (m_loops[i].isNotNull()) {
+				m_loops[i]->release();
+			}
+		}
+		m_flagRunning = sl_false;
+	}
+
+	void AsyncIoLoopGroup::start()
+	{
+		ObjectLocker lock(this);
+		if (m_flagRunning) {
+			return;
+		}
+		for (sl_uint32 i = 0; i < m_nLoops; i++) {
+			m_loops[i]->start();
+		}
+		m_flagRunning = sl_true;
+	}
+
+	sl_bool AsyncIoLoopGroup::isRunning()
+	{
+		return m_flagRunning;
+	}
+
+	sl_uint32 AsyncIoLoopGroup::getLoopsCount()
+	{
+		return m_nLoops;
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getLoop(sl_uint32 index)
+	{
+		if (index < m_nLoops) {
+			return m_loops[index];
+		}
+		return sl_null;
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getNextLoop()
+	{
+		if (m_nLoops == 1) {
+			return m_loops[0];
+		}
+		sl_uint32 index = ((sl_uint32)(Base::interlockedIncrement32(&m_indexNext))) % m_nLoops;
+		return m_loops[index];
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getLeastLoadedLoop()
+	{
+		sl_uint32 indexMin = 0;
+		sl_uint32 nMin = m_loops[0]->getInstancesCount();
+		for (sl_uint32 i = 1; i < m_nLoops; i++) {
+			sl_uint32 n = m_loops[i]->getInstancesCount();
+			if (n < nMin) {
+				nMin = n;
+				indexMin = i;
+			}
+		}
+		return m_loops[indexMin];
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::selectLoop(AsyncIoLoopSelection selection)
+	{
+		if (selection == AsyncIoLoopSelection::LeastLoaded) {
+			return getLeastLoadedLoop();
+		}
+		return getNextLoop();
+	}
+
+	sl_bool AsyncIoLoopGroup::pinLoopsToCpus()
+	{
+		sl_uint32 nCpus = CPU::getProcessorsCount();
+		sl_bool flagSuccess = sl_true;
+		for (sl_uint32 i = 0; i < m_nLoops; i++) {
+			if (!(m_loops[i]->setCpuAffinity((sl_int32)(i % nCpus)))) {
+				flagSuccess = sl_false;
+			}
+		}
+		return flagSuccess;
+	}
+
 /*************************************
 		AsyncIoInstance
 **************************************/
@@ -384,7 +572,7 @@ namespace slib
 		Referable* _userObject,
 		const Function<void(AsyncStreamResult*)>& _callback,
 		sl_bool _flagRead)
-	 : data(_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead)
+	 : data(_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead), offsetFile(0)
 	{
 	}
 
@@ -406,6 +594,40 @@ namespace slib
 		return new AsyncStreamRequest(data, size, userObject, callback, sl_false);
 	}
 
+	Ref<AsyncStreamRequest> AsyncStreamRequest::createSendFile(
+		const Ref<File>& file,
+		sl_uint64 offset,
+		sl_uint32 size,
+		const Function<void(AsyncStreamResult*)>& callback)
+	{
+		Ref<AsyncStreamRequest> ret = new AsyncStreamRequest(sl_null, size, sl_null, callback, sl_false);
+		if (ret.isNotNull()) {
+			ret->file = file;
+			ret->offsetFile = offset;
+		}
+		return ret;
+	}
+
+	Ref<AsyncStreamRequest> AsyncStreamRequest::createWriteVector(
+		MemoryQueue& queue,
+		const Function<void(AsyncStreamResult*)>& callback)
+	{
+		sl_size size = queue.getSize();
+		if (size == 0 || size > 0x40000000) {
+			return sl_null;
+		}
+		Ref<MemoryQueue> chunks = new MemoryQueue;
+		if (chunks.isNull()) {
+			return sl_null;
+		}
+		Ref<AsyncStreamRequest> ret = new AsyncStreamRequest(sl_null, (sl_uint32)size, sl_null, callback, sl_false);
+		if (ret.isNotNull()) {
+			chunks->link(queue);
+			ret->queue = chunks;
+		}
+		return ret;
+	}
+
 	void AsyncStreamRequest::runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError)
 	{
 		if (callback.isNotNull()) {
@@ -457,6 +679,16 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamInstance::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamInstance::writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback)
+	{
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamInstance::isSeekable()
 	{
 		return sl_false;
@@ -551,6 +783,16 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool AsyncStream::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStream::writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback)
+	{
+		return sl_false;
+	}
+
 	sl_bool AsyncStream::isSeekable()
 	{
 		return sl_false;
@@ -664,6 +906,38 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamBase::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback)
+	{
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			if (instance->sendFile(file, offset, size, callback)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamBase::writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback)
+	{
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			if (instance->writev(queue, callback)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamBase::isSeekable()
 	{
 		Ref<AsyncStreamInstance> instance = getIoInstance();
@@ -974,15 +1248,7 @@ namespace slib
 
 	Ref<AsyncFile> AsyncFile::create(const Ref<File>& file)
 	{
-		if (file.isNotNull()) {
-			Ref<AsyncFile> ret = new AsyncFile;
-			if (ret.isNotNull()) {
-				ret->m_file = file;
-				ret->init();
-				return ret;
-			}
-		}
-		return sl_null;
+		return create(file, Ref<Dispatcher>::null());
 	}
 
 	Ref<AsyncFile> AsyncFile::create(const Ref<File>& file, const Ref<Dispatcher>& dispatcher)
@@ -991,6 +1257,12 @@ namespace slib
 			Ref<AsyncFile> ret = new AsyncFile;
 			if (ret.isNotNull()) {
 				ret->m_file = file;
+				if (dispatcher.isNull()) {
+					// the requests complete on the loop instead of a dispatch thread for each file
+					if (ret->_initializeUring(AsyncIoLoop::getDefault())) {
+						return ret;
+					}
+				}
 				ret->init(dispatcher);
 				return ret;
 			}
@@ -1053,6 +1325,7 @@ namespace slib
 
 	void AsyncFile::close()
 	{
+		closeIoInstance();
 		m_file.setNull();
 	}
 
@@ -1061,6 +1334,57 @@ namespace slib
 		return m_file.isNotNull();
 	}
 
+	sl_bool AsyncFile::read(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		Ref<AsyncStreamInstance> instance = Ref<AsyncStreamInstance>::from(getIoInstance());
+		if (instance.isNull()) {
+			return AsyncStreamSimulator::read(data, size, callback, userObject);
+		}
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNotNull() && data && size > 0) {
+			if (instance->read(data, size, callback, userObject)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncFile::write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		Ref<AsyncStreamInstance> instance = Ref<AsyncStreamInstance>::from(getIoInstance());
+		if (instance.isNull()) {
+			return AsyncStreamSimulator::write(data, size, callback, userObject);
+		}
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNotNull() && data && size > 0) {
+			if (instance->write(data, size, callback, userObject)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncFile::addTask(const Function<void()>& callback)
+	{
+		if (getIoInstance().isNull()) {
+			return AsyncStreamSimulator::addTask(callback);
+		}
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNotNull()) {
+			return loop->addTask(callback);
+		}
+		return sl_false;
+	}
+
+#if !defined(SLIB_PLATFORM_IS_LINUX)
+	sl_bool AsyncFile::_initializeUring(const Ref<AsyncIoLoop>& loop)
+	{
+		return sl_false;
+	}
+#endif
+
 	void AsyncFile::processRequest(AsyncStreamRequest* request)
 	{
 		Ref<File> file = m_file;
@@ -1087,6 +1411,10 @@ namespace slib
 
 	sl_bool AsyncFile::seek(sl_uint64 pos)
 	{
+		Ref<AsyncStreamInstance> instance = Ref<AsyncStreamInstance>::from(getIoInstance());
+		if (instance.isNotNull()) {
+			return instance->seek(pos);
+		}
 		Ref<File> file = m_file;
 		if (file.isNotNull()) {
 			return file->seek(pos, SeekPosition::Begin);
@@ -1182,7 +1510,7 @@ namespace slib
 			ret->m_callback = param.callback;
 			ret->m_sizeTotal = param.size;
 			for (sl_uint32 i = 0; i < param.bufferCount; i++) {
-				Memory mem = Memory::create(param.bufferSize);
+				Memory mem = MemoryPool::create(param.bufferSize);
 				if (mem.isNotEmpty()) {
 					Ref<Buffer> buf = new Buffer;
 					if (buf.isNotNull()) {
@@ -1308,6 +1636,13 @@ namespace slib
 		m_bufferReading.setNull();
 
 		if (bufferReading.isNotNull()) {
+			if (!(result->size) && !(result->flagError) && m_sizeTotal == SLIB_UINT64_MAX) {
+				// the source of unknown size is ended by an empty read
+				m_sizeTotal = m_sizeRead;
+				m_buffersRead.pushBack(bufferReading);
+				enqueue();
+				return;
+			}
 			m_sizeRead += result->size;
 			Memory memWrite = bufferReading->mem.sub(0, result->size);
 			if (memWrite.isEmpty()) {
@@ -1442,18 +1777,28 @@ namespace slib
 	AsyncOutputBufferElement::AsyncOutputBufferElement()
 	{
 		m_sizeBody = 0;
+		m_offsetFileBody = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(const Memory& header)
 	{
 		m_header.add(header);
 		m_sizeBody = 0;
+		m_offsetFileBody = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size)
 	{
 		m_body = stream;
 		m_sizeBody = size;
+		m_offsetFileBody = 0;
+	}
+
+	AsyncOutputBufferElement::AsyncOutputBufferElement(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_fileBody = file;
+		m_offsetFileBody = offset;
+		m_sizeBody = size;
 	}
 
 	AsyncOutputBufferElement::~AsyncOutputBufferElement()
@@ -1462,7 +1807,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmpty() const
 	{
-		if (m_header.getSize() == 0 && (m_sizeBody == 0 || m_body.isNull())) {
+		if (m_header.getSize() == 0 && isEmptyBody()) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1470,7 +1815,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmptyBody() const
 	{
-		if (m_sizeBody == 0 || m_body.isNull()) {
+		if (m_sizeBody == 0 || (m_body.isNull() && m_fileBody.isNull())) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1487,6 +1832,13 @@ namespace slib
 		m_sizeBody = size;
 	}
 
+	void AsyncOutputBufferElement::setFileBody(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_fileBody = file;
+		m_offsetFileBody = offset;
+		m_sizeBody = size;
+	}
+
 	MemoryQueue& AsyncOutputBufferElement::getHeader()
 	{
 		return m_header;
@@ -1502,6 +1854,25 @@ namespace slib
 		return m_sizeBody;
 	}
 
+	Ref<File> AsyncOutputBufferElement::getFileBody()
+	{
+		return m_fileBody;
+	}
+
+	sl_uint64 AsyncOutputBufferElement::getFileBodyOffset()
+	{
+		return m_offsetFileBody;
+	}
+
+	void AsyncOutputBufferElement::skipFileBody(sl_uint64 size)
+	{
+		if (size > m_sizeBody) {
+			size = m_sizeBody;
+		}
+		m_offsetFileBody += size;
+		m_sizeBody -= size;
+	}
+
 
 /**********************************************
 		AsyncOutputBuffer
@@ -1524,7 +1895,7 @@ namespace slib
 
 	sl_bool AsyncOutputBuffer::write(const void* buf, sl_size size)
 	{
-		return write(Memory::create(buf, size));
+		return write(MemoryPool::create(buf, size));
 	}
 
 	sl_bool AsyncOutputBuffer::write(const Memory& mem)
@@ -1561,15 +1932,17 @@ namespace slib
 			return sl_false;
 		}
 		ObjectLocker lock(this);
+		// the length of the stream ended by an empty read is not counted
+		sl_uint64 sizeCounted = size == SLIB_UINT64_MAX ? 0 : size;
 		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
 		if (link && link->value->isEmptyBody()) {
 			link->value->setBody(stream, size);
-			m_lengthOutput += size;
+			m_lengthOutput += sizeCounted;
 		} else {
 			Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement(stream, size);
 			if (data.isNotNull()) {
 				if (m_queueOutput.push(data)) {
-					m_lengthOutput += size;
+					m_lengthOutput += sizeCounted;
 				} else {
 					return sl_false;
 				}
@@ -1602,11 +1975,87 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncOutputBuffer::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		if (file.isNull()) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
+		if (link && link->value->isEmptyBody()) {
+			link->value->setFileBody(file, offset, size);
+			m_lengthOutput += size;
+		} else {
+			Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement(file, offset, size);
+			if (data.isNotNull()) {
+				if (m_queueOutput.push(data)) {
+					m_lengthOutput += size;
+				} else {
+					return sl_false;
+				}
+			} else {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool AsyncOutputBuffer::sendFile(const String& path, sl_uint64 offset, sl_uint64 size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		Ref<File> file = File::openForRead(path);
+		if (file.isNotNull()) {
+			return sendFile(file, offset, size);
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncOutputBuffer::sendFile(const String& path)
+	{
+		Ref<File> file = File::openForRead(path);
+		if (file.isNotNull()) {
+			return sendFile(file, 0, file->getSize());
+		}
+		return sl_false;
+	}
+
 	sl_uint64 AsyncOutputBuffer::getOutputLength() const
 	{
 		return m_lengthOutput;
 	}
 
+	sl_bool AsyncOutputBuffer::popMemory(MemoryQueue& output)
+	{
+		ObjectLocker lock(this);
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getFront();
+		while (link) {
+			if (!(link->value->isEmptyBody())) {
+				return sl_false;
+			}
+			link = link->next;
+		}
+		link = m_queueOutput.getFront();
+		while (link) {
+			output.link(link->value->getHeader());
+			link = link->next;
+		}
+		m_queueOutput.removeAll();
+		m_lengthOutput = 0;
+		return sl_true;
+	}
+
+	void AsyncOutputBuffer::popElements(LinkedQueue< Ref<AsyncOutputBufferElement> >& output)
+	{
+		ObjectLocker lock(this);
+		output.merge(&m_queueOutput);
+		m_lengthOutput = 0;
+	}
+
 /**********************************************
 				AsyncOutput
 **********************************************/
@@ -1672,7 +2121,7 @@ namespace slib
 		if (param.stream.isNull()) {
 			return sl_null;
 		}
-		Memory buffer = Memory::create(param.bufferSize);
+		Memory buffer = MemoryPool::create(param.bufferSize);
 		if (buffer.isEmpty()) {
 			return sl_null;
 		}
@@ -1727,6 +2176,12 @@ namespace slib
 		}
 		MemoryQueue& header = m_elementWriting->getHeader();
 		if (header.getSize() > 0) {
+			m_flagWriting = sl_true;
+			if (m_streamOutput->writev(header, SLIB_FUNCTION_WEAKREF(AsyncOutput, onWriteStream, this))) {
+				return;
+			}
+			// the output stream can't gather the chunks
+			m_flagWriting = sl_false;
 			sl_uint32 size = (sl_uint32)(header.pop(m_bufWrite.getData(), m_bufWrite.getSize()));
 			if (size > 0) {
 				m_flagWriting = sl_true;
@@ -1739,26 +2194,51 @@ namespace slib
 			sl_uint64 sizeBody = m_elementWriting->getBodySize();
 			Ref<AsyncStream> body = m_elementWriting->getBody();
 			if (sizeBody != 0 && body.isNotNull()) {
-				m_flagWriting = sl_true;
 				m_elementWriting.setNull();
-				AsyncCopyParam param;
-				param.source = body;
-				param.target = m_streamOutput;
-				param.size = sizeBody;
-				param.bufferSize = m_bufferSize;
-				param.bufferCount = m_bufferCount;
-				param.listener.setWeak(this);
-				Ref<AsyncCopy> copy = AsyncCopy::create(param);
-				if (copy.isNotNull()) {
-					m_copy = copy;
+				_copyBody(body, sizeBody);
+				return;
+			}
+			Ref<File> file = m_elementWriting->getFileBody();
+			if (sizeBody != 0 && file.isNotNull()) {
+				sl_uint64 offset = m_elementWriting->getFileBodyOffset();
+				sl_uint32 size = sizeBody > ASYNC_OUTPUT_SEND_FILE_SIZE ? ASYNC_OUTPUT_SEND_FILE_SIZE : (sl_uint32)sizeBody;
+				m_flagWriting = sl_true;
+				if (m_streamOutput->sendFile(file, offset, size, SLIB_FUNCTION_WEAKREF(AsyncOutput, onWriteStream, this))) {
+					m_elementWriting->skipFileBody(size);
 				} else {
-					m_flagWriting = sl_false;
-					_onError();
+					// the output stream can't send from a file descriptor
+					m_elementWriting.setNull();
+					Ref<AsyncFile> stream = AsyncFile::create(file);
+					if (stream.isNotNull() && stream->seek(offset)) {
+						_copyBody(stream, sizeBody);
+					} else {
+						m_flagWriting = sl_false;
+						_onError();
+					}
 				}
 			}
 		}
 	}
 
+	void AsyncOutput::_copyBody(const Ref<AsyncStream>& body, sl_uint64 size)
+	{
+		m_flagWriting = sl_true;
+		AsyncCopyParam param;
+		param.source = body;
+		param.target = m_streamOutput;
+		param.size = size;
+		param.bufferSize = m_bufferSize;
+		param.bufferCount = m_bufferCount;
+		param.listener.setWeak(this);
+		Ref<AsyncCopy> copy = AsyncCopy::create(param);
+		if (copy.isNotNull()) {
+			m_copy = copy;
+		} else {
+			m_flagWriting = sl_false;
+			_onError();
+		}
+	}
+
 	void AsyncOutput::onAsyncCopyExit(AsyncCopy* task)
 	{
 		m_flagWriting = sl_false;
@@ -1897,13 +2377,13 @@ namespace slib
 
 	void AsyncStreamFilter::addReadData(void* data, sl_uint32 size)
 	{
-		addReadData(Memory::create(data, size));
+		addReadData(MemoryPool::create(data, size));
 	}
 
 	void AsyncStreamFilter::setReadingBufferSize(sl_uint32 sizeBuffer)
 	{
 		if (sizeBuffer > 0) {
-			m_memReading = Memory::create(sizeBuffer);
+			m_memReading = MemoryPool::create(sizeBuffer);
 		}
 	}
 
@@ -1924,7 +2404,7 @@ namespace slib
 		}
 		Memory mem = m_memReading;
 		if (mem.isEmpty()) {
-			mem = Memory::create(SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE);
+			mem = MemoryPool::create(SLIB_ASYNC_STREAM_FILTER_DEFAULT_BUFFER_SIZE);
 			if (mem.isNull()) {
 				return;
 			}
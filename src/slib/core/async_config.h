@@ -23,6 +23,11 @@
 #define ASYNC_USE_KEVENT
 #endif
 
+// io_uring completion ring attached to the epoll loop, used only when the running kernel supports it
+#if defined(ASYNC_USE_EPOLL) && !defined(SLIB_PLATFORM_IS_MOBILE)
+#define ASYNC_USE_URING
+#endif
+
 #define ASYNC_MAX_WAIT_EVENT 256
 
 #endif
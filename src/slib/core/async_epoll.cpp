@@ -15,14 +15,22 @@
 #include "slib/core/async.h"
 #include "slib/core/pipe.h"
 
+#include "async_uring.h"
+
 #include <unistd.h>
 #include <sys/epoll.h>
 #include <sys/errno.h>
 
+#if defined(ASYNC_USE_URING)
+#include <sys/eventfd.h>
+#endif
+
 #if defined(SLIB_PLATFORM_IS_ANDROID)
 #define EPOLL_LOW
 #endif
 
+#define URING_ENTRIES 256
+
 namespace slib
 {
 
@@ -30,6 +38,9 @@ namespace slib
 	{
 		int fdEpoll;
 		Ref<PipeEvent> eventWake;
+#if defined(ASYNC_USE_URING)
+		_AsyncUring* uring;
+#endif
 	};
 
 	void* AsyncIoLoop::_native_createHandle()
@@ -54,6 +65,18 @@ namespace slib
 				ev.data.ptr = sl_null;
 				ev.events = EPOLLIN | EPOLLPRI | EPOLLET;
 				if (0 == epoll_ctl(fdEpoll, EPOLL_CTL_ADD, (int)(pipe->getReadPipeHandle()), &ev)) {
+#if defined(ASYNC_USE_URING)
+					// completions are signaled on the eventfd of the ring
+					handle->uring = _AsyncUring::create(URING_ENTRIES);
+					if (handle->uring) {
+						ev.data.ptr = handle->uring;
+						ev.events = EPOLLIN | EPOLLET;
+						if (0 != epoll_ctl(fdEpoll, EPOLL_CTL_ADD, handle->uring->fdEvent, &ev)) {
+							delete handle->uring;
+							handle->uring = sl_null;
+						}
+					}
+#endif
 					return handle;
 				}
 				delete handle;
@@ -66,6 +89,11 @@ namespace slib
 	void AsyncIoLoop::_native_closeHandle(void* _handle)
 	{
 		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)_handle;
+#if defined(ASYNC_USE_URING)
+		if (handle->uring) {
+			delete handle->uring;
+		}
+#endif
 		::close(handle->fdEpoll);
 		delete handle;
 	}
@@ -80,7 +108,14 @@ namespace slib
 
 			_stepBegin();
 
-			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, -1);
+#if defined(ASYNC_USE_URING)
+			if (handle->uring) {
+				// submits the operations queued in this iteration at once
+				handle->uring->flush();
+			}
+#endif
+
+			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, _getTimeout());
 			if (nEvents == 0) {
 				m_queueInstancesClosed.removeAll();
 			}
@@ -93,6 +128,13 @@ namespace slib
 
 			for (int i = 0; m_flagRunning && i < nEvents; i++) {
 				epoll_event& ev = waitEvents[i];
+#if defined(ASYNC_USE_URING)
+				if (handle->uring && ev.data.ptr == handle->uring) {
+					eventfd_t value;
+					::eventfd_read(handle->uring->fdEvent, &value);
+					continue;
+				}
+#endif
 				AsyncIoInstance* instance = (AsyncIoInstance*)(ev.data.ptr);
 				if (instance) {
 					if (!(instance->isClosing())) {
@@ -121,6 +163,12 @@ namespace slib
 				}
 			}
 
+#if defined(ASYNC_USE_URING)
+			if (m_flagRunning && handle->uring) {
+				handle->uring->processCompletions();
+			}
+#endif
+
 			if (m_flagRunning) {
 				_stepEnd();
 			}
@@ -177,6 +225,91 @@ namespace slib
 		SLIB_UNUSED(ret);
 	}
 
+#if defined(ASYNC_USE_URING)
+	static sl_bool _AsyncIoLoop_submitUring(AsyncIoLoop* loop, void* _handle, const Ref<Thread>& thread, sl_uint8 opcode, sl_file fd, const void* data, sl_uint32 size, sl_int64 offset, sl_uint32 events, const Function<void(sl_int32)>& callback)
+	{
+		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)_handle;
+		if (handle && handle->uring) {
+			sl_bool flagLoopThread = thread.isNotNull() && thread->isCurrentThread();
+			if (handle->uring->submit(opcode, (int)fd, data, size, offset, events, callback, flagLoopThread)) {
+				// the loop thread flushes the submissions before waiting
+				if (!flagLoopThread) {
+					loop->wake();
+				}
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncIoLoop::isUringEnabled()
+	{
+		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
+		return handle && handle->uring;
+	}
+
+	sl_bool AsyncIoLoop::submitUringRead(sl_file fd, void* data, sl_uint32 size, sl_int64 offset, const Function<void(sl_int32)>& callback)
+	{
+		return _AsyncIoLoop_submitUring(this, m_handle, m_thread, IORING_OP_READ, fd, data, size, offset, 0, callback);
+	}
+
+	sl_bool AsyncIoLoop::submitUringWrite(sl_file fd, const void* data, sl_uint32 size, sl_int64 offset, const Function<void(sl_int32)>& callback)
+	{
+		return _AsyncIoLoop_submitUring(this, m_handle, m_thread, IORING_OP_WRITE, fd, data, size, offset, 0, callback);
+	}
+
+	sl_bool AsyncIoLoop::submitUringPoll(sl_file fd, sl_uint32 events, const Function<void(sl_int32)>& callback)
+	{
+		return _AsyncIoLoop_submitUring(this, m_handle, m_thread, IORING_OP_POLL_ADD, fd, sl_null, 0, 0, events, callback);
+	}
+
+	sl_bool AsyncIoLoop::registerUringBuffers(const Memory* buffers, sl_uint32 count)
+	{
+		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
+		if (handle && handle->uring) {
+			return handle->uring->registerBuffers(buffers, count);
+		}
+		return sl_false;
+	}
+
+	void AsyncIoLoop::unregisterUringBuffers()
+	{
+		_AsyncIoLoopHandle* handle = (_AsyncIoLoopHandle*)m_handle;
+		if (handle && handle->uring) {
+			handle->uring->unregisterBuffers();
+		}
+	}
+#else
+	sl_bool AsyncIoLoop::isUringEnabled()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncIoLoop::submitUringRead(sl_file fd, void* data, sl_uint32 size, sl_int64 offset, const Function<void(sl_int32)>& callback)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncIoLoop::submitUringWrite(sl_file fd, const void* data, sl_uint32 size, sl_int64 offset, const Function<void(sl_int32)>& callback)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncIoLoop::submitUringPoll(sl_file fd, sl_uint32 events, const Function<void(sl_int32)>& callback)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncIoLoop::registerUringBuffers(const Memory* buffers, sl_uint32 count)
+	{
+		return sl_false;
+	}
+
+	void AsyncIoLoop::unregisterUringBuffers()
+	{
+	}
+#endif
+
 }
 
 #endif
@@ -84,8 +84,9 @@ namespace slib
 			_stepBegin();
 
 			DWORD nCount = 0;
+			sl_int32 timeout = _getTimeout();
 			
-			if (!fGetQueuedCompletionStatusEx(handle->hCompletionPort, entries, ASYNC_MAX_WAIT_EVENT, &nCount, INFINITE, FALSE)) {
+			if (!fGetQueuedCompletionStatusEx(handle->hCompletionPort, entries, ASYNC_MAX_WAIT_EVENT, &nCount, timeout >= 0 ? (DWORD)timeout : INFINITE, FALSE)) {
 				nCount = 0;
 			}
 			if (nCount == 0) {
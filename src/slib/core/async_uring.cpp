@@ -0,0 +1,616 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "async_uring.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+
+#include "slib/core/async.h"
+
+#if defined(ASYNC_USE_URING)
+
+#include "slib/core/new_helper.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+#define URING_PROBE_OPS_COUNT 256
+
+namespace slib
+{
+
+	struct _AsyncUringOperation
+	{
+		Function<void(sl_int32)> callback;
+
+		sl_uint8 opcode;
+		int fd;
+		const void* data;
+		sl_uint32 size;
+		sl_int64 offset;
+		sl_uint32 pollEvents;
+		sl_int32 indexBuffer;
+
+		// link of the operations waiting for the loop thread
+		_AsyncUringOperation* next;
+	};
+
+	static int _AsyncUring_setup(unsigned entries, io_uring_params* p)
+	{
+		return (int)(::syscall(__NR_io_uring_setup, entries, p));
+	}
+
+	static int _AsyncUring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+	{
+		return (int)(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, sl_null, 0));
+	}
+
+	static int _AsyncUring_register(int fd, unsigned opcode, const void* arg, unsigned nArgs)
+	{
+		return (int)(::syscall(__NR_io_uring_register, fd, opcode, arg, nArgs));
+	}
+
+	static sl_bool _AsyncUring_checkOperations(int fd)
+	{
+		sl_size size = sizeof(io_uring_probe) + URING_PROBE_OPS_COUNT * sizeof(io_uring_probe_op);
+		io_uring_probe* probe = (io_uring_probe*)(Base::createMemory(size));
+		if (!probe) {
+			return sl_false;
+		}
+		Base::zeroMemory(probe, size);
+		sl_bool flagSupported = sl_false;
+		if (_AsyncUring_register(fd, IORING_REGISTER_PROBE, probe, URING_PROBE_OPS_COUNT) == 0) {
+			static const sl_uint8 ops[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED, IORING_OP_POLL_ADD};
+			flagSupported = sl_true;
+			for (sl_size i = 0; i < sizeof(ops); i++) {
+				sl_uint8 op = ops[i];
+				if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+					flagSupported = sl_false;
+					break;
+				}
+			}
+		}
+		Base::freeMemory(probe);
+		return flagSupported;
+	}
+
+	_AsyncUring::_AsyncUring()
+	{
+		fdRing = -1;
+		fdEvent = -1;
+
+		m_ptrSq = MAP_FAILED;
+		m_sizeSq = 0;
+		m_ptrCq = MAP_FAILED;
+		m_sizeCq = 0;
+		m_sqes = (io_uring_sqe*)MAP_FAILED;
+		m_sizeSqes = 0;
+
+		m_sqTailLocal = 0;
+		m_opPendingFirst = sl_null;
+		m_opPendingLast = sl_null;
+
+		m_buffers = sl_null;
+		m_nBuffers = 0;
+	}
+
+	_AsyncUring::~_AsyncUring()
+	{
+		// Operations still in flight are not freed: the kernel may keep writing to their buffers until they are canceled by closing the ring
+		_AsyncUringOperation* op = m_opPendingFirst;
+		while (op) {
+			_AsyncUringOperation* next = op->next;
+			delete op;
+			op = next;
+		}
+		unregisterBuffers();
+		if (fdEvent >= 0) {
+			::close(fdEvent);
+		}
+		if ((void*)m_sqes != MAP_FAILED) {
+			::munmap(m_sqes, m_sizeSqes);
+		}
+		if (m_ptrCq != MAP_FAILED && m_ptrCq != m_ptrSq) {
+			::munmap(m_ptrCq, m_sizeCq);
+		}
+		if (m_ptrSq != MAP_FAILED) {
+			::munmap(m_ptrSq, m_sizeSq);
+		}
+		if (fdRing >= 0) {
+			::close(fdRing);
+		}
+	}
+
+	_AsyncUring* _AsyncUring::create(sl_uint32 nEntries)
+	{
+		io_uring_params params;
+		Base::zeroMemory(&params, sizeof(params));
+		int fd = _AsyncUring_setup(nEntries, &params);
+		if (fd < 0) {
+			return sl_null;
+		}
+		_AsyncUring* ring = new _AsyncUring;
+		if (!ring) {
+			::close(fd);
+			return sl_null;
+		}
+		ring->fdRing = fd;
+		do {
+			if (!(_AsyncUring_checkOperations(fd))) {
+				break;
+			}
+
+			ring->m_sizeSq = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			ring->m_sizeCq = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				if (ring->m_sizeCq > ring->m_sizeSq) {
+					ring->m_sizeSq = ring->m_sizeCq;
+				}
+				ring->m_sizeCq = ring->m_sizeSq;
+			}
+			ring->m_ptrSq = ::mmap(sl_null, ring->m_sizeSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+			if (ring->m_ptrSq == MAP_FAILED) {
+				break;
+			}
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				ring->m_ptrCq = ring->m_ptrSq;
+			} else {
+				ring->m_ptrCq = ::mmap(sl_null, ring->m_sizeCq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+				if (ring->m_ptrCq == MAP_FAILED) {
+					break;
+				}
+			}
+			ring->m_sizeSqes = params.sq_entries * sizeof(io_uring_sqe);
+			ring->m_sqes = (io_uring_sqe*)(::mmap(sl_null, ring->m_sizeSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+			if ((void*)(ring->m_sqes) == MAP_FAILED) {
+				break;
+			}
+
+			sl_uint8* sq = (sl_uint8*)(ring->m_ptrSq);
+			ring->m_sqHead = (unsigned*)(sq + params.sq_off.head);
+			ring->m_sqTail = (unsigned*)(sq + params.sq_off.tail);
+			ring->m_sqMask = *((unsigned*)(sq + params.sq_off.ring_mask));
+			ring->m_sqEntries = *((unsigned*)(sq + params.sq_off.ring_entries));
+			ring->m_sqArray = (unsigned*)(sq + params.sq_off.array);
+			ring->m_sqTailLocal = *(ring->m_sqTail);
+
+			sl_uint8* cq = (sl_uint8*)(ring->m_ptrCq);
+			ring->m_cqHead = (unsigned*)(cq + params.cq_off.head);
+			ring->m_cqTail = (unsigned*)(cq + params.cq_off.tail);
+			ring->m_cqMask = *((unsigned*)(cq + params.cq_off.ring_mask));
+			ring->m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+			ring->fdEvent = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (ring->fdEvent < 0) {
+				break;
+			}
+			if (_AsyncUring_register(fd, IORING_REGISTER_EVENTFD, &(ring->fdEvent), 1) != 0) {
+				break;
+			}
+			return ring;
+		} while (0);
+		delete ring;
+		return sl_null;
+	}
+
+	io_uring_sqe* _AsyncUring::_getSqe()
+	{
+		unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+		if (m_sqTailLocal - head >= m_sqEntries) {
+			return sl_null;
+		}
+		unsigned index = m_sqTailLocal & m_sqMask;
+		m_sqArray[index] = index;
+		m_sqTailLocal++;
+		io_uring_sqe* sqe = m_sqes + index;
+		Base::zeroMemory(sqe, sizeof(io_uring_sqe));
+		return sqe;
+	}
+
+	sl_int32 _AsyncUring::_findBuffer(const void* data, sl_uint32 size)
+	{
+		SpinLocker lock(&m_lockBuffers);
+		for (sl_uint32 i = 0; i < m_nBuffers; i++) {
+			sl_uint8* start = (sl_uint8*)(m_buffers[i].getData());
+			sl_uint8* end = start + m_buffers[i].getSize();
+			if ((sl_uint8*)data >= start && (sl_uint8*)data + size <= end) {
+				return (sl_int32)i;
+			}
+		}
+		return -1;
+	}
+
+	sl_bool _AsyncUring::submit(sl_uint8 opcode, int fd, const void* data, sl_uint32 size, sl_int64 offset, sl_uint32 pollEvents, const Function<void(sl_int32)>& callback, sl_bool flagLoopThread)
+	{
+		sl_int32 indexBuffer = -1;
+		if (opcode == IORING_OP_READ || opcode == IORING_OP_WRITE) {
+			indexBuffer = _findBuffer(data, size);
+			if (indexBuffer >= 0) {
+				opcode = opcode == IORING_OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+			}
+		}
+		_AsyncUringOperation* op = new _AsyncUringOperation;
+		if (!op) {
+			return sl_false;
+		}
+		op->callback = callback;
+		op->opcode = opcode;
+		op->fd = fd;
+		op->data = data;
+		op->size = size;
+		op->offset = offset;
+		op->pollEvents = pollEvents;
+		op->indexBuffer = indexBuffer;
+		op->next = sl_null;
+		if (!flagLoopThread) {
+			// the submission queue is written only by the loop thread, which moves the pending operations in `flush()`
+			SpinLocker lock(&m_lockPending);
+			if (m_opPendingLast) {
+				m_opPendingLast->next = op;
+			} else {
+				m_opPendingFirst = op;
+			}
+			m_opPendingLast = op;
+			return sl_true;
+		}
+		if (_putSqe(op)) {
+			return sl_true;
+		}
+		delete op;
+		return sl_false;
+	}
+
+	sl_bool _AsyncUring::_putSqe(_AsyncUringOperation* op)
+	{
+		for (int iTry = 0; iTry < 2; iTry++) {
+			io_uring_sqe* sqe = _getSqe();
+			if (sqe) {
+				sqe->opcode = op->opcode;
+				sqe->fd = op->fd;
+				if (op->opcode == IORING_OP_POLL_ADD) {
+					sqe->poll32_events = op->pollEvents;
+				} else {
+					sqe->addr = (sl_uint64)(sl_size)(op->data);
+					sqe->len = op->size;
+					sqe->off = (sl_uint64)(op->offset);
+					if (op->indexBuffer >= 0) {
+						sqe->buf_index = (sl_uint16)(op->indexBuffer);
+					}
+				}
+				sqe->user_data = (sl_uint64)(sl_size)op;
+				__atomic_store_n(m_sqTail, m_sqTailLocal, __ATOMIC_RELEASE);
+				return sl_true;
+			}
+			// submission queue is full
+			_enter();
+		}
+		return sl_false;
+	}
+
+	sl_uint32 _AsyncUring::getPendingCount()
+	{
+		return __atomic_load_n(m_sqTail, __ATOMIC_ACQUIRE) - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+	}
+
+	void _AsyncUring::flush()
+	{
+		_AsyncUringOperation* op;
+		{
+			SpinLocker lock(&m_lockPending);
+			op = m_opPendingFirst;
+			m_opPendingFirst = sl_null;
+			m_opPendingLast = sl_null;
+		}
+		while (op) {
+			_AsyncUringOperation* next = op->next;
+			if (!(_putSqe(op))) {
+				// completed as failed, same as the submission refused on the loop thread
+				op->callback(-EBUSY);
+				delete op;
+			}
+			op = next;
+		}
+		_enter();
+	}
+
+	void _AsyncUring::_enter()
+	{
+		sl_uint32 n = getPendingCount();
+		if (n) {
+			_AsyncUring_enter(fdRing, n, 0, 0);
+		}
+	}
+
+	void _AsyncUring::processCompletions()
+	{
+		unsigned head = *m_cqHead;
+		for (;;) {
+			unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+			if (head == tail) {
+				break;
+			}
+			io_uring_cqe* cqe = m_cqes + (head & m_cqMask);
+			_AsyncUringOperation* op = (_AsyncUringOperation*)(sl_size)(cqe->user_data);
+			sl_int32 result = cqe->res;
+			head++;
+			__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+			if (op) {
+				op->callback(result);
+				delete op;
+			}
+		}
+	}
+
+	sl_bool _AsyncUring::registerBuffers(const Memory* buffers, sl_uint32 count)
+	{
+		unregisterBuffers();
+		if (!count) {
+			return sl_true;
+		}
+		iovec* iov = NewHelper<iovec>::create(count);
+		if (!iov) {
+			return sl_false;
+		}
+		for (sl_uint32 i = 0; i < count; i++) {
+			iov[i].iov_base = buffers[i].getData();
+			iov[i].iov_len = buffers[i].getSize();
+		}
+		sl_bool flagSuccess = sl_false;
+		if (_AsyncUring_register(fdRing, IORING_REGISTER_BUFFERS, iov, count) == 0) {
+			Memory* list = NewHelper<Memory>::create(buffers, count);
+			if (list) {
+				SpinLocker lock(&m_lockBuffers);
+				m_buffers = list;
+				m_nBuffers = count;
+				flagSuccess = sl_true;
+			} else {
+				_AsyncUring_register(fdRing, IORING_UNREGISTER_BUFFERS, sl_null, 0);
+			}
+		}
+		NewHelper<iovec>::free(iov, count);
+		return flagSuccess;
+	}
+
+	void _AsyncUring::unregisterBuffers()
+	{
+		Memory* buffers;
+		sl_uint32 n;
+		{
+			SpinLocker lock(&m_lockBuffers);
+			buffers = m_buffers;
+			n = m_nBuffers;
+			m_buffers = sl_null;
+			m_nBuffers = 0;
+		}
+		if (buffers) {
+			_AsyncUring_register(fdRing, IORING_UNREGISTER_BUFFERS, sl_null, 0);
+			NewHelper<Memory>::free(buffers, n);
+		}
+	}
+
+
+	class _Linux_AsyncUringFileStreamInstance : public AsyncStreamInstance
+	{
+	public:
+		Ref<File> m_file;
+		sl_uint64 m_offset;
+		sl_bool m_flagOperating;
+
+	public:
+		_Linux_AsyncUringFileStreamInstance()
+		{
+			m_offset = 0;
+			m_flagOperating = sl_false;
+		}
+
+		~_Linux_AsyncUringFileStreamInstance()
+		{
+			close();
+		}
+
+	public:
+		static Ref<_Linux_AsyncUringFileStreamInstance> open(const String& path, FileMode mode)
+		{
+			Ref<_Linux_AsyncUringFileStreamInstance> ret;
+			Ref<File> file = File::open(path, mode);
+			if (file.isNotNull()) {
+				ret = new _Linux_AsyncUringFileStreamInstance();
+				if (ret.isNotNull()) {
+					ret->m_file = file;
+					ret->setHandle(file->getHandle());
+					if (mode & FileMode::SeekToEnd) {
+						ret->m_offset = file->getSize();
+					}
+				}
+			}
+			return ret;
+		}
+
+		static Ref<_Linux_AsyncUringFileStreamInstance> create(const Ref<File>& file)
+		{
+			Ref<_Linux_AsyncUringFileStreamInstance> ret;
+			if (file.isNotNull() && file->isOpened()) {
+				ret = new _Linux_AsyncUringFileStreamInstance();
+				if (ret.isNotNull()) {
+					ret->m_file = file;
+					ret->setHandle(file->getHandle());
+					ret->m_offset = file->getPosition();
+				}
+			}
+			return ret;
+		}
+
+		void close()
+		{
+			setHandle(SLIB_FILE_INVALID_HANDLE);
+			m_file.setNull();
+		}
+
+		void onOrder()
+		{
+			sl_file handle = getHandle();
+			if (handle == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (m_flagOperating) {
+				return;
+			}
+			Ref<AsyncIoLoop> loop = getLoop();
+			if (loop.isNull()) {
+				return;
+			}
+			Ref<AsyncStreamRequest> req;
+			if (popReadRequest(req)) {
+				if (req.isNotNull()) {
+					m_flagOperating = sl_true;
+					if (!(loop->submitUringRead(handle, req->data, req->size, m_offset, SLIB_BIND_WEAKREF(void(sl_int32), _Linux_AsyncUringFileStreamInstance, _onComplete, this, req)))) {
+						m_flagOperating = sl_false;
+						doCallback(req.get(), 0, sl_true);
+					}
+					return;
+				}
+			}
+			if (popWriteRequest(req)) {
+				if (req.isNotNull()) {
+					m_flagOperating = sl_true;
+					if (!(loop->submitUringWrite(handle, req->data, req->size, m_offset, SLIB_BIND_WEAKREF(void(sl_int32), _Linux_AsyncUringFileStreamInstance, _onComplete, this, req)))) {
+						m_flagOperating = sl_false;
+						doCallback(req.get(), 0, sl_true);
+					}
+				}
+			}
+		}
+
+		void onEvent(EventDesc* pev)
+		{
+		}
+
+		void _onComplete(const Ref<AsyncStreamRequest>& req, sl_int32 result)
+		{
+			m_flagOperating = sl_false;
+			if (result >= 0) {
+				m_offset += result;
+				doCallback(req.get(), result, sl_false);
+			} else {
+				doCallback(req.get(), 0, sl_true);
+			}
+			requestOrder();
+		}
+
+		void doCallback(AsyncStreamRequest* req, sl_uint32 size, sl_bool flagError)
+		{
+			Ref<AsyncIoObject> object = getObject();
+			if (object.isNotNull()) {
+				req->runCallback(static_cast<AsyncStream*>(object.get()), size, flagError);
+			}
+		}
+
+		sl_bool isSeekable()
+		{
+			return sl_true;
+		}
+
+		sl_bool seek(sl_uint64 pos)
+		{
+			m_offset = pos;
+			return sl_true;
+		}
+
+		sl_uint64 getSize()
+		{
+			sl_file handle = getHandle();
+			return File::getSize(handle);
+		}
+
+	};
+
+	Ref<AsyncStream> AsyncFile::openUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		if (loop.isNull()) {
+			return sl_null;
+		}
+		if (loop->isUringEnabled()) {
+			Ref<_Linux_AsyncUringFileStreamInstance> ret = _Linux_AsyncUringFileStreamInstance::open(path, mode);
+			if (ret.isNotNull()) {
+				return AsyncStream::create(ret.get(), AsyncIoMode::None, loop);
+			}
+			return sl_null;
+		}
+		return AsyncFile::open(path, mode, loop);
+	}
+
+	sl_bool AsyncFile::_initializeUring(const Ref<AsyncIoLoop>& loop)
+	{
+		if (loop.isNull() || !(loop->isUringEnabled())) {
+			return sl_false;
+		}
+		Ref<_Linux_AsyncUringFileStreamInstance> instance = _Linux_AsyncUringFileStreamInstance::create(m_file);
+		if (instance.isNull()) {
+			return sl_false;
+		}
+		instance->setObject(this);
+		setIoInstance(instance.get());
+		setIoLoop(loop);
+		if (loop->attachInstance(instance.get(), AsyncIoMode::None)) {
+			return sl_true;
+		}
+		setIoInstance(sl_null);
+		return sl_false;
+	}
+
+}
+
+#else
+
+namespace slib
+{
+
+	sl_bool AsyncFile::_initializeUring(const Ref<AsyncIoLoop>& loop)
+	{
+		return sl_false;
+	}
+
+	Ref<AsyncStream> AsyncFile::openUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		if (loop.isNull()) {
+			return sl_null;
+		}
+		return AsyncFile::open(path, mode, loop);
+	}
+
+}
+
+#endif
+
+namespace slib
+{
+
+	Ref<AsyncStream> AsyncFile::openUring(const String& path, FileMode mode)
+	{
+		return AsyncFile::openUring(path, mode, AsyncIoLoop::getDefault());
+	}
+
+}
+
+#endif
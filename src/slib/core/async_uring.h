@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_ASYNC_URING
+#define CHECKHEADER_SLIB_CORE_ASYNC_URING
+
+#include "async_config.h"
+
+#if defined(ASYNC_USE_URING)
+
+#include "slib/core/function.h"
+#include "slib/core/memory.h"
+#include "slib/core/spin_lock.h"
+
+#include <linux/io_uring.h>
+
+/*
+	Completion ring of an epoll loop.
+
+	The ring is accessed with the raw system calls (no liburing), and signals the completions on an eventfd which is registered in the epoll set.
+	Submissions are batched: the entries queued during one loop iteration are submitted by one `io_uring_enter()` just before `epoll_wait()`.
+*/
+
+namespace slib
+{
+
+	struct _AsyncUringOperation;
+
+	class _AsyncUring
+	{
+	public:
+		int fdRing;
+		int fdEvent;
+
+	public:
+		~_AsyncUring();
+
+	public:
+		// returns null when io_uring (or one of the used operations) is not supported by the kernel
+		static _AsyncUring* create(sl_uint32 nEntries);
+
+		// the submission queue is written only on the loop thread: the operations from the other threads wait for `flush()`
+		sl_bool submit(sl_uint8 opcode, int fd, const void* data, sl_uint32 size, sl_int64 offset, sl_uint32 pollEvents, const Function<void(sl_int32)>& callback, sl_bool flagLoopThread);
+
+		// returns the number of the entries waiting for `flush()`
+		sl_uint32 getPendingCount();
+
+		// called on the loop thread
+		void flush();
+
+		// called on the loop thread
+		void processCompletions();
+
+		sl_bool registerBuffers(const Memory* buffers, sl_uint32 count);
+
+		void unregisterBuffers();
+
+	private:
+		_AsyncUring();
+
+		io_uring_sqe* _getSqe();
+
+		sl_bool _putSqe(_AsyncUringOperation* op);
+
+		void _enter();
+
+		sl_int32 _findBuffer(const void* data, sl_uint32 size);
+
+	private:
+		SpinLock m_lockPending;
+		_AsyncUringOperation* m_opPendingFirst;
+		_AsyncUringOperation* m_opPendingLast;
+
+		void* m_ptrSq;
+		sl_size m_sizeSq;
+		void* m_ptrCq;
+		sl_size m_sizeCq;
+		io_uring_sqe* m_sqes;
+		sl_size m_sizeSqes;
+
+		unsigned* m_sqHead;
+		unsigned* m_sqTail;
+		unsigned m_sqMask;
+		unsigned m_sqEntries;
+		unsigned* m_sqArray;
+		unsigned m_sqTailLocal;
+
+		unsigned* m_cqHead;
+		unsigned* m_cqTail;
+		unsigned m_cqMask;
+		io_uring_cqe* m_cqes;
+
+		SpinLock m_lockBuffers;
+		Memory* m_buffers;
+		sl_uint32 m_nBuffers;
+
+	};
+
+}
+
+#endif
+
+#endif
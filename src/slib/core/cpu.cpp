@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_PLATFORM_IS_WIN32)
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define PRIV_SLIB_CPU_X86
+#	if defined(_MSC_VER)
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+namespace slib
+{
+
+	class _priv_CPU_Features
+	{
+	public:
+		sl_bool flagSSE41;
+		sl_bool flagAVX2;
+		sl_bool flagAESNI;
+		sl_bool flagPCLMULQDQ;
+		sl_bool flagSHA;
+
+	public:
+		_priv_CPU_Features()
+		{
+			flagSSE41 = sl_false;
+			flagAVX2 = sl_false;
+			flagAESNI = sl_false;
+			flagPCLMULQDQ = sl_false;
+			flagSHA = sl_false;
+#if defined(PRIV_SLIB_CPU_X86)
+			sl_uint32 regs[4]; // eax, ebx, ecx, edx
+			if (!(cpuid(0, regs))) {
+				return;
+			}
+			sl_uint32 nMaxLeaf = regs[0];
+			if (!(cpuid(1, regs))) {
+				return;
+			}
+			sl_uint32 ecx1 = regs[2];
+			flagSSE41 = (ecx1 & (1 << 19)) != 0;
+			flagPCLMULQDQ = (ecx1 & (1 << 1)) != 0;
+			flagAESNI = (ecx1 & (1 << 25)) != 0;
+			if (nMaxLeaf >= 7 && cpuid(7, regs)) {
+				// AVX: the OS must save the YMM registers on the context switch (OSXSAVE, XCR0 bit 1, 2)
+				if ((ecx1 & (1 << 27)) && (ecx1 & (1 << 28)) && (xgetbv() & 6) == 6) {
+					flagAVX2 = (regs[1] & (1 << 5)) != 0;
+				}
+				flagSHA = (regs[1] & (1 << 29)) != 0;
+			}
+#endif
+		}
+
+#if defined(PRIV_SLIB_CPU_X86)
+		static sl_bool cpuid(sl_uint32 leaf, sl_uint32* regs)
+		{
+#	if defined(_MSC_VER)
+			int r[4];
+			__cpuidex(r, (int)leaf, 0);
+			regs[0] = (sl_uint32)(r[0]);
+			regs[1] = (sl_uint32)(r[1]);
+			regs[2] = (sl_uint32)(r[2]);
+			regs[3] = (sl_uint32)(r[3]);
+			return sl_true;
+#	else
+			if (leaf > __get_cpuid_max(0, sl_null)) {
+				return sl_false;
+			}
+			unsigned int eax, ebx, ecx, edx;
+			__cpuid_count(leaf, 0, eax, ebx, ecx, edx);
+			regs[0] = eax;
+			regs[1] = ebx;
+			regs[2] = ecx;
+			regs[3] = edx;
+			return sl_true;
+#	endif
+		}
+
+		static sl_uint64 xgetbv()
+		{
+#	if defined(_MSC_VER)
+			return (sl_uint64)(_xgetbv(0));
+#	else
+			sl_uint32 eax, edx;
+			__asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return ((sl_uint64)edx << 32) | eax;
+#	endif
+		}
+#endif
+
+	};
+
+	static const _priv_CPU_Features& _priv_CPU_getFeatures()
+	{
+		static _priv_CPU_Features features;
+		return features;
+	}
+
+
+	sl_bool CPU::isSSE41Supported()
+	{
+		return _priv_CPU_getFeatures().flagSSE41;
+	}
+
+	sl_bool CPU::isAVX2Supported()
+	{
+		return _priv_CPU_getFeatures().flagAVX2;
+	}
+
+	sl_bool CPU::isAESNISupported()
+	{
+		return _priv_CPU_getFeatures().flagAESNI;
+	}
+
+	sl_bool CPU::isPCLMULQDQSupported()
+	{
+		return _priv_CPU_getFeatures().flagPCLMULQDQ;
+	}
+
+	sl_bool CPU::isSHASupported()
+	{
+		return _priv_CPU_getFeatures().flagSHA;
+	}
+
+	sl_uint32 CPU::getProcessorsCount()
+	{
+#if defined(SLIB_PLATFORM_IS_WIN32)
+		SYSTEM_INFO si;
+		GetSystemInfo(&si);
+		sl_uint32 n = (sl_uint32)(si.dwNumberOfProcessors);
+#else
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		if (n < 1) {
+			return 1;
+		}
+		return (sl_uint32)n;
+	}
+
+}
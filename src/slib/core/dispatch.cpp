@@ -73,6 +73,23 @@ namespace slib
 	{
 	}
 
+	Ref<TimerWheelTask> Dispatcher::setTimeout(const Function<void()>& callback, sl_uint64 delay_ms)
+	{
+		if (callback.isNull()) {
+			return sl_null;
+		}
+		Ref<TimerWheel> wheel = TimerWheel::getDefault();
+		if (wheel.isNotNull()) {
+			return wheel->add(SLIB_BIND_WEAKREF(void(), Dispatcher, _dispatchExpired, this, callback), delay_ms);
+		}
+		return sl_null;
+	}
+
+	void Dispatcher::_dispatchExpired(const Function<void()>& callback)
+	{
+		dispatch(callback);
+	}
+
 
 /*************************************
 			DispatchLoop
@@ -112,6 +129,10 @@ namespace slib
 	{
 		Ref<DispatchLoop> ret = new DispatchLoop;
 		if (ret.isNotNull()) {
+			ret->m_timeTasks = TimerWheel::create();
+			if (ret->m_timeTasks.isNull()) {
+				return sl_null;
+			}
 			ret->m_thread = Thread::create(SLIB_FUNCTION_CLASS(DispatchLoop, _runLoop, ret.get()));
 			if (ret->m_thread.isNotNull()) {
 				ret->m_flagInit = sl_true;
@@ -140,8 +161,7 @@ namespace slib
 
 		m_queueTasks.removeAll();
 		
-		MutexLocker lockTime(&m_lockTimeTasks);
-		m_timeTasks.removeAll();
+		m_timeTasks->release();
 	}
 
 	void DispatchLoop::start()
@@ -203,43 +223,26 @@ namespace slib
 				return sl_true;
 			}
 		} else {
-			MutexLocker lock(&m_lockTimeTasks);
-			TimeTask tt;
-			tt.time = getElapsedMilliseconds() + delay_ms;
-			tt.task = task;
-			if (m_timeTasks.put(tt.time, tt, MapPutMode::AddAlways)) {
-				_wake();
-				return sl_true;
-			}
+			return setTimeout(task, delay_ms).isNotNull();
 		}
 		return sl_false;
 	}
 
-	sl_int32 DispatchLoop::_getTimeout_TimeTasks()
+	Ref<TimerWheelTask> DispatchLoop::setTimeout(const Function<void()>& task, sl_uint64 delay_ms)
 	{
-		MutexLocker lock(&m_lockTimeTasks);
-		sl_uint64 rel = getElapsedMilliseconds();
-		if (m_timeTasks.getCount() == 0) {
-			return -1;
+		if (!m_flagInit) {
+			return sl_null;
 		}
-		sl_int32 timeout = -1;
-		LinkedQueue< Function<void()> > tasks;
-		while (RedBlackTreeNode<sl_uint64, TimeTask>* node = m_timeTasks.getFirstNode()) {
-			if (rel >= node->data.key) {
-				tasks.push(node->data.value.task);
-				m_timeTasks.removeNode(node);
-			} else {
-				timeout = (sl_int32)(node->data.key - rel);
-				break;
-			}
+		Ref<TimerWheelTask> ret = m_timeTasks->add(task, delay_ms);
+		if (ret.isNotNull()) {
+			_wake();
 		}
-		lock.unlock();
+		return ret;
+	}
 
-		Function<void()> task;
-		while (tasks.pop(&task)) {
-			task();
-		}
-		return timeout;
+	sl_int32 DispatchLoop::_getTimeout_TimeTasks()
+	{
+		return m_timeTasks->process();
 	}
 
 	sl_int32 DispatchLoop::_getTimeout_Timer()
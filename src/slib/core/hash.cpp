@@ -10,21 +10,119 @@
 
 #include "slib/core/hash.h"
 #include "slib/core/hash_table.h"
+#include "slib/core/mio.h"
+#include "slib/core/math.h"
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
 
 namespace slib
 {
 	
-	// based on adler32
-	sl_uint32 HashBytes(const void* _buf, sl_size n) noexcept
-	{
-		#define PRIV_SLIB_MOD_ADLER 65521
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint32 a = 1, b = 0;
-		for (sl_size i = 0; i < n; i++) {
-			a = (a + buf[i]) % PRIV_SLIB_MOD_ADLER;
-			b = (b + a) % PRIV_SLIB_MOD_ADLER;
+	sl_uint32 HashBytes(const void* buf, sl_size n) noexcept
+	{
+		return (sl_uint32)(HashBytes64(buf, n));
+	}
+
+	#define PRIV_SLIB_WYHASH_P0 SLIB_UINT64(0xa0761d6478bd642f)
+	#define PRIV_SLIB_WYHASH_P1 SLIB_UINT64(0xe7037ed1a0b428db)
+	#define PRIV_SLIB_WYHASH_P2 SLIB_UINT64(0x8ebc6af09c88c6e3)
+	#define PRIV_SLIB_WYHASH_P3 SLIB_UINT64(0x589965cc75374cc3)
+
+	// 128-bit product of `a` and `b`: low 64 bits to `a`, high 64 bits to `b`
+	SLIB_INLINE static void _priv_wyhash_mum(sl_uint64& a, sl_uint64& b) noexcept
+	{
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 r = (unsigned __int128)a * b;
+		a = (sl_uint64)r;
+		b = (sl_uint64)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#else
+		sl_uint64 ha = a >> 32, hb = b >> 32, la = (sl_uint32)a, lb = (sl_uint32)b;
+		sl_uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+		sl_uint64 t = rl + (rm0 << 32);
+		sl_uint64 c = t < rl;
+		sl_uint64 lo = t + (rm1 << 32);
+		c += lo < t;
+		a = lo;
+		b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_wyhash_mix(sl_uint64 a, sl_uint64 b) noexcept
+	{
+		_priv_wyhash_mum(a, b);
+		return a ^ b;
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_wyhash_read8(const sl_uint8* p) noexcept
+	{
+		return MIO::readUint64LE(p);
+	}
+
+	SLIB_INLINE static sl_uint64 _priv_wyhash_read4(const sl_uint8* p) noexcept
+	{
+		return MIO::readUint32LE(p);
+	}
+
+	sl_uint64 HashBytes64(const void* _buf, sl_size n, sl_uint64 seed) noexcept
+	{
+		const sl_uint8* p = (const sl_uint8*)_buf;
+		seed ^= _priv_wyhash_mix(seed ^ PRIV_SLIB_WYHASH_P0, PRIV_SLIB_WYHASH_P1);
+		sl_uint64 a, b;
+		if (n <= 16) {
+			if (n >= 4) {
+				a = (_priv_wyhash_read4(p) << 32) | _priv_wyhash_read4(p + ((n >> 3) << 2));
+				b = (_priv_wyhash_read4(p + n - 4) << 32) | _priv_wyhash_read4(p + n - 4 - ((n >> 3) << 2));
+			} else if (n > 0) {
+				a = ((sl_uint64)(p[0]) << 16) | ((sl_uint64)(p[n >> 1]) << 8) | p[n - 1];
+				b = 0;
+			} else {
+				a = 0;
+				b = 0;
+			}
+		} else {
+			sl_size i = n;
+			if (i > 48) {
+				// three independent lanes
+				sl_uint64 seed1 = seed, seed2 = seed;
+				do {
+					seed = _priv_wyhash_mix(_priv_wyhash_read8(p) ^ PRIV_SLIB_WYHASH_P1, _priv_wyhash_read8(p + 8) ^ seed);
+					seed1 = _priv_wyhash_mix(_priv_wyhash_read8(p + 16) ^ PRIV_SLIB_WYHASH_P2, _priv_wyhash_read8(p + 24) ^ seed1);
+					seed2 = _priv_wyhash_mix(_priv_wyhash_read8(p + 32) ^ PRIV_SLIB_WYHASH_P3, _priv_wyhash_read8(p + 40) ^ seed2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= seed1 ^ seed2;
+			}
+			while (i > 16) {
+				seed = _priv_wyhash_mix(_priv_wyhash_read8(p) ^ PRIV_SLIB_WYHASH_P1, _priv_wyhash_read8(p + 8) ^ seed);
+				i -= 16;
+				p += 16;
+			}
+			// last 16 bytes (overlapping the processed bytes)
+			a = _priv_wyhash_read8(p + i - 16);
+			b = _priv_wyhash_read8(p + i - 8);
 		}
-		return Rehash((b << 16) | a);
+		a ^= PRIV_SLIB_WYHASH_P1;
+		b ^= seed;
+		_priv_wyhash_mum(a, b);
+		return _priv_wyhash_mix(a ^ PRIV_SLIB_WYHASH_P0 ^ n, b ^ PRIV_SLIB_WYHASH_P1);
+	}
+
+	static sl_uint64 _priv_Hash_generateSeed() noexcept
+	{
+		sl_uint64 seed = 0;
+		Math::randomMemory(&seed, sizeof(seed));
+		return seed;
+	}
+
+	sl_uint64 GetHashSeed() noexcept
+	{
+		static sl_uint64 seed = _priv_Hash_generateSeed();
+		return seed;
 	}
 
 	
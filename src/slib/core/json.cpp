@@ -17,6 +17,21 @@
 
 #include "slib/core/file.h"
 #include "slib/core/log.h"
+#include "slib/core/cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define PRIV_SLIB_JSON_SIMD
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		include <intrin.h>
+#		define PRIV_SLIB_JSON_AVX2_FUNC static
+#	else
+#		define PRIV_SLIB_JSON_AVX2_FUNC static __attribute__((target("avx2")))
+#	endif
+#endif
+
+// smaller documents are parsed by `_Json_Parser` directly
+#define PRIV_SLIB_JSON_INDEX_MIN_SIZE 4096
 
 namespace slib
 {
@@ -633,8 +648,455 @@ namespace slib
 	}
 
 
+	/*
+		Structural index (two-stage parsing for the large documents)
+
+		Stage 1 classifies each 64 bytes block into the bit masks of quotes, backslashes, operators ({}[]:,) and white spaces.
+		The escaped quotes are found from the odd-length backslash sequences, and the string ranges from the prefix XOR of the quotes,
+		then the positions of the operators, the opening quotes and the first characters of the other tokens are recorded.
+		Stage 2 builds the `Json` from the positions, slicing the strings and the literals without scanning the characters again.
+		The documents having comments, single quotes or anything else than strict JSON are parsed again by `_Json_Parser`,
+		which also reports the errors.
+	*/
+
+	class _priv_Json_BlockMasks
+	{
+	public:
+		sl_uint64 quote;
+		sl_uint64 backslash;
+		sl_uint64 op;
+		sl_uint64 space;
+		// comments and single quotes
+		sl_uint64 extra;
+	};
+
+	class _priv_Json_StructuralIndex
+	{
+	public:
+		Memory memory;
+		sl_uint32* positions;
+		sl_size count;
+		sl_size capacity;
+
+		// carried between the blocks
+		sl_uint64 prevOddBackslash;
+		sl_uint64 prevInString;
+		sl_uint64 prevPseudoPred;
+
+	public:
+		_priv_Json_StructuralIndex()
+		{
+			positions = sl_null;
+			count = 0;
+			capacity = 0;
+			prevOddBackslash = 0;
+			prevInString = 0;
+			// the beginning of the document is a token boundary
+			prevPseudoPred = 1;
+		}
+
+	public:
+		sl_bool reserve(sl_size n)
+		{
+			if (count + n <= capacity) {
+				return sl_true;
+			}
+			sl_size newCapacity = capacity ? capacity * 2 : 4096;
+			if (newCapacity < count + n) {
+				newCapacity = count + n;
+			}
+			Memory mem = Memory::create(newCapacity * sizeof(sl_uint32));
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			if (count) {
+				Base::copyMemory(mem.getData(), positions, count * sizeof(sl_uint32));
+			}
+			memory = mem;
+			positions = (sl_uint32*)(mem.getData());
+			capacity = newCapacity;
+			return sl_true;
+		}
+
+		SLIB_INLINE static sl_uint32 getFirstBit(sl_uint64 bits)
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			if ((sl_uint32)bits) {
+				_BitScanForward(&index, (sl_uint32)bits);
+				return (sl_uint32)index;
+			} else {
+				_BitScanForward(&index, (sl_uint32)(bits >> 32));
+				return (sl_uint32)index + 32;
+			}
+#else
+			return (sl_uint32)(__builtin_ctzll(bits));
+#endif
+		}
+
+		// returns `sl_false` when the block has comments or single quotes outside of the strings
+		SLIB_INLINE sl_bool addBlock(sl_uint32 offset, const _priv_Json_BlockMasks& m)
+		{
+			const sl_uint64 evenBits = SLIB_UINT64(0x5555555555555555);
+			const sl_uint64 oddBits = ~evenBits;
+
+			// characters escaped by the odd-length backslash sequences
+			sl_uint64 bs = m.backslash;
+			sl_uint64 startEdges = bs & ~(bs << 1);
+			sl_uint64 evenStartMask = evenBits ^ prevOddBackslash;
+			sl_uint64 evenStarts = startEdges & evenStartMask;
+			sl_uint64 oddStarts = startEdges & ~evenStartMask;
+			sl_uint64 evenCarries = bs + evenStarts;
+			sl_uint64 oddCarries = bs + oddStarts;
+			sl_uint64 flagOverflow = oddCarries < bs ? 1 : 0;
+			oddCarries |= prevOddBackslash;
+			prevOddBackslash = flagOverflow;
+			sl_uint64 oddEnds = ((evenCarries & ~bs) & oddBits) | ((oddCarries & ~bs) & evenBits);
+
+			// string ranges: from the opening quote (inclusive) to the closing quote (exclusive)
+			sl_uint64 quoteBits = m.quote & ~oddEnds;
+			sl_uint64 inString = quoteBits;
+			inString ^= inString << 1;
+			inString ^= inString << 2;
+			inString ^= inString << 4;
+			inString ^= inString << 8;
+			inString ^= inString << 16;
+			inString ^= inString << 32;
+			inString ^= prevInString;
+			prevInString = (sl_uint64)((sl_int64)inString >> 63);
+
+			if (m.extra & ~inString) {
+				return sl_false;
+			}
+
+			sl_uint64 structurals = (m.op & ~inString) | quoteBits;
+			// first characters of the literals and numbers
+			sl_uint64 pseudoPred = structurals | m.space;
+			sl_uint64 shiftedPseudoPred = (pseudoPred << 1) | prevPseudoPred;
+			prevPseudoPred = pseudoPred >> 63;
+			structurals |= shiftedPseudoPred & ~(m.space) & ~inString;
+			// closing quotes
+			structurals &= ~(quoteBits & ~inString);
+
+			sl_uint32* p = positions + count;
+			while (structurals) {
+				*(p++) = offset + getFirstBit(structurals);
+				structurals &= structurals - 1;
+			}
+			count = p - positions;
+			return sl_true;
+		}
+
+	};
+
+	SLIB_INLINE static void _priv_Json_classifyBlock(const sl_uint8* p, _priv_Json_BlockMasks& m)
+	{
+		m.quote = 0;
+		m.backslash = 0;
+		m.op = 0;
+		m.space = 0;
+		m.extra = 0;
+		for (sl_uint32 i = 0; i < 64; i++) {
+			sl_uint64 bit = ((sl_uint64)1) << i;
+			switch (p[i]) {
+				case '"':
+					m.quote |= bit;
+					break;
+				case '\\':
+					m.backslash |= bit;
+					break;
+				case '{':
+				case '}':
+				case '[':
+				case ']':
+				case ':':
+				case ',':
+					m.op |= bit;
+					break;
+				case ' ':
+				case '\t':
+				case '\r':
+				case '\n':
+					m.space |= bit;
+					break;
+				case '/':
+				case '\'':
+					m.extra |= bit;
+					break;
+			}
+		}
+	}
+
+#if defined(PRIV_SLIB_JSON_SIMD)
+	PRIV_SLIB_JSON_AVX2_FUNC void _priv_Json_classifyBlock_AVX2(const sl_uint8* p, _priv_Json_BlockMasks& m)
+	{
+		sl_uint64 quote[2], backslash[2], op[2], space[2], extra[2];
+		for (sl_uint32 k = 0; k < 2; k++) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)(p + (k << 5)));
+			// '[' | 0x20 = '{', ']' | 0x20 = '}'
+			__m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+			quote[k] = (sl_uint32)(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))));
+			backslash[k] = (sl_uint32)(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+			__m256i t = _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}')));
+			t = _mm256_or_si256(t, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+			op[k] = (sl_uint32)(_mm256_movemask_epi8(t));
+			t = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+			t = _mm256_or_si256(t, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+			space[k] = (sl_uint32)(_mm256_movemask_epi8(t));
+			t = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+			extra[k] = (sl_uint32)(_mm256_movemask_epi8(t));
+		}
+		m.quote = quote[0] | (quote[1] << 32);
+		m.backslash = backslash[0] | (backslash[1] << 32);
+		m.op = op[0] | (op[1] << 32);
+		m.space = space[0] | (space[1] << 32);
+		m.extra = extra[0] | (extra[1] << 32);
+	}
+#endif
+
+#define PRIV_SLIB_JSON_DEFINE_BUILD_INDEX(NAME, ATTR, CLASSIFY) \
+	ATTR sl_bool NAME(const sl_uint8* buf, sl_size len, _priv_Json_StructuralIndex& index) \
+	{ \
+		_priv_Json_BlockMasks masks; \
+		sl_size offset = 0; \
+		for (; offset + 64 <= len; offset += 64) { \
+			if (!(index.reserve(64))) { \
+				return sl_false; \
+			} \
+			CLASSIFY(buf + offset, masks); \
+			if (!(index.addBlock((sl_uint32)offset, masks))) { \
+				return sl_false; \
+			} \
+		} \
+		if (offset < len) { \
+			/* the last block is padded by white spaces */ \
+			sl_uint8 block[64]; \
+			Base::resetMemory(block, ' ', 64); \
+			Base::copyMemory(block, buf + offset, len - offset); \
+			if (!(index.reserve(64))) { \
+				return sl_false; \
+			} \
+			CLASSIFY(block, masks); \
+			if (!(index.addBlock((sl_uint32)offset, masks))) { \
+				return sl_false; \
+			} \
+		} \
+		/* unterminated string */ \
+		return !(index.prevInString); \
+	}
+
+	PRIV_SLIB_JSON_DEFINE_BUILD_INDEX(_priv_Json_buildIndex_Generic, static, _priv_Json_classifyBlock)
+
+#if defined(PRIV_SLIB_JSON_SIMD)
+	PRIV_SLIB_JSON_DEFINE_BUILD_INDEX(_priv_Json_buildIndex_AVX2, PRIV_SLIB_JSON_AVX2_FUNC, _priv_Json_classifyBlock_AVX2)
+#endif
+
+	static sl_bool _priv_Json_buildIndex(const sl_uint8* buf, sl_size len, _priv_Json_StructuralIndex& index)
+	{
+#if defined(PRIV_SLIB_JSON_SIMD)
+		if (CPU::isAVX2Supported()) {
+			return _priv_Json_buildIndex_AVX2(buf, len, index);
+		}
+#endif
+		return _priv_Json_buildIndex_Generic(buf, len, index);
+	}
+
+	class _priv_Json_IndexParser
+	{
+	public:
+		const sl_char8* buf;
+		sl_size len;
+		const sl_uint32* positions;
+		sl_size count;
+		sl_size current;
+
+	public:
+		// end of the token starting at `positions[current - 1]`
+		SLIB_INLINE sl_size getTokenEnd()
+		{
+			sl_size end = current < count ? positions[current] : len;
+			while (end > 0 && SLIB_CHAR_IS_WHITE_SPACE(buf[end - 1])) {
+				end--;
+			}
+			return end;
+		}
+
+		sl_bool parseString(sl_size start, String& _out)
+		{
+			sl_size end = getTokenEnd();
+			if (end < start + 2 || buf[end - 1] != '"') {
+				return sl_false;
+			}
+			const sl_char8* s = buf + start + 1;
+			sl_size n = end - start - 2;
+			if (!(Base::findMemory(s, '\\', n))) {
+				_out = String(s, n);
+				return sl_true;
+			}
+			sl_size m = 0;
+			sl_bool flagError = sl_false;
+			_out = ParseUtil::parseBackslashEscapes(buf + start, end - start, &m, &flagError);
+			return !flagError && m == end - start;
+		}
+
+		sl_bool parseValue(Json& _out)
+		{
+			if (current >= count) {
+				return sl_false;
+			}
+			sl_size start = positions[current++];
+			sl_char8 first = buf[start];
+			if (first == '"') {
+				String str;
+				if (!(parseString(start, str))) {
+					return sl_false;
+				}
+				_out = str;
+				return sl_true;
+			}
+			if (first == '[') {
+				VariantList list = VariantList::create();
+				if (current < count && buf[positions[current]] == ']') {
+					current++;
+					_out = list;
+					return sl_true;
+				}
+				for (;;) {
+					Json item;
+					if (!(parseValue(item))) {
+						return sl_false;
+					}
+					list.add_NoLock(item);
+					if (current >= count) {
+						return sl_false;
+					}
+					sl_char8 ch = buf[positions[current++]];
+					if (ch == ']') {
+						break;
+					}
+					if (ch != ',') {
+						return sl_false;
+					}
+				}
+				_out = list;
+				return sl_true;
+			}
+			if (first == '{') {
+				VariantMap map = VariantMap::createHash();
+				if (current < count && buf[positions[current]] == '}') {
+					current++;
+					_out = map;
+					return sl_true;
+				}
+				for (;;) {
+					if (current + 1 >= count) {
+						return sl_false;
+					}
+					sl_size posKey = positions[current++];
+					if (buf[posKey] != '"') {
+						return sl_false;
+					}
+					String key;
+					if (!(parseString(posKey, key))) {
+						return sl_false;
+					}
+					if (buf[positions[current++]] != ':') {
+						return sl_false;
+					}
+					Json item;
+					if (!(parseValue(item))) {
+						return sl_false;
+					}
+					map.put_NoLock(key, item);
+					if (current >= count) {
+						return sl_false;
+					}
+					sl_char8 ch = buf[positions[current++]];
+					if (ch == '}') {
+						break;
+					}
+					if (ch != ',') {
+						return sl_false;
+					}
+				}
+				_out = map;
+				return sl_true;
+			}
+			if (first == ']' || first == '}' || first == ':' || first == ',') {
+				return sl_false;
+			}
+			// literals and numbers
+			sl_size end = getTokenEnd();
+			const sl_char8* s = buf + start;
+			sl_size n = end - start;
+			if (n == 4 && s[0] == 'n' && s[1] == 'u' && s[2] == 'l' && s[3] == 'l') {
+				_out = sl_null;
+				return sl_true;
+			}
+			if (n == 4 && s[0] == 't' && s[1] == 'r' && s[2] == 'u' && s[3] == 'e') {
+				_out = Variant::fromBoolean(sl_true);
+				return sl_true;
+			}
+			if (n == 5 && s[0] == 'f' && s[1] == 'a' && s[2] == 'l' && s[3] == 's' && s[4] == 'e') {
+				_out = Variant::fromBoolean(sl_false);
+				return sl_true;
+			}
+			sl_int64 vi64;
+			if (String::parseInt64(10, &vi64, s, 0, n) == (sl_reg)n) {
+				if (vi64 >= SLIB_INT64(-0x80000000) && vi64 < SLIB_INT64(0x7fffffff)) {
+					_out = (sl_int32)vi64;
+				} else {
+					_out = vi64;
+				}
+				return sl_true;
+			}
+			double vf;
+			if (String::parseDouble(&vf, s, 0, n) == (sl_reg)n) {
+				_out = vf;
+				return sl_true;
+			}
+			return sl_false;
+		}
+
+		// returns `sl_false` when the document must be parsed by `_Json_Parser`
+		static sl_bool parse(const sl_char8* buf, sl_size len, Json& _out)
+		{
+			if (len > 0xffffffff) {
+				return sl_false;
+			}
+			_priv_Json_StructuralIndex index;
+			if (!(index.reserve(len / 8 + 64))) {
+				return sl_false;
+			}
+			if (!(_priv_Json_buildIndex((const sl_uint8*)buf, len, index))) {
+				return sl_false;
+			}
+			if (!(index.count)) {
+				return sl_false;
+			}
+			_priv_Json_IndexParser parser;
+			parser.buf = buf;
+			parser.len = len;
+			parser.positions = index.positions;
+			parser.count = index.count;
+			parser.current = 0;
+			if (!(parser.parseValue(_out))) {
+				return sl_false;
+			}
+			return parser.current == parser.count;
+		}
+
+	};
+
 	Json Json::parseJson(const sl_char8* sz, sl_size len, JsonParseParam& param)
 	{
+		if (len >= PRIV_SLIB_JSON_INDEX_MIN_SIZE) {
+			Json ret;
+			if (_priv_Json_IndexParser::parse(sz, len, ret)) {
+				param.flagError = sl_false;
+				return ret;
+			}
+		}
 		return _Json_Parser<String, sl_char8>::parseJson(sz, len, param);
 	}
 
@@ -646,7 +1108,7 @@ namespace slib
 
 	Json Json::parseJson(const String& json, JsonParseParam& param)
 	{
-		return _Json_Parser<String, sl_char8>::parseJson(json.getData(), json.getLength(), param);
+		return parseJson(json.getData(), json.getLength(), param);
 	}
 
 	Json Json::parseJson(const String& json)
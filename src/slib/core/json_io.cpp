@@ -0,0 +1,1166 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/json_io.h"
+
+#include "slib/core/async.h"
+#include "slib/core/map.h"
+#include "slib/core/math.h"
+
+namespace slib
+{
+
+/**********************************************
+				JsonReader
+**********************************************/
+
+	JsonReader::JsonReader()
+	{
+		m_reader = sl_null;
+		m_flagSupportComments = sl_true;
+		_reset();
+	}
+
+	JsonReader::~JsonReader()
+	{
+	}
+
+	void JsonReader::_reset()
+	{
+		m_data = sl_null;
+		m_pos = 0;
+		m_end = 0;
+		m_offsetData = 0;
+
+		m_token = JsonToken::None;
+		m_stack.setNull();
+		m_flagNeedComma = sl_false;
+		m_flagExpectValue = sl_false;
+
+		m_value = sl_null;
+		m_lenValue = 0;
+		m_valueBoolean = sl_false;
+		m_flagValueInteger = sl_false;
+		m_valueInt64 = 0;
+		m_valueDouble = 0;
+
+		m_errorMessage.setNull();
+		m_errorPosition = 0;
+	}
+
+	void JsonReader::setInput(const void* data, sl_size size)
+	{
+		_reset();
+		m_input.setNull();
+		m_inputText.setNull();
+		m_reader = sl_null;
+		m_bufferInput.setNull();
+		m_data = (const sl_char8*)data;
+		m_end = size;
+	}
+
+	void JsonReader::setInput(const String& text)
+	{
+		setInput(text.getData(), text.getLength());
+		m_inputText = text;
+	}
+
+	void JsonReader::setInput(const Memory& mem)
+	{
+		setInput(mem.getData(), mem.getSize());
+		m_input = mem;
+	}
+
+	void JsonReader::setInput(IReader* reader, sl_size sizeBuffer)
+	{
+		_reset();
+		m_input.setNull();
+		m_inputText.setNull();
+		m_reader = reader;
+		if (sizeBuffer < 64) {
+			sizeBuffer = 64;
+		}
+		m_bufferInput = Memory::create(sizeBuffer);
+	}
+
+	void JsonReader::setSupportComments(sl_bool flag)
+	{
+		m_flagSupportComments = flag;
+	}
+
+	sl_bool JsonReader::_fill()
+	{
+		if (!m_reader || m_bufferInput.isNull()) {
+			return sl_false;
+		}
+		m_offsetData += m_end;
+		m_data = (const sl_char8*)(m_bufferInput.getData());
+		m_pos = 0;
+		m_end = 0;
+		sl_reg n = m_reader->read(m_bufferInput.getData(), m_bufferInput.getSize());
+		if (n <= 0) {
+			return sl_false;
+		}
+		m_end = (sl_size)n;
+		return sl_true;
+	}
+
+	SLIB_INLINE sl_bool JsonReader::_peek(sl_char8& ch)
+	{
+		if (m_pos < m_end || _fill()) {
+			ch = m_data[m_pos];
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	sl_bool JsonReader::_skipSpaceAndComments(sl_char8& ch)
+	{
+		while (_peek(ch)) {
+			if (SLIB_CHAR_IS_WHITE_SPACE(ch)) {
+				m_pos++;
+				continue;
+			}
+			if (ch != '/' || !m_flagSupportComments) {
+				return sl_true;
+			}
+			m_pos++;
+			if (!(_peek(ch))) {
+				_setError("Invalid token");
+				return sl_false;
+			}
+			m_pos++;
+			if (ch == '/') {
+				while (_peek(ch)) {
+					m_pos++;
+					if (ch == '\r' || ch == '\n') {
+						break;
+					}
+				}
+			} else if (ch == '*') {
+				sl_bool flagStar = sl_false;
+				for (;;) {
+					if (!(_peek(ch))) {
+						_setError("Comment: Missing */");
+						return sl_false;
+					}
+					m_pos++;
+					if (flagStar && ch == '/') {
+						break;
+					}
+					flagStar = ch == '*';
+				}
+			} else {
+				_setError("Invalid token");
+				return sl_false;
+			}
+		}
+		return sl_false;
+	}
+
+	JsonToken JsonReader::next()
+	{
+		if (m_token == JsonToken::Error) {
+			return JsonToken::Error;
+		}
+		sl_size depth = m_stack.getCount();
+		sl_char8 ch;
+		if (!(_skipSpaceAndComments(ch))) {
+			if (m_token == JsonToken::Error) {
+				return JsonToken::Error;
+			}
+			if (depth) {
+				if (m_flagExpectValue) {
+					return _setError("Object: Missing Item value");
+				}
+				return _setError(m_stack.getData()[depth - 1] ? "Object: Missing character } " : "Array: Missing character ] ");
+			}
+			m_token = JsonToken::End;
+			return JsonToken::End;
+		}
+		if (!depth) {
+			// top-level values are read one after another (NDJSON)
+			return _readValue(ch);
+		}
+		if (m_flagExpectValue) {
+			m_flagExpectValue = sl_false;
+			return _readValue(ch);
+		}
+		sl_bool flagObject = m_stack.getData()[depth - 1];
+		sl_char8 chEnd = flagObject ? '}' : ']';
+		if (m_flagNeedComma && ch == ',') {
+			m_pos++;
+			if (!(_skipSpaceAndComments(ch))) {
+				if (m_token == JsonToken::Error) {
+					return JsonToken::Error;
+				}
+				return _setError(flagObject ? "Object: Missing character } " : "Array: Missing character ] ");
+			}
+		} else if (m_flagNeedComma && ch != chEnd) {
+			return _setError(flagObject ? "Object: Missing character , " : "Array: Missing character , ");
+		}
+		if (ch == chEnd) {
+			m_pos++;
+			m_stack.popBack_NoLock();
+			m_flagNeedComma = sl_true;
+			m_token = flagObject ? JsonToken::EndObject : JsonToken::EndArray;
+			return m_token;
+		}
+		if (!flagObject) {
+			return _readValue(ch);
+		}
+		// name of the object member
+		if (ch == '"' || ch == '\'') {
+			m_pos++;
+			if (!(_readString(ch))) {
+				return JsonToken::Error;
+			}
+		} else {
+			_readToken(sl_true);
+			if (!m_lenValue) {
+				return _setError("Object Item Name: Invalid character");
+			}
+		}
+		if (!(_skipSpaceAndComments(ch))) {
+			if (m_token == JsonToken::Error) {
+				return JsonToken::Error;
+			}
+			return _setError("Object: Missing character : ");
+		}
+		if (ch != ':') {
+			return _setError("Object: Missing character : ");
+		}
+		m_pos++;
+		m_flagExpectValue = sl_true;
+		m_token = JsonToken::Key;
+		return JsonToken::Key;
+	}
+
+	JsonToken JsonReader::_readValue(sl_char8 first)
+	{
+		if (first == '{' || first == '[') {
+			m_pos++;
+			sl_bool flagObject = first == '{';
+			if (!(m_stack.add_NoLock(flagObject))) {
+				return _setError("Out of memory");
+			}
+			m_flagNeedComma = sl_false;
+			m_token = flagObject ? JsonToken::BeginObject : JsonToken::BeginArray;
+			return m_token;
+		}
+		m_flagNeedComma = sl_true;
+		if (first == '"' || first == '\'') {
+			m_pos++;
+			if (!(_readString(first))) {
+				return JsonToken::Error;
+			}
+			m_token = JsonToken::String;
+			return JsonToken::String;
+		}
+		return _readBareToken();
+	}
+
+	sl_bool JsonReader::_readString(sl_char8 chEnd)
+	{
+		m_value = sl_null;
+		m_lenValue = 0;
+		if (!m_reader) {
+			// the whole text is in memory: refers the input when the string has no escape
+			sl_size i = m_pos;
+			while (i < m_end) {
+				sl_char8 ch = m_data[i];
+				if (ch == chEnd) {
+					m_value = m_data + m_pos;
+					m_lenValue = i - m_pos;
+					m_pos = i + 1;
+					return sl_true;
+				}
+				if (ch == '\\') {
+					break;
+				}
+				i++;
+			}
+		}
+		for (;;) {
+			if (m_pos >= m_end && !(_fill())) {
+				_setError("String: Missing character  \" or ' ");
+				return sl_false;
+			}
+			sl_size start = m_pos;
+			sl_size i = start;
+			sl_char8 ch = 0;
+			while (i < m_end) {
+				ch = m_data[i];
+				if (ch == chEnd || ch == '\\') {
+					break;
+				}
+				i++;
+			}
+			if (i > start) {
+				if (!(_appendValue(m_data + start, i - start))) {
+					_setError("Out of memory");
+					return sl_false;
+				}
+			}
+			m_pos = i;
+			if (i == m_end) {
+				continue;
+			}
+			m_pos++;
+			if (ch == chEnd) {
+				m_value = (const sl_char8*)(m_bufferValue.getData());
+				return sl_true;
+			}
+			if (!(_peek(ch))) {
+				_setError("String: Missing character  \" or ' ");
+				return sl_false;
+			}
+			m_pos++;
+			sl_uint32 code = 0;
+			switch (ch) {
+				case '"':
+				case '\'':
+				case '\\':
+				case '/':
+					break;
+				case 'n':
+					ch = '\n';
+					break;
+				case 'r':
+					ch = '\r';
+					break;
+				case 't':
+					ch = '\t';
+					break;
+				case 'b':
+					ch = '\b';
+					break;
+				case 'f':
+					ch = '\f';
+					break;
+				case 'a':
+					ch = '\a';
+					break;
+				case 'v':
+					ch = '\v';
+					break;
+				case '0':
+					ch = 0;
+					break;
+				case 'x':
+				case 'u':
+					{
+						sl_uint32 nDigits = ch == 'x' ? 2 : 4;
+						for (sl_uint32 k = 0; k < nDigits; k++) {
+							sl_uint32 h = 16;
+							if (_peek(ch)) {
+								h = SLIB_CHAR_HEX_TO_INT(ch);
+							}
+							if (h >= 16) {
+								_setError("String: Invalid escape sequence");
+								return sl_false;
+							}
+							m_pos++;
+							code = (code << 4) | h;
+						}
+						if (nDigits == 2) {
+							ch = (sl_char8)code;
+							break;
+						}
+						if (code >= 0xD800 && code < 0xDC00) {
+							// surrogate pair
+							sl_uint32 low = 0;
+							if (!(_peek(ch)) || ch != '\\') {
+								_setError("String: Invalid surrogate pair");
+								return sl_false;
+							}
+							m_pos++;
+							if (!(_peek(ch)) || ch != 'u') {
+								_setError("String: Invalid surrogate pair");
+								return sl_false;
+							}
+							m_pos++;
+							for (sl_uint32 k = 0; k < 4; k++) {
+								sl_uint32 h = 16;
+								if (_peek(ch)) {
+									h = SLIB_CHAR_HEX_TO_INT(ch);
+								}
+								if (h >= 16) {
+									_setError("String: Invalid escape sequence");
+									return sl_false;
+								}
+								m_pos++;
+								low = (low << 4) | h;
+							}
+							if (low < 0xDC00 || low >= 0xE000) {
+								_setError("String: Invalid surrogate pair");
+								return sl_false;
+							}
+							code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+						}
+						if (!(_appendUtf8(code))) {
+							_setError("Out of memory");
+							return sl_false;
+						}
+						continue;
+					}
+				default:
+					_setError("String: Invalid escape sequence");
+					return sl_false;
+			}
+			if (!(_appendValue(&ch, 1))) {
+				_setError("Out of memory");
+				return sl_false;
+			}
+		}
+	}
+
+	void JsonReader::_readToken(sl_bool flagIdentifier)
+	{
+		m_value = sl_null;
+		m_lenValue = 0;
+		for (;;) {
+			if (m_pos >= m_end && !(_fill())) {
+				break;
+			}
+			sl_size start = m_pos;
+			sl_size i = start;
+			while (i < m_end) {
+				sl_char8 ch = m_data[i];
+				if (flagIdentifier) {
+					if (!((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '_' || ((i != start || m_lenValue) && ch >= '0' && ch <= '9'))) {
+						break;
+					}
+				} else {
+					if (ch == '\r' || ch == '\n' || ch == ' ' || ch == '\t' || ch == '/' || ch == ']' || ch == '}' || ch == ',') {
+						break;
+					}
+				}
+				i++;
+			}
+			m_pos = i;
+			if (!m_reader) {
+				m_value = m_data + start;
+				m_lenValue = i - start;
+				return;
+			}
+			if (i > start) {
+				if (!(_appendValue(m_data + start, i - start))) {
+					m_lenValue = 0;
+					return;
+				}
+			}
+			if (i < m_end) {
+				break;
+			}
+		}
+		m_value = (const sl_char8*)(m_bufferValue.getData());
+	}
+
+	JsonToken JsonReader::_readBareToken()
+	{
+		_readToken(sl_false);
+		const sl_char8* s = m_value;
+		sl_size n = m_lenValue;
+		if (!n) {
+			return _setError("Invalid token");
+		}
+		if (n == 4 && s[0] == 'n' && s[1] == 'u' && s[2] == 'l' && s[3] == 'l') {
+			m_token = JsonToken::Null;
+			return JsonToken::Null;
+		}
+		if (n == 4 && s[0] == 't' && s[1] == 'r' && s[2] == 'u' && s[3] == 'e') {
+			m_valueBoolean = sl_true;
+			m_token = JsonToken::Boolean;
+			return JsonToken::Boolean;
+		}
+		if (n == 5 && s[0] == 'f' && s[1] == 'a' && s[2] == 'l' && s[3] == 's' && s[4] == 'e') {
+			m_valueBoolean = sl_false;
+			m_token = JsonToken::Boolean;
+			return JsonToken::Boolean;
+		}
+		if (String::parseInt64(10, &m_valueInt64, s, 0, n) == (sl_reg)n) {
+			m_flagValueInteger = sl_true;
+			m_valueDouble = (double)m_valueInt64;
+			m_token = JsonToken::Number;
+			return JsonToken::Number;
+		}
+		if (String::parseDouble(&m_valueDouble, s, 0, n) == (sl_reg)n) {
+			m_flagValueInteger = sl_false;
+			m_token = JsonToken::Number;
+			return JsonToken::Number;
+		}
+		return _setError("Invalid token");
+	}
+
+	sl_bool JsonReader::_appendValue(const sl_char8* data, sl_size size)
+	{
+		sl_size capacity = m_bufferValue.getSize();
+		if (m_lenValue + size > capacity) {
+			capacity = capacity ? capacity * 2 : 256;
+			if (capacity < m_lenValue + size) {
+				capacity = m_lenValue + size;
+			}
+			Memory mem = Memory::create(capacity);
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			if (m_lenValue) {
+				Base::copyMemory(mem.getData(), m_bufferValue.getData(), m_lenValue);
+			}
+			m_bufferValue = mem;
+		}
+		Base::copyMemory((sl_char8*)(m_bufferValue.getData()) + m_lenValue, data, size);
+		m_lenValue += size;
+		return sl_true;
+	}
+
+	sl_bool JsonReader::_appendUtf8(sl_uint32 code)
+	{
+		sl_char8 buf[4];
+		sl_size n;
+		if (code < 0x80) {
+			buf[0] = (sl_char8)code;
+			n = 1;
+		} else if (code < 0x800) {
+			buf[0] = (sl_char8)(0xC0 | (code >> 6));
+			buf[1] = (sl_char8)(0x80 | (code & 0x3F));
+			n = 2;
+		} else if (code < 0x10000) {
+			buf[0] = (sl_char8)(0xE0 | (code >> 12));
+			buf[1] = (sl_char8)(0x80 | ((code >> 6) & 0x3F));
+			buf[2] = (sl_char8)(0x80 | (code & 0x3F));
+			n = 3;
+		} else {
+			buf[0] = (sl_char8)(0xF0 | (code >> 18));
+			buf[1] = (sl_char8)(0x80 | ((code >> 12) & 0x3F));
+			buf[2] = (sl_char8)(0x80 | ((code >> 6) & 0x3F));
+			buf[3] = (sl_char8)(0x80 | (code & 0x3F));
+			n = 4;
+		}
+		return _appendValue(buf, n);
+	}
+
+	JsonToken JsonReader::_setError(const char* message)
+	{
+		m_token = JsonToken::Error;
+		m_errorMessage = message;
+		m_errorPosition = m_offsetData + m_pos;
+		return JsonToken::Error;
+	}
+
+	JsonToken JsonReader::getToken()
+	{
+		return m_token;
+	}
+
+	sl_size JsonReader::getDepth()
+	{
+		return m_stack.getCount();
+	}
+
+	const sl_char8* JsonReader::getStringData()
+	{
+		return m_value;
+	}
+
+	sl_size JsonReader::getStringLength()
+	{
+		return m_lenValue;
+	}
+
+	String JsonReader::getString()
+	{
+		if (m_token == JsonToken::Key || m_token == JsonToken::String || m_token == JsonToken::Number) {
+			return String(m_value, m_lenValue);
+		}
+		return sl_null;
+	}
+
+	sl_bool JsonReader::getBoolean()
+	{
+		return m_token == JsonToken::Boolean && m_valueBoolean;
+	}
+
+	sl_bool JsonReader::getInt64(sl_int64* _out)
+	{
+		if (m_token == JsonToken::Number && m_flagValueInteger) {
+			if (_out) {
+				*_out = m_valueInt64;
+			}
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	sl_int64 JsonReader::getInt64(sl_int64 def)
+	{
+		if (m_token == JsonToken::Number) {
+			if (m_flagValueInteger) {
+				return m_valueInt64;
+			}
+			return (sl_int64)m_valueDouble;
+		}
+		return def;
+	}
+
+	double JsonReader::getDouble(double def)
+	{
+		if (m_token == JsonToken::Number) {
+			return m_valueDouble;
+		}
+		return def;
+	}
+
+	Json JsonReader::readValue()
+	{
+		switch (m_token) {
+			case JsonToken::BeginObject:
+				{
+					VariantMap map = VariantMap::createHash();
+					for (;;) {
+						JsonToken token = next();
+						if (token == JsonToken::EndObject) {
+							return map;
+						}
+						if (token != JsonToken::Key) {
+							return sl_null;
+						}
+						String key(m_value, m_lenValue);
+						next();
+						Json item = readValue();
+						if (m_token == JsonToken::Error) {
+							return sl_null;
+						}
+						map.put_NoLock(key, item);
+					}
+				}
+			case JsonToken::BeginArray:
+				{
+					VariantList list = VariantList::create();
+					for (;;) {
+						JsonToken token = next();
+						if (token == JsonToken::EndArray) {
+							return list;
+						}
+						if (token == JsonToken::Error || token == JsonToken::End) {
+							return sl_null;
+						}
+						Json item = readValue();
+						if (m_token == JsonToken::Error) {
+							return sl_null;
+						}
+						list.add_NoLock(item);
+					}
+				}
+			case JsonToken::String:
+				return String(m_value, m_lenValue);
+			case JsonToken::Number:
+				if (m_flagValueInteger) {
+					if (m_valueInt64 >= SLIB_INT64(-0x80000000) && m_valueInt64 < SLIB_INT64(0x7fffffff)) {
+						return (sl_int32)m_valueInt64;
+					} else {
+						return m_valueInt64;
+					}
+				}
+				return m_valueDouble;
+			case JsonToken::Boolean:
+				return Variant::fromBoolean(m_valueBoolean);
+			default:
+				return sl_null;
+		}
+	}
+
+	sl_bool JsonReader::skipValue()
+	{
+		if (m_token == JsonToken::Key) {
+			next();
+		}
+		if (m_token == JsonToken::BeginObject || m_token == JsonToken::BeginArray) {
+			sl_size depth = m_stack.getCount();
+			while (m_stack.getCount() >= depth) {
+				JsonToken token = next();
+				if (token == JsonToken::Error || token == JsonToken::End) {
+					return sl_false;
+				}
+			}
+			return sl_true;
+		}
+		return m_token != JsonToken::Error && m_token != JsonToken::End && m_token != JsonToken::None;
+	}
+
+	sl_bool JsonReader::isError()
+	{
+		return m_token == JsonToken::Error;
+	}
+
+	String JsonReader::getErrorMessage()
+	{
+		return m_errorMessage;
+	}
+
+	sl_uint64 JsonReader::getErrorPosition()
+	{
+		return m_errorPosition;
+	}
+
+/**********************************************
+				JsonWriter
+**********************************************/
+
+	JsonWriter::JsonWriter()
+	{
+		m_writer = sl_null;
+		m_output = sl_null;
+		m_sizeBuffer = 16384;
+		m_posBuffer = 0;
+		m_flagNeedComma = sl_false;
+		m_flagExpectValue = sl_false;
+		m_flagWrittenTopValue = sl_false;
+		m_flagError = sl_false;
+	}
+
+	JsonWriter::~JsonWriter()
+	{
+		flush();
+	}
+
+	void JsonWriter::setOutput(IWriter* writer)
+	{
+		flush();
+		m_writer = writer;
+		m_output = sl_null;
+	}
+
+	void JsonWriter::setOutput(AsyncOutputBuffer* output)
+	{
+		flush();
+		m_writer = sl_null;
+		m_output = output;
+	}
+
+	void JsonWriter::setBufferSize(sl_size size)
+	{
+		flush();
+		if (size < 64) {
+			size = 64;
+		}
+		m_sizeBuffer = size;
+		m_buffer.setNull();
+	}
+
+	sl_bool JsonWriter::_write(const void* _data, sl_size size)
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		const sl_uint8* data = (const sl_uint8*)_data;
+		while (size) {
+			if (m_buffer.isNull()) {
+				m_buffer = Memory::create(m_sizeBuffer);
+				if (m_buffer.isNull()) {
+					m_flagError = sl_true;
+					return sl_false;
+				}
+				m_posBuffer = 0;
+			}
+			sl_size n = m_sizeBuffer - m_posBuffer;
+			if (n > size) {
+				n = size;
+			}
+			Base::copyMemory((sl_uint8*)(m_buffer.getData()) + m_posBuffer, data, n);
+			m_posBuffer += n;
+			data += n;
+			size -= n;
+			if (m_posBuffer == m_sizeBuffer) {
+				if (!(flush())) {
+					return sl_false;
+				}
+			}
+		}
+		return sl_true;
+	}
+
+	SLIB_INLINE sl_bool JsonWriter::_writeChar(sl_char8 ch)
+	{
+		if (m_posBuffer + 1 < m_sizeBuffer && m_buffer.isNotNull()) {
+			((sl_char8*)(m_buffer.getData()))[m_posBuffer++] = ch;
+			return sl_true;
+		}
+		return _write(&ch, 1);
+	}
+
+	sl_bool JsonWriter::flush()
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		if (!m_posBuffer) {
+			return sl_true;
+		}
+		if (m_writer) {
+			if (m_writer->writeFully(m_buffer.getData(), m_posBuffer) != (sl_reg)m_posBuffer) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+		} else if (m_output) {
+			// the chunk is owned by the output, and the next text is written to a new buffer
+			if (!(m_output->write(m_buffer.sub(0, m_posBuffer)))) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+			m_buffer.setNull();
+		} else {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		m_posBuffer = 0;
+		return sl_true;
+	}
+
+	sl_bool JsonWriter::_beginValue()
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		sl_size depth = m_stack.getCount();
+		if (depth) {
+			if (m_stack.getData()[depth - 1]) {
+				// object member without name
+				if (!m_flagExpectValue) {
+					m_flagError = sl_true;
+					return sl_false;
+				}
+				m_flagExpectValue = sl_false;
+			} else if (m_flagNeedComma) {
+				return _writeChar(',');
+			}
+		} else if (m_flagWrittenTopValue) {
+			return _writeChar('\n');
+		}
+		return sl_true;
+	}
+
+	void JsonWriter::_endValue()
+	{
+		m_flagNeedComma = sl_true;
+		if (!(m_stack.getCount())) {
+			m_flagWrittenTopValue = sl_true;
+		}
+	}
+
+	sl_bool JsonWriter::beginObject()
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		if (!(m_stack.add_NoLock(sl_true))) {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		m_flagNeedComma = sl_false;
+		return _writeChar('{');
+	}
+
+	sl_bool JsonWriter::endObject()
+	{
+		sl_size depth = m_stack.getCount();
+		if (m_flagError || !depth || !(m_stack.getData()[depth - 1]) || m_flagExpectValue) {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		m_stack.popBack_NoLock();
+		_endValue();
+		return _writeChar('}');
+	}
+
+	sl_bool JsonWriter::beginArray()
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		if (!(m_stack.add_NoLock(sl_false))) {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		m_flagNeedComma = sl_false;
+		return _writeChar('[');
+	}
+
+	sl_bool JsonWriter::endArray()
+	{
+		sl_size depth = m_stack.getCount();
+		if (m_flagError || !depth || m_stack.getData()[depth - 1]) {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		m_stack.popBack_NoLock();
+		_endValue();
+		return _writeChar(']');
+	}
+
+	sl_bool JsonWriter::writeKey(const sl_char8* key, sl_size len)
+	{
+		sl_size depth = m_stack.getCount();
+		if (m_flagError || !depth || !(m_stack.getData()[depth - 1]) || m_flagExpectValue) {
+			m_flagError = sl_true;
+			return sl_false;
+		}
+		if (m_flagNeedComma) {
+			if (!(_writeChar(','))) {
+				return sl_false;
+			}
+		}
+		if (!(_writeEscaped(key, len))) {
+			return sl_false;
+		}
+		m_flagExpectValue = sl_true;
+		return _writeChar(':');
+	}
+
+	sl_bool JsonWriter::writeKey(const String& key)
+	{
+		return writeKey(key.getData(), key.getLength());
+	}
+
+	sl_bool JsonWriter::writeString(const sl_char8* str, sl_size len)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		_endValue();
+		return _writeEscaped(str, len);
+	}
+
+	sl_bool JsonWriter::writeString(const String& str)
+	{
+		return writeString(str.getData(), str.getLength());
+	}
+
+	sl_bool JsonWriter::_writeEscaped(const sl_char8* str, sl_size len)
+	{
+		if (!(_writeChar('"'))) {
+			return sl_false;
+		}
+		sl_size start = 0;
+		for (sl_size i = 0; i < len; i++) {
+			sl_uint8 ch = (sl_uint8)(str[i]);
+			if (ch >= 0x20 && ch != '"' && ch != '\\') {
+				continue;
+			}
+			if (i > start) {
+				if (!(_write(str + start, i - start))) {
+					return sl_false;
+				}
+			}
+			start = i + 1;
+			sl_char8 esc[6] = {'\\', 0, '0', '0', 0, 0};
+			sl_size n = 2;
+			switch (ch) {
+				case '"':
+				case '\\':
+					esc[1] = (sl_char8)ch;
+					break;
+				case '\n':
+					esc[1] = 'n';
+					break;
+				case '\r':
+					esc[1] = 'r';
+					break;
+				case '\t':
+					esc[1] = 't';
+					break;
+				case '\b':
+					esc[1] = 'b';
+					break;
+				case '\f':
+					esc[1] = 'f';
+					break;
+				default:
+					esc[1] = 'u';
+					esc[4] = "0123456789abcdef"[ch >> 4];
+					esc[5] = "0123456789abcdef"[ch & 15];
+					n = 6;
+					break;
+			}
+			if (!(_write(esc, n))) {
+				return sl_false;
+			}
+		}
+		if (len > start) {
+			if (!(_write(str + start, len - start))) {
+				return sl_false;
+			}
+		}
+		return _writeChar('"');
+	}
+
+	sl_bool JsonWriter::_writeUnsigned(sl_uint64 value, sl_bool flagNegative)
+	{
+		sl_char8 buf[24];
+		sl_size pos = sizeof(buf);
+		do {
+			buf[--pos] = (sl_char8)('0' + (value % 10));
+			value /= 10;
+		} while (value);
+		if (flagNegative) {
+			buf[--pos] = '-';
+		}
+		return _write(buf + pos, sizeof(buf) - pos);
+	}
+
+	sl_bool JsonWriter::writeInt32(sl_int32 value)
+	{
+		return writeInt64(value);
+	}
+
+	sl_bool JsonWriter::writeUint32(sl_uint32 value)
+	{
+		return writeUint64(value);
+	}
+
+	sl_bool JsonWriter::writeInt64(sl_int64 value)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		_endValue();
+		if (value < 0) {
+			return _writeUnsigned((sl_uint64)(-(value + 1)) + 1, sl_true);
+		} else {
+			return _writeUnsigned((sl_uint64)value, sl_false);
+		}
+	}
+
+	sl_bool JsonWriter::writeUint64(sl_uint64 value)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		_endValue();
+		return _writeUnsigned(value, sl_false);
+	}
+
+	sl_bool JsonWriter::writeDouble(double value)
+	{
+		if (Math::isNaN(value) || Math::isInfinite(value)) {
+			return writeNull();
+		}
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		_endValue();
+		String str = String::fromDouble(value);
+		return _write(str.getData(), str.getLength());
+	}
+
+	sl_bool JsonWriter::writeBoolean(sl_bool value)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		_endValue();
+		if (value) {
+			return _write("true", 4);
+		} else {
+			return _write("false", 5);
+		}
+	}
+
+	sl_bool JsonWriter::writeNull()
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		_endValue();
+		return _write("null", 4);
+	}
+
+	sl_bool JsonWriter::writeValue(const Json& value)
+	{
+		switch (value.getType()) {
+			case VariantType::Null:
+				return writeNull();
+			case VariantType::Int32:
+				return writeInt32(value.getInt32());
+			case VariantType::Uint32:
+				return writeUint32(value.getUint32());
+			case VariantType::Int64:
+				return writeInt64(value.getInt64());
+			case VariantType::Uint64:
+				return writeUint64(value.getUint64());
+			case VariantType::Float:
+			case VariantType::Double:
+				return writeDouble(value.getDouble());
+			case VariantType::Boolean:
+				return writeBoolean(value.getBoolean());
+			case VariantType::String8:
+			case VariantType::String16:
+			case VariantType::Sz8:
+			case VariantType::Sz16:
+			case VariantType::Time:
+				return writeString(value.getString());
+			case VariantType::Object:
+			case VariantType::Weak:
+				if (value.isVariantList()) {
+					if (!(beginArray())) {
+						return sl_false;
+					}
+					ListLocker<Variant> list(value.getVariantList());
+					for (sl_size i = 0; i < list.count; i++) {
+						if (!(writeValue(list[i]))) {
+							return sl_false;
+						}
+					}
+					return endArray();
+				} else if (value.isVariantMap()) {
+					if (!(beginObject())) {
+						return sl_false;
+					}
+					Map<String, Variant> map = value.getVariantMap();
+					MutexLocker lock(map.getLocker());
+					for (auto& pair : map) {
+						if (!(writeKey(pair.key))) {
+							return sl_false;
+						}
+						if (!(writeValue(pair.value))) {
+							return sl_false;
+						}
+					}
+					return endObject();
+				} else if (value.isVariantMapList()) {
+					if (!(beginArray())) {
+						return sl_false;
+					}
+					ListLocker< Map<String, Variant> > list(value.getVariantMapList());
+					for (sl_size i = 0; i < list.count; i++) {
+						if (!(writeValue(list[i]))) {
+							return sl_false;
+						}
+					}
+					return endArray();
+				}
+				return writeNull();
+			default:
+				return writeNull();
+		}
+	}
+
+	sl_bool JsonWriter::isError()
+	{
+		return m_flagError;
+	}
+
+	sl_size JsonWriter::getDepth()
+	{
+		return m_stack.getCount();
+	}
+
+}
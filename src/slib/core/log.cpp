@@ -13,6 +13,8 @@
 #include "slib/core/file.h"
 #include "slib/core/variant.h"
 #include "slib/core/safe_static.h"
+#include "slib/core/thread.h"
+#include "slib/core/event.h"
 
 #if defined(SLIB_PLATFORM_IS_ANDROID)
 #include <android/log.h>
@@ -84,6 +86,314 @@ namespace slib
 			File::appendAllTextUTF8(fileName, s);
 		}
 	}
+
+	AsyncFileLoggerParam::AsyncFileLoggerParam()
+	{
+		queueSize = 8192;
+		overflowPolicy = LogOverflowPolicy::Drop;
+		
+		maxFileSize = 0;
+		rotationInterval = 0;
+		maxBackupCount = 5;
+	}
+
+	AsyncFileLoggerParam::~AsyncFileLoggerParam()
+	{
+	}
+
+
+#define ASYNC_LOGGER_WRITE_BUFFER_SIZE 0x10000
+#define ASYNC_LOGGER_WRITE_INTERVAL 100
+
+	struct AsyncFileLogger::Slot
+	{
+		// `position` when empty, `position + 1` when filled
+		sl_reg sequence;
+		Time time;
+		String tag;
+		String content;
+	};
+
+	SLIB_DEFINE_OBJECT(AsyncFileLogger, Logger)
+
+	AsyncFileLogger::AsyncFileLogger()
+	{
+		m_slots = sl_null;
+		m_mask = 0;
+		m_posEnqueue = 0;
+		m_posDequeue = 0;
+		m_posWritten = 0;
+		m_flagWriterSleeping = 0;
+		m_nDropped = 0;
+		m_flagReleased = sl_false;
+		
+		m_sizeFile = 0;
+		m_sizeBufWrite = 0;
+		m_secondsFormatted = 0;
+	}
+
+	AsyncFileLogger::~AsyncFileLogger()
+	{
+		release();
+		if (m_slots) {
+			delete[] m_slots;
+		}
+	}
+
+	Ref<AsyncFileLogger> AsyncFileLogger::create(const AsyncFileLoggerParam& param)
+	{
+		if (param.fileName.isEmpty()) {
+			return sl_null;
+		}
+		sl_reg n = 2;
+		while (n < (sl_reg)(param.queueSize)) {
+			n <<= 1;
+		}
+		Ref<AsyncFileLogger> ret = new AsyncFileLogger;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			ret->m_slots = new Slot[n];
+			ret->m_bufWrite = Memory::create(ASYNC_LOGGER_WRITE_BUFFER_SIZE);
+			ret->m_eventWrite = Event::create();
+			ret->m_eventWritten = Event::create();
+			if (ret->m_slots && ret->m_bufWrite.isNotNull() && ret->m_eventWrite.isNotNull() && ret->m_eventWritten.isNotNull()) {
+				for (sl_reg i = 0; i < n; i++) {
+					ret->m_slots[i].sequence = i;
+				}
+				ret->m_mask = n - 1;
+				ret->_openFile();
+				ret->m_thread = Thread::start(SLIB_FUNCTION_CLASS(AsyncFileLogger, _runThread, ret.get()));
+				if (ret->m_thread.isNotNull()) {
+					return ret;
+				}
+			}
+		}
+		return sl_null;
+	}
+
+	Ref<AsyncFileLogger> AsyncFileLogger::create(const String& fileName)
+	{
+		AsyncFileLoggerParam param;
+		param.fileName = fileName;
+		return create(param);
+	}
+
+	void AsyncFileLogger::log(const String& tag, const String& content)
+	{
+		if (m_flagReleased) {
+			return;
+		}
+		if (_push(tag, content)) {
+			return;
+		}
+		if (m_param.overflowPolicy == LogOverflowPolicy::Block) {
+			do {
+				m_eventWrite->set();
+				m_eventWritten->wait(10);
+				if (m_flagReleased) {
+					return;
+				}
+			} while (!(_push(tag, content)));
+		} else {
+			Base::interlockedIncrement64(&m_nDropped);
+		}
+	}
+
+	void AsyncFileLogger::flush()
+	{
+		sl_reg pos = Base::interlockedAdd(&m_posEnqueue, 0);
+		while (Base::interlockedAdd(&m_posWritten, 0) - pos < 0) {
+			Ref<Thread> thread = m_thread;
+			if (thread.isNull() || !(thread->isRunning())) {
+				return;
+			}
+			m_eventWrite->set();
+			m_eventWritten->wait(10);
+		}
+	}
+
+	void AsyncFileLogger::release()
+	{
+		m_flagReleased = sl_true;
+		Ref<Thread> thread = m_thread;
+		if (thread.isNotNull()) {
+			thread->finish();
+			m_eventWrite->set();
+			thread->finishAndWait();
+			m_thread.setNull();
+		}
+		if (m_eventWritten.isNotNull()) {
+			m_eventWritten->set();
+		}
+		m_file.setNull();
+	}
+
+	sl_uint64 AsyncFileLogger::getDroppedLinesCount()
+	{
+		return m_nDropped;
+	}
+
+	sl_bool AsyncFileLogger::_push(const String& tag, const String& content)
+	{
+		sl_reg pos = Base::interlockedAdd(&m_posEnqueue, 0);
+		Slot* slot;
+		for (;;) {
+			slot = m_slots + (pos & m_mask);
+			sl_reg diff = Base::interlockedAdd(&(slot->sequence), 0) - pos;
+			if (diff == 0) {
+				if (Base::interlockedCompareExchange(&m_posEnqueue, pos + 1, pos)) {
+					break;
+				}
+				pos = Base::interlockedAdd(&m_posEnqueue, 0);
+			} else if (diff < 0) {
+				// full
+				return sl_false;
+			} else {
+				pos = Base::interlockedAdd(&m_posEnqueue, 0);
+			}
+		}
+		slot->time = Time::now();
+		slot->tag = tag;
+		slot->content = content;
+		// publish
+		Base::interlockedIncrement(&(slot->sequence));
+		// the writer wakes up by itself every `ASYNC_LOGGER_WRITE_INTERVAL`; wake it early only when the ring fills up to the half
+		if (m_flagWriterSleeping && pos - m_posDequeue >= (m_mask >> 1)) {
+			if (Base::interlockedCompareExchange32(&m_flagWriterSleeping, 0, 1)) {
+				m_eventWrite->set();
+			}
+		}
+		return sl_true;
+	}
+
+	void AsyncFileLogger::_runThread()
+	{
+		while (Thread::isNotStoppingCurrent()) {
+			_processBatch();
+			m_flagWriterSleeping = 1;
+			if (Base::interlockedAdd(&m_posEnqueue, 0) - m_posDequeue >= (m_mask >> 1)) {
+				m_flagWriterSleeping = 0;
+				continue;
+			}
+			m_eventWrite->wait(ASYNC_LOGGER_WRITE_INTERVAL);
+			m_flagWriterSleeping = 0;
+		}
+		// the remaining lines
+		while (_processBatch()) {
+		}
+	}
+
+	sl_bool AsyncFileLogger::_processBatch()
+	{
+		if (m_param.rotationInterval > 0 && m_file.isNotNull()) {
+			if ((Time::now() - m_timeOpened).getSecondsCount() >= (sl_int64)(m_param.rotationInterval)) {
+				_rotate();
+			}
+		}
+		sl_bool flagProcessed = sl_false;
+		for (;;) {
+			sl_reg pos = m_posDequeue;
+			Slot* slot = m_slots + (pos & m_mask);
+			if (Base::interlockedAdd(&(slot->sequence), 0) != pos + 1) {
+				break;
+			}
+			sl_int64 seconds = slot->time.toInt() / 1000000;
+			if (seconds != m_secondsFormatted || m_timeFormatted.isNull()) {
+				m_timeFormatted = slot->time.toString();
+				m_secondsFormatted = seconds;
+			}
+			String tag = Move(slot->tag);
+			String content = Move(slot->content);
+			// release the slot for `pos + size`
+			Base::interlockedAdd(&(slot->sequence), m_mask);
+			m_posDequeue = pos + 1;
+			_writeLine(tag, content);
+			flagProcessed = sl_true;
+		}
+		if (flagProcessed) {
+			_writeBuffer();
+			Base::interlockedAdd(&m_posWritten, m_posDequeue - m_posWritten);
+			m_eventWritten->set();
+		}
+		return flagProcessed;
+	}
+
+	void AsyncFileLogger::_writeLine(const String& tag, const String& content)
+	{
+		// same format with `FileLogger`
+		sl_size len = m_timeFormatted.getLength() + tag.getLength() + content.getLength() + 7;
+		if (m_param.maxFileSize > 0 && m_sizeFile + m_sizeBufWrite > 0 && m_sizeFile + m_sizeBufWrite + len > m_param.maxFileSize) {
+			_writeBuffer();
+			_rotate();
+		}
+		_write(m_timeFormatted.getData(), m_timeFormatted.getLength());
+		_write(" [", 2);
+		_write(tag.getData(), tag.getLength());
+		_write("] ", 2);
+		_write(content.getData(), content.getLength());
+		_write("\r\n", 2);
+	}
+
+	void AsyncFileLogger::_write(const void* data, sl_size size)
+	{
+		sl_size sizeBuf = m_bufWrite.getSize();
+		if (m_sizeBufWrite + size > sizeBuf) {
+			_writeBuffer();
+			if (size > sizeBuf) {
+				if (m_file.isNotNull() || _openFile()) {
+					m_file->writeFully(data, size);
+					m_sizeFile += size;
+				}
+				return;
+			}
+		}
+		Base::copyMemory((sl_uint8*)(m_bufWrite.getData()) + m_sizeBufWrite, data, size);
+		m_sizeBufWrite += size;
+	}
+
+	void AsyncFileLogger::_writeBuffer()
+	{
+		if (m_sizeBufWrite == 0) {
+			return;
+		}
+		if (m_file.isNotNull() || _openFile()) {
+			m_file->writeFully(m_bufWrite.getData(), m_sizeBufWrite);
+			m_sizeFile += m_sizeBufWrite;
+		}
+		m_sizeBufWrite = 0;
+	}
+
+	sl_bool AsyncFileLogger::_openFile()
+	{
+		m_file = File::openForAppend(m_param.fileName);
+		if (m_file.isNotNull()) {
+			m_sizeFile = m_file->getSize();
+			m_timeOpened = Time::now();
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void AsyncFileLogger::_rotate()
+	{
+		m_file.setNull();
+		const String& fileName = m_param.fileName;
+		sl_uint32 n = m_param.maxBackupCount;
+		if (n > 0) {
+			File::deleteFile(fileName + "." + String::fromUint32(n));
+			for (sl_uint32 i = n - 1; i > 0; i--) {
+				String path = fileName + "." + String::fromUint32(i);
+				if (File::exists(path)) {
+					File::rename(path, fileName + "." + String::fromUint32(i + 1));
+				}
+			}
+			File::rename(fileName, fileName + ".1");
+		} else {
+			File::deleteFile(fileName);
+		}
+		_openFile();
+	}
+
 	
 	class ConsoleLogger : public Logger
 	{
@@ -214,6 +524,16 @@ namespace slib
 		return new FileLogger(fileName);
 	}
 
+	Ref<Logger> Logger::createAsyncFileLogger(const String& fileName)
+	{
+		return AsyncFileLogger::create(fileName);
+	}
+
+	Ref<Logger> Logger::createAsyncFileLogger(const AsyncFileLoggerParam& param)
+	{
+		return AsyncFileLogger::create(param);
+	}
+
 	void Logger::logGlobal(const String& tag, const String& content)
 	{
 		Ref<LoggerSet> log = global();
@@ -0,0 +1,316 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/mapped_file.h"
+
+#if defined(SLIB_PLATFORM_IS_WIN32)
+#	include <windows.h>
+#else
+#	include <unistd.h>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <sys/mman.h>
+#endif
+
+namespace slib
+{
+
+	SLIB_DEFINE_OBJECT(MappedFile, Referable)
+
+	MappedFile::MappedFile()
+	{
+		m_data = sl_null;
+		m_size = 0;
+		m_base = sl_null;
+		m_sizeBase = 0;
+		m_mode = MappedFileMode::Read;
+		m_handle = -1;
+		m_handleMapping = -1;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#if defined(SLIB_PLATFORM_IS_WIN32)
+
+	Ref<MappedFile> MappedFile::open(const String& _filePath, MappedFileMode mode, sl_uint64 offset, sl_size size)
+	{
+		String16 filePath = _filePath;
+		if (filePath.isEmpty()) {
+			return sl_null;
+		}
+		DWORD dwAccess = GENERIC_READ;
+		DWORD dwProtect = PAGE_READONLY;
+		DWORD dwMapAccess = FILE_MAP_READ;
+		if (mode == MappedFileMode::ReadWrite) {
+			dwAccess |= GENERIC_WRITE;
+			dwProtect = PAGE_READWRITE;
+			dwMapAccess = FILE_MAP_WRITE;
+		} else if (mode == MappedFileMode::CopyOnWrite) {
+			dwProtect = PAGE_WRITECOPY;
+			dwMapAccess = FILE_MAP_COPY;
+		}
+		HANDLE hFile = ::CreateFileW((LPCWSTR)(filePath.getData()), dwAccess, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			return sl_null;
+		}
+		LARGE_INTEGER sizeFile;
+		if (::GetFileSizeEx(hFile, &sizeFile) && offset < (sl_uint64)(sizeFile.QuadPart)) {
+			sl_uint64 sizeRemain = (sl_uint64)(sizeFile.QuadPart) - offset;
+			if (size > sizeRemain) {
+				size = (sl_size)sizeRemain;
+			} else if (!size && sizeRemain <= SLIB_SIZE_MAX) {
+				size = (sl_size)sizeRemain;
+			}
+			if (size) {
+				HANDLE hMapping = ::CreateFileMappingW(hFile, NULL, dwProtect, 0, 0, NULL);
+				if (hMapping) {
+					SYSTEM_INFO si;
+					::GetSystemInfo(&si);
+					sl_uint64 offsetBase = offset - (offset % si.dwAllocationGranularity);
+					sl_size sizeBase = (sl_size)(offset - offsetBase) + size;
+					void* base = ::MapViewOfFile(hMapping, dwMapAccess, (DWORD)(offsetBase >> 32), (DWORD)offsetBase, sizeBase);
+					if (base) {
+						Ref<MappedFile> ret = new MappedFile;
+						if (ret.isNotNull()) {
+							ret->m_base = base;
+							ret->m_sizeBase = sizeBase;
+							ret->m_data = (sl_uint8*)base + (sl_size)(offset - offsetBase);
+							ret->m_size = size;
+							ret->m_mode = mode;
+							ret->m_handle = (sl_reg)hFile;
+							ret->m_handleMapping = (sl_reg)hMapping;
+							return ret;
+						}
+						::UnmapViewOfFile(base);
+					}
+					::CloseHandle(hMapping);
+				}
+			}
+		}
+		::CloseHandle(hFile);
+		return sl_null;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_base) {
+			::UnmapViewOfFile(m_base);
+			m_base = sl_null;
+			m_data = sl_null;
+			m_size = 0;
+			m_sizeBase = 0;
+		}
+		if (m_handleMapping != -1) {
+			::CloseHandle((HANDLE)m_handleMapping);
+			m_handleMapping = -1;
+		}
+		if (m_handle != -1) {
+			::CloseHandle((HANDLE)m_handle);
+			m_handle = -1;
+		}
+	}
+
+	typedef BOOL (WINAPI *_priv_MappedFile_PrefetchVirtualMemory)(HANDLE hProcess, ULONG_PTR NumberOfEntries, PVOID VirtualAddresses, ULONG Flags);
+
+	sl_bool MappedFile::advise(MappedFileAdvice advice, sl_size offset, sl_size size)
+	{
+		if (!m_data || offset >= m_size) {
+			return sl_false;
+		}
+		if (size > m_size - offset) {
+			size = m_size - offset;
+		}
+		if (advice == MappedFileAdvice::WillNeed) {
+			// PrefetchVirtualMemory: Windows 8 or later
+			static _priv_MappedFile_PrefetchVirtualMemory func = (_priv_MappedFile_PrefetchVirtualMemory)(::GetProcAddress(::GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory"));
+			if (func) {
+				struct {
+					PVOID VirtualAddress;
+					SIZE_T NumberOfBytes;
+				} entry;
+				entry.VirtualAddress = (sl_uint8*)m_data + offset;
+				entry.NumberOfBytes = size;
+				return func(::GetCurrentProcess(), 1, &entry, 0) != 0;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_bool MappedFile::flush(sl_bool flagWait)
+	{
+		if (!m_base) {
+			return sl_false;
+		}
+		if (!(::FlushViewOfFile(m_base, m_sizeBase))) {
+			return sl_false;
+		}
+		if (flagWait && m_mode == MappedFileMode::ReadWrite) {
+			return ::FlushFileBuffers((HANDLE)m_handle) != 0;
+		}
+		return sl_true;
+	}
+
+#else
+
+	Ref<MappedFile> MappedFile::open(const String& filePath, MappedFileMode mode, sl_uint64 offset, sl_size size)
+	{
+		if (filePath.isEmpty()) {
+			return sl_null;
+		}
+		int flags = O_RDONLY;
+		int prot = PROT_READ;
+		int type = MAP_SHARED;
+		if (mode == MappedFileMode::ReadWrite) {
+			flags = O_RDWR;
+			prot |= PROT_WRITE;
+		} else if (mode == MappedFileMode::CopyOnWrite) {
+			prot |= PROT_WRITE;
+			type = MAP_PRIVATE;
+		}
+		int fd = ::open(filePath.getData(), flags | O_CLOEXEC);
+		if (fd < 0) {
+			return sl_null;
+		}
+		struct stat st;
+		if (!(::fstat(fd, &st)) && offset < (sl_uint64)(st.st_size)) {
+			sl_uint64 sizeRemain = (sl_uint64)(st.st_size) - offset;
+			if (size > sizeRemain) {
+				size = (sl_size)sizeRemain;
+			} else if (!size && sizeRemain <= SLIB_SIZE_MAX) {
+				size = (sl_size)sizeRemain;
+			}
+			if (size) {
+				sl_uint64 granularity = (sl_uint64)(::sysconf(_SC_PAGESIZE));
+				sl_uint64 offsetBase = offset - (offset % granularity);
+				sl_size sizeBase = (sl_size)(offset - offsetBase) + size;
+				void* base = ::mmap(sl_null, sizeBase, prot, type, fd, (off_t)offsetBase);
+				if (base != MAP_FAILED) {
+					Ref<MappedFile> ret = new MappedFile;
+					if (ret.isNotNull()) {
+						ret->m_base = base;
+						ret->m_sizeBase = sizeBase;
+						ret->m_data = (sl_uint8*)base + (sl_size)(offset - offsetBase);
+						ret->m_size = size;
+						ret->m_mode = mode;
+						// the mapping is valid after the file is closed
+						::close(fd);
+						return ret;
+					}
+					::munmap(base, sizeBase);
+				}
+			}
+		}
+		::close(fd);
+		return sl_null;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_base) {
+			::munmap(m_base, m_sizeBase);
+			m_base = sl_null;
+			m_data = sl_null;
+			m_size = 0;
+			m_sizeBase = 0;
+		}
+	}
+
+	sl_bool MappedFile::advise(MappedFileAdvice advice, sl_size offset, sl_size size)
+	{
+		if (!m_data || offset >= m_size) {
+			return sl_false;
+		}
+		if (size > m_size - offset) {
+			size = m_size - offset;
+		}
+		int value;
+		switch (advice) {
+			case MappedFileAdvice::Normal:
+				value = MADV_NORMAL;
+				break;
+			case MappedFileAdvice::Sequential:
+				value = MADV_SEQUENTIAL;
+				break;
+			case MappedFileAdvice::Random:
+				value = MADV_RANDOM;
+				break;
+			case MappedFileAdvice::WillNeed:
+				value = MADV_WILLNEED;
+				break;
+			case MappedFileAdvice::DontNeed:
+				value = MADV_DONTNEED;
+				break;
+#if defined(MADV_HUGEPAGE)
+			case MappedFileAdvice::HugePage:
+				value = MADV_HUGEPAGE;
+				break;
+#endif
+			default:
+				return sl_false;
+		}
+		// the address must be aligned to the page
+		sl_uint8* start = (sl_uint8*)m_data + offset;
+		sl_size align = (sl_size)(start - (sl_uint8*)m_base) % (sl_size)(::sysconf(_SC_PAGESIZE));
+		return ::madvise(start - align, size + align, value) == 0;
+	}
+
+	sl_bool MappedFile::flush(sl_bool flagWait)
+	{
+		if (!m_base) {
+			return sl_false;
+		}
+		return ::msync(m_base, m_sizeBase, flagWait ? MS_SYNC : MS_ASYNC) == 0;
+	}
+
+#endif
+
+	sl_bool MappedFile::isOpened() const
+	{
+		return m_base != sl_null;
+	}
+
+	void* MappedFile::getData() const
+	{
+		return m_data;
+	}
+
+	sl_size MappedFile::getSize() const
+	{
+		return m_size;
+	}
+
+	MappedFileMode MappedFile::getMode() const
+	{
+		return m_mode;
+	}
+
+	Memory MappedFile::getMemory()
+	{
+		if (m_data) {
+			return Memory::createStatic(m_data, m_size, this);
+		}
+		return sl_null;
+	}
+
+	Memory MappedFile::getMemory(sl_size offset, sl_size size)
+	{
+		if (m_data && offset < m_size) {
+			if (size > m_size - offset) {
+				size = m_size - offset;
+			}
+			return Memory::createStatic((sl_uint8*)m_data + offset, size, this);
+		}
+		return sl_null;
+	}
+
+}
@@ -10,6 +10,9 @@
 
 #include "slib/core/memory.h"
 
+#include "slib/core/memory_pool.h"
+#include "slib/core/mapped_file.h"
+
 namespace slib
 {
 
@@ -119,6 +122,15 @@ namespace slib
 		return CMemory::createStatic(buf, count, refer);
 	}
 
+	Memory Memory::createMapped(const String& filePath, sl_bool flagWritable)
+	{
+		Ref<MappedFile> file = MappedFile::open(filePath, flagWritable ? MappedFileMode::CopyOnWrite : MappedFileMode::Read);
+		if (file.isNotNull()) {
+			return file->getMemory();
+		}
+		return sl_null;
+	}
+
 	void* Memory::getData() const
 	{
 		CMemory* obj = ref._ptr;
@@ -536,8 +548,45 @@ namespace slib
 		return sl_false;
 	}
 	
+	sl_bool MemoryQueue::addNew_NoLock(const void* buf, sl_size size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		if (buf) {
+			Memory mem = MemoryPool::create(buf, size);
+			if (mem.isNotNull()) {
+				return add_NoLock(mem);
+			}
+		}
+		return sl_false;
+	}
+	
+	sl_bool MemoryQueue::addNew(const void* buf, sl_size size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		if (buf) {
+			Memory mem = MemoryPool::create(buf, size);
+			if (mem.isNotNull()) {
+				return add(mem);
+			}
+		}
+		return sl_false;
+	}
+	
 	void MemoryQueue::link_NoLock(MemoryQueue& buf)
 	{
+		MemoryData mem;
+		if (buf.m_memCurrent.size > 0) {
+			// the remaining part of the partially popped chunk
+			if (buf.pop_NoLock(mem)) {
+				if (m_queue.push_NoLock(mem)) {
+					m_size += mem.size;
+				}
+			}
+		}
 		m_size += buf.m_size;
 		buf.m_size = 0;
 		m_queue.merge_NoLock(&(buf.m_queue));
@@ -546,9 +595,7 @@ namespace slib
 	void MemoryQueue::link(MemoryQueue& buf)
 	{
 		ObjectLocker lock(this, &buf);
-		m_size += buf.m_size;
-		buf.m_size = 0;
-		m_queue.merge_NoLock(&(buf.m_queue));
+		link_NoLock(buf);
 	}
 	
 	void MemoryQueue::clear_NoLock()
@@ -637,6 +684,63 @@ namespace slib
 		return pop_NoLock(buf, size);
 	}
 	
+	sl_size MemoryQueue::skip_NoLock(sl_size size)
+	{
+		sl_size nSkip = 0;
+		while (nSkip < size) {
+			MemoryData mem = m_memCurrent;
+			sl_size pos = m_posCurrent;
+			m_memCurrent.size = 0;
+			m_posCurrent = 0;
+			if (mem.size == 0) {
+				m_queue.pop_NoLock(&mem);
+				pos = 0;
+			}
+			if (mem.size == 0) {
+				break;
+			}
+			sl_size n = size - nSkip;
+			sl_size m = mem.size;
+			if (pos > m) {
+				pos = m;
+			}
+			m -= pos;
+			if (n >= m) {
+				nSkip += m;
+			} else {
+				nSkip += n;
+				m_posCurrent = pos + n;
+				m_memCurrent = mem;
+			}
+		}
+		m_size -= nSkip;
+		return nSkip;
+	}
+	
+	sl_size MemoryQueue::skip(sl_size size)
+	{
+		ObjectLocker lock(this);
+		return skip_NoLock(size);
+	}
+	
+	sl_uint32 MemoryQueue::getChunks_NoLock(MemoryData* chunks, sl_uint32 maxCount) const
+	{
+		sl_uint32 n = 0;
+		if (n < maxCount && m_memCurrent.size > m_posCurrent) {
+			chunks[n].data = (sl_uint8*)(m_memCurrent.data) + m_posCurrent;
+			chunks[n].size = m_memCurrent.size - m_posCurrent;
+			n++;
+		}
+		Link<MemoryData>* item = m_queue.getFront();
+		while (item && n < maxCount) {
+			chunks[n].data = item->value.data;
+			chunks[n].size = item->value.size;
+			n++;
+			item = item->next;
+		}
+		return n;
+	}
+
 	Memory MemoryQueue::merge_NoLock() const
 	{
 		if (m_queue.getCount() == 0) {
@@ -647,7 +751,7 @@ namespace slib
 			return front->value.getMemory();
 		}
 		sl_size total = m_size;
-		Memory ret = Memory::create(total);
+		Memory ret = MemoryPool::create(total);
 		if (ret.isNotEmpty()) {
 			char* buf = (char*)(ret.getData());
 			sl_size offset = 0;
@@ -0,0 +1,279 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/memory_pool.h"
+
+#include "slib/core/base.h"
+#include "slib/core/spin_lock.h"
+
+#define MIN_CLASS_SHIFT 8
+#define MAX_CLASS_SHIFT 20
+#define CLASS_COUNT (MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1)
+// bytes cached by a thread per size class (at least one buffer)
+#define THREAD_CACHE_BYTES 131072
+#define DEFAULT_MAX_CACHED_SIZE 0x4000000
+
+namespace slib
+{
+
+	struct _MemoryPoolBuffer
+	{
+		_MemoryPoolBuffer* next;
+	};
+
+	// zero-initialized, so that it is valid before the static constructors
+	struct _MemoryPoolClass
+	{
+		sl_int32 lock;
+		_MemoryPoolBuffer* list;
+	};
+
+	struct _MemoryPoolThreadCache
+	{
+		_MemoryPoolBuffer* list[CLASS_COUNT];
+		sl_uint32 count[CLASS_COUNT];
+	};
+
+	static _MemoryPoolClass _g_memoryPoolClasses[CLASS_COUNT];
+	static sl_reg _g_memoryPoolSizeCached = 0;
+	static sl_reg _g_memoryPoolMaxCachedSize = DEFAULT_MAX_CACHED_SIZE;
+
+	static sl_int64 _g_memoryPoolCountHit = 0;
+	static sl_int64 _g_memoryPoolCountMiss = 0;
+	static sl_int64 _g_memoryPoolCountOversized = 0;
+	static sl_int64 _g_memoryPoolCountDiscarded = 0;
+
+	SLIB_THREAD _MemoryPoolThreadCache _gt_memoryPoolCache;
+	// 0: not attached, 1: attached, 2: released (thread is finishing)
+	SLIB_THREAD sl_uint32 _gt_memoryPoolCacheState = 0;
+
+	SLIB_INLINE static sl_size _MemoryPool_getClassSize(sl_uint32 index)
+	{
+		return (sl_size)1 << (index + MIN_CLASS_SHIFT);
+	}
+
+	SLIB_INLINE static sl_uint32 _MemoryPool_getThreadCacheCount(sl_uint32 index)
+	{
+		sl_size n = THREAD_CACHE_BYTES >> (index + MIN_CLASS_SHIFT);
+		return n ? (sl_uint32)n : 1;
+	}
+
+	SLIB_INLINE static SpinLock* _MemoryPool_getLock(_MemoryPoolClass* c)
+	{
+		return reinterpret_cast<SpinLock*>(&(c->lock));
+	}
+
+	static void _MemoryPool_releaseShared(_MemoryPoolBuffer* buf, sl_uint32 index)
+	{
+		sl_reg size = (sl_reg)(_MemoryPool_getClassSize(index));
+		if (Base::interlockedAdd(&_g_memoryPoolSizeCached, size) <= _g_memoryPoolMaxCachedSize) {
+			_MemoryPoolClass* c = _g_memoryPoolClasses + index;
+			SpinLocker lock(_MemoryPool_getLock(c));
+			buf->next = c->list;
+			c->list = buf;
+		} else {
+			Base::interlockedAdd(&_g_memoryPoolSizeCached, -size);
+			Base::interlockedIncrement64(&_g_memoryPoolCountDiscarded);
+			Base::freeMemory(buf);
+		}
+	}
+
+	class _MemoryPoolThreadCacheReleaser
+	{
+	public:
+		~_MemoryPoolThreadCacheReleaser()
+		{
+			_gt_memoryPoolCacheState = 2;
+			for (sl_uint32 i = 0; i < CLASS_COUNT; i++) {
+				_MemoryPoolBuffer* buf = _gt_memoryPoolCache.list[i];
+				while (buf) {
+					_MemoryPoolBuffer* next = buf->next;
+					_MemoryPool_releaseShared(buf, i);
+					buf = next;
+				}
+				_gt_memoryPoolCache.list[i] = sl_null;
+				_gt_memoryPoolCache.count[i] = 0;
+			}
+		}
+	};
+
+	static sl_bool _MemoryPool_attachThreadCache()
+	{
+		sl_uint32 state = _gt_memoryPoolCacheState;
+		if (state == 1) {
+			return sl_true;
+		}
+		if (state) {
+			return sl_false;
+		}
+		// registers the releaser to be destructed when the thread is finished
+		static SLIB_THREAD _MemoryPoolThreadCacheReleaser releaser;
+		SLIB_UNUSED(releaser);
+		_gt_memoryPoolCacheState = 1;
+		return sl_true;
+	}
+
+	static void* _MemoryPool_allocate(sl_uint32 index)
+	{
+		sl_bool flagCache = _MemoryPool_attachThreadCache();
+		if (flagCache) {
+			_MemoryPoolBuffer* buf = _gt_memoryPoolCache.list[index];
+			if (buf) {
+				_gt_memoryPoolCache.list[index] = buf->next;
+				_gt_memoryPoolCache.count[index]--;
+				Base::interlockedIncrement64(&_g_memoryPoolCountHit);
+				return buf;
+			}
+		}
+		_MemoryPoolClass* c = _g_memoryPoolClasses + index;
+		if (c->list) {
+			_MemoryPoolBuffer* buf;
+			{
+				SpinLocker lock(_MemoryPool_getLock(c));
+				buf = c->list;
+				if (buf) {
+					c->list = buf->next;
+				}
+			}
+			if (buf) {
+				Base::interlockedAdd(&_g_memoryPoolSizeCached, -(sl_reg)(_MemoryPool_getClassSize(index)));
+				Base::interlockedIncrement64(&_g_memoryPoolCountHit);
+				return buf;
+			}
+		}
+		Base::interlockedIncrement64(&_g_memoryPoolCountMiss);
+		return Base::createMemory(_MemoryPool_getClassSize(index));
+	}
+
+	static void _MemoryPool_free(void* ptr, sl_uint32 index)
+	{
+		_MemoryPoolBuffer* buf = (_MemoryPoolBuffer*)ptr;
+		if (_MemoryPool_attachThreadCache()) {
+			if (_gt_memoryPoolCache.count[index] < _MemoryPool_getThreadCacheCount(index)) {
+				buf->next = _gt_memoryPoolCache.list[index];
+				_gt_memoryPoolCache.list[index] = buf;
+				_gt_memoryPoolCache.count[index]++;
+				return;
+			}
+		}
+		_MemoryPool_releaseShared(buf, index);
+	}
+
+	class _MemoryPoolMemory : public CMemory
+	{
+	public:
+		sl_uint32 m_classIndex;
+
+	public:
+		_MemoryPoolMemory(void* buf, sl_size size, sl_uint32 index)
+		{
+			// owns the buffer (not static), but the buffer is returned to the pool instead of `CArray`
+			m_flagStatic = sl_false;
+			m_data = (sl_uint8*)buf;
+			m_count = size;
+			m_classIndex = index;
+		}
+
+		~_MemoryPoolMemory()
+		{
+			if (m_data) {
+				_MemoryPool_free(m_data, m_classIndex);
+				m_data = sl_null;
+				m_count = 0;
+			}
+		}
+
+	};
+
+
+	MemoryPoolStatistics::MemoryPoolStatistics()
+	{
+		countHit = 0;
+		countMiss = 0;
+		countOversized = 0;
+		countDiscarded = 0;
+		sizeCached = 0;
+	}
+
+
+	Memory MemoryPool::create(sl_size size)
+	{
+		if (size == 0) {
+			return sl_null;
+		}
+		if (size > SLIB_MEMORY_POOL_MAX_SIZE) {
+			Base::interlockedIncrement64(&_g_memoryPoolCountOversized);
+			return Memory::create(size);
+		}
+		sl_uint32 index = 0;
+		while (_MemoryPool_getClassSize(index) < size) {
+			index++;
+		}
+		void* buf = _MemoryPool_allocate(index);
+		if (!buf) {
+			return sl_null;
+		}
+		CMemory* mem = new _MemoryPoolMemory(buf, size, index);
+		if (mem) {
+			return mem;
+		}
+		_MemoryPool_free(buf, index);
+		return sl_null;
+	}
+
+	Memory MemoryPool::create(const void* data, sl_size size)
+	{
+		Memory ret = create(size);
+		if (ret.isNotNull()) {
+			Base::copyMemory(ret.getData(), data, size);
+		}
+		return ret;
+	}
+
+	void MemoryPool::getStatistics(MemoryPoolStatistics& statistics)
+	{
+		statistics.countHit = _g_memoryPoolCountHit;
+		statistics.countMiss = _g_memoryPoolCountMiss;
+		statistics.countOversized = _g_memoryPoolCountOversized;
+		statistics.countDiscarded = _g_memoryPoolCountDiscarded;
+		sl_reg size = _g_memoryPoolSizeCached;
+		statistics.sizeCached = size > 0 ? (sl_size)size : 0;
+	}
+
+	sl_size MemoryPool::getMaxCachedSize()
+	{
+		return (sl_size)_g_memoryPoolMaxCachedSize;
+	}
+
+	void MemoryPool::setMaxCachedSize(sl_size size)
+	{
+		_g_memoryPoolMaxCachedSize = (sl_reg)size;
+	}
+
+	void MemoryPool::clear()
+	{
+		for (sl_uint32 i = 0; i < CLASS_COUNT; i++) {
+			_MemoryPoolClass* c = _g_memoryPoolClasses + i;
+			_MemoryPoolBuffer* buf;
+			{
+				SpinLocker lock(_MemoryPool_getLock(c));
+				buf = c->list;
+				c->list = sl_null;
+			}
+			while (buf) {
+				_MemoryPoolBuffer* next = buf->next;
+				Base::interlockedAdd(&_g_memoryPoolSizeCached, -(sl_reg)(_MemoryPool_getClassSize(i)));
+				Base::freeMemory(buf);
+				buf = next;
+			}
+		}
+	}
+
+}
@@ -11,6 +11,7 @@
 #include "slib/core/mutex.h"
 
 #include "slib/core/base.h"
+#include "slib/core/slab_allocator.h"
 
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
 #include <windows.h>
@@ -25,17 +26,17 @@ namespace slib
 
 	Mutex::Mutex() noexcept
 	{
-		_init();
+		m_pObject = sl_null;
 	}
 
 	Mutex::Mutex(const Mutex& other) noexcept
 	{
-		_init();
+		m_pObject = sl_null;
 	}
 	
 	Mutex::Mutex(Mutex&& other) noexcept
 	{
-		_init();
+		m_pObject = sl_null;
 	}
 
 	Mutex::~Mutex() noexcept
@@ -43,70 +44,101 @@ namespace slib
 		_free();
 	}
 
-	void Mutex::_init() noexcept
+	void* Mutex::_create() const noexcept
 	{
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		m_pObject = Base::createMemory(sizeof(CRITICAL_SECTION));
+		void* object = SlabAllocator::allocate(sizeof(CRITICAL_SECTION));
+		if (!object) {
+			return sl_null;
+		}
 #	if defined(SLIB_PLATFORM_IS_DESKTOP)
-		InitializeCriticalSection((PCRITICAL_SECTION)m_pObject);
+		InitializeCriticalSection((PCRITICAL_SECTION)object);
 #	elif defined(SLIB_PLATFORM_IS_MOBILE)
-		InitializeCriticalSectionEx((PCRITICAL_SECTION)m_pObject, NULL, NULL);
+		InitializeCriticalSectionEx((PCRITICAL_SECTION)object, NULL, NULL);
 #	endif
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		m_pObject = Base::createMemory(sizeof(pthread_mutex_t));
+		void* object = SlabAllocator::allocate(sizeof(pthread_mutex_t));
+		if (!object) {
+			return sl_null;
+		}
 		pthread_mutexattr_t attr;
 		pthread_mutexattr_init(&attr);
 		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-		pthread_mutex_init((pthread_mutex_t*)(m_pObject), &attr);
+		pthread_mutex_init((pthread_mutex_t*)object, &attr);
 		pthread_mutexattr_destroy(&attr);
 #endif
+		if (Base::interlockedCompareExchangePtr(&m_pObject, object, sl_null)) {
+			return object;
+		}
+		// created by another thread
+#if defined(SLIB_PLATFORM_IS_WINDOWS)
+		DeleteCriticalSection((PCRITICAL_SECTION)object);
+		SlabAllocator::free(object, sizeof(CRITICAL_SECTION));
+#elif defined(SLIB_PLATFORM_IS_UNIX)
+		pthread_mutex_destroy((pthread_mutex_t*)object);
+		SlabAllocator::free(object, sizeof(pthread_mutex_t));
+#endif
+		return m_pObject;
 	}
 
 	void Mutex::_free() noexcept
 	{
+		void* object = m_pObject;
+		if (!object) {
+			return;
+		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		DeleteCriticalSection((PCRITICAL_SECTION)m_pObject);
-		Base::freeMemory(m_pObject);
-		m_pObject = sl_null;
+		DeleteCriticalSection((PCRITICAL_SECTION)object);
+		SlabAllocator::free(object, sizeof(CRITICAL_SECTION));
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		pthread_mutex_destroy((pthread_mutex_t*)(m_pObject));
-		Base::freeMemory(m_pObject);
+		pthread_mutex_destroy((pthread_mutex_t*)object);
+		SlabAllocator::free(object, sizeof(pthread_mutex_t));
 #endif
+		m_pObject = sl_null;
 	}
 
 	void Mutex::lock() const noexcept
 	{
-		if (!m_pObject) {
-			return;
+		void* object = m_pObject;
+		if (!object) {
+			object = _create();
+			if (!object) {
+				return;
+			}
 		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		EnterCriticalSection((PCRITICAL_SECTION)m_pObject);
+		EnterCriticalSection((PCRITICAL_SECTION)object);
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		pthread_mutex_lock((pthread_mutex_t*)(m_pObject));
+		pthread_mutex_lock((pthread_mutex_t*)object);
 #endif
 	}
 
 	sl_bool Mutex::tryLock() const noexcept
 	{
-		if (!m_pObject) {
-			return sl_false;
+		void* object = m_pObject;
+		if (!object) {
+			object = _create();
+			if (!object) {
+				return sl_false;
+			}
 		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		return TryEnterCriticalSection((PCRITICAL_SECTION)m_pObject) != 0;
+		return TryEnterCriticalSection((PCRITICAL_SECTION)object) != 0;
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		return pthread_mutex_trylock((pthread_mutex_t*)(m_pObject)) == 0;
+		return pthread_mutex_trylock((pthread_mutex_t*)object) == 0;
 #endif
 	}
 
 	void Mutex::unlock() const noexcept
 	{
-		if (!m_pObject) {
+		void* object = m_pObject;
+		if (!object) {
 			return;
 		}
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
-		LeaveCriticalSection((PCRITICAL_SECTION)m_pObject);
+		LeaveCriticalSection((PCRITICAL_SECTION)object);
 #elif defined(SLIB_PLATFORM_IS_UNIX)
-		pthread_mutex_unlock((pthread_mutex_t*)(m_pObject));
+		pthread_mutex_unlock((pthread_mutex_t*)object);
 #endif
 	}
 
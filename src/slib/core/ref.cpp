@@ -10,6 +10,8 @@
 
 #include "slib/core/ref.h"
 
+#include "slib/core/slab_allocator.h"
+
 #define _SIGNATURE 0x15181289
 
 namespace slib
@@ -106,6 +108,25 @@ namespace slib
 	{
 		m_nRefCount = -1;
 	}
+
+	void* Referable::operator new(sl_size_t size) noexcept
+	{
+		return SlabAllocator::allocate(size);
+	}
+
+	void Referable::operator delete(void* ptr, sl_size_t size) noexcept
+	{
+		SlabAllocator::free(ptr, size);
+	}
+
+	void* Referable::operator new(sl_size_t size, void* place) noexcept
+	{
+		return place;
+	}
+
+	void Referable::operator delete(void* ptr, void* place) noexcept
+	{
+	}
 	
 	sl_object_type Referable::ObjectType() noexcept
 	{
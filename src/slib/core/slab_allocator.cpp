@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/slab_allocator.h"
+
+#include "slib/core/base.h"
+#include "slib/core/spin_lock.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+#	define SLIB_NO_SLAB_ALLOCATOR
+#elif defined(__has_feature)
+#	if __has_feature(address_sanitizer)
+#		define SLIB_NO_SLAB_ALLOCATOR
+#	endif
+#endif
+
+#define SIZE_CLASS_SHIFT 4
+#define SIZE_CLASS_COUNT (SLIB_SLAB_ALLOCATOR_MAX_SIZE >> SIZE_CLASS_SHIFT)
+#define SLAB_SIZE 65536
+// bytes moved between the thread cache and the shared list at once
+#define BATCH_BYTES 4096
+#define BATCH_MIN_COUNT 4
+
+namespace slib
+{
+
+#if !defined(SLIB_NO_SLAB_ALLOCATOR)
+
+	struct _SlabBlock
+	{
+		_SlabBlock* next;
+	};
+
+	// zero-initialized, so that it is valid before the static constructors
+	struct _SlabClass
+	{
+		sl_int32 lock;
+		_SlabBlock* freeList;
+		sl_uint8* slab;
+		sl_size sizeSlabRemain;
+	};
+
+	struct _SlabThreadCache
+	{
+		_SlabBlock* list[SIZE_CLASS_COUNT];
+		sl_uint32 count[SIZE_CLASS_COUNT];
+	};
+
+	static _SlabClass _g_slabClasses[SIZE_CLASS_COUNT];
+	static sl_reg _g_slabReservedSize = 0;
+
+	SLIB_THREAD _SlabThreadCache _gt_slabCache;
+	// 0: not attached, 1: attached, 2: released (thread is finishing)
+	SLIB_THREAD sl_uint32 _gt_slabCacheState = 0;
+
+	SLIB_INLINE static sl_size _SlabAllocator_getBlockSize(sl_uint32 index)
+	{
+		return (sl_size)(index + 1) << SIZE_CLASS_SHIFT;
+	}
+
+	SLIB_INLINE static sl_uint32 _SlabAllocator_getBatchCount(sl_uint32 index)
+	{
+		sl_uint32 n = (sl_uint32)(BATCH_BYTES / _SlabAllocator_getBlockSize(index));
+		return n < BATCH_MIN_COUNT ? BATCH_MIN_COUNT : n;
+	}
+
+	SLIB_INLINE static SpinLock* _SlabAllocator_getLock(_SlabClass* c)
+	{
+		return reinterpret_cast<SpinLock*>(&(c->lock));
+	}
+
+	// returns the number of blocks linked to `first`
+	static sl_uint32 _SlabAllocator_fetch(sl_uint32 index, sl_uint32 count, _SlabBlock*& first)
+	{
+		_SlabClass* c = _g_slabClasses + index;
+		sl_size sizeBlock = _SlabAllocator_getBlockSize(index);
+		_SlabBlock* list = sl_null;
+		sl_uint32 n = 0;
+		SpinLocker lock(_SlabAllocator_getLock(c));
+		while (n < count) {
+			_SlabBlock* block = c->freeList;
+			if (block) {
+				c->freeList = block->next;
+			} else {
+				if (c->sizeSlabRemain < sizeBlock) {
+					sl_uint8* slab = (sl_uint8*)(Base::createMemory(SLAB_SIZE));
+					if (!slab) {
+						break;
+					}
+					Base::interlockedAdd(&_g_slabReservedSize, SLAB_SIZE);
+					c->slab = slab;
+					c->sizeSlabRemain = SLAB_SIZE;
+				}
+				block = (_SlabBlock*)(c->slab);
+				c->slab += sizeBlock;
+				c->sizeSlabRemain -= sizeBlock;
+			}
+			block->next = list;
+			list = block;
+			n++;
+		}
+		first = list;
+		return n;
+	}
+
+	static void _SlabAllocator_release(sl_uint32 index, _SlabBlock* first, _SlabBlock* last)
+	{
+		_SlabClass* c = _g_slabClasses + index;
+		SpinLocker lock(_SlabAllocator_getLock(c));
+		last->next = c->freeList;
+		c->freeList = first;
+	}
+
+	class _SlabThreadCacheReleaser
+	{
+	public:
+		~_SlabThreadCacheReleaser()
+		{
+			_gt_slabCacheState = 2;
+			for (sl_uint32 i = 0; i < SIZE_CLASS_COUNT; i++) {
+				_SlabBlock* first = _gt_slabCache.list[i];
+				if (first) {
+					_SlabBlock* last = first;
+					while (last->next) {
+						last = last->next;
+					}
+					_SlabAllocator_release(i, first, last);
+					_gt_slabCache.list[i] = sl_null;
+					_gt_slabCache.count[i] = 0;
+				}
+			}
+		}
+	};
+
+	static sl_bool _SlabAllocator_attachThreadCache()
+	{
+		sl_uint32 state = _gt_slabCacheState;
+		if (state == 1) {
+			return sl_true;
+		}
+		if (state) {
+			return sl_false;
+		}
+		// registers the releaser to be destructed when the thread is finished
+		static SLIB_THREAD _SlabThreadCacheReleaser releaser;
+		SLIB_UNUSED(releaser);
+		_gt_slabCacheState = 1;
+		return sl_true;
+	}
+
+	void* SlabAllocator::allocate(sl_size size) noexcept
+	{
+		if (size > SLIB_SLAB_ALLOCATOR_MAX_SIZE) {
+			return Base::createMemory(size);
+		}
+		sl_uint32 index = size ? (sl_uint32)((size - 1) >> SIZE_CLASS_SHIFT) : 0;
+		_SlabBlock* block;
+		if (_SlabAllocator_attachThreadCache()) {
+			block = _gt_slabCache.list[index];
+			if (!block) {
+				sl_uint32 n = _SlabAllocator_fetch(index, _SlabAllocator_getBatchCount(index), block);
+				if (!n) {
+					return sl_null;
+				}
+				_gt_slabCache.count[index] = n;
+			}
+			_gt_slabCache.list[index] = block->next;
+			_gt_slabCache.count[index]--;
+		} else {
+			if (!(_SlabAllocator_fetch(index, 1, block))) {
+				return sl_null;
+			}
+		}
+		return block;
+	}
+
+	void SlabAllocator::free(void* ptr, sl_size size) noexcept
+	{
+		if (!ptr) {
+			return;
+		}
+		if (size > SLIB_SLAB_ALLOCATOR_MAX_SIZE) {
+			Base::freeMemory(ptr);
+			return;
+		}
+		sl_uint32 index = size ? (sl_uint32)((size - 1) >> SIZE_CLASS_SHIFT) : 0;
+		_SlabBlock* block = (_SlabBlock*)ptr;
+		if (_SlabAllocator_attachThreadCache()) {
+			block->next = _gt_slabCache.list[index];
+			_gt_slabCache.list[index] = block;
+			sl_uint32 count = ++(_gt_slabCache.count[index]);
+			sl_uint32 nBatch = _SlabAllocator_getBatchCount(index);
+			if (count >= nBatch * 2) {
+				// returns a batch to the shared list
+				_SlabBlock* last = block;
+				for (sl_uint32 i = 1; i < nBatch; i++) {
+					last = last->next;
+				}
+				_gt_slabCache.list[index] = last->next;
+				_gt_slabCache.count[index] = count - nBatch;
+				_SlabAllocator_release(index, block, last);
+			}
+		} else {
+			_SlabAllocator_release(index, block, block);
+		}
+	}
+
+	sl_size SlabAllocator::getReservedSize() noexcept
+	{
+		return (sl_size)_g_slabReservedSize;
+	}
+
+#else
+
+	void* SlabAllocator::allocate(sl_size size) noexcept
+	{
+		return Base::createMemory(size ? size : 1);
+	}
+
+	void SlabAllocator::free(void* ptr, sl_size size) noexcept
+	{
+		Base::freeMemory(ptr);
+	}
+
+	sl_size SlabAllocator::getReservedSize() noexcept
+	{
+		return 0;
+	}
+
+#endif
+
+}
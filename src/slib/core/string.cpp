@@ -1835,13 +1835,8 @@ namespace slib
 	template <class CT>
 	SLIB_INLINE static sl_uint32 _priv_String_calcHash(const CT* buf, sl_size len) noexcept
 	{
-		sl_uint32 hash = 0;
-		for (sl_size i = 0; i < len; i++) {
-			sl_uint32 ch = buf[i];
-			hash = hash * 31 + ch;
-		}
-		hash = Rehash(hash);
-		return hash;
+		// seeded per process, so that the keys colliding in the hash tables can not be prepared
+		return (sl_uint32)(HashBytes64(buf, len * sizeof(CT), GetHashSeed()));
 	}
 
 	sl_uint32 String::getHashCode() const noexcept
@@ -27,6 +27,7 @@ namespace slib
 
 		m_handle = sl_null;
 		m_priority = ThreadPriority::Normal;
+		m_cpuAffinity = -1;
 	}
 
 	Thread::~Thread()
@@ -69,6 +70,9 @@ namespace slib
 				if (m_priority != ThreadPriority::Normal) {
 					_nativeSetPriority();
 				}
+				if (m_cpuAffinity >= 0) {
+					_nativeSetCpuAffinity();
+				}
 				return sl_true;
 			} else {
 				m_flagRunning = sl_false;
@@ -170,6 +174,24 @@ namespace slib
 		_nativeSetPriority();
 	}
 
+	sl_int32 Thread::getCpuAffinity()
+	{
+		return m_cpuAffinity;
+	}
+
+	sl_bool Thread::setCpuAffinity(sl_int32 cpuIndex)
+	{
+		ObjectLocker lock(this);
+		if (cpuIndex < 0) {
+			cpuIndex = -1;
+		}
+		m_cpuAffinity = cpuIndex;
+		if (m_handle) {
+			return _nativeSetCpuAffinity();
+		}
+		return sl_true;
+	}
+
 	sl_bool Thread::isRunning()
 	{
 		return m_flagRunning;
@@ -127,6 +127,12 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::_nativeSetCpuAffinity()
+	{
+		// not supported: the scheduler of Darwin does not bind the threads to the processors
+		return sl_false;
+	}
+
 }
 
 #endif
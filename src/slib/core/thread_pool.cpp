@@ -10,28 +10,150 @@
 
 #include "slib/core/thread_pool.h"
 
+#include "slib/core/new_helper.h"
+
+#define THREAD_POOL_STEALING_QUEUE_INIT_SIZE 64
+
 namespace slib
 {
 
+	class ThreadPool::StealingWorker
+	{
+	public:
+		ThreadPool* pool;
+		sl_uint32 index;
+		
+		SpinLock lock;
+		Function<void()>* tasks;
+		sl_size capacity;
+		sl_size first;
+		sl_size count;
+		
+		sl_int32 flagParked;
+		Ref<Event> eventWake;
+		
+	public:
+		StealingWorker()
+		{
+			pool = sl_null;
+			index = 0;
+			tasks = sl_null;
+			capacity = 0;
+			first = 0;
+			count = 0;
+			flagParked = 0;
+		}
+		
+		~StealingWorker()
+		{
+			if (tasks) {
+				NewHelper< Function<void()> >::free(tasks, capacity);
+			}
+		}
+		
+	public:
+		// called by any thread; the owner pushes its own sub-tasks here too
+		sl_bool pushBack(const Function<void()>& task)
+		{
+			SpinLocker lock(&(this->lock));
+			if (count >= capacity) {
+				sl_size capacityNew = capacity ? (capacity << 1) : THREAD_POOL_STEALING_QUEUE_INIT_SIZE;
+				Function<void()>* tasksNew = NewHelper< Function<void()> >::create(capacityNew);
+				if (!tasksNew) {
+					return sl_false;
+				}
+				for (sl_size i = 0; i < count; i++) {
+					tasksNew[i] = Move(tasks[(first + i) & (capacity - 1)]);
+				}
+				if (tasks) {
+					NewHelper< Function<void()> >::free(tasks, capacity);
+				}
+				tasks = tasksNew;
+				capacity = capacityNew;
+				first = 0;
+			}
+			tasks[(first + count) & (capacity - 1)] = task;
+			count++;
+			return sl_true;
+		}
+		
+		// called by the owner: newest task first, its data is most likely still in cache
+		sl_bool popBack(Function<void()>& task)
+		{
+			SpinLocker lock(&(this->lock));
+			if (count == 0) {
+				return sl_false;
+			}
+			count--;
+			Function<void()>& slot = tasks[(first + count) & (capacity - 1)];
+			task = Move(slot);
+			slot.setNull();
+			return sl_true;
+		}
+		
+		// called by thieves: oldest task first
+		sl_bool popFront(Function<void()>& task)
+		{
+			SpinLocker lock(&(this->lock));
+			if (count == 0) {
+				return sl_false;
+			}
+			Function<void()>& slot = tasks[first];
+			task = Move(slot);
+			slot.setNull();
+			first = (first + 1) & (capacity - 1);
+			count--;
+			return sl_true;
+		}
+		
+	};
+	
+	SLIB_THREAD void* _gt_threadPoolStealingWorkerCurrent = sl_null;
+
 	SLIB_DEFINE_OBJECT(ThreadPool, Dispatcher)
 
 	ThreadPool::ThreadPool()
 	{
 		setThreadStackSize(SLIB_THREAD_DEFAULT_STACK_SIZE);
 		m_flagRunning = sl_true;
+		m_mode = ThreadPoolMode::Shared;
+		
+		m_stealingWorkers = sl_null;
+		m_nStealingWorkers = 0;
+		m_nStealingWorkersStarted = 0;
+		m_nStealingWorkersParked = 0;
+		m_indexStealingSubmit = 0;
 	}
 
 	ThreadPool::~ThreadPool()
 	{
 		release();
+		if (m_stealingWorkers) {
+			for (sl_uint32 i = 0; i < m_nStealingWorkers; i++) {
+				delete m_stealingWorkers[i];
+			}
+			Base::freeMemory(m_stealingWorkers);
+		}
 	}
 
-	Ref<ThreadPool> ThreadPool::create(sl_uint32 minThreads, sl_uint32 maxThreads)
+	Ref<ThreadPool> ThreadPool::create(sl_uint32 minThreads, sl_uint32 maxThreads, ThreadPoolMode mode)
 	{
 		Ref<ThreadPool> ret = new ThreadPool();
 		if (ret.isNotNull()) {
 			ret->setMinimumThreadsCount(minThreads);
 			ret->setMaximumThreadsCount(maxThreads);
+			ret->m_mode = mode;
+			if (mode == ThreadPoolMode::WorkStealing) {
+				if (!(ret->_initStealingWorkers())) {
+					return sl_null;
+				}
+				// the minimum workers wait for the tasks from the start
+				while ((sl_uint32)(ret->m_nStealingWorkersStarted) < minThreads) {
+					if (!(ret->_startStealingWorker())) {
+						break;
+					}
+				}
+			}
 		}
 		return ret;
 	}
@@ -44,11 +166,20 @@ namespace slib
 		}
 		m_flagRunning = sl_false;
 		
-		ListElements< Ref<Thread> > threads(m_threadWorkers);
+		// the workers are joined without the lock: an idle worker locks the pool to remove itself from the list or to start another worker
+		ListElements< Ref<Thread> > threads(List< Ref<Thread> >(m_threadWorkers.getData(), m_threadWorkers.getCount()));
+		lock.unlock();
+		
 		sl_size i;
 		for (i = 0; i < threads.count; i++) {
 			threads[i]->finish();
 		}
+		if (m_stealingWorkers) {
+			// the parked workers are waiting on their own events
+			for (i = 0; i < m_nStealingWorkers; i++) {
+				m_stealingWorkers[i]->eventWake->set();
+			}
+		}
 		for (i = 0; i < threads.count; i++) {
 			threads[i]->finishAndWait();
 		}
@@ -63,12 +194,20 @@ namespace slib
 	{
 		return (sl_uint32)(m_threadWorkers.getCount());
 	}
+	
+	ThreadPoolMode ThreadPool::getMode()
+	{
+		return m_mode;
+	}
 
 	sl_bool ThreadPool::addTask(const Function<void()>& task)
 	{
 		if (task.isNull()) {
 			return sl_false;
 		}
+		if (m_mode == ThreadPoolMode::WorkStealing) {
+			return _addTaskStealing(task);
+		}
 		ObjectLocker lock(this);
 		if (!m_flagRunning) {
 			return sl_false;
@@ -104,7 +243,13 @@ namespace slib
 
 	sl_bool ThreadPool::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
 	{
-		return addTask(callback);
+		if (delay_ms == 0) {
+			return addTask(callback);
+		}
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		return setTimeout(callback, delay_ms).isNotNull();
 	}
 
 	void ThreadPool::onRunWorker()
@@ -127,4 +272,150 @@ namespace slib
 		}
 	}
 
+	
+	/*
+		In WorkStealing mode, the worker slots are allocated once (MaximumThreadsCount) and
+		threads are started on demand, at least MinimumThreadsCount. Started workers are kept
+		until the pool is released: an idle worker parks on its event until a submission wakes it.
+	*/
+	sl_bool ThreadPool::_initStealingWorkers()
+	{
+		sl_uint32 n = getMaximumThreadsCount();
+		if (n == 0) {
+			n = 1;
+		}
+		StealingWorker** workers = (StealingWorker**)(Base::createZeroMemory(sizeof(StealingWorker*) * n));
+		if (!workers) {
+			return sl_false;
+		}
+		m_stealingWorkers = workers;
+		for (sl_uint32 i = 0; i < n; i++) {
+			StealingWorker* worker = new StealingWorker;
+			if (!worker) {
+				return sl_false;
+			}
+			worker->pool = this;
+			worker->index = i;
+			worker->eventWake = Event::create(sl_true);
+			if (worker->eventWake.isNull()) {
+				delete worker;
+				return sl_false;
+			}
+			workers[i] = worker;
+			m_nStealingWorkers = i + 1;
+		}
+		return sl_true;
+	}
+	
+	sl_bool ThreadPool::_startStealingWorker()
+	{
+		ObjectLocker lock(this);
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		sl_uint32 index = (sl_uint32)m_nStealingWorkersStarted;
+		if (index >= m_nStealingWorkers) {
+			return sl_false;
+		}
+		StealingWorker* worker = m_stealingWorkers[index];
+		Ref<Thread> thread = Thread::start(SLIB_BIND_CLASS(void(), ThreadPool, _runStealingWorker, this, worker), getThreadStackSize());
+		if (thread.isNull()) {
+			return sl_false;
+		}
+		m_threadWorkers.add_NoLock(thread);
+		Base::interlockedIncrement32(&m_nStealingWorkersStarted);
+		return sl_true;
+	}
+	
+	sl_bool ThreadPool::_addTaskStealing(const Function<void()>& task)
+	{
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		StealingWorker* worker = (StealingWorker*)_gt_threadPoolStealingWorkerCurrent;
+		if (!worker || worker->pool != this) {
+			// submitted from outside of the pool: distribute over the started workers
+			sl_uint32 n = (sl_uint32)m_nStealingWorkersStarted;
+			if (n == 0) {
+				n = 1;
+			}
+			sl_uint32 index = ((sl_uint32)(Base::interlockedIncrement32(&m_indexStealingSubmit))) % n;
+			worker = m_stealingWorkers[index];
+		}
+		if (!(worker->pushBack(task))) {
+			return sl_false;
+		}
+		_wakeStealingWorker();
+		return sl_true;
+	}
+	
+	sl_bool ThreadPool::_popTaskStealing(StealingWorker* worker, Function<void()>& task)
+	{
+		if (worker->popBack(task)) {
+			return sl_true;
+		}
+		sl_uint32 n = m_nStealingWorkers;
+		for (sl_uint32 i = 1; i < n; i++) {
+			StealingWorker* victim = m_stealingWorkers[(worker->index + i) % n];
+			if (victim->popFront(task)) {
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+	
+	void ThreadPool::_wakeStealingWorker()
+	{
+		if ((sl_uint32)m_nStealingWorkersStarted < getMinimumThreadsCount()) {
+			if (_startStealingWorker()) {
+				return;
+			}
+		}
+		// interlocked read: pairs with the increment done by a parking worker before it re-checks the queues
+		if (Base::interlockedAdd32(&m_nStealingWorkersParked, 0) > 0) {
+			sl_uint32 n = (sl_uint32)m_nStealingWorkersStarted;
+			for (sl_uint32 i = 0; i < n; i++) {
+				StealingWorker* worker = m_stealingWorkers[i];
+				if (Base::interlockedCompareExchange32(&(worker->flagParked), 0, 1)) {
+					Base::interlockedDecrement32(&m_nStealingWorkersParked);
+					worker->eventWake->set();
+					return;
+				}
+			}
+		}
+		if ((sl_uint32)m_nStealingWorkersStarted < m_nStealingWorkers) {
+			_startStealingWorker();
+		}
+	}
+	
+	void ThreadPool::_runStealingWorker(StealingWorker* worker)
+	{
+		_gt_threadPoolStealingWorkerCurrent = worker;
+		Function<void()> task;
+		while (m_flagRunning && Thread::isNotStoppingCurrent()) {
+			if (_popTaskStealing(worker, task)) {
+				task();
+				task.setNull();
+				continue;
+			}
+			Base::interlockedCompareExchange32(&(worker->flagParked), 1, 0);
+			Base::interlockedIncrement32(&m_nStealingWorkersParked);
+			// re-check after announcing, so that a concurrent submission is never missed
+			if (_popTaskStealing(worker, task)) {
+				if (Base::interlockedCompareExchange32(&(worker->flagParked), 0, 1)) {
+					Base::interlockedDecrement32(&m_nStealingWorkersParked);
+				}
+				task();
+				task.setNull();
+				continue;
+			}
+			// woken by `_wakeStealingWorker()` on the submission, or by `release()`
+			worker->eventWake->wait();
+			if (Base::interlockedCompareExchange32(&(worker->flagParked), 0, 1)) {
+				Base::interlockedDecrement32(&m_nStealingWorkersParked);
+			}
+		}
+		_gt_threadPoolStealingWorkerCurrent = sl_null;
+	}
+
 }
@@ -13,6 +13,7 @@
 #if defined(SLIB_PLATFORM_IS_UNIX) && !defined(SLIB_PLATFORM_IS_APPLE)
 
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
 
 #include "slib/core/thread.h"
@@ -114,6 +115,29 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::_nativeSetCpuAffinity()
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX) && !defined(SLIB_PLATFORM_IS_ANDROID)
+		pthread_t thread = (pthread_t)m_handle;
+		if (thread) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			if (m_cpuAffinity >= 0) {
+				if (m_cpuAffinity >= CPU_SETSIZE) {
+					return sl_false;
+				}
+				CPU_SET(m_cpuAffinity, &set);
+			} else {
+				for (int i = 0; i < CPU_SETSIZE; i++) {
+					CPU_SET(i, &set);
+				}
+			}
+			return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+		}
+#endif
+		return sl_false;
+	}
+
 }
 
 #endif
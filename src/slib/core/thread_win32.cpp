@@ -83,6 +83,27 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::_nativeSetCpuAffinity()
+	{
+		HANDLE hThread = (HANDLE)m_handle;
+		if (hThread) {
+			DWORD_PTR mask;
+			if (m_cpuAffinity >= 0) {
+				if (m_cpuAffinity >= (sl_int32)(sizeof(DWORD_PTR) * 8)) {
+					return sl_false;
+				}
+				mask = ((DWORD_PTR)1) << m_cpuAffinity;
+			} else {
+				DWORD_PTR maskSystem;
+				if (!(GetProcessAffinityMask(GetCurrentProcess(), &mask, &maskSystem))) {
+					return sl_false;
+				}
+			}
+			return SetThreadAffinityMask(hThread, mask) != 0;
+		}
+		return sl_false;
+	}
+
 	void Thread::_nativeClose()
 	{
 		if (m_handle) {
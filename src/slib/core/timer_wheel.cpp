@@ -0,0 +1,391 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/timer_wheel.h"
+
+#include "slib/core/safe_static.h"
+
+#define LEVEL0_MASK (SLIB_TIMER_WHEEL_LEVEL0_SIZE - 1)
+#define LEVEL_MASK (SLIB_TIMER_WHEEL_LEVEL_SIZE - 1)
+#define SLOT_BASE(LEVEL) (SLIB_TIMER_WHEEL_LEVEL0_SIZE + ((LEVEL) - 1) * SLIB_TIMER_WHEEL_LEVEL_SIZE)
+#define LEVEL_SHIFT(LEVEL) (SLIB_TIMER_WHEEL_LEVEL0_BITS + ((LEVEL) - 1) * SLIB_TIMER_WHEEL_LEVEL_BITS)
+#define SLOTS_COUNT (SLIB_TIMER_WHEEL_LEVEL0_SIZE + (SLIB_TIMER_WHEEL_LEVELS - 1) * SLIB_TIMER_WHEEL_LEVEL_SIZE)
+#define MAX_RANGE (((sl_uint64)1) << LEVEL_SHIFT(SLIB_TIMER_WHEEL_LEVELS))
+#define MAX_THREAD_WAIT 10000
+
+namespace slib
+{
+
+	SLIB_DEFINE_OBJECT(TimerWheelTask, Referable)
+
+	TimerWheelTask::TimerWheelTask()
+	{
+		m_timeExpire = 0;
+		m_slot = sl_null;
+		m_prev = sl_null;
+		m_next = sl_null;
+	}
+
+	TimerWheelTask::~TimerWheelTask()
+	{
+	}
+
+	sl_bool TimerWheelTask::cancel()
+	{
+		Ref<TimerWheel> wheel(m_wheel);
+		if (wheel.isNotNull()) {
+			return wheel->cancel(this);
+		}
+		return sl_false;
+	}
+
+	sl_bool TimerWheelTask::isPending()
+	{
+		return m_slot != sl_null;
+	}
+
+	const Function<void()>& TimerWheelTask::getTask()
+	{
+		return m_task;
+	}
+
+
+	SLIB_DEFINE_OBJECT(TimerWheel, Object)
+
+	TimerWheel::TimerWheel()
+	{
+		m_tickCurrent = 0;
+		m_nTasks = 0;
+		for (sl_uint32 i = 0; i < SLOTS_COUNT; i++) {
+			m_slots[i] = sl_null;
+		}
+		m_tickWake = 0;
+	}
+
+	TimerWheel::~TimerWheel()
+	{
+		release();
+	}
+
+	Ref<TimerWheel> TimerWheel::create()
+	{
+		return new TimerWheel;
+	}
+
+	Ref<TimerWheel> TimerWheel::createWithThread()
+	{
+		Ref<TimerWheel> ret = new TimerWheel;
+		if (ret.isNotNull()) {
+			ret->m_eventWake = Event::create();
+			if (ret->m_eventWake.isNotNull()) {
+				ret->m_thread = Thread::start(SLIB_FUNCTION_CLASS(TimerWheel, _runThread, ret.get()));
+				if (ret->m_thread.isNotNull()) {
+					return ret;
+				}
+			}
+		}
+		return sl_null;
+	}
+
+	Ref<TimerWheel> TimerWheel::getDefault()
+	{
+		SLIB_SAFE_STATIC(Ref<TimerWheel>, ret, createWithThread())
+		if (SLIB_SAFE_STATIC_CHECK_FREED(ret)) {
+			return sl_null;
+		}
+		return ret;
+	}
+
+	void TimerWheel::releaseDefault()
+	{
+		Ref<TimerWheel> wheel = getDefault();
+		if (wheel.isNotNull()) {
+			wheel->release();
+		}
+	}
+
+	void TimerWheel::release()
+	{
+		Ref<Thread> thread = m_thread;
+		if (thread.isNotNull()) {
+			thread->finish();
+			m_eventWake->set();
+			thread->finishAndWait();
+			m_thread.setNull();
+		}
+
+		MutexLocker lock(&m_lockWheel);
+		TimerWheelTask* tasks = sl_null;
+		for (sl_uint32 i = 0; i < SLOTS_COUNT; i++) {
+			TimerWheelTask* task = m_slots[i];
+			while (task) {
+				TimerWheelTask* next = task->m_next;
+				task->m_slot = sl_null;
+				task->m_prev = sl_null;
+				task->m_next = tasks;
+				tasks = task;
+				task = next;
+			}
+			m_slots[i] = sl_null;
+		}
+		m_nTasks = 0;
+		lock.unlock();
+
+		while (tasks) {
+			TimerWheelTask* next = tasks->m_next;
+			tasks->m_next = sl_null;
+			tasks->decreaseReference();
+			tasks = next;
+		}
+	}
+
+	Ref<TimerWheelTask> TimerWheel::add(const Function<void()>& callback, sl_uint64 delay_ms)
+	{
+		if (callback.isNull()) {
+			return sl_null;
+		}
+		Ref<TimerWheelTask> task = new TimerWheelTask;
+		if (task.isNull()) {
+			return sl_null;
+		}
+		task->m_task = callback;
+		task->m_wheel = this;
+		sl_bool flagWake = sl_false;
+		{
+			MutexLocker lock(&m_lockWheel);
+			sl_uint64 now = m_timeCounter.getElapsedMilliseconds();
+			if (m_nTasks == 0 && m_tickCurrent <= now) {
+				// nothing to fire in the skipped ticks
+				m_tickCurrent = now + 1;
+			}
+			task->m_timeExpire = now + delay_ms;
+			task->increaseReference();
+			_insert(task.get());
+			m_nTasks++;
+			if (m_thread.isNotNull() && task->m_timeExpire < m_tickWake) {
+				m_tickWake = task->m_timeExpire;
+				flagWake = sl_true;
+			}
+		}
+		if (flagWake) {
+			m_eventWake->set();
+		}
+		return task;
+	}
+
+	sl_bool TimerWheel::cancel(TimerWheelTask* task)
+	{
+		if (!task) {
+			return sl_false;
+		}
+		MutexLocker lock(&m_lockWheel);
+		if (task->m_slot) {
+			_unlink(task);
+			m_nTasks--;
+			lock.unlock();
+			task->decreaseReference();
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	sl_size TimerWheel::getCount()
+	{
+		return m_nTasks;
+	}
+
+	sl_uint64 TimerWheel::getElapsedMilliseconds()
+	{
+		MutexLocker lock(&m_lockWheel);
+		return m_timeCounter.getElapsedMilliseconds();
+	}
+
+	sl_int32 TimerWheel::process()
+	{
+		TimerWheelTask* expired = sl_null;
+		sl_int32 timeout;
+		{
+			MutexLocker lock(&m_lockWheel);
+			m_timeCounter.update();
+			_advance(m_timeCounter.getElapsedMilliseconds(), expired);
+			timeout = _getTimeout();
+			if (m_thread.isNotNull()) {
+				if (timeout < 0 || timeout > MAX_THREAD_WAIT) {
+					m_tickWake = m_tickCurrent + MAX_THREAD_WAIT;
+				} else {
+					m_tickWake = m_tickCurrent + timeout;
+				}
+			}
+		}
+		while (expired) {
+			TimerWheelTask* next = expired->m_next;
+			expired->m_next = sl_null;
+			expired->m_task();
+			expired->decreaseReference();
+			expired = next;
+		}
+		return timeout;
+	}
+
+	void TimerWheel::_insert(TimerWheelTask* task)
+	{
+		sl_uint64 current = m_tickCurrent;
+		sl_uint64 expire = task->m_timeExpire;
+		if (expire < current) {
+			expire = current;
+		}
+		sl_uint64 delta = expire - current;
+		sl_uint32 index;
+		if (delta < SLIB_TIMER_WHEEL_LEVEL0_SIZE) {
+			index = (sl_uint32)(expire & LEVEL0_MASK);
+		} else {
+			sl_uint32 level = 1;
+			while (level < SLIB_TIMER_WHEEL_LEVELS - 1 && delta >= (((sl_uint64)1) << LEVEL_SHIFT(level + 1))) {
+				level++;
+			}
+			if (delta >= MAX_RANGE) {
+				// parked in the last slot of the top level, and re-inserted when cascaded
+				expire = current + MAX_RANGE - 1;
+			}
+			index = SLOT_BASE(level) + (sl_uint32)((expire >> LEVEL_SHIFT(level)) & LEVEL_MASK);
+		}
+		TimerWheelTask** slot = m_slots + index;
+		TimerWheelTask* first = *slot;
+		task->m_slot = slot;
+		task->m_prev = sl_null;
+		task->m_next = first;
+		if (first) {
+			first->m_prev = task;
+		}
+		*slot = task;
+	}
+
+	void TimerWheel::_unlink(TimerWheelTask* task)
+	{
+		TimerWheelTask* prev = task->m_prev;
+		TimerWheelTask* next = task->m_next;
+		if (prev) {
+			prev->m_next = next;
+		} else {
+			*(task->m_slot) = next;
+		}
+		if (next) {
+			next->m_prev = prev;
+		}
+		task->m_slot = sl_null;
+		task->m_prev = sl_null;
+		task->m_next = sl_null;
+	}
+
+	void TimerWheel::_cascade(sl_uint32 level)
+	{
+		sl_uint32 index = SLOT_BASE(level) + (sl_uint32)((m_tickCurrent >> LEVEL_SHIFT(level)) & LEVEL_MASK);
+		TimerWheelTask* task = m_slots[index];
+		m_slots[index] = sl_null;
+		while (task) {
+			TimerWheelTask* next = task->m_next;
+			_insert(task);
+			task = next;
+		}
+	}
+
+	void TimerWheel::_advance(sl_uint64 now, TimerWheelTask*& expired)
+	{
+		TimerWheelTask* last = sl_null;
+		while (m_tickCurrent <= now) {
+			if (m_nTasks == 0) {
+				m_tickCurrent = now + 1;
+				break;
+			}
+			sl_uint32 index = (sl_uint32)(m_tickCurrent & LEVEL0_MASK);
+			if (!index) {
+				for (sl_uint32 level = 1; level < SLIB_TIMER_WHEEL_LEVELS; level++) {
+					_cascade(level);
+					if ((m_tickCurrent >> LEVEL_SHIFT(level)) & LEVEL_MASK) {
+						break;
+					}
+				}
+			}
+			TimerWheelTask* task = m_slots[index];
+			m_slots[index] = sl_null;
+			while (task) {
+				TimerWheelTask* next = task->m_next;
+				task->m_slot = sl_null;
+				task->m_prev = sl_null;
+				task->m_next = sl_null;
+				if (last) {
+					last->m_next = task;
+				} else {
+					expired = task;
+				}
+				last = task;
+				m_nTasks--;
+				task = next;
+			}
+			m_tickCurrent++;
+		}
+	}
+
+	sl_int32 TimerWheel::_getTimeout()
+	{
+		if (m_nTasks == 0) {
+			return -1;
+		}
+		// `m_tickCurrent` is the first tick not processed yet, and it becomes due after 1 millisecond
+		sl_uint64 current = m_tickCurrent;
+		sl_uint64 delta = MAX_RANGE;
+		sl_uint32 index = (sl_uint32)(current & LEVEL0_MASK);
+		for (sl_uint32 i = 0; i < SLIB_TIMER_WHEEL_LEVEL0_SIZE; i++) {
+			if (m_slots[(index + i) & LEVEL0_MASK]) {
+				delta = i;
+				break;
+			}
+		}
+		// the tasks of the upper levels are due at least when their slots are cascaded
+		for (sl_uint32 level = 1; level < SLIB_TIMER_WHEEL_LEVELS; level++) {
+			sl_uint32 shift = LEVEL_SHIFT(level);
+			sl_uint64 range = current >> shift;
+			// the slot of the current range is not cascaded yet when the lower levels are at the beginning
+			sl_uint32 k = 0;
+			if (current & ((((sl_uint64)1) << shift) - 1)) {
+				if (((range + 1) << shift) - current >= delta) {
+					// the upper levels are cascaded later
+					break;
+				}
+				k = 1;
+			}
+			for (; k < SLIB_TIMER_WHEEL_LEVEL_SIZE; k++) {
+				if (m_slots[SLOT_BASE(level) + (sl_uint32)((range + k) & LEVEL_MASK)]) {
+					sl_uint64 d = ((range + k) << shift) - current;
+					if (d < delta) {
+						delta = d;
+					}
+					break;
+				}
+			}
+		}
+		if (delta >= 0x7fffffff) {
+			return 0x7fffffff;
+		}
+		return (sl_int32)delta + 1;
+	}
+
+	void TimerWheel::_runThread()
+	{
+		while (Thread::isNotStoppingCurrent()) {
+			sl_int32 t = process();
+			if (t < 0 || t > MAX_THREAD_WAIT) {
+				t = MAX_THREAD_WAIT;
+			}
+			m_eventWake->wait(t);
+		}
+	}
+
+}
@@ -12,6 +12,17 @@
 
 #include "slib/crypto/sha2.h"
 #include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define PRIV_SLIB_AES_NI
+#	include <wmmintrin.h>
+#	if defined(_MSC_VER)
+#		define PRIV_SLIB_AES_NI_FUNC static
+#	else
+#		define PRIV_SLIB_AES_NI_FUNC static __attribute__((target("aes,sse2")))
+#	endif
+#endif
 
 /*
 	AES - Advanced Encryption Standard
@@ -24,6 +35,7 @@ namespace slib
 
 	AES::AES()
 	{
+		m_flagNI = sl_false;
 	}
 
 	AES::~AES()
@@ -353,9 +365,87 @@ static const sl_uint32 _AES_RT3[256] = { RT };
 			W += 4;
 		}
 		Base::copyMemory(W, WE, 32);
+
+#if defined(PRIV_SLIB_AES_NI)
+		if (CPU::isAESNISupported()) {
+			// AES-NI uses the same (equivalent inverse cipher) round keys in the byte order
+			j = (nRounds + 1) << 2;
+			for (i = 0; i < j; i++) {
+				MIO::writeUint32BE(m_roundKeyEncNI + (i << 2), m_roundKeyEnc[i]);
+				MIO::writeUint32BE(m_roundKeyDecNI + (i << 2), m_roundKeyDec[i]);
+			}
+			m_flagNI = sl_true;
+		} else {
+			m_flagNI = sl_false;
+		}
+#endif
 		return sl_true;
 	}
 
+#if defined(PRIV_SLIB_AES_NI)
+
+/*
+	AES-NI
+
+	The rounds of 8 blocks are interleaved to hide the latency of AESENC/AESDEC instructions.
+*/
+
+#define PRIV_SLIB_AES_NI_DEFINE_PROCESS(NAME, ROUND, ROUND_LAST) \
+	PRIV_SLIB_AES_NI_FUNC void NAME(const sl_uint8* W, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) \
+	{ \
+		const __m128i* K = (const __m128i*)W; \
+		sl_uint32 i; \
+		while (nBlocks >= 8) { \
+			__m128i k = _mm_loadu_si128(K); \
+			__m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src), k); \
+			__m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 1), k); \
+			__m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 2), k); \
+			__m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 3), k); \
+			__m128i b4 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 4), k); \
+			__m128i b5 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 5), k); \
+			__m128i b6 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 6), k); \
+			__m128i b7 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src + 7), k); \
+			for (i = 1; i < nRounds; i++) { \
+				k = _mm_loadu_si128(K + i); \
+				b0 = ROUND(b0, k); \
+				b1 = ROUND(b1, k); \
+				b2 = ROUND(b2, k); \
+				b3 = ROUND(b3, k); \
+				b4 = ROUND(b4, k); \
+				b5 = ROUND(b5, k); \
+				b6 = ROUND(b6, k); \
+				b7 = ROUND(b7, k); \
+			} \
+			k = _mm_loadu_si128(K + nRounds); \
+			_mm_storeu_si128((__m128i*)dst, ROUND_LAST(b0, k)); \
+			_mm_storeu_si128((__m128i*)dst + 1, ROUND_LAST(b1, k)); \
+			_mm_storeu_si128((__m128i*)dst + 2, ROUND_LAST(b2, k)); \
+			_mm_storeu_si128((__m128i*)dst + 3, ROUND_LAST(b3, k)); \
+			_mm_storeu_si128((__m128i*)dst + 4, ROUND_LAST(b4, k)); \
+			_mm_storeu_si128((__m128i*)dst + 5, ROUND_LAST(b5, k)); \
+			_mm_storeu_si128((__m128i*)dst + 6, ROUND_LAST(b6, k)); \
+			_mm_storeu_si128((__m128i*)dst + 7, ROUND_LAST(b7, k)); \
+			src += 128; \
+			dst += 128; \
+			nBlocks -= 8; \
+		} \
+		while (nBlocks) { \
+			__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)src), _mm_loadu_si128(K)); \
+			for (i = 1; i < nRounds; i++) { \
+				b = ROUND(b, _mm_loadu_si128(K + i)); \
+			} \
+			_mm_storeu_si128((__m128i*)dst, ROUND_LAST(b, _mm_loadu_si128(K + nRounds))); \
+			src += 16; \
+			dst += 16; \
+			nBlocks--; \
+		} \
+	}
+
+	PRIV_SLIB_AES_NI_DEFINE_PROCESS(_priv_AES_NI_encryptBlocks, _mm_aesenc_si128, _mm_aesenclast_si128)
+	PRIV_SLIB_AES_NI_DEFINE_PROCESS(_priv_AES_NI_decryptBlocks, _mm_aesdec_si128, _mm_aesdeclast_si128)
+
+#endif
+
 /*
 	Encryption Rounds
 
@@ -437,6 +527,13 @@ Roundn (Last):
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 
+#if defined(PRIV_SLIB_AES_NI)
+		if (m_flagNI) {
+			_priv_AES_NI_encryptBlocks(m_roundKeyEncNI, m_nCountRounds, IN, OUT, 1);
+			return;
+		}
+#endif
+
 		sl_uint32 d0 = MIO::readUint32BE(IN);
 		sl_uint32 d1 = MIO::readUint32BE(IN + 4);
 		sl_uint32 d2 = MIO::readUint32BE(IN + 8);
@@ -532,6 +629,13 @@ Roundn (Last):
 	{
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
+
+#if defined(PRIV_SLIB_AES_NI)
+		if (m_flagNI) {
+			_priv_AES_NI_decryptBlocks(m_roundKeyDecNI, m_nCountRounds, IN, OUT, 1);
+			return;
+		}
+#endif
 		
 		sl_uint32 d0 = MIO::readUint32BE(IN);
 		sl_uint32 d1 = MIO::readUint32BE(IN + 4);
@@ -546,6 +650,50 @@ Roundn (Last):
 		MIO::writeUint32BE(OUT + 12, d3);
 	}
 
+	sl_size AES::encryptBlocks(const void* _src, void* _dst, sl_size size) const
+	{
+		if (size & 15) {
+			return 0;
+		}
+		const sl_uint8* src = (const sl_uint8*)_src;
+		sl_uint8* dst = (sl_uint8*)_dst;
+		sl_size n = size >> 4;
+#if defined(PRIV_SLIB_AES_NI)
+		if (m_flagNI) {
+			_priv_AES_NI_encryptBlocks(m_roundKeyEncNI, m_nCountRounds, src, dst, n);
+			return size;
+		}
+#endif
+		for (sl_size i = 0; i < n; i++) {
+			encryptBlock(src, dst);
+			src += 16;
+			dst += 16;
+		}
+		return size;
+	}
+
+	sl_size AES::decryptBlocks(const void* _src, void* _dst, sl_size size) const
+	{
+		if (size & 15) {
+			return 0;
+		}
+		const sl_uint8* src = (const sl_uint8*)_src;
+		sl_uint8* dst = (sl_uint8*)_dst;
+		sl_size n = size >> 4;
+#if defined(PRIV_SLIB_AES_NI)
+		if (m_flagNI) {
+			_priv_AES_NI_decryptBlocks(m_roundKeyDecNI, m_nCountRounds, src, dst, n);
+			return size;
+		}
+#endif
+		for (sl_size i = 0; i < n; i++) {
+			decryptBlock(src, dst);
+			src += 16;
+			dst += 16;
+		}
+		return size;
+	}
+
 	void AES::setKey_SHA256(const String& key)
 	{
 		char sig[32];
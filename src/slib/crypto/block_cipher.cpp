@@ -328,15 +328,35 @@ namespace slib
 				return size;
 			}
 		}
-		while (size > 0) {
-			crypto->encryptBlock(counter, mask);
-			n = SLIB_MIN(sizeBlock, size);
+		// the key stream of the full blocks is generated by `encryptBlocks` at once, so that the cipher can process the blocks in parallel
+		sl_uint8 counters[SLIB_CRYPTO_BLOCK_CIPHER_CTR_BATCH_LEN];
+		sl_uint8 masks[SLIB_CRYPTO_BLOCK_CIPHER_CTR_BATCH_LEN];
+		sl_size nBatch = SLIB_CRYPTO_BLOCK_CIPHER_CTR_BATCH_LEN / sizeBlock;
+		while (size >= sizeBlock) {
+			sl_size nBlocks = size / sizeBlock;
+			if (nBlocks > nBatch) {
+				nBlocks = nBatch;
+			}
+			sl_uint8* c = counters;
+			for (i = 0; i < nBlocks; i++) {
+				Base::copyMemory(c, counter, sizeBlock);
+				MIO::increaseBE(counter, sizeBlock);
+				c += sizeBlock;
+			}
+			n = nBlocks * sizeBlock;
+			crypto->encryptBlocks(counters, masks, n);
 			for (i = 0; i < n; i++) {
-				output[i] = input[i] ^ mask[i];
+				output[i] = input[i] ^ masks[i];
 			}
 			size -= n;
 			input += n;
 			output += n;
+		}
+		if (size > 0) {
+			crypto->encryptBlock(counter, mask);
+			for (i = 0; i < size; i++) {
+				output[i] = input[i] ^ mask[i];
+			}
 			MIO::increaseBE(counter, sizeBlock);
 		}
 		return _size;
@@ -369,11 +389,13 @@ namespace slib
 	}
 
 
-#define DEFINE_BLOCKCIPHER(CLASS) \
+#define DEFINE_BLOCKCIPHER_BLOCKS(CLASS) \
 	sl_size CLASS::encryptBlocks(const void* src, void* dst, sl_size size) const \
 	{ return BlockCipher_Blocks<CLASS>::encryptBlocks(this, src, dst, size); } \
 	sl_size CLASS::decryptBlocks(const void* src, void* dst, sl_size size) const \
-	{ return BlockCipher_Blocks<CLASS>::decryptBlocks(this, src, dst, size); } \
+	{ return BlockCipher_Blocks<CLASS>::decryptBlocks(this, src, dst, size); }
+
+#define DEFINE_BLOCKCIPHER_MODES(CLASS) \
 	sl_size CLASS::encrypt_ECB_PKCS7Padding(const void* src, sl_size size, void* dst) const \
 	{ return BlockCipher_ECB<CLASS, BlockCipherPadding_PKCS7>::encrypt(this, src, size, dst); } \
 	sl_size CLASS::decrypt_ECB_PKCS7Padding(const void* src, sl_size size, void* dst) const \
@@ -401,7 +423,12 @@ namespace slib
 	sl_size CLASS::encrypt_CTR(const void* iv, sl_uint64 pos, const void* input, sl_size size, void* output) const \
 	{ return BlockCipher_CTR<CLASS>::encrypt(this, iv, pos, input, size, output); }
 
-	DEFINE_BLOCKCIPHER(AES);
+#define DEFINE_BLOCKCIPHER(CLASS) \
+	DEFINE_BLOCKCIPHER_BLOCKS(CLASS) \
+	DEFINE_BLOCKCIPHER_MODES(CLASS)
+
+	// AES::encryptBlocks, AES::decryptBlocks: defined in aes.cpp (AES-NI)
+	DEFINE_BLOCKCIPHER_MODES(AES);
 	DEFINE_BLOCKCIPHER(Blowfish);
 
 }
@@ -10,6 +10,10 @@
 
 #include "slib/crypto/zlib.h"
 
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/core/mio.h"
+
 #include "thirdparty/zlib/zlib.h"
 
 #define STREAM ((z_stream*)(this->m_stream))
@@ -134,6 +138,33 @@ namespace slib
 		return 1;
 	}
 
+	sl_int32 ZlibCompress::flush(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		if (!m_flagStarted) {
+			return Z_STREAM_ERROR;
+		}
+		z_stream* stream = STREAM;
+		sizeOutputUsed = 0;
+		stream->next_in = sl_null;
+		stream->avail_in = 0;
+		stream->next_out = (Bytef*)output;
+		stream->avail_out = sizeOutputAvailable;
+		int iRet = deflate(stream, Z_SYNC_FLUSH);
+		if (iRet == Z_BUF_ERROR) {
+			// nothing to flush
+			return 0;
+		}
+		if (iRet < 0) {
+			abort();
+			return iRet;
+		}
+		sizeOutputUsed = sizeOutputAvailable - stream->avail_out;
+		if (stream->avail_out) {
+			return 0;
+		}
+		return 1;
+	}
+
 	Memory ZlibCompress::compress(const void* _data, sl_size size, sl_bool flagFinish)
 	{
 		Memory ret;
@@ -243,6 +274,10 @@ namespace slib
 		if (iRet == Z_NEED_DICT) {
 			iRet = Z_DATA_ERROR;
 		}
+		if (iRet == Z_BUF_ERROR) {
+			// no progress is possible until more input is provided (not fatal)
+			return 1;
+		}
 		if (iRet < 0) {
 			abort();
 			return iRet;
@@ -256,7 +291,17 @@ namespace slib
 		return 1;
 	}
 
-	Memory ZlibDecompress::decompress(const void* _data, sl_size size)
+	Memory ZlibDecompress::decompress(const void* data, sl_size size)
+	{
+		return _decompress(data, size, sl_false);
+	}
+
+	Memory ZlibDecompress::decompressPart(const void* data, sl_size size)
+	{
+		return _decompress(data, size, sl_true);
+	}
+
+	Memory ZlibDecompress::_decompress(const void* _data, sl_size size, sl_bool flagPart)
 	{
 		Memory ret;
 		sl_uint8* data = (sl_uint8*)_data;
@@ -288,8 +333,14 @@ namespace slib
 			if (iRet == 0) {
 				break;
 			}
-			if (size == 0 && sizeOutputUsed == 0) {
-				break;
+			if (sizeInputPassed == 0 && sizeOutputUsed == 0) {
+				if (flagPart) {
+					// waits for the next part
+					break;
+				}
+				// the input ended before the end of the stream (truncated)
+				abort();
+				return ret;
 			}
 		}
 		ret = buffer.merge();
@@ -398,6 +449,243 @@ namespace slib
 		return compressGzip(param, data, size, level);
 	}
 
+	enum class _priv_ZlibParallel_Format
+	{
+		Zlib,
+		Raw,
+		Gzip
+	};
+
+	class _priv_ZlibParallel_Context : public Referable
+	{
+	public:
+		const sl_uint8* data;
+		sl_size size;
+		sl_size sizeBlock;
+		sl_int32 nBlocks;
+		sl_int32 level;
+		_priv_ZlibParallel_Format format;
+
+		Array<Memory> outputs;
+		Array<sl_uint32> checks;
+		sl_int32 indexNext;
+		sl_int32 nRemainingBlocks;
+		sl_bool flagError;
+		Ref<Event> eventDone;
+
+	public:
+		// called by the workers and the calling thread: takes the blocks until no block remains
+		void run()
+		{
+			for (;;) {
+				sl_int32 index = Base::interlockedIncrement32(&indexNext) - 1;
+				if (index >= nBlocks) {
+					return;
+				}
+				if (!(processBlock(index))) {
+					flagError = sl_true;
+				}
+				if (!(Base::interlockedDecrement32(&nRemainingBlocks))) {
+					eventDone->set();
+				}
+			}
+		}
+
+		sl_bool processBlock(sl_int32 index)
+		{
+			sl_size offset = (sl_size)index * sizeBlock;
+			const sl_uint8* input = data + offset;
+			sl_uint32 sizeInput = (sl_uint32)(SLIB_MIN(sizeBlock, size - offset));
+			sl_bool flagLast = index == nBlocks - 1;
+
+			if (format == _priv_ZlibParallel_Format::Gzip) {
+				checks[index] = (sl_uint32)(::crc32(0, input, sizeInput));
+			} else if (format == _priv_ZlibParallel_Format::Zlib) {
+				checks[index] = (sl_uint32)(::adler32(1, input, sizeInput));
+			}
+
+			z_stream stream;
+			Base::zeroMemory(&stream, sizeof(stream));
+			if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+				return sl_false;
+			}
+			sl_bool flagSuccess = sl_false;
+			do {
+				if (offset) {
+					// priming: the matches can refer to the former block as the serial stream does
+					sl_uint32 sizeDictionary = (sl_uint32)(SLIB_MIN(offset, 32768));
+					if (deflateSetDictionary(&stream, input - sizeDictionary, sizeDictionary) != Z_OK) {
+						break;
+					}
+				}
+				// the sync flush appends an empty stored block (5 bytes) at most
+				sl_uint32 sizeOutput = (sl_uint32)(deflateBound(&stream, sizeInput)) + 16;
+				Memory output = Memory::create(sizeOutput);
+				if (output.isNull()) {
+					break;
+				}
+				stream.next_in = (Bytef*)input;
+				stream.avail_in = sizeInput;
+				stream.next_out = (Bytef*)(output.getData());
+				stream.avail_out = sizeOutput;
+				int iRet = deflate(&stream, flagLast ? Z_FINISH : Z_SYNC_FLUSH);
+				if (flagLast) {
+					if (iRet != Z_STREAM_END) {
+						break;
+					}
+				} else {
+					if (iRet != Z_OK || stream.avail_in || !(stream.avail_out)) {
+						break;
+					}
+				}
+				outputs[index] = output.sub(0, sizeOutput - stream.avail_out);
+				flagSuccess = sl_true;
+			} while (0);
+			deflateEnd(&stream);
+			return flagSuccess;
+		}
+
+	};
+
+	static Memory _priv_ZlibParallel_compress(_priv_ZlibParallel_Format format, const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level, sl_size sizeBlock)
+	{
+		if (!sizeBlock) {
+			sizeBlock = 0x20000;
+		} else if (sizeBlock > 0x40000000) {
+			sizeBlock = 0x40000000;
+		}
+		sl_size nBlocks = (size + sizeBlock - 1) / sizeBlock;
+		if (nBlocks < 2 || nBlocks > 0x7fffffff) {
+			switch (format) {
+				case _priv_ZlibParallel_Format::Raw:
+					return Zlib::compressRaw(data, size, level);
+				case _priv_ZlibParallel_Format::Gzip:
+					return Zlib::compressGzip(data, size, level);
+				default:
+					return Zlib::compress(data, size, level);
+			}
+		}
+
+		Ref<_priv_ZlibParallel_Context> context = new _priv_ZlibParallel_Context;
+		if (context.isNull()) {
+			return sl_null;
+		}
+		context->data = (const sl_uint8*)data;
+		context->size = size;
+		context->sizeBlock = sizeBlock;
+		context->nBlocks = (sl_int32)nBlocks;
+		context->level = level;
+		context->format = format;
+		context->outputs = Array<Memory>::create(nBlocks);
+		context->checks = Array<sl_uint32>::create(nBlocks);
+		context->indexNext = 0;
+		context->nRemainingBlocks = (sl_int32)nBlocks;
+		context->flagError = sl_false;
+		context->eventDone = Event::create(sl_false);
+		if (context->outputs.isNull() || context->checks.isNull() || context->eventDone.isNull()) {
+			return sl_null;
+		}
+
+		if (threadPool.isNotNull()) {
+			sl_size nWorkers = SLIB_MIN(nBlocks - 1, (sl_size)(threadPool->getMaximumThreadsCount()));
+			for (sl_size i = 0; i < nWorkers; i++) {
+				if (!(threadPool->addTask(SLIB_FUNCTION_REF(_priv_ZlibParallel_Context, run, context)))) {
+					break;
+				}
+			}
+		}
+		// the calling thread also takes the blocks, so the work is finished even if the pool is busy
+		context->run();
+		context->eventDone->wait();
+		if (context->flagError) {
+			return sl_null;
+		}
+
+		Memory* outputs = context->outputs.getData();
+		sl_uint32* checks = context->checks.getData();
+		sl_size sizeHeader = 0;
+		sl_size sizeTrailer = 0;
+		if (format == _priv_ZlibParallel_Format::Zlib) {
+			sizeHeader = 2;
+			sizeTrailer = 4;
+		} else if (format == _priv_ZlibParallel_Format::Gzip) {
+			sizeHeader = 10;
+			sizeTrailer = 8;
+		}
+		sl_size sizeTotal = sizeHeader + sizeTrailer;
+		for (sl_size i = 0; i < nBlocks; i++) {
+			sizeTotal += outputs[i].getSize();
+		}
+		Memory ret = Memory::create(sizeTotal);
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		sl_uint8* p = (sl_uint8*)(ret.getData());
+
+		sl_uint32 check = checks[0];
+		for (sl_size i = 1; i < nBlocks; i++) {
+			z_off_t sizeBlockInput = (z_off_t)(i == nBlocks - 1 ? size - i * sizeBlock : sizeBlock);
+			if (format == _priv_ZlibParallel_Format::Gzip) {
+				check = (sl_uint32)(crc32_combine(check, checks[i], sizeBlockInput));
+			} else if (format == _priv_ZlibParallel_Format::Zlib) {
+				check = (sl_uint32)(adler32_combine(check, checks[i], sizeBlockInput));
+			}
+		}
+
+		if (format == _priv_ZlibParallel_Format::Zlib) {
+			// CMF: deflate, 32KB window; FLG: compression level, check bits
+			sl_uint32 flevel;
+			if (level < 0 || level == 6) {
+				flevel = 2;
+			} else if (level < 2) {
+				flevel = 0;
+			} else if (level < 6) {
+				flevel = 1;
+			} else {
+				flevel = 3;
+			}
+			sl_uint32 header = (0x78 << 8) | (flevel << 6);
+			header += 31 - (header % 31);
+			p[0] = (sl_uint8)(header >> 8);
+			p[1] = (sl_uint8)header;
+		} else if (format == _priv_ZlibParallel_Format::Gzip) {
+			Base::zeroMemory(p, 10);
+			p[0] = 0x1f;
+			p[1] = 0x8b;
+			p[2] = Z_DEFLATED;
+			p[8] = level == 9 ? 2 : (level >= 0 && level < 2 ? 4 : 0);
+			p[9] = 255;
+		}
+		p += sizeHeader;
+		for (sl_size i = 0; i < nBlocks; i++) {
+			sl_size n = outputs[i].getSize();
+			Base::copyMemory(p, outputs[i].getData(), n);
+			p += n;
+		}
+		if (format == _priv_ZlibParallel_Format::Zlib) {
+			MIO::writeUint32BE(p, check);
+		} else if (format == _priv_ZlibParallel_Format::Gzip) {
+			MIO::writeUint32LE(p, check);
+			MIO::writeUint32LE(p + 4, (sl_uint32)size);
+		}
+		return ret;
+	}
+
+	Memory Zlib::compressParallel(const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level, sl_size sizeBlock)
+	{
+		return _priv_ZlibParallel_compress(_priv_ZlibParallel_Format::Zlib, data, size, threadPool, level, sizeBlock);
+	}
+
+	Memory Zlib::compressRawParallel(const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level, sl_size sizeBlock)
+	{
+		return _priv_ZlibParallel_compress(_priv_ZlibParallel_Format::Raw, data, size, threadPool, level, sizeBlock);
+	}
+
+	Memory Zlib::compressGzipParallel(const void* data, sl_size size, const Ref<ThreadPool>& threadPool, sl_int32 level, sl_size sizeBlock)
+	{
+		return _priv_ZlibParallel_compress(_priv_ZlibParallel_Format::Gzip, data, size, threadPool, level, sizeBlock);
+	}
+
 	Memory Zlib::decompress(const void* data, sl_size size)
 	{
 		ZlibDecompress zlib;
@@ -77,6 +77,30 @@ namespace slib
 		return new SHA512();
 	}
 
+	void CryptoHash::hashMany(CryptoHashType type, const void* const* inputs, const sl_size* sizes, sl_uint32 count, void* _output)
+	{
+		switch (type) {
+		case CryptoHashType::SHA224:
+			SHA224::hashMany(inputs, sizes, count, _output);
+			return;
+		case CryptoHashType::SHA256:
+			SHA256::hashMany(inputs, sizes, count, _output);
+			return;
+		default:
+			break;
+		}
+		Ref<CryptoHash> hash = create(type);
+		if (hash.isNull()) {
+			return;
+		}
+		sl_uint8* output = (sl_uint8*)_output;
+		sl_uint32 size = hash->getSize();
+		for (sl_uint32 i = 0; i < count; i++) {
+			hash->execute(inputs[i], sizes[i], output);
+			output += size;
+		}
+	}
+
 	void CryptoHash::execute(const void* input, sl_size n, void* output)
 	{
 		start();
@@ -11,10 +11,152 @@
 #include "slib/crypto/gcm.h"
 
 #include "slib/crypto/aes.h"
+#include "slib/core/cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define PRIV_SLIB_GCM_CLMUL
+#	include <wmmintrin.h>
+#	include <tmmintrin.h>
+#	if defined(_MSC_VER)
+#		define PRIV_SLIB_GCM_CLMUL_FUNC static
+#	else
+#		define PRIV_SLIB_GCM_CLMUL_FUNC static __attribute__((target("pclmul,ssse3")))
+#	endif
+#endif
 
 namespace slib
 {
 
+#if defined(PRIV_SLIB_GCM_CLMUL)
+
+/*
+	Carry-less multiplication in GF(2^128)
+
+	Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode (Shay Gueron, Michael E. Kounavis)
+
+	The blocks are byte-reflected when loaded, so that the bit-reflected product is shifted left by 1 bit before the reduction.
+	The products of the aggregated blocks are summed before the reduction:
+		X' = (X + D0) * H^4 + D1 * H^3 + D2 * H^2 + D3 * H
+*/
+
+	PRIV_SLIB_GCM_CLMUL_FUNC __m128i _priv_GCM_CLMUL_load(const void* p)
+	{
+		return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)p), _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	}
+
+	PRIV_SLIB_GCM_CLMUL_FUNC void _priv_GCM_CLMUL_store(void* p, __m128i x)
+	{
+		_mm_storeu_si128((__m128i*)p, _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)));
+	}
+
+	// adds the 256-bit product of a and b to (lo, hi)
+	PRIV_SLIB_GCM_CLMUL_FUNC void _priv_GCM_CLMUL_multiplyAdd(__m128i a, __m128i b, __m128i& lo, __m128i& hi)
+	{
+		__m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+		__m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+		__m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+		__m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+		t1 = _mm_xor_si128(t1, t2);
+		lo = _mm_xor_si128(lo, _mm_xor_si128(t0, _mm_slli_si128(t1, 8)));
+		hi = _mm_xor_si128(hi, _mm_xor_si128(t3, _mm_srli_si128(t1, 8)));
+	}
+
+	// (lo, hi) mod (x^128 + x^7 + x^2 + x + 1)
+	PRIV_SLIB_GCM_CLMUL_FUNC __m128i _priv_GCM_CLMUL_reduce(__m128i lo, __m128i hi)
+	{
+		// shift left by 1 bit
+		__m128i t0 = _mm_srli_epi32(lo, 31);
+		__m128i t1 = _mm_srli_epi32(hi, 31);
+		lo = _mm_slli_epi32(lo, 1);
+		hi = _mm_slli_epi32(hi, 1);
+		__m128i t2 = _mm_srli_si128(t0, 12);
+		t1 = _mm_slli_si128(t1, 4);
+		t0 = _mm_slli_si128(t0, 4);
+		lo = _mm_or_si128(lo, t0);
+		hi = _mm_or_si128(hi, t1);
+		hi = _mm_or_si128(hi, t2);
+		// first phase
+		t0 = _mm_slli_epi32(lo, 31);
+		t1 = _mm_slli_epi32(lo, 30);
+		t2 = _mm_slli_epi32(lo, 25);
+		t0 = _mm_xor_si128(t0, t1);
+		t0 = _mm_xor_si128(t0, t2);
+		t1 = _mm_srli_si128(t0, 4);
+		t0 = _mm_slli_si128(t0, 12);
+		lo = _mm_xor_si128(lo, t0);
+		// second phase
+		t0 = _mm_srli_epi32(lo, 1);
+		t2 = _mm_srli_epi32(lo, 2);
+		t0 = _mm_xor_si128(t0, t2);
+		t2 = _mm_srli_epi32(lo, 7);
+		t0 = _mm_xor_si128(t0, t2);
+		t0 = _mm_xor_si128(t0, t1);
+		lo = _mm_xor_si128(lo, t0);
+		return _mm_xor_si128(hi, lo);
+	}
+
+	PRIV_SLIB_GCM_CLMUL_FUNC __m128i _priv_GCM_CLMUL_multiply(__m128i a, __m128i b)
+	{
+		__m128i lo = _mm_setzero_si128();
+		__m128i hi = _mm_setzero_si128();
+		_priv_GCM_CLMUL_multiplyAdd(a, b, lo, hi);
+		return _priv_GCM_CLMUL_reduce(lo, hi);
+	}
+
+	PRIV_SLIB_GCM_CLMUL_FUNC void _priv_GCM_CLMUL_generatePowers(const void* H, sl_uint8 (*HP)[16])
+	{
+		__m128i h1 = _priv_GCM_CLMUL_load(H);
+		__m128i h2 = _priv_GCM_CLMUL_multiply(h1, h1);
+		__m128i h3 = _priv_GCM_CLMUL_multiply(h2, h1);
+		__m128i h4 = _priv_GCM_CLMUL_multiply(h3, h1);
+		_mm_storeu_si128((__m128i*)(HP[0]), h1);
+		_mm_storeu_si128((__m128i*)(HP[1]), h2);
+		_mm_storeu_si128((__m128i*)(HP[2]), h3);
+		_mm_storeu_si128((__m128i*)(HP[3]), h4);
+	}
+
+	PRIV_SLIB_GCM_CLMUL_FUNC void _priv_GCM_CLMUL_multiplyH(const sl_uint8 (*HP)[16], const void* X, void* O)
+	{
+		_priv_GCM_CLMUL_store(O, _priv_GCM_CLMUL_multiply(_priv_GCM_CLMUL_load(X), _mm_loadu_si128((const __m128i*)(HP[0]))));
+	}
+
+	PRIV_SLIB_GCM_CLMUL_FUNC void _priv_GCM_CLMUL_multiplyData(const sl_uint8 (*HP)[16], void* X, const sl_uint8* D, sl_size lenD)
+	{
+		__m128i h1 = _mm_loadu_si128((const __m128i*)(HP[0]));
+		__m128i x = _priv_GCM_CLMUL_load(X);
+		sl_size n = lenD >> 4;
+		if (n >= 4) {
+			__m128i h2 = _mm_loadu_si128((const __m128i*)(HP[1]));
+			__m128i h3 = _mm_loadu_si128((const __m128i*)(HP[2]));
+			__m128i h4 = _mm_loadu_si128((const __m128i*)(HP[3]));
+			do {
+				__m128i lo = _mm_setzero_si128();
+				__m128i hi = _mm_setzero_si128();
+				_priv_GCM_CLMUL_multiplyAdd(_mm_xor_si128(x, _priv_GCM_CLMUL_load(D)), h4, lo, hi);
+				_priv_GCM_CLMUL_multiplyAdd(_priv_GCM_CLMUL_load(D + 16), h3, lo, hi);
+				_priv_GCM_CLMUL_multiplyAdd(_priv_GCM_CLMUL_load(D + 32), h2, lo, hi);
+				_priv_GCM_CLMUL_multiplyAdd(_priv_GCM_CLMUL_load(D + 48), h1, lo, hi);
+				x = _priv_GCM_CLMUL_reduce(lo, hi);
+				D += 64;
+				n -= 4;
+			} while (n >= 4);
+		}
+		while (n) {
+			x = _priv_GCM_CLMUL_multiply(_mm_xor_si128(x, _priv_GCM_CLMUL_load(D)), h1);
+			D += 16;
+			n--;
+		}
+		n = lenD & 15;
+		if (n) {
+			sl_uint8 last[16] = { 0 };
+			Base::copyMemory(last, D, n);
+			x = _priv_GCM_CLMUL_multiply(_mm_xor_si128(x, _priv_GCM_CLMUL_load(last)), h1);
+		}
+		_priv_GCM_CLMUL_store(X, x);
+	}
+
+#endif
+
 	void GCM_Table::generateTable(const void* _H)
 	{
 		sl_uint32 i, j;
@@ -50,6 +192,15 @@ namespace slib
 			}
 			i <<= 1;
 		}
+
+#if defined(PRIV_SLIB_GCM_CLMUL)
+		flagCLMUL = CPU::isPCLMULQDQSupported();
+		if (flagCLMUL) {
+			_priv_GCM_CLMUL_generatePowers(_H, HP);
+		}
+#else
+		flagCLMUL = sl_false;
+#endif
 	}
 
 	static const sl_uint64 _GCM_R[16] =
@@ -74,6 +225,12 @@ namespace slib
 
 	void GCM_Table::multiplyH(const void* _X, void* _O) const
 	{
+#if defined(PRIV_SLIB_GCM_CLMUL)
+		if (flagCLMUL) {
+			_priv_GCM_CLMUL_multiplyH(HP, _X, _O);
+			return;
+		}
+#endif
 		const sl_uint8* X = (const sl_uint8*)_X;
 		sl_uint8* O = (sl_uint8*)_O;
 		Uint128 Z;
@@ -117,6 +274,12 @@ namespace slib
 	{
 		sl_uint8* X = (sl_uint8*)_X;
 		const sl_uint8* D = (const sl_uint8*)_D;
+#if defined(PRIV_SLIB_GCM_CLMUL)
+		if (flagCLMUL) {
+			_priv_GCM_CLMUL_multiplyData(HP, X, D, lenD);
+			return;
+		}
+#endif
 		sl_size i, k, n;
 
 		n = lenD >> 4;
@@ -312,25 +475,33 @@ namespace slib
 	template <class BlockCipher>
 	void GCM<BlockCipher>::encrypt(const void* src, void *dst, sl_size len)
 	{
-		sl_uint8 GCTR[16];
-		sl_size i, k, n;
+		// the counter blocks are encrypted in batches, and GHASH is calculated over the batch
+		sl_uint8 CTR[128];
+		sl_uint8 GCTR[128];
+		sl_size k, n;
 		const sl_uint8* P = (const sl_uint8*)src;
 		sl_uint8* C = (sl_uint8*)dst;
-		
-		for (i = 0; i < len; i += 16) {
-			increaseCIV();
-			m_cipher->encryptBlock(CIV, GCTR);
-			n = len - i;
-			if (n > 16) {
-				n = 16;
+
+		while (len >= 16) {
+			n = len & ~((sl_size)15);
+			if (n > 128) {
+				n = 128;
+			}
+			for (k = 0; k < n; k += 16) {
+				increaseCIV();
+				Base::copyMemory(CTR + k, CIV, 16);
 			}
+			m_cipher->encryptBlocks(CTR, GCTR, n);
 			for (k = 0; k < n; k++) {
-				*C = *P ^ GCTR[k];
-				GHASH_X[k] ^= *C;
-				C++;
-				P++;
+				C[k] = P[k] ^ GCTR[k];
 			}
-			multiplyH(GHASH_X, GHASH_X);
+			multiplyData(GHASH_X, C, n);
+			P += n;
+			C += n;
+			len -= n;
+		}
+		if (len) {
+			encryptBlock(P, C, (sl_uint32)len);
 		}
 	}
 
@@ -355,25 +526,34 @@ namespace slib
 	template <class BlockCipher>
 	void GCM<BlockCipher>::decrypt(const void* src, void *dst, sl_size len)
 	{
-		sl_uint8 GCTR[16];
-		sl_size i, k, n;
+		// the counter blocks are encrypted in batches, and GHASH is calculated over the batch
+		sl_uint8 CTR[128];
+		sl_uint8 GCTR[128];
+		sl_size k, n;
 		const sl_uint8* C = (const sl_uint8*)src;
 		sl_uint8* P = (sl_uint8*)dst;
-		
-		for (i = 0; i < len; i += 16) {
-			increaseCIV();
-			m_cipher->encryptBlock(CIV, GCTR);
-			n = len - i;
-			if (n > 16) {
-				n = 16;
+
+		while (len >= 16) {
+			n = len & ~((sl_size)15);
+			if (n > 128) {
+				n = 128;
+			}
+			for (k = 0; k < n; k += 16) {
+				increaseCIV();
+				Base::copyMemory(CTR + k, CIV, 16);
 			}
+			m_cipher->encryptBlocks(CTR, GCTR, n);
+			// the cipher text is hashed before it is overwritten (in-place decryption)
+			multiplyData(GHASH_X, C, n);
 			for (k = 0; k < n; k++) {
-				GHASH_X[k] ^= *C;
-				*P = *C ^ GCTR[k];
-				C++;
-				P++;
+				P[k] = C[k] ^ GCTR[k];
 			}
-			multiplyH(GHASH_X, GHASH_X);
+			C += n;
+			P += n;
+			len -= n;
+		}
+		if (len) {
+			decryptBlock(C, P, (sl_uint32)len);
 		}
 	}
 
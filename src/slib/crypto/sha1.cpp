@@ -12,10 +12,92 @@
 
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define PRIV_SLIB_SHA1_NI
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		define PRIV_SLIB_SHA1_NI_FUNC static
+#	else
+#		define PRIV_SLIB_SHA1_NI_FUNC static __attribute__((target("sha,sse4.1")))
+#	endif
+#endif
 
 namespace slib
 {
 
+#if defined(PRIV_SLIB_SHA1_NI)
+
+/*
+	SHA extensions
+
+	SHA1RNDS4 performs 4 rounds, and SHA1NEXTE calculates E of the next 4 rounds from A of the previous state.
+	The message schedule of the next 4 rounds is prepared by SHA1MSG1, XOR and SHA1MSG2 while the rounds are running.
+
+	Group G (rounds 4G ~ 4G+3), E is alternated between E0 (even group) and E1 (odd group)
+*/
+#define PRIV_SLIB_SHA1_NI_ROUNDS(G, E, E_NEXT, M, M_NEXT, M_PREV, M_PREV2, F) \
+	E = _mm_sha1nexte_epu32(E, M); \
+	E_NEXT = ABCD; \
+	if (G >= 3 && G <= 18) { \
+		M_NEXT = _mm_sha1msg2_epu32(M_NEXT, M); \
+	} \
+	ABCD = _mm_sha1rnds4_epu32(ABCD, E, F); \
+	if (G <= 16) { \
+		M_PREV = _mm_sha1msg1_epu32(M_PREV, M); \
+	} \
+	if (G >= 2 && G <= 17) { \
+		M_PREV2 = _mm_xor_si128(M_PREV2, M); \
+	}
+
+	PRIV_SLIB_SHA1_NI_FUNC void _priv_SHA1_NI_process(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+		const __m128i MASK = _mm_set_epi64x(SLIB_UINT64(0x0001020304050607), SLIB_UINT64(0x08090a0b0c0d0e0f));
+		__m128i ABCD = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1B);
+		__m128i E0 = _mm_set_epi32((int)(h[4]), 0, 0, 0);
+		__m128i E1;
+		__m128i M0, M1, M2, M3;
+		for (sl_size i = 0; i < nSections; i++) {
+			__m128i ABCD_SAVE = ABCD;
+			__m128i E0_SAVE = E0;
+			M0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), MASK);
+			M1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), MASK);
+			M2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), MASK);
+			M3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), MASK);
+			// rounds 0 ~ 3
+			E0 = _mm_add_epi32(E0, M0);
+			E1 = ABCD;
+			ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+			PRIV_SLIB_SHA1_NI_ROUNDS(1, E1, E0, M1, M2, M0, M3, 0)
+			PRIV_SLIB_SHA1_NI_ROUNDS(2, E0, E1, M2, M3, M1, M0, 0)
+			PRIV_SLIB_SHA1_NI_ROUNDS(3, E1, E0, M3, M0, M2, M1, 0)
+			PRIV_SLIB_SHA1_NI_ROUNDS(4, E0, E1, M0, M1, M3, M2, 0)
+			PRIV_SLIB_SHA1_NI_ROUNDS(5, E1, E0, M1, M2, M0, M3, 1)
+			PRIV_SLIB_SHA1_NI_ROUNDS(6, E0, E1, M2, M3, M1, M0, 1)
+			PRIV_SLIB_SHA1_NI_ROUNDS(7, E1, E0, M3, M0, M2, M1, 1)
+			PRIV_SLIB_SHA1_NI_ROUNDS(8, E0, E1, M0, M1, M3, M2, 1)
+			PRIV_SLIB_SHA1_NI_ROUNDS(9, E1, E0, M1, M2, M0, M3, 1)
+			PRIV_SLIB_SHA1_NI_ROUNDS(10, E0, E1, M2, M3, M1, M0, 2)
+			PRIV_SLIB_SHA1_NI_ROUNDS(11, E1, E0, M3, M0, M2, M1, 2)
+			PRIV_SLIB_SHA1_NI_ROUNDS(12, E0, E1, M0, M1, M3, M2, 2)
+			PRIV_SLIB_SHA1_NI_ROUNDS(13, E1, E0, M1, M2, M0, M3, 2)
+			PRIV_SLIB_SHA1_NI_ROUNDS(14, E0, E1, M2, M3, M1, M0, 2)
+			PRIV_SLIB_SHA1_NI_ROUNDS(15, E1, E0, M3, M0, M2, M1, 3)
+			PRIV_SLIB_SHA1_NI_ROUNDS(16, E0, E1, M0, M1, M3, M2, 3)
+			PRIV_SLIB_SHA1_NI_ROUNDS(17, E1, E0, M1, M2, M0, M3, 3)
+			PRIV_SLIB_SHA1_NI_ROUNDS(18, E0, E1, M2, M3, M1, M0, 3)
+			PRIV_SLIB_SHA1_NI_ROUNDS(19, E1, E0, M3, M0, M2, M1, 3)
+			E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+			ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+			input += 64;
+		}
+		_mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(ABCD, 0x1B));
+		h[4] = (sl_uint32)(_mm_extract_epi32(E0, 3));
+	}
+
+#endif
+
 	SHA1::SHA1()
 	{
 		rdata_len = 0;
@@ -54,7 +136,7 @@ namespace slib
 				return;
 			} else {
 				Base::copyMemory(rdata + rdata_len, input, n);
-				_updateSection(rdata);
+				_updateSections(rdata, 1);
 				rdata_len = 0;
 				sizeInput -= n;
 				input += n;
@@ -63,10 +145,11 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		if (sizeInput >= 64) {
+			sl_size nSections = sizeInput >> 6;
+			_updateSections(input, nSections);
+			sizeInput &= 63;
+			input += (nSections << 6);
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -83,13 +166,13 @@ namespace slib
 		if (rdata_len < 56) {
 			Base::zeroMemory(rdata + rdata_len + 1, 55 - rdata_len);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		} else {
 			Base::zeroMemory(rdata + rdata_len + 1, 63 - rdata_len);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 			Base::zeroMemory(rdata, 56);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		}
 		rdata_len = 0;
 
@@ -100,6 +183,20 @@ namespace slib
 		}
 	}
 
+	void SHA1::_updateSections(const sl_uint8* input, sl_size nSections)
+	{
+#if defined(PRIV_SLIB_SHA1_NI)
+		if (CPU::isSHASupported()) {
+			_priv_SHA1_NI_process(h, input, nSections);
+			return;
+		}
+#endif
+		for (sl_size iSection = 0; iSection < nSections; iSection++) {
+			_updateSection(input);
+			input += 64;
+		}
+	}
+
 	void SHA1::_updateSection(const sl_uint8* input)
 	{
 		static sl_uint32 K[4] = {
@@ -11,10 +11,387 @@
 #include "slib/crypto/sha2.h"
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define PRIV_SLIB_SHA256_SIMD
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		define PRIV_SLIB_SHA256_NI_FUNC static
+#		define PRIV_SLIB_SHA256_AVX2_FUNC static
+#	else
+#		define PRIV_SLIB_SHA256_NI_FUNC static __attribute__((target("sha,sse4.1")))
+#		define PRIV_SLIB_SHA256_AVX2_FUNC static __attribute__((target("avx2")))
+#	endif
+#endif
 
 namespace slib
 {
 
+	static const sl_uint32 _priv_SHA256_K[64] = {
+		0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
+		0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+		0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
+		0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+		0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+		0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+		0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
+		0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+		0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
+		0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+		0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
+		0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+		0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
+		0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+		0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+		0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+	};
+
+	static const sl_uint32 _priv_SHA224_H0[8] = {
+		0xc1059ed8ul, 0x367cd507ul, 0x3070dd17ul, 0xf70e5939ul,
+		0xffc00b31ul, 0x68581511ul, 0x64f98fa7ul, 0xbefa4fa4ul
+	};
+
+	static const sl_uint32 _priv_SHA256_H0[8] = {
+		0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul,
+		0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul
+	};
+
+	static void _priv_SHA256_process(sl_uint32* h, const sl_uint8* input)
+	{
+		const sl_uint32* K = _priv_SHA256_K;
+		sl_uint32 W[64];
+		sl_uint32 v[8];
+		sl_uint32 i;
+		for (i = 0; i < 16; i++) {
+			W[i] = MIO::readUint32BE(input + (i << 2));
+		}
+		for (i = 16; i < 64; i++) {
+			sl_uint32 s0 = Math::rotateRight32(W[i - 15], 7) ^ Math::rotateRight32(W[i - 15], 18) ^ (W[i - 15] >> 3);
+			sl_uint32 s1 = Math::rotateRight32(W[i - 2], 17) ^ Math::rotateRight32(W[i - 2], 19) ^ (W[i - 2] >> 10);
+			W[i] = W[i - 16] + s0 + W[i - 7] + s1;
+		}
+		for (i = 0; i < 8; i++) {
+			v[i] = h[i];
+		}
+		for (i = 0; i < 64; i++) {
+			sl_uint32 S1 = Math::rotateRight32(v[4], 6) ^ Math::rotateRight32(v[4], 11) ^ Math::rotateRight32(v[4], 25);
+			sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
+			sl_uint32 temp1 = v[7] + S1 + ch + K[i] + W[i];
+			sl_uint32 S0 = Math::rotateRight32(v[0], 2) ^ Math::rotateRight32(v[0], 13) ^ Math::rotateRight32(v[0], 22);
+			sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+			sl_uint32 temp2 = S0 + maj;
+			v[7] = v[6];
+			v[6] = v[5];
+			v[5] = v[4];
+			v[4] = v[3] + temp1;
+			v[3] = v[2];
+			v[2] = v[1];
+			v[1] = v[0];
+			v[0] = temp1 + temp2;
+		}
+		for (i = 0; i < 8; i++) {
+			h[i] += v[i];
+		}
+	}
+
+	// blocks of a message: the blocks of the input, followed by the last 1 or 2 blocks containing the padding and the length
+	class _priv_SHA256_MultiBufferLane
+	{
+	public:
+		sl_uint32 index;
+		const sl_uint8* data;
+		sl_size nSectionsData;
+		sl_uint32 nSectionsLast;
+		sl_uint32 iSectionLast;
+		sl_uint8 last[128];
+
+	public:
+		void start(sl_uint32 _index, const void* input, sl_size size)
+		{
+			index = _index;
+			data = (const sl_uint8*)input;
+			nSectionsData = size >> 6;
+			sl_uint32 nRemain = (sl_uint32)(size & 63);
+			Base::copyMemory(last, data + (nSectionsData << 6), nRemain);
+			last[nRemain] = 0x80;
+			nSectionsLast = nRemain < 56 ? 1 : 2;
+			iSectionLast = 0;
+			sl_uint32 sizeLast = nSectionsLast << 6;
+			Base::zeroMemory(last + nRemain + 1, sizeLast - 8 - nRemain - 1);
+			MIO::writeUint64BE(last + sizeLast - 8, ((sl_uint64)size) << 3);
+		}
+
+		sl_bool isFinished()
+		{
+			return !nSectionsData && iSectionLast >= nSectionsLast;
+		}
+
+		const sl_uint8* next()
+		{
+			if (nSectionsData) {
+				const sl_uint8* ret = data;
+				data += 64;
+				nSectionsData--;
+				return ret;
+			}
+			const sl_uint8* ret = last + (iSectionLast << 6);
+			iSectionLast++;
+			return ret;
+		}
+
+	};
+
+#if defined(PRIV_SLIB_SHA256_SIMD)
+
+/*
+	SHA extensions
+
+	The state is kept as ABEF and CDGH for SHA256RNDS2, which performs 2 rounds.
+	The message schedule of the next rounds is prepared by SHA256MSG1, ALIGNR and SHA256MSG2 while the rounds are running.
+
+	Group G (rounds 4G ~ 4G+3)
+*/
+#define PRIV_SLIB_SHA256_NI_ROUNDS(G, M, M_NEXT, M_PREV) \
+	MSG = _mm_add_epi32(M, _mm_loadu_si128((const __m128i*)(_priv_SHA256_K + (G << 2)))); \
+	STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG); \
+	if (G >= 3 && G <= 14) { \
+		TMP = _mm_alignr_epi8(M, M_PREV, 4); \
+		M_NEXT = _mm_add_epi32(M_NEXT, TMP); \
+		M_NEXT = _mm_sha256msg2_epu32(M_NEXT, M); \
+	} \
+	MSG = _mm_shuffle_epi32(MSG, 0x0E); \
+	STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG); \
+	if (G >= 1 && G <= 12) { \
+		M_PREV = _mm_sha256msg1_epu32(M_PREV, M); \
+	}
+
+	PRIV_SLIB_SHA256_NI_FUNC void _priv_SHA256_NI_process(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+		const __m128i MASK = _mm_set_epi64x(SLIB_UINT64(0x0c0d0e0f08090a0b), SLIB_UINT64(0x0405060700010203));
+		__m128i MSG, TMP, M0, M1, M2, M3;
+		TMP = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0xB1); // CDAB
+		__m128i STATE1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h + 4)), 0x1B); // EFGH
+		__m128i STATE0 = _mm_alignr_epi8(TMP, STATE1, 8); // ABEF
+		STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); // CDGH
+		for (sl_size i = 0; i < nSections; i++) {
+			__m128i ABEF_SAVE = STATE0;
+			__m128i CDGH_SAVE = STATE1;
+			M0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), MASK);
+			M1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), MASK);
+			M2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), MASK);
+			M3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), MASK);
+			PRIV_SLIB_SHA256_NI_ROUNDS(0, M0, M1, M3)
+			PRIV_SLIB_SHA256_NI_ROUNDS(1, M1, M2, M0)
+			PRIV_SLIB_SHA256_NI_ROUNDS(2, M2, M3, M1)
+			PRIV_SLIB_SHA256_NI_ROUNDS(3, M3, M0, M2)
+			PRIV_SLIB_SHA256_NI_ROUNDS(4, M0, M1, M3)
+			PRIV_SLIB_SHA256_NI_ROUNDS(5, M1, M2, M0)
+			PRIV_SLIB_SHA256_NI_ROUNDS(6, M2, M3, M1)
+			PRIV_SLIB_SHA256_NI_ROUNDS(7, M3, M0, M2)
+			PRIV_SLIB_SHA256_NI_ROUNDS(8, M0, M1, M3)
+			PRIV_SLIB_SHA256_NI_ROUNDS(9, M1, M2, M0)
+			PRIV_SLIB_SHA256_NI_ROUNDS(10, M2, M3, M1)
+			PRIV_SLIB_SHA256_NI_ROUNDS(11, M3, M0, M2)
+			PRIV_SLIB_SHA256_NI_ROUNDS(12, M0, M1, M3)
+			PRIV_SLIB_SHA256_NI_ROUNDS(13, M1, M2, M0)
+			PRIV_SLIB_SHA256_NI_ROUNDS(14, M2, M3, M1)
+			PRIV_SLIB_SHA256_NI_ROUNDS(15, M3, M0, M2)
+			STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+			STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+			input += 64;
+		}
+		TMP = _mm_shuffle_epi32(STATE0, 0x1B); // FEBA
+		STATE1 = _mm_shuffle_epi32(STATE1, 0xB1); // DCHG
+		_mm_storeu_si128((__m128i*)h, _mm_blend_epi16(TMP, STATE1, 0xF0)); // DCBA
+		_mm_storeu_si128((__m128i*)(h + 4), _mm_alignr_epi8(STATE1, TMP, 8)); // HGFE
+	}
+
+/*
+	Multi-buffer SHA-256 (AVX2)
+
+	8 messages are hashed in parallel, one message in each 32-bit lane.
+	When a message is finished, the lane is assigned to the next message, so the messages can have different lengths.
+*/
+
+#define PRIV_SLIB_SHA256_AVX2_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n))
+
+	// state: [word][lane]
+	PRIV_SLIB_SHA256_AVX2_FUNC void _priv_SHA256_AVX2_process(sl_uint32* state, const sl_uint8* const* blocks)
+	{
+		const __m256i MASK = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		__m256i W[16];
+		sl_uint32 i;
+		// transpose: W[i] = i-th words of the lanes
+		for (i = 0; i < 2; i++) {
+			__m256i r0 = _mm256_loadu_si256((const __m256i*)(blocks[0] + (i << 5)));
+			__m256i r1 = _mm256_loadu_si256((const __m256i*)(blocks[1] + (i << 5)));
+			__m256i r2 = _mm256_loadu_si256((const __m256i*)(blocks[2] + (i << 5)));
+			__m256i r3 = _mm256_loadu_si256((const __m256i*)(blocks[3] + (i << 5)));
+			__m256i r4 = _mm256_loadu_si256((const __m256i*)(blocks[4] + (i << 5)));
+			__m256i r5 = _mm256_loadu_si256((const __m256i*)(blocks[5] + (i << 5)));
+			__m256i r6 = _mm256_loadu_si256((const __m256i*)(blocks[6] + (i << 5)));
+			__m256i r7 = _mm256_loadu_si256((const __m256i*)(blocks[7] + (i << 5)));
+			__m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+			__m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+			__m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+			__m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+			__m256i t4 = _mm256_unpacklo_epi32(r4, r5);
+			__m256i t5 = _mm256_unpackhi_epi32(r4, r5);
+			__m256i t6 = _mm256_unpacklo_epi32(r6, r7);
+			__m256i t7 = _mm256_unpackhi_epi32(r6, r7);
+			r0 = _mm256_unpacklo_epi64(t0, t2);
+			r1 = _mm256_unpackhi_epi64(t0, t2);
+			r2 = _mm256_unpacklo_epi64(t1, t3);
+			r3 = _mm256_unpackhi_epi64(t1, t3);
+			r4 = _mm256_unpacklo_epi64(t4, t6);
+			r5 = _mm256_unpackhi_epi64(t4, t6);
+			r6 = _mm256_unpacklo_epi64(t5, t7);
+			r7 = _mm256_unpackhi_epi64(t5, t7);
+			__m256i* w = W + (i << 3);
+			w[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r0, r4, 0x20), MASK);
+			w[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r1, r5, 0x20), MASK);
+			w[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r2, r6, 0x20), MASK);
+			w[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r3, r7, 0x20), MASK);
+			w[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r0, r4, 0x31), MASK);
+			w[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r1, r5, 0x31), MASK);
+			w[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r2, r6, 0x31), MASK);
+			w[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(r3, r7, 0x31), MASK);
+		}
+		__m256i a = _mm256_loadu_si256((const __m256i*)state);
+		__m256i b = _mm256_loadu_si256((const __m256i*)(state + 8));
+		__m256i c = _mm256_loadu_si256((const __m256i*)(state + 16));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(state + 24));
+		__m256i e = _mm256_loadu_si256((const __m256i*)(state + 32));
+		__m256i f = _mm256_loadu_si256((const __m256i*)(state + 40));
+		__m256i g = _mm256_loadu_si256((const __m256i*)(state + 48));
+		__m256i h = _mm256_loadu_si256((const __m256i*)(state + 56));
+		for (i = 0; i < 64; i++) {
+			__m256i w;
+			if (i < 16) {
+				w = W[i];
+			} else {
+				__m256i w15 = W[(i - 15) & 15];
+				__m256i w2 = W[(i - 2) & 15];
+				__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SLIB_SHA256_AVX2_ROTR(w15, 7), PRIV_SLIB_SHA256_AVX2_ROTR(w15, 18)), _mm256_srli_epi32(w15, 3));
+				__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SLIB_SHA256_AVX2_ROTR(w2, 17), PRIV_SLIB_SHA256_AVX2_ROTR(w2, 19)), _mm256_srli_epi32(w2, 10));
+				w = _mm256_add_epi32(_mm256_add_epi32(W[i & 15], s0), _mm256_add_epi32(W[(i - 7) & 15], s1));
+				W[i & 15] = w;
+			}
+			__m256i S1 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SLIB_SHA256_AVX2_ROTR(e, 6), PRIV_SLIB_SHA256_AVX2_ROTR(e, 11)), PRIV_SLIB_SHA256_AVX2_ROTR(e, 25));
+			__m256i ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+			__m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, w)), _mm256_set1_epi32((int)(_priv_SHA256_K[i])));
+			__m256i S0 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SLIB_SHA256_AVX2_ROTR(a, 2), PRIV_SLIB_SHA256_AVX2_ROTR(a, 13)), PRIV_SLIB_SHA256_AVX2_ROTR(a, 22));
+			__m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+			__m256i temp2 = _mm256_add_epi32(S0, maj);
+			h = g;
+			g = f;
+			f = e;
+			e = _mm256_add_epi32(d, temp1);
+			d = c;
+			c = b;
+			b = a;
+			a = _mm256_add_epi32(temp1, temp2);
+		}
+		_mm256_storeu_si256((__m256i*)state, _mm256_add_epi32(a, _mm256_loadu_si256((const __m256i*)state)));
+		_mm256_storeu_si256((__m256i*)(state + 8), _mm256_add_epi32(b, _mm256_loadu_si256((const __m256i*)(state + 8))));
+		_mm256_storeu_si256((__m256i*)(state + 16), _mm256_add_epi32(c, _mm256_loadu_si256((const __m256i*)(state + 16))));
+		_mm256_storeu_si256((__m256i*)(state + 24), _mm256_add_epi32(d, _mm256_loadu_si256((const __m256i*)(state + 24))));
+		_mm256_storeu_si256((__m256i*)(state + 32), _mm256_add_epi32(e, _mm256_loadu_si256((const __m256i*)(state + 32))));
+		_mm256_storeu_si256((__m256i*)(state + 40), _mm256_add_epi32(f, _mm256_loadu_si256((const __m256i*)(state + 40))));
+		_mm256_storeu_si256((__m256i*)(state + 48), _mm256_add_epi32(g, _mm256_loadu_si256((const __m256i*)(state + 48))));
+		_mm256_storeu_si256((__m256i*)(state + 56), _mm256_add_epi32(h, _mm256_loadu_si256((const __m256i*)(state + 56))));
+	}
+
+	static void _priv_SHA256_AVX2_hashMany(const sl_uint32* H0, sl_uint32 sizeOutput, const void* const* inputs, const sl_size* sizes, sl_uint32 count, sl_uint8* output)
+	{
+		static const sl_uint8 zero[64] = { 0 };
+		_priv_SHA256_MultiBufferLane lanes[8];
+		sl_bool flagActive[8];
+		const sl_uint8* blocks[8];
+		sl_uint32 state[64];
+		sl_uint32 iNext = 0;
+		sl_uint32 nActive = 0;
+		sl_uint32 i, k;
+		for (i = 0; i < 8; i++) {
+			if (iNext < count) {
+				lanes[i].start(iNext, inputs[iNext], sizes[iNext]);
+				for (k = 0; k < 8; k++) {
+					state[(k << 3) + i] = H0[k];
+				}
+				flagActive[i] = sl_true;
+				iNext++;
+				nActive++;
+			} else {
+				flagActive[i] = sl_false;
+			}
+		}
+		while (nActive) {
+			for (i = 0; i < 8; i++) {
+				blocks[i] = flagActive[i] ? lanes[i].next() : zero;
+			}
+			_priv_SHA256_AVX2_process(state, blocks);
+			for (i = 0; i < 8; i++) {
+				if (flagActive[i] && lanes[i].isFinished()) {
+					sl_uint8* o = output + lanes[i].index * sizeOutput;
+					for (k = 0; (k << 2) < sizeOutput; k++) {
+						MIO::writeUint32BE(o + (k << 2), state[(k << 3) + i]);
+					}
+					if (iNext < count) {
+						lanes[i].start(iNext, inputs[iNext], sizes[iNext]);
+						for (k = 0; k < 8; k++) {
+							state[(k << 3) + i] = H0[k];
+						}
+						iNext++;
+					} else {
+						flagActive[i] = sl_false;
+						nActive--;
+					}
+				}
+			}
+		}
+	}
+
+#endif
+
+	static void _priv_SHA256_processSections(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+#if defined(PRIV_SLIB_SHA256_SIMD)
+		if (CPU::isSHASupported()) {
+			_priv_SHA256_NI_process(h, input, nSections);
+			return;
+		}
+#endif
+		for (sl_size i = 0; i < nSections; i++) {
+			_priv_SHA256_process(h, input);
+			input += 64;
+		}
+	}
+
+	static void _priv_SHA256_hashMany(const sl_uint32* H0, sl_uint32 sizeOutput, const void* const* inputs, const sl_size* sizes, sl_uint32 count, void* _output)
+	{
+		sl_uint8* output = (sl_uint8*)_output;
+#if defined(PRIV_SLIB_SHA256_SIMD)
+		// SHA-NI on one message is faster than AVX2 on 8 messages
+		if (count > 1 && CPU::isAVX2Supported() && !(CPU::isSHASupported())) {
+			_priv_SHA256_AVX2_hashMany(H0, sizeOutput, inputs, sizes, count, output);
+			return;
+		}
+#endif
+		_priv_SHA256_MultiBufferLane lane;
+		for (sl_uint32 i = 0; i < count; i++) {
+			sl_uint32 h[8];
+			Base::copyMemory(h, H0, 32);
+			lane.start(i, inputs[i], sizes[i]);
+			_priv_SHA256_processSections(h, lane.data, lane.nSectionsData);
+			_priv_SHA256_processSections(h, lane.last, lane.nSectionsLast);
+			for (sl_uint32 k = 0; (k << 2) < sizeOutput; k++) {
+				MIO::writeUint32BE(output + (k << 2), h[k]);
+			}
+			output += sizeOutput;
+		}
+	}
+
 	_SHA256Base::_SHA256Base()
 	{
 		rdata_len = 0;
@@ -48,7 +425,7 @@ namespace slib
 				return;
 			} else {
 				Base::copyMemory(rdata + rdata_len, input, n);
-				_updateSection(rdata);
+				_updateSections(rdata, 1);
 				rdata_len = 0;
 				sizeInput -= n;
 				input += n;
@@ -57,10 +434,11 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		if (sizeInput >= 64) {
+			sl_size nSections = sizeInput >> 6;
+			_updateSections(input, nSections);
+			sizeInput &= 63;
+			input += (nSections << 6);
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -77,71 +455,20 @@ namespace slib
 		if (rdata_len < 56) {
 			Base::zeroMemory(rdata + rdata_len + 1, 55 - rdata_len);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		} else {
 			Base::zeroMemory(rdata + rdata_len + 1, 63 - rdata_len);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 			Base::zeroMemory(rdata, 56);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		}
 		rdata_len = 0;
 	}
 
-	void _SHA256Base::_updateSection(const sl_uint8* input)
-	{
-		static sl_uint32 K[64] = {
-			0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
-			0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
-			0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
-			0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
-			0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
-			0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
-			0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
-			0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
-			0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
-			0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
-			0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
-			0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
-			0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
-			0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
-			0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
-			0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
-		};
-
-		sl_uint32 W[64];
-		sl_uint32 v[8];
-		sl_uint32 i;
-		for (i = 0; i < 16; i++) {
-			W[i] = MIO::readUint32BE(input + (i << 2));
-		}
-		for (i = 16; i < 64; i++) {
-			sl_uint32 s0 = Math::rotateRight32(W[i - 15], 7) ^ Math::rotateRight32(W[i - 15], 18) ^ (W[i - 15] >> 3);
-			sl_uint32 s1 = Math::rotateRight32(W[i - 2], 17) ^ Math::rotateRight32(W[i - 2], 19) ^ (W[i - 2] >> 10);
-			W[i] = W[i - 16] + s0 + W[i - 7] + s1;
-		}
-		for (i = 0; i < 8; i++) {
-			v[i] = h[i];
-		}
-		for (i = 0; i < 64; i++) {
-			sl_uint32 S1 = Math::rotateRight32(v[4], 6) ^ Math::rotateRight32(v[4], 11) ^ Math::rotateRight32(v[4], 25);
-			sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
-			sl_uint32 temp1 = v[7] + S1 + ch + K[i] + W[i];
-			sl_uint32 S0 = Math::rotateRight32(v[0], 2) ^ Math::rotateRight32(v[0], 13) ^ Math::rotateRight32(v[0], 22);
-			sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
-			sl_uint32 temp2 = S0 + maj;
-			v[7] = v[6];
-			v[6] = v[5];
-			v[5] = v[4];
-			v[4] = v[3] + temp1;
-			v[3] = v[2];
-			v[2] = v[1];
-			v[1] = v[0];
-			v[0] = temp1 + temp2;
-		}
-		for (i = 0; i < 8; i++) {
-			h[i] += v[i];
-		}
+	void _SHA256Base::_updateSections(const sl_uint8* input, sl_size nSections)
+	{
+		_priv_SHA256_processSections(h, input, nSections);
 	}
 
 
@@ -156,14 +483,7 @@ namespace slib
 	void SHA224::start()
 	{
 		_start();
-		h[0] = 0xc1059ed8ul;
-		h[1] = 0x367cd507ul;
-		h[2] = 0x3070dd17ul;
-		h[3] = 0xf70e5939ul;
-		h[4] = 0xffc00b31ul;
-		h[5] = 0x68581511ul;
-		h[6] = 0x64f98fa7ul;
-		h[7] = 0xbefa4fa4ul;
+		Base::copyMemory(h, _priv_SHA224_H0, 32);
 	}
 
 	void SHA224::finish(void* _output)
@@ -176,6 +496,11 @@ namespace slib
 		}
 	}
 
+	void SHA224::hashMany(const void* const* inputs, const sl_size* sizes, sl_uint32 count, void* output)
+	{
+		_priv_SHA256_hashMany(_priv_SHA224_H0, 28, inputs, sizes, count, output);
+	}
+
 
 	SHA256::SHA256()
 	{
@@ -188,14 +513,7 @@ namespace slib
 	void SHA256::start()
 	{
 		_start();
-		h[0] = 0x6a09e667ul;
-		h[1] = 0xbb67ae85ul;
-		h[2] = 0x3c6ef372ul;
-		h[3] = 0xa54ff53aul;
-		h[4] = 0x510e527ful;
-		h[5] = 0x9b05688cul;
-		h[6] = 0x1f83d9abul;
-		h[7] = 0x5be0cd19ul;
+		Base::copyMemory(h, _priv_SHA256_H0, 32);
 	}
 
 	void SHA256::finish(void* _output)
@@ -208,6 +526,11 @@ namespace slib
 		}
 	}
 
+	void SHA256::hashMany(const void* const* inputs, const sl_size* sizes, sl_uint32 count, void* output)
+	{
+		_priv_SHA256_hashMany(_priv_SHA256_H0, 32, inputs, sizes, count, output);
+	}
+
 
 	_SHA512Base::_SHA512Base()
 	{
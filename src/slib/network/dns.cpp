@@ -14,6 +14,7 @@
 #include "slib/core/scoped.h"
 #include "slib/core/mio.h"
 #include "slib/core/log.h"
+#include "slib/core/math.h"
 
 #define _MAX_NAME SLIB_NETWORK_DNS_NAME_MAX_LENGTH
 
@@ -535,6 +536,7 @@ namespace slib
 	{
 		id = 0;
 		flagQuestion = sl_false;
+		responseCode = DnsResponseCode::NoError;
 	}
 
 	DnsPacket::~DnsPacket()
@@ -556,6 +558,7 @@ namespace slib
 				flagQuestion = sl_false;
 			}
 			id = header->getId();
+			responseCode = header->getResponseCode();
 			
 			sl_uint32 i, n;
 			sl_uint32 offset = sizeof(DnsHeader);
@@ -586,6 +589,7 @@ namespace slib
 				if (type == DnsRecordType::A) {
 					DnsPacket::Address item;
 					item.name = record.getName();
+					item.TTL = record.getTTL();
 					IPv4Address addr = record.parseData_A();
 					if (addr.isNotZero()) {
 						item.address = addr;
@@ -594,6 +598,7 @@ namespace slib
 				} else if (type == DnsRecordType::AAAA) {
 					DnsPacket::Address item;
 					item.name = record.getName();
+					item.TTL = record.getTTL();
 					IPv6Address addr = record.parseData_AAAA();
 					if (addr.isNotZero()) {
 						item.address = addr;
@@ -602,6 +607,7 @@ namespace slib
 				} else if (type == DnsRecordType::CNAME) {
 					DnsPacket::Alias item;
 					item.name = record.getName();
+					item.TTL = record.getTTL();
 					item.alias = record.parseData_CNAME();
 					if (item.alias.isNotEmpty()) {
 						aliases.add(item);
@@ -683,32 +689,40 @@ namespace slib
 			}
 			
 		} else {
-			
-			DnsHeader* header = (DnsHeader*)(buf);
-			header->setId(id);
-			header->setQuestion(sl_false); // Response
-			header->setRD(sl_false);
-			header->setOpcode(DnsOpcode::Query);
-			header->setResponseCode(DnsResponseCode::NameError);
-			header->setQuestionsCount(1);
-			header->setAnswersCount(0);
-			header->setAuthoritiesCount(0);
-			header->setAdditionalsCount(0);
-			
-			sl_uint32 offset = sizeof(DnsHeader);
-			DnsQuestionRecord recordQuestion;
-			recordQuestion.setName(hostName);
-			recordQuestion.setType(DnsRecordType::A);
-			offset = recordQuestion.buildRecord(buf, offset, 1024);
-			if (offset == 0) {
-				return Memory::create(buf, offset);
-			}
+			return buildErrorAnswerPacket(id, hostName, DnsResponseCode::NameError);
 		}
 		
 		return sl_null;
 		
 	}
 
+	Memory DnsPacket::buildErrorAnswerPacket(sl_uint16 id, const String& hostName, DnsResponseCode code)
+	{
+		char buf[1024];
+		Base::zeroMemory(buf, sizeof(DnsHeader));
+		
+		DnsHeader* header = (DnsHeader*)(buf);
+		header->setId(id);
+		header->setQuestion(sl_false); // Response
+		header->setRD(sl_false);
+		header->setOpcode(DnsOpcode::Query);
+		header->setResponseCode(code);
+		header->setQuestionsCount(1);
+		header->setAnswersCount(0);
+		header->setAuthoritiesCount(0);
+		header->setAdditionalsCount(0);
+		
+		sl_uint32 offset = sizeof(DnsHeader);
+		DnsQuestionRecord recordQuestion;
+		recordQuestion.setName(hostName);
+		recordQuestion.setType(DnsRecordType::A);
+		offset = recordQuestion.buildRecord(buf, offset, sizeof(buf));
+		if (offset > 0) {
+			return Memory::create(buf, offset);
+		}
+		return sl_null;
+	}
+
 /*************************************************************
 				DnsClient
 *************************************************************/
@@ -787,6 +801,476 @@ namespace slib
 		}
 	}
 
+/*************************************************************
+				DnsResolver
+*************************************************************/
+
+	DnsResolverParam::DnsResolverParam()
+	{
+		serverAddress = SocketAddress(IPv4Address(8, 8, 8, 8), SLIB_NETWORK_DNS_PORT);
+		maxCacheCount = 10000;
+		minTTL = 0;
+		maxTTL = 86400;
+		negativeTTL = 30;
+		timeout = 2000;
+		retryCount = 2;
+	}
+
+	DnsResolverParam::~DnsResolverParam()
+	{
+	}
+
+
+	DnsResolverResult::DnsResolverResult()
+	{
+		responseCode = DnsResponseCode::NoError;
+		flagTimeout = sl_false;
+		flagCached = sl_false;
+	}
+
+	DnsResolverResult::~DnsResolverResult()
+	{
+	}
+
+
+	SLIB_DEFINE_ROOT_OBJECT(DnsResolverCacheEntry)
+
+	DnsResolverCacheEntry::DnsResolverCacheEntry()
+	{
+		responseCode = DnsResponseCode::NoError;
+		m_tickExpire = 0;
+		m_prev = sl_null;
+		m_next = sl_null;
+	}
+
+	DnsResolverCacheEntry::~DnsResolverCacheEntry()
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(DnsResolver, Object)
+
+	DnsResolver::DnsResolver()
+	{
+		m_front = sl_null;
+		m_back = sl_null;
+	}
+
+	DnsResolver::~DnsResolver()
+	{
+		release();
+	}
+
+#define TAG_RESOLVER "DnsResolver"
+
+	// lower case, without the trailing dot
+	static String _DnsResolver_normalizeName(const String& name)
+	{
+		String ret = name.toLower();
+		if (ret.endsWith('.')) {
+			ret = ret.substring(0, ret.getLength() - 1);
+		}
+		return ret;
+	}
+
+	// records of the answer section. They refer to `message`
+	static void _DnsResolver_parseAnswerRecords(const Memory& message, List<DnsResponseRecord>& records)
+	{
+		const void* buf = message.getData();
+		sl_uint32 size = (sl_uint32)(message.getSize());
+		if (size < sizeof(DnsHeader)) {
+			return;
+		}
+		DnsHeader* header = (DnsHeader*)buf;
+		sl_uint32 offset = sizeof(DnsHeader);
+		sl_uint32 n = header->getQuestionsCount();
+		for (sl_uint32 i = 0; i < n; i++) {
+			DnsQuestionRecord record;
+			offset = record.parseRecord(buf, offset, size);
+			if (offset == 0) {
+				return;
+			}
+		}
+		n = header->getAnswersCount();
+		for (sl_uint32 i = 0; i < n; i++) {
+			DnsResponseRecord record;
+			offset = record.parseRecord(buf, offset, size);
+			if (offset == 0) {
+				return;
+			}
+			records.add_NoLock(record);
+		}
+	}
+
+	static void _DnsResolver_setCachedResult(DnsResolverResult& result, DnsResolverCacheEntry* entry, sl_uint64 now, sl_uint64 tickExpire)
+	{
+		result.hostName = entry->hostName;
+		result.addresses = entry->addresses;
+		result.message = entry->message;
+		result.responseCode = entry->responseCode;
+		result.flagTimeout = sl_false;
+		result.flagCached = sl_true;
+		// counts down the TTL of the records by the time spent in the cache
+		sl_uint32 TTL = (sl_uint32)((tickExpire - now + 999) / 1000);
+		ListElements<DnsResponseRecord> records(entry->records);
+		for (sl_size i = 0; i < records.count; i++) {
+			DnsResponseRecord record = records[i];
+			if (record.getTTL() > TTL) {
+				record.setTTL(TTL);
+			}
+			result.records.add_NoLock(record);
+		}
+	}
+
+	Ref<DnsResolver> DnsResolver::create(const DnsResolverParam& param)
+	{
+		Ref<AsyncIoLoop> loop = param.ioLoop;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::getDefault();
+			if (loop.isNull()) {
+				return sl_null;
+			}
+		}
+		Ref<DnsResolver> ret = new DnsResolver;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			ret->m_ioLoop = loop;
+			AsyncUdpSocketParam up;
+			up.listener.setWeak(ret);
+			up.packetSize = 4096;
+			up.flagIPv6 = param.serverAddress.ip.isIPv6();
+			up.flagAutoStart = sl_true;
+			up.ioLoop = loop;
+			Ref<AsyncUdpSocket> socket = AsyncUdpSocket::create(up);
+			if (socket.isNotNull()) {
+				ret->m_udp = socket;
+				return ret;
+			}
+			LogError(TAG_RESOLVER, "Failed to create the socket");
+		}
+		return sl_null;
+	}
+
+	void DnsResolver::release()
+	{
+		Ref<AsyncUdpSocket> socket = m_udp;
+		if (socket.isNotNull()) {
+			socket->close();
+		}
+		List< Pair<String, Query> > queries;
+		{
+			MutexLocker lock(&m_lock);
+			HashTableNode<String, Query>* node = m_queries.getFirstNode();
+			while (node) {
+				queries.add_NoLock(node->data);
+				node = node->getNext();
+			}
+			m_queries.removeAll();
+			m_queryNames.removeAll();
+		}
+		for (auto& item : queries) {
+			Query& query = item.value;
+			if (query.taskTimeout.isNotNull()) {
+				query.taskTimeout->cancel();
+			}
+			// the waiters are not left without the answer
+			DnsResolverResult result;
+			result.hostName = item.key;
+			result.responseCode = DnsResponseCode::ServerFailure;
+			for (auto& callback : query.callbacks) {
+				callback(&result);
+			}
+		}
+	}
+
+	SocketAddress DnsResolver::getServerAddress()
+	{
+		return m_param.serverAddress;
+	}
+
+	void DnsResolver::resolve(const String& hostName, const Function<void(DnsResolverResult*)>& callback)
+	{
+		String name = _DnsResolver_normalizeName(hostName);
+		if (name.isEmpty()) {
+			DnsResolverResult result;
+			result.responseCode = DnsResponseCode::NameError;
+			callback(&result);
+			return;
+		}
+		sl_uint64 now = m_timeCounter.getElapsedMilliseconds();
+		Ref<DnsResolverCacheEntry> entry;
+		sl_uint64 tickExpire = 0;
+		sl_uint16 id = 0;
+		{
+			MutexLocker lock(&m_lock);
+			entry = _getCache(name, now);
+			if (entry.isNotNull()) {
+				tickExpire = entry->m_tickExpire;
+			}
+			if (entry.isNull()) {
+				Query* query = m_queries.getItemPointer(name);
+				if (query) {
+					// joins the question in flight
+					query->callbacks.add_NoLock(callback);
+					return;
+				}
+				id = _newQueryId();
+				Query q;
+				q.id = id;
+				q.nRetries = 0;
+				q.callbacks.add_NoLock(callback);
+				q.taskTimeout = m_ioLoop->setTimeout(SLIB_BIND_WEAKREF(void(), DnsResolver, _onTimeout, this, name, id), m_param.timeout);
+				m_queries.put(name, q);
+				m_queryNames.put(id, name);
+			}
+		}
+		if (entry.isNotNull()) {
+			DnsResolverResult result;
+			_DnsResolver_setCachedResult(result, entry.get(), now, tickExpire);
+			callback(&result);
+			return;
+		}
+		_sendQuestion(name, id);
+	}
+
+	sl_bool DnsResolver::getCachedResult(const String& hostName, DnsResolverResult& result)
+	{
+		String name = _DnsResolver_normalizeName(hostName);
+		sl_uint64 now = m_timeCounter.getElapsedMilliseconds();
+		MutexLocker lock(&m_lock);
+		Ref<DnsResolverCacheEntry> entry = _getCache(name, now);
+		if (entry.isNotNull()) {
+			_DnsResolver_setCachedResult(result, entry.get(), now, entry->m_tickExpire);
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void DnsResolver::removeAllCache()
+	{
+		MutexLocker lock(&m_lock);
+		m_front = sl_null;
+		m_back = sl_null;
+		m_cache.removeAll();
+	}
+
+	sl_size DnsResolver::getCacheCount()
+	{
+		MutexLocker lock(&m_lock);
+		return m_cache.getCount();
+	}
+
+	void DnsResolver::onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& address, void* data, sl_uint32 sizeReceive)
+	{
+		if (address != m_param.serverAddress) {
+			return;
+		}
+		DnsPacket packet;
+		if (!(packet.parsePacket(data, sizeReceive)) || packet.flagQuestion) {
+			return;
+		}
+		String name;
+		{
+			MutexLocker lock(&m_lock);
+			if (!(m_queryNames.get(packet.id, &name))) {
+				return;
+			}
+		}
+		// the answer should repeat the question
+		if (packet.questions.getCount() != 1 || _DnsResolver_normalizeName((packet.questions.getData())[0].name) != name) {
+			return;
+		}
+		DnsResolverResult result;
+		result.hostName = name;
+		result.responseCode = packet.responseCode;
+		result.message = Memory::create(data, sizeReceive);
+		_DnsResolver_parseAnswerRecords(result.message, result.records);
+		if (packet.responseCode == DnsResponseCode::NoError || packet.responseCode == DnsResponseCode::NameError) {
+			sl_uint32 TTL = m_param.maxTTL;
+			// names of the host following the aliases
+			List<String> names;
+			names.add_NoLock(name);
+			{
+				ListElements<DnsPacket::Alias> aliases(packet.aliases);
+				sl_bool flagAdded = sl_true;
+				while (flagAdded) {
+					flagAdded = sl_false;
+					for (sl_size i = 0; i < aliases.count; i++) {
+						DnsPacket::Alias& alias = aliases[i];
+						String target = _DnsResolver_normalizeName(alias.alias);
+						if (names.contains_NoLock(_DnsResolver_normalizeName(alias.name)) && !(names.contains_NoLock(target))) {
+							names.add_NoLock(target);
+							if (alias.TTL < TTL) {
+								TTL = alias.TTL;
+							}
+							flagAdded = sl_true;
+						}
+					}
+				}
+			}
+			{
+				ListElements<DnsPacket::Address> addresses(packet.addresses);
+				for (sl_size i = 0; i < addresses.count; i++) {
+					DnsPacket::Address& address = addresses[i];
+					if (names.contains_NoLock(_DnsResolver_normalizeName(address.name))) {
+						result.addresses.add_NoLock(address.address);
+						if (address.TTL < TTL) {
+							TTL = address.TTL;
+						}
+					}
+				}
+			}
+			if (result.addresses.isEmpty()) {
+				// negative caching
+				TTL = m_param.negativeTTL;
+			} else if (TTL < m_param.minTTL) {
+				TTL = m_param.minTTL;
+			}
+			Ref<DnsResolverCacheEntry> entry = new DnsResolverCacheEntry;
+			if (entry.isNotNull()) {
+				entry->hostName = name;
+				entry->addresses = result.addresses;
+				entry->records = result.records;
+				entry->message = result.message;
+				entry->responseCode = result.responseCode;
+				_putCache(entry, TTL);
+			}
+		}
+		_complete(name, result);
+	}
+
+	Ref<DnsResolverCacheEntry> DnsResolver::_getCache(const String& name, sl_uint64 now)
+	{
+		Ref<DnsResolverCacheEntry> entry;
+		if (m_cache.get(name, &entry)) {
+			if (now < entry->m_tickExpire) {
+				if (m_front != entry.get()) {
+					_removeCacheEntry(entry.get());
+					_addCacheEntry(entry.get());
+				}
+				return entry;
+			}
+			_removeCacheEntry(entry.get());
+			m_cache.remove(name);
+		}
+		return sl_null;
+	}
+
+	void DnsResolver::_putCache(const Ref<DnsResolverCacheEntry>& entry, sl_uint32 TTL)
+	{
+		if (TTL == 0 || m_param.maxCacheCount == 0) {
+			return;
+		}
+		entry->m_tickExpire = m_timeCounter.getElapsedMilliseconds() + (sl_uint64)TTL * 1000;
+		MutexLocker lock(&m_lock);
+		Ref<DnsResolverCacheEntry> old;
+		if (m_cache.remove(entry->hostName, &old)) {
+			_removeCacheEntry(old.get());
+		}
+		_addCacheEntry(entry.get());
+		m_cache.put(entry->hostName, entry);
+		while (m_cache.getCount() > m_param.maxCacheCount && m_back && m_back != entry.get()) {
+			DnsResolverCacheEntry* last = m_back;
+			String nameLast = last->hostName;
+			_removeCacheEntry(last);
+			m_cache.remove(nameLast);
+		}
+	}
+
+	void DnsResolver::_addCacheEntry(DnsResolverCacheEntry* entry)
+	{
+		entry->m_prev = sl_null;
+		entry->m_next = m_front;
+		if (m_front) {
+			m_front->m_prev = entry;
+		} else {
+			m_back = entry;
+		}
+		m_front = entry;
+	}
+
+	void DnsResolver::_removeCacheEntry(DnsResolverCacheEntry* entry)
+	{
+		if (entry->m_prev) {
+			entry->m_prev->m_next = entry->m_next;
+		} else {
+			m_front = entry->m_next;
+		}
+		if (entry->m_next) {
+			entry->m_next->m_prev = entry->m_prev;
+		} else {
+			m_back = entry->m_prev;
+		}
+		entry->m_prev = sl_null;
+		entry->m_next = sl_null;
+	}
+
+	sl_uint16 DnsResolver::_newQueryId()
+	{
+		// random id, so that the spoofed answers are hard to match. 0 is not used: `_onTimeout()` uses it as "no retry"
+		for (;;) {
+			sl_uint16 id = (sl_uint16)(Math::randomInt());
+			if (id && !(m_queryNames.find(id))) {
+				return id;
+			}
+		}
+	}
+
+	void DnsResolver::_sendQuestion(const String& name, sl_uint16 id)
+	{
+		Memory mem = DnsPacket::buildQuestionPacket(id, name);
+		if (mem.isNotEmpty()) {
+			m_udp->sendTo(m_param.serverAddress, mem);
+		}
+	}
+
+	void DnsResolver::_onTimeout(String name, sl_uint16 id)
+	{
+		sl_uint16 idRetry = 0;
+		{
+			MutexLocker lock(&m_lock);
+			Query* query = m_queries.getItemPointer(name);
+			if (!query || query->id != id) {
+				return;
+			}
+			if (query->nRetries < m_param.retryCount) {
+				query->nRetries++;
+				m_queryNames.remove(id);
+				idRetry = _newQueryId();
+				query->id = idRetry;
+				query->taskTimeout = m_ioLoop->setTimeout(SLIB_BIND_WEAKREF(void(), DnsResolver, _onTimeout, this, name, idRetry), m_param.timeout);
+				m_queryNames.put(idRetry, name);
+			}
+		}
+		if (idRetry) {
+			_sendQuestion(name, idRetry);
+			return;
+		}
+		DnsResolverResult result;
+		result.hostName = name;
+		result.responseCode = DnsResponseCode::ServerFailure;
+		result.flagTimeout = sl_true;
+		_complete(name, result);
+	}
+
+	void DnsResolver::_complete(const String& name, DnsResolverResult& result)
+	{
+		Query query;
+		{
+			MutexLocker lock(&m_lock);
+			if (!(m_queries.remove(name, &query))) {
+				return;
+			}
+			m_queryNames.remove(query.id);
+		}
+		if (query.taskTimeout.isNotNull()) {
+			query.taskTimeout->cancel();
+		}
+		for (auto& callback : query.callbacks) {
+			callback(&result);
+		}
+	}
+
 /*************************************************************
 					DnsServer
 *************************************************************/
@@ -824,6 +1308,8 @@ namespace slib
 		flagEncryptDefaultForward = sl_false;
 
 		flagAutoStart = sl_true;
+
+		batchCount = 32;
 	}
 
 	DnsServerParam::~DnsServerParam()
@@ -841,6 +1327,8 @@ namespace slib
 		IPv4Address defaultForwardAddressIp = IPv4Address(8, 8, 4, 4);
 		defaultForwardAddressIp.parse(conf.getItem("forward_dns").getString());
 		defaultForwardAddress = SocketAddress(defaultForwardAddressIp, SLIB_NETWORK_DNS_PORT);
+
+		batchCount = conf.getItem("batch_count").getUint32(32);
 	}
 
 
@@ -873,6 +1361,7 @@ namespace slib
 			AsyncUdpSocketParam up;
 			up.listener.setWeak(ret);
 			up.packetSize = 4096;
+			up.batchCount = param.batchCount;
 			up.ioLoop = param.ioLoop;
 			up.flagAutoStart = sl_false;
 			
@@ -901,6 +1390,11 @@ namespace slib
 
 				ret->m_defaultForwardAddress = param.defaultForwardAddress;
 				ret->m_flagEncryptDefaultForward = param.flagEncryptDefaultForward;
+				ret->m_resolver = param.resolver;
+				if (param.resolver.isNotNull()) {
+					// the resolved and the forwarded questions go to the same upstream server
+					ret->m_defaultForwardAddress = param.resolver->getServerAddress();
+				}
 
 				ret->m_listener = param.listener;
 
@@ -978,6 +1472,17 @@ namespace slib
 			_sendPacket(flagEncryptedRequest, clientAddress, _buildHostAddressAnswerPacket(id, hostName, rp.hostAddress, flagEncryptedRequest));
 		}
 		
+		// resolve through the caching resolver
+		if (m_resolver.isNotNull() && !(rp.flagEncryptForward) && rp.forwardAddress == m_defaultForwardAddress) {
+			if (rp.hostAddress.isNotZero()) {
+				// updates the cache of the resolver, while the client is already answered
+				m_resolver->resolve(hostName, SLIB_BIND_WEAKREF(void(DnsResolverResult*), DnsServer, _onResolve, this, SocketAddress(), id, hostName, flagEncryptedRequest));
+			} else {
+				m_resolver->resolve(hostName, SLIB_BIND_WEAKREF(void(DnsResolverResult*), DnsServer, _onResolve, this, clientAddress, id, hostName, flagEncryptedRequest));
+			}
+			return;
+		}
+		
 		// forward DNS request
 		{
 			sl_uint16 idForward = m_lastForwardId++;
@@ -1152,6 +1657,35 @@ namespace slib
 		return mem;
 	}
 
+	void DnsServer::_onResolve(SocketAddress clientAddress, sl_uint16 id, String hostName, sl_bool flagEncrypted, DnsResolverResult* result)
+	{
+		if (result->flagTimeout) {
+			if (clientAddress.isValid()) {
+				_sendPacket(flagEncrypted, clientAddress, _buildErrorAnswerPacket(id, hostName, DnsResponseCode::ServerFailure, flagEncrypted));
+			}
+			return;
+		}
+		IPv4Address resolvedAddress;
+		resolvedAddress.setZero();
+		ListElements<IPAddress> addresses(result->addresses);
+		for (sl_size i = 0; i < addresses.count; i++) {
+			IPAddress& address = addresses[i];
+			if (!(result->flagCached)) {
+				_cacheDnsHost(hostName, address);
+			}
+			if (resolvedAddress.isZero() && address.isIPv4()) {
+				resolvedAddress = address.getIPv4();
+			}
+		}
+		if (clientAddress.isValid()) {
+			if (resolvedAddress.isZero() && result->responseCode != DnsResponseCode::NoError) {
+				_sendPacket(flagEncrypted, clientAddress, _buildErrorAnswerPacket(id, hostName, result->responseCode, flagEncrypted));
+			} else {
+				_sendPacket(flagEncrypted, clientAddress, _buildHostAddressAnswerPacket(id, hostName, resolvedAddress, flagEncrypted));
+			}
+		}
+	}
+
 	Memory DnsServer::_buildHostAddressAnswerPacket(sl_uint16 id, const String& hostName, const IPv4Address& hostAddress, sl_bool flagEncrypt)
 	{
 		Memory mem = DnsPacket::buildHostAddressAnswerPacket(id, hostName, hostAddress);
@@ -1161,6 +1695,15 @@ namespace slib
 		return mem;
 	}
 
+	Memory DnsServer::_buildErrorAnswerPacket(sl_uint16 id, const String& hostName, DnsResponseCode code, sl_bool flagEncrypt)
+	{
+		Memory mem = DnsPacket::buildErrorAnswerPacket(id, hostName, code);
+		if (flagEncrypt) {
+			return m_encrypt.encrypt_CBC_PKCS7Padding(mem);
+		}
+		return mem;
+	}
+
 	void DnsServer::onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& addressFrom, void* data, sl_uint32 size)
 	{
 		sl_bool flagEncrypted = sl_false;
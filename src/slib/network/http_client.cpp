@@ -0,0 +1,1167 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/network/http_client.h"
+
+#include "slib/network/async.h"
+#include "slib/network/url.h"
+#include "slib/core/system.h"
+#include "slib/core/safe_static.h"
+#include "slib/core/log.h"
+#include "slib/core/memory_pool.h"
+
+#define TAG "HttpClient"
+
+#define HTTP_CLIENT_MAX_RESPONSE_HEADERS_SIZE 0x10000
+
+namespace slib
+{
+
+	class _HttpClientHost : public Referable
+	{
+	public:
+		String name;
+		sl_uint16 port;
+		// resolved address, cleared when connecting is failed
+		IPAddress address;
+
+		// all connections (connecting, active and idle)
+		List< Ref<_HttpClientConnection> > connections;
+		// most recently used at back
+		List< Ref<_HttpClientConnection> > connectionsIdle;
+		LinkedQueue< Ref<HttpClientContext> > queueContexts;
+
+	};
+
+	enum class _HttpClientConnectionState
+	{
+		Resolving = 0,
+		Connecting = 1,
+		Requesting = 2,
+		Idle = 3,
+		Closed = 4
+	};
+
+	class _HttpClientConnection : public Referable, public IHttpContentReaderListener
+	{
+	public:
+		WeakRef<HttpClient> m_client;
+		Ref<_HttpClientHost> m_host;
+		Ref<AsyncIoLoop> m_ioLoop;
+		Ref<AsyncTcpSocket> m_socket;
+
+		_HttpClientConnectionState m_state;
+		sl_uint32 m_nRequests;
+
+		Memory m_bufRead;
+		sl_bool m_flagReading;
+
+		Ref<HttpClientContext> m_context;
+		HttpHeaderReader m_headerReader;
+		sl_bool m_flagResponseStarted;
+		sl_bool m_flagHeaderReceived;
+		sl_bool m_flagKeepAlive;
+		sl_bool m_flagReadUntilClose;
+		Ref<HttpContentReader> m_contentReader;
+		sl_bool m_flagContentCompleted;
+		sl_bool m_flagContentError;
+
+		sl_uint32 m_tickLastActive;
+		sl_uint32 m_tickTimeout;
+		Ref<TimerWheelTask> m_taskTimeout;
+
+	public:
+		_HttpClientConnection()
+		{
+			m_state = _HttpClientConnectionState::Resolving;
+			m_nRequests = 0;
+			m_flagReading = sl_false;
+			m_flagResponseStarted = sl_false;
+			m_flagHeaderReceived = sl_false;
+			m_flagKeepAlive = sl_false;
+			m_flagReadUntilClose = sl_false;
+			m_flagContentCompleted = sl_false;
+			m_flagContentError = sl_false;
+			m_tickLastActive = 0;
+			m_tickTimeout = 0;
+		}
+
+		~_HttpClientConnection()
+		{
+			if (m_socket.isNotNull()) {
+				m_socket->close();
+			}
+		}
+
+	public:
+		sl_bool isClosed()
+		{
+			return m_state == _HttpClientConnectionState::Closed;
+		}
+
+		void resolve()
+		{
+			// runs on the thread pool
+			IPAddress ip;
+			if (!(ip.setHostName(m_host->name))) {
+				ip.setNone();
+			}
+			m_ioLoop->addTask(SLIB_BIND_REF(void(), _HttpClientConnection, connect, this, ip));
+		}
+
+		void connect(const IPAddress& ip)
+		{
+			if (isClosed()) {
+				return;
+			}
+			Ref<HttpClient> client = m_client;
+			if (client.isNull()) {
+				close();
+				return;
+			}
+			if (ip.isNone()) {
+				_fail(String::format("Failed to resolve the host: %s", m_host->name), sl_false);
+				return;
+			}
+			{
+				MutexLocker lock(&(client->m_lock));
+				m_host->address = ip;
+			}
+			AsyncTcpSocketParam param;
+			param.ioLoop = m_ioLoop;
+			param.flagIPv6 = ip.isIPv6();
+			param.flagLogError = client->m_param.flagLogError;
+			param.connectAddress = SocketAddress(ip, m_host->port);
+			param.onConnect = SLIB_FUNCTION_WEAKREF(_HttpClientConnection, onConnect, this);
+			m_socket = AsyncTcpSocket::create(param);
+			if (m_socket.isNull()) {
+				_fail(String::format("Failed to connect to %s:%d", m_host->name, m_host->port), sl_false);
+				return;
+			}
+			_setState(_HttpClientConnectionState::Connecting);
+		}
+
+		void onConnect(AsyncTcpSocket* socket, const SocketAddress& address, sl_bool flagError)
+		{
+			if (isClosed()) {
+				return;
+			}
+			if (flagError) {
+				Ref<HttpClient> client = m_client;
+				if (client.isNotNull()) {
+					MutexLocker lock(&(client->m_lock));
+					m_host->address.setNone();
+				}
+				_fail(String::format("Failed to connect to %s:%d", m_host->name, m_host->port), sl_false);
+				return;
+			}
+			Ref<Socket> s = socket->getSocket();
+			if (s.isNotNull()) {
+				s->setOption_TcpNoDelay(sl_true);
+			}
+			_sendRequest();
+		}
+
+		// called on the loop thread
+		void startRequest(const Ref<HttpClientContext>& context)
+		{
+			if (isClosed()) {
+				_retryOrFail(context, "Connection is closed", sl_true);
+				return;
+			}
+			m_context = context;
+			context->m_connection = this;
+			if (m_state != _HttpClientConnectionState::Resolving && m_state != _HttpClientConnectionState::Connecting) {
+				_sendRequest();
+			}
+		}
+
+		void cancel(const Ref<HttpClientContext>& context)
+		{
+			if (m_context == context) {
+				m_context.setNull();
+				close();
+			}
+		}
+
+		void close()
+		{
+			if (isClosed()) {
+				return;
+			}
+			m_state = _HttpClientConnectionState::Closed;
+			if (m_taskTimeout.isNotNull()) {
+				m_taskTimeout->cancel();
+				m_taskTimeout.setNull();
+			}
+			if (m_socket.isNotNull()) {
+				m_socket->close();
+			}
+			m_contentReader.setNull();
+			Ref<HttpClient> client = m_client;
+			if (client.isNotNull()) {
+				client->_onConnectionClosed(this);
+			}
+		}
+
+		// runs on the loop, when the client is released
+		void abort(const String& message)
+		{
+			Ref<HttpClientContext> context = m_context;
+			m_context.setNull();
+			close();
+			if (context.isNotNull()) {
+				context->m_connection.setNull();
+				context->_onComplete(sl_true, message);
+			}
+		}
+
+		void onCompleteReadHttpContent(void* dataRemained, sl_uint32 sizeRemained, sl_bool flagError) override
+		{
+			if (flagError) {
+				m_flagContentError = sl_true;
+			} else {
+				m_flagContentCompleted = sl_true;
+				if (sizeRemained > 0) {
+					// the server is not expected to send anything after the response
+					m_flagKeepAlive = sl_false;
+				}
+			}
+		}
+
+	protected:
+		void _setState(_HttpClientConnectionState state)
+		{
+			m_state = state;
+			m_tickLastActive = System::getTickCount();
+			sl_uint32 timeout = _getTimeout();
+			if (timeout == 0) {
+				return;
+			}
+			// armed when nothing is pending, or when the pending one expires later than the new timeout
+			if (m_taskTimeout.isNotNull() && m_taskTimeout->isPending()) {
+				if ((sl_int32)(m_tickLastActive + timeout - m_tickTimeout) >= 0) {
+					return;
+				}
+				m_taskTimeout->cancel();
+			}
+			_setTimer(timeout);
+		}
+
+		sl_uint32 _getTimeout()
+		{
+			Ref<HttpClient> client = m_client;
+			if (client.isNull()) {
+				return 0;
+			}
+			const HttpClientParam& param = client->m_param;
+			switch (m_state) {
+				case _HttpClientConnectionState::Resolving:
+				case _HttpClientConnectionState::Connecting:
+					return param.connectTimeout;
+				case _HttpClientConnectionState::Requesting:
+					return param.readTimeout;
+				case _HttpClientConnectionState::Idle:
+					return param.keepAliveTimeout;
+				default:
+					return 0;
+			}
+		}
+
+		void _setTimer(sl_uint32 timeout)
+		{
+			m_tickTimeout = System::getTickCount() + timeout;
+			m_taskTimeout = m_ioLoop->setTimeout(SLIB_FUNCTION_WEAKREF(_HttpClientConnection, _onTimer, this), timeout);
+		}
+
+		void _onTimer()
+		{
+			if (isClosed()) {
+				return;
+			}
+			sl_uint32 timeout = _getTimeout();
+			if (timeout == 0) {
+				return;
+			}
+			sl_uint32 elapsed = System::getTickCount() - m_tickLastActive;
+			if (elapsed < timeout) {
+				_setTimer(timeout - elapsed);
+				return;
+			}
+			switch (m_state) {
+				case _HttpClientConnectionState::Idle:
+					close();
+					break;
+				case _HttpClientConnectionState::Requesting:
+					_fail(String::format("Timeout while receiving the response from %s:%d", m_host->name, m_host->port), sl_false);
+					break;
+				default:
+					_fail(String::format("Timeout while connecting to %s:%d", m_host->name, m_host->port), sl_false);
+					break;
+			}
+		}
+
+		void _sendRequest()
+		{
+			Ref<HttpClient> client = m_client;
+			if (client.isNull()) {
+				close();
+				return;
+			}
+			Ref<HttpClientContext> context = m_context;
+			if (context.isNull()) {
+				// the request is cancelled while connecting
+				_onResponseCompleted();
+				return;
+			}
+			const HttpClientParam& param = client->m_param;
+			m_nRequests++;
+			if (param.maxRequestsPerConnection > 0 && m_nRequests >= param.maxRequestsPerConnection) {
+				context->setRequestHeader(HttpHeaders::Connection, "close");
+			}
+
+			m_headerReader.clear();
+			m_flagResponseStarted = sl_false;
+			m_flagHeaderReceived = sl_false;
+			m_flagKeepAlive = sl_false;
+			m_flagReadUntilClose = sl_false;
+			m_contentReader.setNull();
+			m_flagContentCompleted = sl_false;
+			m_flagContentError = sl_false;
+			_setState(_HttpClientConnectionState::Requesting);
+
+			Memory header = context->makeRequestPacket();
+			Memory body = context->m_requestBody;
+			sl_bool flagSuccess;
+			if (body.isEmpty()) {
+				flagSuccess = m_socket->writeFromMemory(header, SLIB_FUNCTION_WEAKREF(_HttpClientConnection, _onWrite, this));
+			} else if (body.getSize() < 0x4000) {
+				// one segment for the small body
+				Memory packet = MemoryPool::create(header.getSize() + body.getSize());
+				if (packet.isNull()) {
+					flagSuccess = sl_false;
+				} else {
+					Base::copyMemory(packet.getData(), header.getData(), header.getSize());
+					Base::copyMemory((sl_uint8*)(packet.getData()) + header.getSize(), body.getData(), body.getSize());
+					flagSuccess = m_socket->writeFromMemory(packet, SLIB_FUNCTION_WEAKREF(_HttpClientConnection, _onWrite, this));
+				}
+			} else {
+				flagSuccess = m_socket->writeFromMemory(header, sl_null) && m_socket->writeFromMemory(body, SLIB_FUNCTION_WEAKREF(_HttpClientConnection, _onWrite, this));
+			}
+			if (!flagSuccess) {
+				_fail("Failed to send the request", sl_true);
+				return;
+			}
+			_read();
+		}
+
+		void _onWrite(AsyncStreamResult* result)
+		{
+			if (result->flagError) {
+				if (m_state == _HttpClientConnectionState::Requesting) {
+					_fail("Failed to send the request", !m_flagResponseStarted);
+				}
+			}
+		}
+
+		void _read()
+		{
+			if (m_flagReading || isClosed()) {
+				return;
+			}
+			if (m_bufRead.isNull()) {
+				Ref<HttpClient> client = m_client;
+				if (client.isNull()) {
+					close();
+					return;
+				}
+				m_bufRead = MemoryPool::create(client->m_param.bufferSize);
+				if (m_bufRead.isNull()) {
+					_fail("Lack of memory", sl_false);
+					return;
+				}
+			}
+			if (m_socket->readToMemory(m_bufRead, SLIB_FUNCTION_WEAKREF(_HttpClientConnection, _onRead, this))) {
+				m_flagReading = sl_true;
+			} else {
+				_fail("Failed to receive the response", !m_flagResponseStarted);
+			}
+		}
+
+		void _onRead(AsyncStreamResult* result)
+		{
+			m_flagReading = sl_false;
+			if (isClosed()) {
+				return;
+			}
+			if (result->size > 0) {
+				if (m_state != _HttpClientConnectionState::Requesting) {
+					// unexpected data on the idle connection
+					close();
+					return;
+				}
+				m_tickLastActive = System::getTickCount();
+				_processInput(result->data, result->size);
+				if (isClosed()) {
+					return;
+				}
+			}
+			if (result->flagError) {
+				// closed by the server
+				if (m_state == _HttpClientConnectionState::Requesting) {
+					if (m_flagReadUntilClose) {
+						m_flagKeepAlive = sl_false;
+						_onResponseCompleted();
+					} else {
+						_fail("Connection is closed by the server", !m_flagResponseStarted);
+					}
+				} else {
+					close();
+				}
+				return;
+			}
+			// keeps reading on the idle connection to detect the closing by the server
+			_read();
+		}
+
+		void _processInput(void* data, sl_uint32 size)
+		{
+			m_flagResponseStarted = sl_true;
+			if (m_flagHeaderReceived) {
+				_processContent(data, size);
+				return;
+			}
+			sl_size posBody;
+			if (!(m_headerReader.add(data, size, posBody))) {
+				if (m_headerReader.getHeaderSize() > HTTP_CLIENT_MAX_RESPONSE_HEADERS_SIZE) {
+					_fail("Too large response header", sl_false);
+				}
+				return;
+			}
+			Ref<HttpClientContext> context = m_context;
+			if (context.isNull()) {
+				close();
+				return;
+			}
+			Memory header = m_headerReader.mergeHeader();
+			m_headerReader.clear();
+			context->clearResponseHeaders();
+			if (context->parseResponsePacket(header.getData(), header.getSize()) <= 0) {
+				_fail("Invalid response header", sl_false);
+				return;
+			}
+			int status = (int)(context->getResponseCode());
+			if (status >= 100 && status < 200) {
+				// interim response (100 Continue)
+				if (posBody < size) {
+					_processInput((sl_uint8*)data + posBody, size - (sl_uint32)posBody);
+				}
+				return;
+			}
+			m_flagHeaderReceived = sl_true;
+			if (!(_prepareContent(context.get()))) {
+				_fail("Failed to decode the response content", sl_false);
+				return;
+			}
+			context->_onResponse();
+			if (m_flagContentCompleted) {
+				if (posBody < size) {
+					m_flagKeepAlive = sl_false;
+				}
+				_onResponseCompleted();
+				return;
+			}
+			if (posBody < size) {
+				_processContent((sl_uint8*)data + posBody, size - (sl_uint32)posBody);
+			}
+		}
+
+		sl_bool _prepareContent(HttpClientContext* context)
+		{
+			Ref<HttpClient> client = m_client;
+			if (client.isNull()) {
+				return sl_false;
+			}
+			String version = context->getResponseVersion();
+			String connection = context->getResponseHeader(HttpHeaders::Connection);
+			if (version.equalsIgnoreCase("HTTP/1.0")) {
+				m_flagKeepAlive = connection.equalsIgnoreCase("keep-alive");
+			} else {
+				m_flagKeepAlive = !(connection.equalsIgnoreCase("close"));
+			}
+			if (context->getRequestHeader(HttpHeaders::Connection).equalsIgnoreCase("close")) {
+				m_flagKeepAlive = sl_false;
+			}
+			int status = (int)(context->getResponseCode());
+			if (context->getMethod() == HttpMethod::HEAD || status == 204 || status == 304) {
+				m_flagContentCompleted = sl_true;
+				return sl_true;
+			}
+			sl_bool flagDecompress = sl_false;
+			if (client->m_param.flagDecompress) {
+				String encoding = context->getResponseContentEncoding();
+				if (encoding.equalsIgnoreCase("gzip") || encoding.equalsIgnoreCase("deflate")) {
+					flagDecompress = sl_true;
+				}
+			}
+			Ptr<IHttpContentReaderListener> listener = WeakRef<_HttpClientConnection>(this);
+			if (context->isChunkedResponse()) {
+				m_contentReader = HttpContentReader::createChunked(sl_null, listener, 0, flagDecompress);
+			} else if (context->containsResponseHeader(HttpHeaders::ContentLength)) {
+				sl_uint64 length = context->getResponseContentLengthHeader();
+				if (length == 0) {
+					m_flagContentCompleted = sl_true;
+					return sl_true;
+				}
+				m_contentReader = HttpContentReader::createPersistent(sl_null, listener, length, 0, flagDecompress);
+			} else {
+				m_flagKeepAlive = sl_false;
+				m_flagReadUntilClose = sl_true;
+				if (flagDecompress) {
+					m_contentReader = HttpContentReader::createTearDown(sl_null, listener, 0, sl_true);
+				} else {
+					return sl_true;
+				}
+			}
+			return m_contentReader.isNotNull();
+		}
+
+		void _processContent(void* data, sl_uint32 size)
+		{
+			Ref<HttpClientContext> context = m_context;
+			if (context.isNull()) {
+				close();
+				return;
+			}
+			if (m_contentReader.isNull()) {
+				context->_onReceiveContent(data, size, sl_null);
+				return;
+			}
+			Memory mem = m_contentReader->decode(data, size);
+			if (mem.isNotEmpty()) {
+				if (m_contentReader->isDecompressing()) {
+					context->_onReceiveContent(mem.getData(), mem.getSize(), mem);
+				} else {
+					// static memory on the reading buffer
+					context->_onReceiveContent(mem.getData(), mem.getSize(), sl_null);
+				}
+			}
+			if (m_flagContentError) {
+				_fail("Invalid response content", sl_false);
+				return;
+			}
+			if (m_flagContentCompleted) {
+				_onResponseCompleted();
+			}
+		}
+
+		void _onResponseCompleted()
+		{
+			Ref<HttpClientContext> context = m_context;
+			m_context.setNull();
+			m_contentReader.setNull();
+			Ref<HttpClient> client = m_client;
+			sl_bool flagReuse = m_flagKeepAlive && client.isNotNull() && client->isRunning();
+			if (flagReuse && client->m_param.maxRequestsPerConnection > 0 && m_nRequests >= client->m_param.maxRequestsPerConnection) {
+				flagReuse = sl_false;
+			}
+			if (context.isNotNull()) {
+				context->m_connection.setNull();
+			}
+			if (flagReuse) {
+				_setState(_HttpClientConnectionState::Idle);
+			} else {
+				close();
+			}
+			if (context.isNotNull()) {
+				context->_onComplete(sl_false, sl_null);
+			}
+			if (flagReuse && !(isClosed())) {
+				client->_onConnectionFree(this);
+				_read();
+			}
+		}
+
+		void _fail(const String& message, sl_bool flagRetry)
+		{
+			Ref<HttpClientContext> context = m_context;
+			m_context.setNull();
+			close();
+			if (context.isNotNull()) {
+				// a reused connection may be closed by the server just before receiving the request
+				_retryOrFail(context, message, flagRetry && m_nRequests > 1);
+			}
+		}
+
+		// only the requests which can be repeated without side effects are sent again
+		static sl_bool _isIdempotentMethod(HttpMethod method)
+		{
+			switch (method) {
+				case HttpMethod::GET:
+				case HttpMethod::HEAD:
+				case HttpMethod::OPTIONS:
+				case HttpMethod::PUT:
+				case HttpMethod::DELETE:
+				case HttpMethod::TRACE:
+					return sl_true;
+				default:
+					break;
+			}
+			return sl_false;
+		}
+
+		void _retryOrFail(const Ref<HttpClientContext>& context, const String& message, sl_bool flagRetry)
+		{
+			context->m_connection.setNull();
+			if (flagRetry && !(context->m_flagRetried)) {
+				if (_isIdempotentMethod(context->getMethod())) {
+					Ref<HttpClient> client = m_client;
+					if (client.isNotNull()) {
+						context->m_flagRetried = sl_true;
+						client->_processContext(context);
+						return;
+					}
+				}
+			}
+			Ref<HttpClient> client = m_client;
+			if (client.isNotNull() && client->m_param.flagLogError && !(context->m_flagCancelled)) {
+				LogError(TAG, "%s (%s)", message, context->m_url);
+			}
+			context->_onComplete(sl_true, message);
+		}
+
+		friend class HttpClient;
+
+	};
+
+
+	SLIB_DEFINE_OBJECT(HttpClientContext, Object)
+
+	HttpClientContext::HttpClientContext()
+	{
+		m_port = 80;
+		m_flagStoreResponseContent = sl_true;
+		m_sizeContentReceived = 0;
+		m_flagCompleted = sl_false;
+		m_flagError = sl_false;
+		m_flagCancelled = sl_false;
+		m_flagRetried = sl_false;
+	}
+
+	HttpClientContext::~HttpClientContext()
+	{
+	}
+
+	String HttpClientContext::getUrl() const
+	{
+		return m_url;
+	}
+
+	String HttpClientContext::getHostName() const
+	{
+		return m_host;
+	}
+
+	sl_uint16 HttpClientContext::getPort() const
+	{
+		return m_port;
+	}
+
+	const Memory& HttpClientContext::getRequestBody() const
+	{
+		return m_requestBody;
+	}
+
+	Memory HttpClientContext::getResponseContent() const
+	{
+		return m_bufResponseContent.merge();
+	}
+
+	sl_uint64 HttpClientContext::getReceivedContentSize() const
+	{
+		return m_sizeContentReceived;
+	}
+
+	sl_bool HttpClientContext::isCompleted() const
+	{
+		return m_flagCompleted;
+	}
+
+	sl_bool HttpClientContext::isError() const
+	{
+		return m_flagError;
+	}
+
+	String HttpClientContext::getErrorMessage() const
+	{
+		return m_errorMessage;
+	}
+
+	void HttpClientContext::cancel()
+	{
+		if (m_flagCancelled || m_flagCompleted) {
+			return;
+		}
+		m_flagCancelled = sl_true;
+		Ref<_HttpClientConnection> connection = m_connection;
+		if (connection.isNotNull()) {
+			connection->m_ioLoop->addTask(SLIB_BIND_WEAKREF(void(), _HttpClientConnection, cancel, connection.get(), Ref<HttpClientContext>(this)));
+		}
+	}
+
+	sl_bool HttpClientContext::isCancelled() const
+	{
+		return m_flagCancelled;
+	}
+
+	void HttpClientContext::_onResponse()
+	{
+		if (m_flagCancelled) {
+			return;
+		}
+		m_onResponse(this);
+	}
+
+	void HttpClientContext::_onReceiveContent(const void* data, sl_size size, const Memory& mem)
+	{
+		if (m_flagCancelled) {
+			return;
+		}
+		m_sizeContentReceived += size;
+		if (m_flagStoreResponseContent) {
+			if (mem.isNotNull()) {
+				m_bufResponseContent.add(mem);
+			} else {
+				m_bufResponseContent.addNew(data, size);
+			}
+		}
+		m_onReceiveContent(this, data, size);
+	}
+
+	void HttpClientContext::_onComplete(sl_bool flagError, const String& errorMessage)
+	{
+		if (m_flagCompleted) {
+			return;
+		}
+		m_flagCompleted = sl_true;
+		m_flagError = flagError;
+		m_errorMessage = errorMessage;
+		if (m_flagCancelled) {
+			return;
+		}
+		m_onComplete(this);
+	}
+
+
+	HttpClientRequestParam::HttpClientRequestParam()
+	{
+		method = HttpMethod::GET;
+		flagStoreResponseContent = sl_true;
+	}
+
+	HttpClientRequestParam::HttpClientRequestParam(const HttpClientRequestParam& other) = default;
+
+	HttpClientRequestParam::~HttpClientRequestParam()
+	{
+	}
+
+
+	HttpClientParam::HttpClientParam()
+	{
+		maxConnectionsPerHost = 16;
+		maxRequestsPerConnection = 0;
+
+		connectTimeout = 10000;
+		readTimeout = 30000;
+		keepAliveTimeout = 30000;
+
+		bufferSize = 0x10000;
+
+		flagDecompress = sl_true;
+		flagLogError = sl_true;
+	}
+
+	HttpClientParam::HttpClientParam(const HttpClientParam& other) = default;
+
+	HttpClientParam::~HttpClientParam()
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(HttpClient, Object)
+
+	HttpClient::HttpClient()
+	{
+		m_flagRunning = sl_false;
+		m_nConnections = 0;
+		m_nIdleConnections = 0;
+	}
+
+	HttpClient::~HttpClient()
+	{
+		release();
+	}
+
+	Ref<HttpClient> HttpClient::create(const HttpClientParam& param)
+	{
+		Ref<AsyncIoLoop> loop = param.ioLoop;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::getDefault();
+			if (loop.isNull()) {
+				return sl_null;
+			}
+		}
+		Ref<HttpClient> ret = new HttpClient;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			if (ret->m_param.maxConnectionsPerHost == 0) {
+				ret->m_param.maxConnectionsPerHost = 1;
+			}
+			if (ret->m_param.bufferSize < 1024) {
+				ret->m_param.bufferSize = 1024;
+			}
+			ret->m_ioLoop = loop;
+			ret->m_flagRunning = sl_true;
+		}
+		return ret;
+	}
+
+	Ref<HttpClient> HttpClient::create()
+	{
+		HttpClientParam param;
+		return create(param);
+	}
+
+	Ref<HttpClient> HttpClient::getDefault()
+	{
+		SLIB_SAFE_STATIC(Ref<HttpClient>, ret, create())
+		if (SLIB_SAFE_STATIC_CHECK_FREED(ret)) {
+			return sl_null;
+		}
+		return ret;
+	}
+
+	void HttpClient::release()
+	{
+		List< Ref<_HttpClientConnection> > connections;
+		List< Ref<HttpClientContext> > contexts;
+		{
+			MutexLocker lock(&m_lock);
+			if (!m_flagRunning) {
+				return;
+			}
+			m_flagRunning = sl_false;
+			for (auto& item : m_hosts) {
+				_HttpClientHost* host = item.value.get();
+				connections.addAll_NoLock(host->connections);
+				Ref<HttpClientContext> context;
+				while (host->queueContexts.pop_NoLock(&context)) {
+					contexts.add_NoLock(context);
+				}
+				host->connections.setNull();
+				host->connectionsIdle.setNull();
+			}
+			m_hosts.removeAll_NoLock();
+			m_nConnections = 0;
+			m_nIdleConnections = 0;
+		}
+		// the state of the connections is owned by the loop
+		for (auto& connection : connections) {
+			if (!(m_ioLoop->addTask(SLIB_BIND_REF(void(), _HttpClientConnection, abort, connection.get(), String("HttpClient is released"))))) {
+				// the loop is stopped
+				connection->abort("HttpClient is released");
+			}
+		}
+		for (auto& context : contexts) {
+			context->_onComplete(sl_true, "HttpClient is released");
+		}
+		Ref<ThreadPool> threadPool = m_threadPoolResolve;
+		if (threadPool.isNotNull()) {
+			threadPool->release();
+		}
+	}
+
+	sl_bool HttpClient::isRunning()
+	{
+		return m_flagRunning;
+	}
+
+	Ref<AsyncIoLoop> HttpClient::getAsyncIoLoop()
+	{
+		return m_ioLoop;
+	}
+
+	const HttpClientParam& HttpClient::getParam()
+	{
+		return m_param;
+	}
+
+	Ref<HttpClientContext> HttpClient::send(const HttpClientRequestParam& param)
+	{
+		if (!m_flagRunning) {
+			return sl_null;
+		}
+		Url url;
+		url.parse(param.url);
+		String scheme = url.scheme;
+		if (scheme.isNotEmpty() && !(scheme.equalsIgnoreCase("http"))) {
+			return sl_null;
+		}
+		String hostHeader = url.host;
+		String hostName = hostHeader;
+		sl_uint32 port = 80;
+		sl_reg indexPort = hostHeader.lastIndexOf(':');
+		if (indexPort >= 0 && hostHeader.indexOf(']', indexPort) < 0) {
+			if (!(hostHeader.substring(indexPort + 1).parseUint32(10, &port)) || port == 0 || port > 65535) {
+				return sl_null;
+			}
+			hostName = hostHeader.substring(0, indexPort);
+		}
+		if (hostName.startsWith('[') && hostName.endsWith(']')) {
+			hostName = hostName.substring(1, hostName.getLength() - 1);
+		}
+		if (hostName.isEmpty()) {
+			return sl_null;
+		}
+
+		Ref<HttpClientContext> context = new HttpClientContext;
+		if (context.isNull()) {
+			return sl_null;
+		}
+		context->m_url = param.url;
+		context->m_host = hostName;
+		context->m_port = (sl_uint16)port;
+		context->m_requestBody = param.requestBody;
+		context->m_flagStoreResponseContent = param.flagStoreResponseContent;
+		context->m_onResponse = param.onResponse;
+		context->m_onReceiveContent = param.onReceiveContent;
+		context->m_onComplete = param.onComplete;
+
+		context->setMethod(param.method);
+		String path = url.path;
+		if (path.isEmpty()) {
+			path = "/";
+		}
+		context->setPath(path);
+		context->setQuery(url.query);
+		context->setRequestVersion("HTTP/1.1");
+		for (auto& item : param.requestHeaders) {
+			context->addRequestHeader(item.key, item.value);
+		}
+		if (!(context->containsRequestHeader(HttpHeaders::Host))) {
+			context->setHost(hostHeader);
+		}
+		if (m_param.flagDecompress && !(context->containsRequestHeader(HttpHeaders::AcceptEncoding))) {
+			context->setRequestHeader(HttpHeaders::AcceptEncoding, "gzip, deflate");
+		}
+		HttpMethod method = param.method;
+		if (param.requestBody.isNotEmpty() || method == HttpMethod::POST || method == HttpMethod::PUT) {
+			context->setRequestContentLengthHeader(param.requestBody.getSize());
+		}
+
+		if (m_ioLoop->addTask(SLIB_BIND_WEAKREF(void(), HttpClient, _processContext, this, context))) {
+			return context;
+		}
+		return sl_null;
+	}
+
+	Ref<HttpClientContext> HttpClient::send(HttpMethod method, const String& url, const Function<void(HttpClientContext*)>& onComplete)
+	{
+		HttpClientRequestParam param;
+		param.method = method;
+		param.url = url;
+		param.onComplete = onComplete;
+		return send(param);
+	}
+
+	sl_uint32 HttpClient::getConnectionsCount()
+	{
+		return m_nConnections;
+	}
+
+	sl_uint32 HttpClient::getIdleConnectionsCount()
+	{
+		return m_nIdleConnections;
+	}
+
+	void HttpClient::_processContext(const Ref<HttpClientContext>& context)
+	{
+		if (context->m_flagCancelled) {
+			return;
+		}
+		Ref<_HttpClientConnection> connection;
+		sl_bool flagNewConnection = sl_false;
+		{
+			MutexLocker lock(&m_lock);
+			if (!m_flagRunning) {
+				lock.unlock();
+				context->_onComplete(sl_true, "HttpClient is released");
+				return;
+			}
+			Ref<_HttpClientHost> host = _getHost(context->m_host, context->m_port);
+			if (host.isNull()) {
+				lock.unlock();
+				context->_onComplete(sl_true, "Lack of memory");
+				return;
+			}
+			while (host->connectionsIdle.popBack_NoLock(&connection)) {
+				m_nIdleConnections--;
+				if (!(connection->isClosed())) {
+					break;
+				}
+				connection.setNull();
+			}
+			if (connection.isNull()) {
+				if (host->connections.getCount() < m_param.maxConnectionsPerHost) {
+					connection = _createConnection(host.get());
+					if (connection.isNull()) {
+						lock.unlock();
+						context->_onComplete(sl_true, "Lack of memory");
+						return;
+					}
+					flagNewConnection = sl_true;
+				} else {
+					host->queueContexts.push_NoLock(context);
+					return;
+				}
+			}
+		}
+		connection->startRequest(context);
+		if (flagNewConnection) {
+			_startConnection(connection);
+		}
+	}
+
+	Ref<_HttpClientHost> HttpClient::_getHost(const String& name, sl_uint16 port)
+	{
+		String key = name + ":" + String::fromUint32(port);
+		Ref<_HttpClientHost> host;
+		if (m_hosts.get_NoLock(key, &host)) {
+			return host;
+		}
+		host = new _HttpClientHost;
+		if (host.isNotNull()) {
+			host->name = name;
+			host->port = port;
+			host->address.setNone();
+			// IP literals are not resolved
+			IPAddress ip;
+			if (ip.parse(name)) {
+				host->address = ip;
+			}
+			m_hosts.put_NoLock(key, host);
+		}
+		return host;
+	}
+
+	Ref<_HttpClientConnection> HttpClient::_createConnection(_HttpClientHost* host)
+	{
+		Ref<_HttpClientConnection> connection = new _HttpClientConnection;
+		if (connection.isNotNull()) {
+			connection->m_client = this;
+			connection->m_host = host;
+			connection->m_ioLoop = m_ioLoop;
+			if (host->connections.add_NoLock(connection)) {
+				m_nConnections++;
+				return connection;
+			}
+		}
+		return sl_null;
+	}
+
+	void HttpClient::_startConnection(const Ref<_HttpClientConnection>& connection)
+	{
+		IPAddress address;
+		{
+			MutexLocker lock(&m_lock);
+			address = connection->m_host->address;
+		}
+		if (address.isNotNone()) {
+			connection->connect(address);
+			return;
+		}
+		connection->_setState(_HttpClientConnectionState::Resolving);
+		Ref<ThreadPool> threadPool = m_threadPoolResolve;
+		if (threadPool.isNull()) {
+			MutexLocker lock(&m_lock);
+			threadPool = m_threadPoolResolve;
+			if (threadPool.isNull()) {
+				threadPool = ThreadPool::create(0, 8);
+				m_threadPoolResolve = threadPool;
+			}
+		}
+		if (threadPool.isNull() || !(threadPool->addTask(SLIB_FUNCTION_REF(_HttpClientConnection, resolve, connection)))) {
+			connection->connect(IPAddress::none());
+		}
+	}
+
+	void HttpClient::_onConnectionFree(_HttpClientConnection* connection)
+	{
+		Ref<HttpClientContext> context;
+		{
+			MutexLocker lock(&m_lock);
+			_HttpClientHost* host = connection->m_host.get();
+			while (host->queueContexts.pop_NoLock(&context)) {
+				if (!(context->m_flagCancelled)) {
+					break;
+				}
+				context.setNull();
+			}
+			if (context.isNull()) {
+				if (host->connectionsIdle.add_NoLock(connection)) {
+					m_nIdleConnections++;
+				}
+				return;
+			}
+		}
+		connection->startRequest(context);
+	}
+
+	void HttpClient::_onConnectionClosed(_HttpClientConnection* connection)
+	{
+		Ref<_HttpClientConnection> connectionNew;
+		Ref<HttpClientContext> context;
+		{
+			MutexLocker lock(&m_lock);
+			_HttpClientHost* host = connection->m_host.get();
+			if (host->connections.removeValue_NoLock(connection)) {
+				m_nConnections--;
+			}
+			if (host->connectionsIdle.removeValue_NoLock(connection)) {
+				m_nIdleConnections--;
+			}
+			if (!m_flagRunning) {
+				return;
+			}
+			// the waiting request takes the freed slot
+			if (host->connections.getCount() < m_param.maxConnectionsPerHost) {
+				while (host->queueContexts.pop_NoLock(&context)) {
+					if (!(context->m_flagCancelled)) {
+						break;
+					}
+					context.setNull();
+				}
+				if (context.isNotNull()) {
+					connectionNew = _createConnection(host);
+					if (connectionNew.isNull()) {
+						lock.unlock();
+						context->_onComplete(sl_true, "Lack of memory");
+						return;
+					}
+				}
+			}
+		}
+		if (connectionNew.isNotNull()) {
+			connectionNew->startRequest(context);
+			_startConnection(connectionNew);
+		}
+	}
+
+}
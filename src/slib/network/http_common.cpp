@@ -13,6 +13,24 @@
 #include "slib/network/url.h"
 #include "slib/core/safe_static.h"
 #include "slib/core/variant.h"
+#include "slib/core/cpu.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	define HTTP_SCAN_USE_AVX2
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		define HTTP_SCAN_AVX2_FUNC static
+#	else
+#		define HTTP_SCAN_AVX2_FUNC static __attribute__((target("avx2")))
+#	endif
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define HTTP_SCAN_USE_SSE2
+#	include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
 
 namespace slib
 {
@@ -45,6 +63,7 @@ namespace slib
 			HTTP_STATUS_CASE(NotModified, "Not Modified");
 			HTTP_STATUS_CASE(UseProxy, "Use Proxy");
 			HTTP_STATUS_CASE(TemporaryRedirect, "Temporary Redirect");
+			HTTP_STATUS_CASE(PermanentRedirect, "Permanent Redirect");
 			
 			HTTP_STATUS_CASE(BadRequest, "Bad Request");
 			HTTP_STATUS_CASE(Unauthorized, "Unauthorized");
@@ -157,43 +176,541 @@ namespace slib
 	DEFINE_HTTP_HEADER(Origin, "Origin")
 	DEFINE_HTTP_HEADER(AccessControlAllowOrigin, "Access-Control-Allow-Origin")
 
-	sl_reg HttpHeaders::parseHeaders(Map<String, String>& map, const void* _data, sl_size size)
+	DEFINE_HTTP_HEADER(ETag, "ETag")
+	DEFINE_HTTP_HEADER(IfNoneMatch, "If-None-Match")
+	DEFINE_HTTP_HEADER(Vary, "Vary")
+	DEFINE_HTTP_HEADER(LastModified, "Last-Modified")
+	DEFINE_HTTP_HEADER(IfModifiedSince, "If-Modified-Since")
+
+	DEFINE_HTTP_HEADER(Connection, "Connection")
+	DEFINE_HTTP_HEADER(KeepAlive, "Keep-Alive")
+
+	DEFINE_HTTP_HEADER(Location, "Location")
+
+	sl_reg HttpHeaders::parseHeaders(Map<String, String>& map, const void* data, sl_size size)
 	{
-		const sl_char8* data = (const sl_char8*)_data;
-		sl_size posCurrent = 0;
+		HttpHeaderScanner scanner;
+		sl_reg iRet = scanner.scanHeaders(data, size);
+		if (iRet > 0) {
+			scanner.putFields(map);
+		}
+		return iRet;
+	}
 
-		// headers
-		for (;;) {
-			sl_size posStart = posCurrent;
-			sl_size indexSplit = 0;
-			while (posCurrent < size) {
-				sl_char8 ch = data[posCurrent];
-				if (ch == '\r') {
-					break;
+	static const char* _g_sz_http_date_weekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+	static const char* _g_sz_http_date_months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+	static sl_bool _HttpDate_equalsName(const sl_char8* s, const char* name)
+	{
+		for (sl_uint32 i = 0; i < 3; i++) {
+			sl_char8 c = s[i];
+			if (c >= 'A' && c <= 'Z') {
+				c = c - 'A' + 'a';
+			}
+			sl_char8 n = name[i];
+			if (n >= 'A' && n <= 'Z') {
+				n = n - 'A' + 'a';
+			}
+			if (c != n) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	// days since 1970-01-01 (proleptic Gregorian), independent of the local time zone
+	static sl_int64 _HttpDate_getDaysFromCivil(sl_int64 y, sl_uint32 m, sl_uint32 d)
+	{
+		if (m <= 2) {
+			y--;
+		}
+		sl_int64 era = (y >= 0 ? y : y - 399) / 400;
+		sl_uint32 yoe = (sl_uint32)(y - era * 400);
+		sl_uint32 doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+		sl_uint32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + (sl_int64)doe - 719468;
+	}
+
+	static void _HttpDate_getCivilFromDays(sl_int64 z, sl_int64& y, sl_uint32& m, sl_uint32& d)
+	{
+		z += 719468;
+		sl_int64 era = (z >= 0 ? z : z - 146096) / 146097;
+		sl_uint32 doe = (sl_uint32)(z - era * 146097);
+		sl_uint32 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		sl_uint32 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		sl_uint32 mp = (5 * doy + 2) / 153;
+		d = doy - (153 * mp + 2) / 5 + 1;
+		m = mp < 10 ? mp + 3 : mp - 9;
+		y = (sl_int64)yoe + era * 400 + (m <= 2 ? 1 : 0);
+	}
+
+	String HttpHeaders::formatDate(const Time& time)
+	{
+		sl_int64 t = time.toInt() / 1000000;
+		sl_int64 days = t / 86400;
+		sl_int64 secs = t % 86400;
+		if (secs < 0) {
+			secs += 86400;
+			days--;
+		}
+		sl_int64 year;
+		sl_uint32 month, day;
+		_HttpDate_getCivilFromDays(days, year, month, day);
+		sl_uint32 weekday = (sl_uint32)(((days % 7) + 11) % 7); // 1970-01-01: Thursday
+		String ret = _g_sz_http_date_weekdays[weekday];
+		ret += ", ";
+		ret += String::fromUint32(day, 10, 2);
+		ret += " ";
+		ret += _g_sz_http_date_months[month - 1];
+		ret += " ";
+		ret += String::fromInt64(year, 10, 4);
+		ret += " ";
+		ret += String::fromUint32((sl_uint32)(secs / 3600), 10, 2);
+		ret += ":";
+		ret += String::fromUint32((sl_uint32)(secs / 60 % 60), 10, 2);
+		ret += ":";
+		ret += String::fromUint32((sl_uint32)(secs % 60), 10, 2);
+		ret += " GMT";
+		return ret;
+	}
+
+	sl_bool HttpHeaders::parseDate(const String& str, Time* _out)
+	{
+		const sl_char8* s = str.getData();
+		sl_size len = str.getLength();
+		sl_int64 numbers[6];
+		sl_uint32 nNumbers = 0;
+		sl_int32 month = -1;
+		// asctime: the month comes before the day
+		sl_bool flagMonthFirst = sl_false;
+		sl_bool flagGMT = sl_false;
+		sl_size i = 0;
+		while (i < len) {
+			sl_char8 ch = s[i];
+			if (SLIB_CHAR_IS_DIGIT(ch)) {
+				sl_size start = i;
+				sl_int64 v = 0;
+				while (i < len && SLIB_CHAR_IS_DIGIT(s[i])) {
+					if (i - start >= 9) {
+						return sl_false;
+					}
+					v = v * 10 + (s[i] - '0');
+					i++;
+				}
+				if (nNumbers >= 6) {
+					return sl_false;
 				}
-				if (indexSplit == 0) {
-					if (ch == ':') {
-						indexSplit = posCurrent;
+				numbers[nNumbers++] = v;
+			} else if (SLIB_CHAR_IS_ALPHA(ch)) {
+				sl_size start = i;
+				while (i < len && SLIB_CHAR_IS_ALPHA(s[i])) {
+					i++;
+				}
+				sl_size n = i - start;
+				if (n == 3) {
+					for (sl_int32 k = 0; k < 12; k++) {
+						if (_HttpDate_equalsName(s + start, _g_sz_http_date_months[k])) {
+							if (month >= 0) {
+								return sl_false;
+							}
+							month = k;
+							flagMonthFirst = nNumbers == 0;
+							break;
+						}
+					}
+					if (_HttpDate_equalsName(s + start, "GMT")) {
+						flagGMT = sl_true;
 					}
 				}
-				posCurrent++;
+			} else if (ch == ' ' || ch == ',' || ch == '-' || ch == ':' || ch == '\t') {
+				i++;
+			} else {
+				return sl_false;
 			}
-			if (posCurrent >= size - 1) {
-				return 0;
+		}
+		if (month < 0 || nNumbers != 5) {
+			return sl_false;
+		}
+		sl_int64 day, year, hour, minute, second;
+		if (flagMonthFirst) {
+			day = numbers[0];
+			hour = numbers[1];
+			minute = numbers[2];
+			second = numbers[3];
+			year = numbers[4];
+		} else {
+			if (!flagGMT) {
+				return sl_false;
 			}
-			if (data[posCurrent + 1] != '\n') {
+			day = numbers[0];
+			year = numbers[1];
+			hour = numbers[2];
+			minute = numbers[3];
+			second = numbers[4];
+			if (year < 100) {
+				// RFC 850: two digit year
+				year += year < 70 ? 2000 : 1900;
+			}
+		}
+		if (day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+			return sl_false;
+		}
+		sl_int64 t = _HttpDate_getDaysFromCivil(year, (sl_uint32)(month + 1), (sl_uint32)day) * 86400 + hour * 3600 + minute * 60 + second;
+		if (_out) {
+			_out->setInt(t * 1000000);
+		}
+		return sl_true;
+	}
+
+
+/***********************************************************************
+						HttpHeaderScanner
+***********************************************************************/
+
+	SLIB_INLINE static sl_uint32 _HttpHeaderScanner_getFirstBit(sl_uint32 mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return (sl_uint32)index;
+#else
+		return (sl_uint32)(__builtin_ctz(mask));
+#endif
+	}
+
+	// returns `end` when [CR] is not found
+	static const sl_char8* _HttpHeaderScanner_findCR_Generic(const sl_char8* p, const sl_char8* end)
+	{
+#if defined(HTTP_SCAN_USE_SSE2)
+		__m128i cr16 = _mm_set1_epi8('\r');
+		while (end - p >= 16) {
+			__m128i v = _mm_loadu_si128((const __m128i*)p);
+			sl_uint32 mask = (sl_uint32)(_mm_movemask_epi8(_mm_cmpeq_epi8(v, cr16)));
+			if (mask) {
+				return p + _HttpHeaderScanner_getFirstBit(mask);
+			}
+			p += 16;
+		}
+#endif
+		while (p < end) {
+			if (*p == '\r') {
+				return p;
+			}
+			p++;
+		}
+		return end;
+	}
+
+#if defined(HTTP_SCAN_USE_AVX2)
+	HTTP_SCAN_AVX2_FUNC const sl_char8* _HttpHeaderScanner_findCR_AVX2(const sl_char8* p, const sl_char8* end)
+	{
+		__m256i cr32 = _mm256_set1_epi8('\r');
+		while (end - p >= 32) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)p);
+			sl_uint32 mask = (sl_uint32)(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, cr32)));
+			if (mask) {
+				return p + _HttpHeaderScanner_getFirstBit(mask);
+			}
+			p += 32;
+		}
+		return _HttpHeaderScanner_findCR_Generic(p, end);
+	}
+#endif
+
+	static const sl_char8* _HttpHeaderScanner_findCR(const sl_char8* p, const sl_char8* end)
+	{
+#if defined(HTTP_SCAN_USE_AVX2)
+		if (CPU::isAVX2Supported()) {
+			return _HttpHeaderScanner_findCR_AVX2(p, end);
+		}
+#endif
+		return _HttpHeaderScanner_findCR_Generic(p, end);
+	}
+
+	HttpHeaderScanner::HttpHeaderScanner()
+	{
+		m_fields = m_fieldsInline;
+		m_nFieldsCapacity = sizeof(m_fieldsInline) / sizeof(Field);
+		clear();
+	}
+
+	HttpHeaderScanner::HttpHeaderScanner(const HttpHeaderScanner& other)
+	{
+		m_fields = m_fieldsInline;
+		m_nFieldsCapacity = sizeof(m_fieldsInline) / sizeof(Field);
+		clear();
+		*this = other;
+	}
+
+	HttpHeaderScanner::~HttpHeaderScanner()
+	{
+		if (m_fields != m_fieldsInline) {
+			Base::freeMemory(m_fields);
+		}
+	}
+
+	HttpHeaderScanner& HttpHeaderScanner::operator=(const HttpHeaderScanner& other)
+	{
+		if (this == &other) {
+			return *this;
+		}
+		clear();
+		sl_size n = other.m_nFields;
+		for (sl_size i = 0; i < n; i++) {
+			if (!(_addField(other.m_fields[i]))) {
+				clear();
+				return *this;
+			}
+		}
+		m_data = other.m_data;
+		m_method = other.m_method;
+		m_path = other.m_path;
+		m_query = other.m_query;
+		m_version = other.m_version;
+		return *this;
+	}
+
+	sl_reg HttpHeaderScanner::findHeaderEnd(const void* _data, sl_size size)
+	{
+		const sl_char8* data = (const sl_char8*)_data;
+		const sl_char8* end = data + size;
+		const sl_char8* p = data;
+		for (;;) {
+			p = _HttpHeaderScanner_findCR(p, end);
+			if (end - p < 4) {
 				return -1;
 			}
+			if (p[1] == '\n' && p[2] == '\r' && p[3] == '\n') {
+				return p + 4 - data;
+			}
+			p++;
+		}
+	}
 
-			if (posCurrent == posStart) {
-				posCurrent += 2;
+	sl_reg HttpHeaderScanner::scanHeaders(const void* data, sl_size size)
+	{
+		clear();
+		if (size > 0x7fffffff) {
+			return -1;
+		}
+		m_data = (const sl_char8*)data;
+		return _scanFields(0, size);
+	}
+
+	sl_reg HttpHeaderScanner::scanRequest(const void* data, sl_size size)
+	{
+		clear();
+		if (size > 0x7fffffff) {
+			return -1;
+		}
+		const sl_char8* buf = (const sl_char8*)data;
+		m_data = buf;
+		sl_size posCurrent = 0;
+		// method
+		while (posCurrent < size) {
+			sl_char8 ch = buf[posCurrent];
+			if (ch == ' ') {
+				break;
+			}
+			if (ch == '\r' || ch == '\n') {
+				return -1;
+			}
+			posCurrent++;
+		}
+		if (posCurrent == size) {
+			return 0;
+		}
+		m_method.offset = 0;
+		m_method.length = (sl_uint32)posCurrent;
+		posCurrent++;
+		// uri
+		sl_size posStart = posCurrent;
+		sl_size posQuery = 0;
+		while (posCurrent < size) {
+			sl_char8 ch = buf[posCurrent];
+			if (ch == ' ') {
 				break;
 			}
+			if (ch == '\r' || ch == '\n') {
+				return -1;
+			}
+			if (posQuery == 0 && ch == '?') {
+				posQuery = posCurrent + 1;
+			}
+			posCurrent++;
+		}
+		if (posCurrent == size) {
+			return 0;
+		}
+		m_path.offset = (sl_uint32)posStart;
+		if (posQuery > 0) {
+			m_path.length = (sl_uint32)(posQuery - 1 - posStart);
+			m_query.offset = (sl_uint32)posQuery;
+			m_query.length = (sl_uint32)(posCurrent - posQuery);
+		} else {
+			m_path.length = (sl_uint32)(posCurrent - posStart);
+		}
+		posCurrent++;
+		// version
+		posStart = posCurrent;
+		const sl_char8* cr = _HttpHeaderScanner_findCR(buf + posCurrent, buf + size);
+		posCurrent = cr - buf;
+		if (posCurrent + 1 >= size) {
+			return 0;
+		}
+		if (buf[posCurrent + 1] != '\n') {
+			return -1;
+		}
+		m_version.offset = (sl_uint32)posStart;
+		m_version.length = (sl_uint32)(posCurrent - posStart);
+		return _scanFields(posCurrent + 2, size);
+	}
+
+	void HttpHeaderScanner::clear()
+	{
+		m_data = sl_null;
+		m_method.offset = 0;
+		m_method.length = 0;
+		m_path = m_method;
+		m_query = m_method;
+		m_version = m_method;
+		m_nFields = 0;
+	}
+
+	const sl_char8* HttpHeaderScanner::getData() const
+	{
+		return m_data;
+	}
+
+	const HttpHeaderScanner::Token& HttpHeaderScanner::getMethod() const
+	{
+		return m_method;
+	}
+
+	const HttpHeaderScanner::Token& HttpHeaderScanner::getPath() const
+	{
+		return m_path;
+	}
+
+	const HttpHeaderScanner::Token& HttpHeaderScanner::getQuery() const
+	{
+		return m_query;
+	}
+
+	const HttpHeaderScanner::Token& HttpHeaderScanner::getVersion() const
+	{
+		return m_version;
+	}
+
+	String HttpHeaderScanner::getString(const Token& token) const
+	{
+		if (m_data && token.length) {
+			return String::fromUtf8(m_data + token.offset, token.length);
+		}
+		return String::null();
+	}
+
+	sl_size HttpHeaderScanner::getFieldCount() const
+	{
+		return m_nFields;
+	}
+
+	const HttpHeaderScanner::Field& HttpHeaderScanner::getField(sl_size index) const
+	{
+		return m_fields[index];
+	}
+
+	String HttpHeaderScanner::getFieldName(sl_size index) const
+	{
+		if (index < m_nFields) {
+			return getString(m_fields[index].name);
+		}
+		return String::null();
+	}
+
+	String HttpHeaderScanner::getFieldValue(sl_size index) const
+	{
+		if (index < m_nFields) {
+			Field& field = m_fields[index];
+			String value = getString(field.value);
+			if (field.flagEncoded) {
+				return Url::decodeUriComponentByUTF8(value);
+			}
+			return value;
+		}
+		return String::null();
+	}
+
+	sl_reg HttpHeaderScanner::indexOfField(const String& name, sl_size start) const
+	{
+		for (sl_size i = start; i < m_nFields; i++) {
+			if (_equalsFieldName(m_fields[i], name)) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	sl_reg HttpHeaderScanner::lastIndexOfField(const String& name, sl_reg start) const
+	{
+		if (start < 0 || start >= (sl_reg)m_nFields) {
+			start = (sl_reg)m_nFields - 1;
+		}
+		for (sl_reg i = start; i >= 0; i--) {
+			if (_equalsFieldName(m_fields[i], name)) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void HttpHeaderScanner::putFields(Map<String, String>& map) const
+	{
+		for (sl_size i = 0; i < m_nFields; i++) {
+			map.put_NoLock(getFieldName(i), getFieldValue(i), MapPutMode::AddAlways);
+		}
+	}
+
+	sl_bool HttpHeaderScanner::_equalsFieldName(const Field& field, const String& name) const
+	{
+		sl_size len = name.getLength();
+		if (field.name.length != len) {
+			return sl_false;
+		}
+		const sl_char8* s = name.getData();
+		const sl_char8* f = m_data + field.name.offset;
+		for (sl_size k = 0; k < len; k++) {
+			if (SLIB_CHAR_LOWER_TO_UPPER(f[k]) != SLIB_CHAR_LOWER_TO_UPPER(s[k])) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
 
-			String name;
-			String value;
-			if (indexSplit != 0) {
-				name = String::fromUtf8(data + posStart, indexSplit - posStart);
+	sl_reg HttpHeaderScanner::_scanFields(sl_size posCurrent, sl_size size)
+	{
+		const sl_char8* data = m_data;
+		const sl_char8* end = data + size;
+		for (;;) {
+			sl_size posStart = posCurrent;
+			const sl_char8* cr = _HttpHeaderScanner_findCR(data + posCurrent, end);
+			posCurrent = cr - data;
+			if (posCurrent + 1 >= size) {
+				return 0;
+			}
+			if (data[posCurrent + 1] != '\n') {
+				return -1;
+			}
+			if (posCurrent == posStart) {
+				return posCurrent + 2;
+			}
+			Field field;
+			field.name.offset = (sl_uint32)posStart;
+			field.flagEncoded = sl_false;
+			const sl_char8* colon = (const sl_char8*)(Base::findMemory(data + posStart, ':', posCurrent - posStart));
+			if (colon) {
+				sl_size indexSplit = colon - data;
+				field.name.length = (sl_uint32)(indexSplit - posStart);
 				sl_size startValue = indexSplit + 1;
 				sl_size endValue = posCurrent;
 				while (startValue < endValue) {
@@ -208,14 +725,41 @@ namespace slib
 					}
 					endValue--;
 				}
-				value = Url::decodeUriComponentByUTF8(String::fromUtf8(data + startValue, endValue - startValue));
+				field.value.offset = (sl_uint32)startValue;
+				field.value.length = (sl_uint32)(endValue - startValue);
+				if (startValue < endValue) {
+					field.flagEncoded = Base::findMemory(data + startValue, '%', endValue - startValue) != sl_null;
+				}
 			} else {
-				name = String::fromUtf8(data + posStart, posCurrent - posStart);
+				field.name.length = (sl_uint32)(posCurrent - posStart);
+				field.value.offset = (sl_uint32)posCurrent;
+				field.value.length = 0;
+			}
+			if (!(_addField(field))) {
+				return -1;
 			}
-			map.put_NoLock(name, value, MapPutMode::AddAlways);
 			posCurrent += 2;
 		}
-		return posCurrent;
+	}
+
+	sl_bool HttpHeaderScanner::_addField(const Field& field)
+	{
+		if (m_nFields >= m_nFieldsCapacity) {
+			sl_size n = m_nFieldsCapacity * 2;
+			Field* fields = (Field*)(Base::createMemory(n * sizeof(Field)));
+			if (!fields) {
+				return sl_false;
+			}
+			Base::copyMemory(fields, m_fields, m_nFields * sizeof(Field));
+			if (m_fields != m_fieldsInline) {
+				Base::freeMemory(m_fields);
+			}
+			m_fields = fields;
+			m_nFieldsCapacity = n;
+		}
+		m_fields[m_nFields] = field;
+		m_nFields++;
+		return sl_true;
 	}
 
 
@@ -233,6 +777,7 @@ namespace slib
 		m_methodTextUpper = s2;
 		
 		m_requestHeaders.initHash(0, HashIgnoreCaseString(), EqualsIgnoreCaseString());
+		m_flagRequestHeadersPending = sl_false;
 	}
 
 	HttpRequest::~HttpRequest()
@@ -300,41 +845,72 @@ namespace slib
 
 	const Map<String, String>& HttpRequest::getRequestHeaders() const
 	{
+		_materializeRequestHeaders();
 		return m_requestHeaders;
 	}
 
 	String HttpRequest::getRequestHeader(String name) const
 	{
+		if (m_flagRequestHeadersPending) {
+			// the last field, same as the materialized map
+			sl_reg index = m_requestHeaderScanner.lastIndexOfField(name);
+			if (index >= 0) {
+				return m_requestHeaderScanner.getFieldValue(index);
+			}
+			return String::null();
+		}
 		return m_requestHeaders.getValue_NoLock(name, String::null());
 	}
 
 	List<String> HttpRequest::getRequestHeaderValues(String name) const
 	{
+		if (m_flagRequestHeadersPending) {
+			// from the last field, same order as the materialized map
+			List<String> ret;
+			sl_reg index = m_requestHeaderScanner.lastIndexOfField(name);
+			while (index >= 0) {
+				ret.add_NoLock(m_requestHeaderScanner.getFieldValue(index));
+				if (!index) {
+					break;
+				}
+				index = m_requestHeaderScanner.lastIndexOfField(name, index - 1);
+			}
+			return ret;
+		}
 		return m_requestHeaders.getValues_NoLock(name);
 	}
 
 	void HttpRequest::setRequestHeader(String name, String value)
 	{
+		_materializeRequestHeaders();
 		m_requestHeaders.put_NoLock(name, value);
 	}
 
 	void HttpRequest::addRequestHeader(String name, String value)
 	{
+		_materializeRequestHeaders();
 		m_requestHeaders.put_NoLock(name, value, MapPutMode::AddAlways);
 	}
 
 	sl_bool HttpRequest::containsRequestHeader(String name) const
 	{
+		if (m_flagRequestHeadersPending) {
+			return m_requestHeaderScanner.indexOfField(name) >= 0;
+		}
 		return m_requestHeaders.contains_NoLock(name);
 	}
 
 	void HttpRequest::removeRequestHeader(String name)
 	{
+		_materializeRequestHeaders();
 		m_requestHeaders.removeItems_NoLock(name);
 	}
 
 	void HttpRequest::clearRequestHeaders()
 	{
+		m_flagRequestHeadersPending = sl_false;
+		m_requestHeaderScanner.clear();
+		m_requestHeaderPacket.setNull();
 		m_requestHeaders.removeAll_NoLock();
 	}
 
@@ -592,6 +1168,7 @@ namespace slib
 		msg.addStatic(strVersion.getData(), strVersion.getLength());
 		msg.addStatic("\r\n", 2);
 
+		_materializeRequestHeaders();
 		for (auto& pair : m_requestHeaders) {
 			String str = pair.key;
 			msg.addStatic(str.getData(), str.getLength());
@@ -606,77 +1183,48 @@ namespace slib
 
 	sl_reg HttpRequest::parseRequestPacket(const void* packet, sl_size size)
 	{
-		const sl_char8* data = (const sl_char8*)packet;
-		sl_size posCurrent = 0;
-		sl_size posStart = 0;
-		// method
-		while (posCurrent < size) {
-			sl_char8 ch = data[posCurrent];
-			if (ch == ' ') {
-				break;
-			}
-			if (ch == '\r' || ch == '\n') {
-				return -1;
-			}
-			posCurrent++;
-		}
-		if (posCurrent == size) {
-			return 0;
-		}
-		setMethod(String::fromUtf8(data + posStart, posCurrent - posStart));
-		posCurrent++;
-
-		// uri
-		posStart = posCurrent;
-		sl_size posQuery = 0;
-		while (posCurrent < size) {
-			sl_char8 ch = data[posCurrent];
-			if (ch == ' ') {
-				break;
-			}
-			if (ch == '\r' || ch == '\n') {
-				return -1;
-			}
-			if (posQuery == 0 && ch == '?') {
-				posQuery = posCurrent + 1;
-			}
-			posCurrent++;
-		}
-		if (posCurrent == size) {
-			return 0;
-		}
-		if (posQuery > 0) {
-			setPath(String::fromUtf8(data + posStart, posQuery - 1 - posStart));
-			setQuery(String::fromUtf8(data + posQuery, posCurrent - posQuery));
-		} else {
-			setPath(String::fromUtf8(data + posStart, posCurrent - posStart));
-			setQuery(String::null());
+		_materializeRequestHeaders();
+		HttpHeaderScanner scanner;
+		sl_reg iRet = scanner.scanRequest(packet, size);
+		if (iRet > 0) {
+			setMethod(scanner.getString(scanner.getMethod()));
+			setPath(scanner.getString(scanner.getPath()));
+			setQuery(scanner.getString(scanner.getQuery()));
+			setRequestVersion(scanner.getString(scanner.getVersion()));
+			scanner.putFields(m_requestHeaders);
 		}
-		posCurrent++;
+		return iRet;
+	}
 
-		// version
-		posStart = posCurrent;
-		while (posCurrent < size) {
-			sl_char8 ch = data[posCurrent];
-			if (ch == '\r') {
-				break;
+	sl_reg HttpRequest::parseRequestPacket(const Memory& packet)
+	{
+		_materializeRequestHeaders();
+		HttpHeaderScanner& scanner = m_requestHeaderScanner;
+		sl_reg iRet = scanner.scanRequest(packet.getData(), packet.getSize());
+		if (iRet > 0) {
+			setMethod(scanner.getString(scanner.getMethod()));
+			setPath(scanner.getString(scanner.getPath()));
+			setQuery(scanner.getString(scanner.getQuery()));
+			setRequestVersion(scanner.getString(scanner.getVersion()));
+			if (m_requestHeaders.getCount() == 0) {
+				// keep the views until a header is modified or the whole map is requested
+				m_requestHeaderPacket = packet;
+				m_flagRequestHeadersPending = sl_true;
+				return iRet;
 			}
-			posCurrent++;
-		}
-		if (posCurrent >= size - 1) {
-			return 0;
-		}
-		if (data[posCurrent + 1] != '\n') {
-			return -1;
+			scanner.putFields(m_requestHeaders);
 		}
-		setRequestVersion(String::fromUtf8(data + posStart, posCurrent - posStart));
-		posCurrent += 2;
+		scanner.clear();
+		return iRet;
+	}
 
-		sl_reg iRet = HttpHeaders::parseHeaders(m_requestHeaders, data + posCurrent, size - posCurrent);
-		if (iRet > 0) {
-			return posCurrent + iRet;
-		} else {
-			return iRet;
+	void HttpRequest::_materializeRequestHeaders() const
+	{
+		if (m_flagRequestHeadersPending) {
+			m_flagRequestHeadersPending = sl_false;
+			m_requestHeaderScanner.putFields(m_requestHeaders);
+			m_requestHeaderScanner.clear();
+			m_requestHeaderPacket.setNull();
 		}
 	}
 
@@ -0,0 +1,277 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/network/http_file_cache.h"
+
+#include "slib/core/file.h"
+#include "slib/crypto/zlib.h"
+
+#define HTTP_FILE_CACHE_MAX_LARGE_FILES 4096
+
+namespace slib
+{
+
+	HttpFileCacheParam::HttpFileCacheParam()
+	{
+		maxTotalSize = 64 * 1024 * 1024;
+		maxFileSize = 1024 * 1024;
+		revalidateInterval = 1000;
+
+		flagCompress = sl_true;
+		minCompressSize = 256;
+		compressLevel = 6;
+	}
+
+	HttpFileCacheParam::~HttpFileCacheParam()
+	{
+	}
+
+
+	SLIB_DEFINE_ROOT_OBJECT(HttpFileCacheEntry)
+
+	HttpFileCacheEntry::HttpFileCacheEntry()
+	{
+		m_tickValidated = 0;
+		m_prev = sl_null;
+		m_next = sl_null;
+	}
+
+	HttpFileCacheEntry::~HttpFileCacheEntry()
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(HttpFileCache, Object)
+
+	HttpFileCache::HttpFileCache()
+	{
+		m_front = sl_null;
+		m_back = sl_null;
+		m_sizeTotal = 0;
+	}
+
+	HttpFileCache::~HttpFileCache()
+	{
+	}
+
+	Ref<HttpFileCache> HttpFileCache::create(const HttpFileCacheParam& param)
+	{
+		Ref<HttpFileCache> ret = new HttpFileCache;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+		}
+		return ret;
+	}
+
+	Ref<HttpFileCacheEntry> HttpFileCache::get(const String& path, sl_uint64* pSizeLarge, Time* pTimeModifiedLarge)
+	{
+		sl_uint64 now = m_timeCounter.getElapsedMilliseconds();
+		Ref<HttpFileCacheEntry> entry;
+		LargeFile large;
+		sl_bool flagLarge = sl_false;
+		{
+			MutexLocker lock(&m_lock);
+			if (m_table.get(path, &entry)) {
+				if (now - entry->m_tickValidated < m_param.revalidateInterval) {
+					_moveToFront(entry.get());
+					return entry;
+				}
+			} else if (m_tableLarge.get(path, &large)) {
+				if (now - large.tickValidated < m_param.revalidateInterval) {
+					if (pSizeLarge) {
+						*pSizeLarge = large.size;
+					}
+					if (pTimeModifiedLarge) {
+						*pTimeModifiedLarge = large.timeModified;
+					}
+					return sl_null;
+				}
+				flagLarge = sl_true;
+			}
+		}
+		if (flagLarge) {
+			// the same modified time: still too big
+			if (File::getModifiedTime(path) == large.timeModified) {
+				{
+					MutexLocker lock(&m_lock);
+					large.tickValidated = now;
+					m_tableLarge.put(path, large);
+				}
+				if (pSizeLarge) {
+					*pSizeLarge = large.size;
+				}
+				if (pTimeModifiedLarge) {
+					*pTimeModifiedLarge = large.timeModified;
+				}
+				return sl_null;
+			}
+			MutexLocker lock(&m_lock);
+			m_tableLarge.remove(path);
+		}
+		if (entry.isNotNull()) {
+			// revalidate by the modified time
+			if (File::exists(path) && File::getModifiedTime(path) == entry->timeModified && File::getSize(path) == entry->content.getSize()) {
+				MutexLocker lock(&m_lock);
+				Ref<HttpFileCacheEntry> current;
+				if (m_table.get(path, &current) && current == entry) {
+					entry->m_tickValidated = now;
+					_moveToFront(entry.get());
+				}
+				return entry;
+			}
+			remove(path);
+		}
+		entry = _load(path, now, pSizeLarge, pTimeModifiedLarge);
+		if (entry.isNull()) {
+			return sl_null;
+		}
+		entry->m_tickValidated = now;
+		MutexLocker lock(&m_lock);
+		Ref<HttpFileCacheEntry> old;
+		if (m_table.remove(path, &old)) {
+			_remove(old.get());
+		}
+		_add(entry.get());
+		m_table.put(path, entry);
+		while (m_sizeTotal > m_param.maxTotalSize && m_back && m_back != entry.get()) {
+			HttpFileCacheEntry* last = m_back;
+			String pathLast = last->path;
+			_remove(last);
+			m_table.remove(pathLast);
+		}
+		return entry;
+	}
+
+	void HttpFileCache::remove(const String& path)
+	{
+		MutexLocker lock(&m_lock);
+		Ref<HttpFileCacheEntry> entry;
+		if (m_table.remove(path, &entry)) {
+			_remove(entry.get());
+		}
+		m_tableLarge.remove(path);
+	}
+
+	void HttpFileCache::removeAll()
+	{
+		MutexLocker lock(&m_lock);
+		m_front = sl_null;
+		m_back = sl_null;
+		m_sizeTotal = 0;
+		m_table.removeAll();
+		m_tableLarge.removeAll();
+	}
+
+	sl_size HttpFileCache::getCount()
+	{
+		MutexLocker lock(&m_lock);
+		return m_table.getCount();
+	}
+
+	sl_uint64 HttpFileCache::getTotalSize()
+	{
+		return m_sizeTotal;
+	}
+
+	Ref<HttpFileCacheEntry> HttpFileCache::_load(const String& path, sl_uint64 now, sl_uint64* pSizeLarge, Time* pTimeModifiedLarge)
+	{
+		if (!(File::exists(path)) || File::isDirectory(path)) {
+			return sl_null;
+		}
+		sl_uint64 size = File::getSize(path);
+		Time timeModified = File::getModifiedTime(path);
+		if (size > m_param.maxFileSize || size > m_param.maxTotalSize) {
+			LargeFile large;
+			large.size = size;
+			large.timeModified = timeModified;
+			large.tickValidated = now;
+			{
+				MutexLocker lock(&m_lock);
+				if (m_tableLarge.getCount() >= HTTP_FILE_CACHE_MAX_LARGE_FILES) {
+					m_tableLarge.removeAll();
+				}
+				m_tableLarge.put(path, large);
+			}
+			if (pSizeLarge) {
+				*pSizeLarge = size;
+			}
+			if (pTimeModifiedLarge) {
+				*pTimeModifiedLarge = timeModified;
+			}
+			return sl_null;
+		}
+		Memory content = File::readAllBytes(path);
+		if (content.getSize() != size) {
+			return sl_null;
+		}
+		Ref<HttpFileCacheEntry> entry = new HttpFileCacheEntry;
+		if (entry.isNull()) {
+			return sl_null;
+		}
+		entry->path = path;
+		entry->timeModified = timeModified;
+		entry->content = content;
+		sl_uint32 crc = Zlib::crc32(content);
+		String tag = String::fromUint64(size, 16) + "-" + String::fromUint64(timeModified.toInt(), 16) + "-" + String::fromUint32(crc, 16, 8);
+		entry->etag = "\"" + tag + "\"";
+		if (m_param.flagCompress && size >= m_param.minCompressSize) {
+			Memory gzip = Zlib::compressGzip(content.getData(), content.getSize(), m_param.compressLevel);
+			if (gzip.isNotNull() && gzip.getSize() < size) {
+				entry->contentGzip = gzip;
+				entry->etagGzip = "\"" + tag + "-gz\"";
+			}
+		}
+		return entry;
+	}
+
+	void HttpFileCache::_add(HttpFileCacheEntry* entry)
+	{
+		entry->m_prev = sl_null;
+		entry->m_next = m_front;
+		if (m_front) {
+			m_front->m_prev = entry;
+		} else {
+			m_back = entry;
+		}
+		m_front = entry;
+		m_sizeTotal += _getEntrySize(entry);
+	}
+
+	void HttpFileCache::_remove(HttpFileCacheEntry* entry)
+	{
+		if (entry->m_prev) {
+			entry->m_prev->m_next = entry->m_next;
+		} else {
+			m_front = entry->m_next;
+		}
+		if (entry->m_next) {
+			entry->m_next->m_prev = entry->m_prev;
+		} else {
+			m_back = entry->m_prev;
+		}
+		entry->m_prev = sl_null;
+		entry->m_next = sl_null;
+		m_sizeTotal -= _getEntrySize(entry);
+	}
+
+	void HttpFileCache::_moveToFront(HttpFileCacheEntry* entry)
+	{
+		if (m_front != entry) {
+			_remove(entry);
+			_add(entry);
+		}
+	}
+
+	sl_uint64 HttpFileCache::_getEntrySize(HttpFileCacheEntry* entry)
+	{
+		return entry->content.getSize() + entry->contentGzip.getSize();
+	}
+
+}
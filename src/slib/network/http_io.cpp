@@ -10,6 +10,8 @@
 
 #include "slib/network/http_io.h"
 
+#include "slib/network/http_common.h"
+
 namespace slib
 {
 
@@ -59,6 +61,21 @@ namespace slib
 		m_bufferOutput.copyFromFile(path, dispatcher);
 	}
 
+	void HttpOutputBuffer::sendFile(const String& path)
+	{
+		m_bufferOutput.sendFile(path);
+	}
+
+	void HttpOutputBuffer::sendFile(const String& path, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bufferOutput.sendFile(path, offset, size);
+	}
+
+	void HttpOutputBuffer::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bufferOutput.sendFile(file, offset, size);
+	}
+
 	sl_uint64 HttpOutputBuffer::getOutputLength() const
 	{
 		return m_bufferOutput.getOutputLength();
@@ -85,34 +102,30 @@ namespace slib
 		}
 		sl_bool flagFound = sl_false;
 		const sl_uint8* buf = (const sl_uint8*)(_buf);
-		if (size > 0 && m_last[0] == '\r' && m_last[1] == '\n' && m_last[2] == '\r' && buf[0] == '\n') {
+		// terminator crossing the previous chunk
+		if (m_last[0] == '\r' && m_last[1] == '\n' && m_last[2] == '\r' && buf[0] == '\n') {
 			posBody = 1;
 			flagFound = sl_true;
-		}
-		if (size > 1 && m_last[1] == '\r' && m_last[2] == '\n' && buf[0] == '\r' && buf[1] == '\n') {
+		} else if (size > 1 && m_last[1] == '\r' && m_last[2] == '\n' && buf[0] == '\r' && buf[1] == '\n') {
 			posBody = 2;
 			flagFound = sl_true;
-		}
-		if (size > 2 && m_last[2] == '\r' && buf[0] == '\n' && buf[1] == '\r' && buf[2] == '\n') {
+		} else if (size > 2 && m_last[2] == '\r' && buf[0] == '\n' && buf[1] == '\r' && buf[2] == '\n') {
 			posBody = 3;
 			flagFound = sl_true;
-		}
-		if (size > 3) {
-			for (sl_size i = 0; i <= size - 4; i++) {
-				if (buf[i] == '\r' && buf[i + 1] == '\n' && buf[i + 2] == '\r' && buf[i + 3] == '\n') {
-					posBody = 4 + i;
-					flagFound = sl_true;
-					break;
-				}
+		} else {
+			sl_reg pos = HttpHeaderScanner::findHeaderEnd(buf, size);
+			if (pos > 0) {
+				posBody = pos;
+				flagFound = sl_true;
 			}
 		}
 		if (flagFound) {
-			m_buffer.add(Memory::create(buf, posBody));
+			m_buffer.addNew(buf, posBody);
 			m_last[0] = 0;
 			m_last[1] = 0;
 			m_last[2] = 0;
 		} else {
-			m_buffer.add(Memory::create(buf, size));
+			m_buffer.addNew(buf, size);
 			if (size < 3) {
 				if (size == 1) {
 					m_last[0] = m_last[1];
@@ -207,17 +220,19 @@ namespace slib
 															   sl_bool flagDecompress)
 	{
 		Ref<_HttpContentReader_Persistent> ret = new _HttpContentReader_Persistent;
-		if (io.isNull()) {
+		if (contentLength == 0) {
 			return ret;
 		}
-		if (contentLength == 0 || bufferSize == 0) {
+		if (io.isNotNull() && bufferSize == 0) {
 			return ret;
 		}
 		if (ret.isNotNull()) {
 			ret->m_sizeTotal = contentLength;
 			ret->m_listener = listener;
-			ret->setReadingBufferSize(bufferSize);
-			ret->setSourceStream(io);
+			if (io.isNotNull()) {
+				ret->setReadingBufferSize(bufferSize);
+				ret->setSourceStream(io);
+			}
 			if (flagDecompress) {
 				if (!(ret->setDecompressing())) {
 					ret.setNull();
@@ -308,9 +323,17 @@ namespace slib
 					break;
 				case 3: // chunk-data
 					if (m_sizeCurrentChunkRead < m_sizeCurrentChunk) {
-						output[sizeOutput] = ch;
-						m_sizeCurrentChunkRead++;
-						sizeOutput++;
+						sl_uint32 n = size - pos;
+						if (m_sizeCurrentChunk - m_sizeCurrentChunkRead < n) {
+							n = (sl_uint32)(m_sizeCurrentChunk - m_sizeCurrentChunkRead);
+						}
+						if (output + sizeOutput != data + pos) {
+							Base::moveMemory(output + sizeOutput, data + pos, n);
+						}
+						m_sizeCurrentChunkRead += n;
+						sizeOutput += n;
+						pos += n;
+						break;
 					} else {
 						if (ch == '\r') {
 							m_state = 4;
@@ -375,16 +398,15 @@ namespace slib
 															sl_bool flagDecompress)
 	{
 		Ref<_HttpContentReader_Chunked> ret = new _HttpContentReader_Chunked;
-		if (io.isNull()) {
-			return ret;
-		}
-		if (bufferSize == 0) {
+		if (io.isNotNull() && bufferSize == 0) {
 			return ret;
 		}
 		if (ret.isNotNull()) {
 			ret->m_listener = listener;
-			ret->setReadingBufferSize(bufferSize);
-			ret->setSourceStream(io);
+			if (io.isNotNull()) {
+				ret->setReadingBufferSize(bufferSize);
+				ret->setSourceStream(io);
+			}
 			if (flagDecompress) {
 				if (!(ret->setDecompressing())) {
 					ret.setNull();
@@ -409,16 +431,15 @@ namespace slib
 															 sl_bool flagDecompress)
 	{
 		Ref<_HttpContentReader_TearDown> ret = new _HttpContentReader_TearDown;
-		if (io.isNull()) {
-			return ret;
-		}
-		if (bufferSize == 0) {
+		if (io.isNotNull() && bufferSize == 0) {
 			return ret;
 		}
 		if (ret.isNotNull()) {
 			ret->m_listener = listener;
-			ret->setReadingBufferSize(bufferSize);
-			ret->setSourceStream(io);
+			if (io.isNotNull()) {
+				ret->setReadingBufferSize(bufferSize);
+				ret->setSourceStream(io);
+			}
 			if (flagDecompress) {
 				if (!(ret->setDecompressing())) {
 					ret.setNull();
@@ -433,6 +454,14 @@ namespace slib
 		return m_flagDecompressing;
 	}
 
+	Memory HttpContentReader::decode(void* data, sl_uint32 size, Referable* refData)
+	{
+		if (size > 0 && !(isReadingEnded())) {
+			return filterRead(data, size, refData);
+		}
+		return sl_null;
+	}
+
 	void HttpContentReader::onReadStream(AsyncStreamResult* result)
 	{
 		if (result->flagError) {
@@ -483,7 +512,7 @@ namespace slib
 	Memory HttpContentReader::decompressData(void* data, sl_uint32 size, Referable* refData)
 	{
 		if (m_flagDecompressing) {
-			return m_zlib.decompress(data, size);
+			return m_zlib.decompressPart(data, size);
 		} else {
 			return Memory::createStatic(data, size, refData);
 		}
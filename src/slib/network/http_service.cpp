@@ -15,10 +15,17 @@
 #include "slib/core/file.h"
 #include "slib/core/log.h"
 #include "slib/core/json.h"
+#include "slib/core/memory_pool.h"
 #include "slib/core/content_type.h"
+#include "slib/core/system.h"
+#include "slib/crypto/zlib.h"
 
 #define SERVICE_TAG "HTTP SERVICE"
 
+#if defined(SLIB_PLATFORM_IS_UNIX) && !defined(SLIB_PLATFORM_IS_ANDROID) && !defined(SLIB_PLATFORM_IS_TIZEN)
+#define SUPPORT_LISTEN_PER_IO_LOOP
+#endif
+
 namespace slib
 {
 
@@ -32,6 +39,7 @@ namespace slib
 	{
 		m_requestContentLength = 0;
 		m_flagAsynchronousResponse = sl_false;
+		m_flagResponseCompleted = sl_false;
 
 		setClosingConnection(sl_false);
 		setProcessingByThread(sl_true);
@@ -103,6 +111,13 @@ namespace slib
 
 	Ref<AsyncIoLoop> HttpServiceContext::getAsyncIoLoop()
 	{
+		Ref<AsyncStream> io = getIO();
+		if (io.isNotNull()) {
+			Ref<AsyncIoLoop> loop = io->getIoLoop();
+			if (loop.isNotNull()) {
+				return loop;
+			}
+		}
 		Ref<HttpService> service = getService();
 		if (service.isNotNull()) {
 			return service->getAsyncIoLoop();
@@ -149,6 +164,482 @@ namespace slib
 		}
 	}
 
+	static sl_bool _HttpService_acceptsGzip(const String& header)
+	{
+		ListElements<String> codings(header.split(","));
+		for (sl_size i = 0; i < codings.count; i++) {
+			String coding = codings[i].trim();
+			sl_reg indexParam = coding.indexOf(';');
+			if (indexParam >= 0) {
+				String param = coding.substring(indexParam + 1).trim();
+				coding = coding.substring(0, indexParam).trim();
+				if (param == "q=0" || param == "q=0.0" || param == "q=0.00" || param == "q=0.000") {
+					continue;
+				}
+			}
+			if (coding.equalsIgnoreCase("gzip") || coding == "*") {
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	static sl_bool _HttpService_isCompressibleContentType(const String& contentType)
+	{
+		String type = contentType;
+		sl_reg indexParam = type.indexOf(';');
+		if (indexParam >= 0) {
+			type = type.substring(0, indexParam);
+		}
+		type = type.trim().toLower();
+		if (type.startsWith("text/") || type.endsWith("+json") || type.endsWith("+xml")) {
+			return sl_true;
+		}
+		return type == "application/json" || type == "application/javascript" || type == "application/x-javascript" || type == "application/xml";
+	}
+
+#define PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE 16384
+#define PRIV_SLIB_HTTP_GZIP_READ_SIZE 0x10000
+// the buffered bodies from this size are compressed by the parallel compressor
+#define PRIV_SLIB_HTTP_GZIP_PARALLEL_SIZE 0x100000
+
+	/*
+		Body source of the compressed response: reads the elements of the original body (memory, stream and file bodies) in order,
+		and produces the gzip stream framed in chunked transfer encoding. The compression runs on the dispatcher (thread pool),
+		one read request at a time, and the output ends by an empty read.
+	*/
+	class _HttpService_GzipStream : public AsyncStream
+	{
+	public:
+		ZlibCompress m_zlib;
+		sl_int32 m_level;
+		Ref<ThreadPool> m_threadPool;
+		LinkedQueue< Ref<AsyncOutputBufferElement> > m_elements;
+		sl_bool m_flagParallel;
+		
+		MemoryQueue m_input;
+		Ref<AsyncStream> m_source;
+		sl_uint64 m_sizeSource;
+		sl_uint32 m_sizeSourceRead;
+		sl_bool m_flagReadingSource;
+		Ref<File> m_file;
+		sl_uint64 m_offsetFile;
+		sl_uint64 m_sizeFile;
+		Memory m_bufRead;
+		
+		Memory m_chunk;
+		sl_uint32 m_sizeChunk;
+		MemoryQueue m_output;
+		
+		Ref<AsyncStreamRequest> m_request;
+		sl_bool m_flagOpened;
+		sl_bool m_flagEnded;
+		sl_bool m_flagError;
+		
+	public:
+		_HttpService_GzipStream()
+		{
+			m_level = 6;
+			m_flagParallel = sl_false;
+			m_sizeSource = 0;
+			m_sizeSourceRead = 0;
+			m_flagReadingSource = sl_false;
+			m_offsetFile = 0;
+			m_sizeFile = 0;
+			m_sizeChunk = 0;
+			m_flagOpened = sl_true;
+			m_flagEnded = sl_false;
+			m_flagError = sl_false;
+		}
+		
+	public:
+		static Ref<_HttpService_GzipStream> create(AsyncOutputBuffer& body, sl_int32 level, const Ref<ThreadPool>& threadPool)
+		{
+			Ref<_HttpService_GzipStream> ret = new _HttpService_GzipStream;
+			if (ret.isNotNull()) {
+				ret->m_bufRead = Memory::create(PRIV_SLIB_HTTP_GZIP_READ_SIZE);
+				if (ret->m_bufRead.isNotNull() && ret->m_zlib.startGzip(level)) {
+					ret->m_level = level;
+					ret->m_threadPool = threadPool;
+					sl_uint64 sizeBody = body.getOutputLength();
+					body.popElements(ret->m_elements);
+					if (sizeBody >= PRIV_SLIB_HTTP_GZIP_PARALLEL_SIZE) {
+						ret->m_flagParallel = sl_true;
+						Link< Ref<AsyncOutputBufferElement> >* link = ret->m_elements.getFront();
+						while (link) {
+							if (!(link->value->isEmptyBody())) {
+								ret->m_flagParallel = sl_false;
+								break;
+							}
+							link = link->next;
+						}
+					}
+					return ret;
+				}
+			}
+			return sl_null;
+		}
+		
+	public:
+		void close() override
+		{
+			ObjectLocker lock(this);
+			m_flagOpened = sl_false;
+			m_request.setNull();
+			m_source.setNull();
+			m_file.setNull();
+			m_elements.removeAll();
+		}
+		
+		sl_bool isOpened() override
+		{
+			return m_flagOpened;
+		}
+		
+		sl_bool read(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject) override
+		{
+			ObjectLocker lock(this);
+			if (!m_flagOpened || m_request.isNotNull() || !size) {
+				return sl_false;
+			}
+			m_request = AsyncStreamRequest::createRead(data, size, userObject, callback);
+			if (m_request.isNull()) {
+				return sl_false;
+			}
+			if (m_threadPool->addTask(SLIB_FUNCTION_WEAKREF(_HttpService_GzipStream, _process, this))) {
+				return sl_true;
+			}
+			m_request.setNull();
+			return sl_false;
+		}
+		
+		sl_bool write(void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject) override
+		{
+			return sl_false;
+		}
+		
+		sl_bool addTask(const Function<void()>& callback) override
+		{
+			return m_threadPool->addTask(callback);
+		}
+		
+	public:
+		void _process()
+		{
+			ObjectLocker lock(this);
+			if (m_request.isNull()) {
+				return;
+			}
+			while (!(m_output.getSize()) && !m_flagEnded && !m_flagError) {
+				if (m_flagReadingSource) {
+					// resumed by `onReadSource()`
+					return;
+				}
+				_step();
+			}
+			Ref<AsyncStreamRequest> request = m_request;
+			m_request.setNull();
+			sl_uint32 n = 0;
+			if (!m_flagError) {
+				n = (sl_uint32)(m_output.pop(request->data, request->size));
+			}
+			sl_bool flagError = m_flagError;
+			lock.unlock();
+			request->runCallback(this, n, flagError);
+		}
+		
+		void _step()
+		{
+			if (m_flagParallel) {
+				// the whole buffered body is compressed at once, by the blocks on the thread pool
+				Ref<AsyncOutputBufferElement> element;
+				while (m_elements.pop(&element)) {
+					m_input.link(element->getHeader());
+				}
+				Memory input = m_input.merge();
+				m_input.clear();
+				Memory output = Zlib::compressGzipParallel(input.getData(), input.getSize(), m_threadPool, m_level);
+				if (output.isNull() || !(_writeChunk(output)) || !(_writeLastChunk())) {
+					m_flagError = sl_true;
+				}
+				m_flagEnded = sl_true;
+				return;
+			}
+			MemoryData data;
+			if (m_input.pop(data)) {
+				if (!(_deflate(data.data, data.size))) {
+					m_flagError = sl_true;
+				}
+				return;
+			}
+			if (m_sizeSourceRead) {
+				// the stream may be slow, so the compressed data until now is sent
+				sl_uint32 n = m_sizeSourceRead;
+				m_sizeSourceRead = 0;
+				m_sizeSource -= n;
+				if (!m_sizeSource) {
+					m_source.setNull();
+				}
+				if (!(_deflate(m_bufRead.getData(), n)) || !(_flush())) {
+					m_flagError = sl_true;
+				}
+				return;
+			}
+			if (m_sizeSource) {
+				sl_uint32 n = (sl_uint32)(SLIB_MIN(m_sizeSource, (sl_uint64)(m_bufRead.getSize())));
+				m_flagReadingSource = sl_true;
+				if (!(m_source->read(m_bufRead.getData(), n, SLIB_FUNCTION_WEAKREF(_HttpService_GzipStream, onReadSource, this), m_bufRead.ref.get()))) {
+					m_flagReadingSource = sl_false;
+					m_flagError = sl_true;
+				}
+				return;
+			}
+			if (m_sizeFile) {
+				sl_uint32 n = (sl_uint32)(SLIB_MIN(m_sizeFile, (sl_uint64)(m_bufRead.getSize())));
+				if (!(m_file->seek(m_offsetFile, SeekPosition::Begin))) {
+					m_flagError = sl_true;
+					return;
+				}
+				sl_reg m = m_file->read(m_bufRead.getData(), n);
+				if (m <= 0 || !(_deflate(m_bufRead.getData(), m))) {
+					m_flagError = sl_true;
+					return;
+				}
+				m_offsetFile += m;
+				m_sizeFile -= m;
+				if (!m_sizeFile) {
+					m_file.setNull();
+				}
+				return;
+			}
+			Ref<AsyncOutputBufferElement> element;
+			if (m_elements.pop(&element)) {
+				m_input.link(element->getHeader());
+				sl_uint64 size = element->getBodySize();
+				Ref<AsyncStream> body = element->getBody();
+				if (body.isNotNull()) {
+					m_source = body;
+					m_sizeSource = size;
+				} else {
+					Ref<File> file = element->getFileBody();
+					if (file.isNotNull()) {
+						m_file = file;
+						m_offsetFile = element->getFileBodyOffset();
+						m_sizeFile = size;
+					}
+				}
+				return;
+			}
+			if (!(_finish())) {
+				m_flagError = sl_true;
+			}
+			m_flagEnded = sl_true;
+		}
+		
+		void onReadSource(AsyncStreamResult* result)
+		{
+			ObjectLocker lock(this);
+			m_flagReadingSource = sl_false;
+			if (result->flagError || !(result->size)) {
+				m_flagError = sl_true;
+			} else {
+				m_sizeSourceRead = result->size;
+			}
+			if (m_request.isNotNull()) {
+				if (!(m_threadPool->addTask(SLIB_FUNCTION_WEAKREF(_HttpService_GzipStream, _process, this)))) {
+					m_flagError = sl_true;
+					lock.unlock();
+					_process();
+				}
+			}
+		}
+		
+		sl_bool _prepareChunk()
+		{
+			if (m_chunk.isNull()) {
+				m_chunk = Memory::create(PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE);
+				if (m_chunk.isNull()) {
+					return sl_false;
+				}
+				m_sizeChunk = 0;
+			}
+			return sl_true;
+		}
+		
+		sl_bool _writeChunk(const Memory& data)
+		{
+			if (data.isEmpty()) {
+				return sl_true;
+			}
+			String size = String::fromUint64(data.getSize(), 16) + "\r\n";
+			SLIB_STATIC_STRING(crlf, "\r\n")
+			return m_output.add(Memory::create(size.getData(), size.getLength())) && m_output.add(data) && m_output.add(Memory::createStatic(crlf.getData(), crlf.getLength()));
+		}
+		
+		sl_bool _writeLastChunk()
+		{
+			SLIB_STATIC_STRING(s, "0\r\n\r\n")
+			return m_output.add(Memory::createStatic(s.getData(), s.getLength()));
+		}
+		
+		sl_bool _emitChunk()
+		{
+			if (m_sizeChunk) {
+				Memory chunk = m_chunk.sub(0, m_sizeChunk);
+				m_chunk.setNull();
+				m_sizeChunk = 0;
+				return _writeChunk(chunk);
+			}
+			return sl_true;
+		}
+		
+		sl_bool _deflate(const void* _data, sl_size size)
+		{
+			const sl_uint8* data = (const sl_uint8*)_data;
+			while (size) {
+				if (!(_prepareChunk())) {
+					return sl_false;
+				}
+				sl_uint32 sizeInputPassed = 0;
+				sl_uint32 sizeOutputUsed = 0;
+				if (m_zlib.compress(data, (sl_uint32)(SLIB_MIN(size, 0x40000000)), sizeInputPassed, (sl_uint8*)(m_chunk.getData()) + m_sizeChunk, PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE - m_sizeChunk, sizeOutputUsed, sl_false) < 0) {
+					return sl_false;
+				}
+				data += sizeInputPassed;
+				size -= sizeInputPassed;
+				m_sizeChunk += sizeOutputUsed;
+				if (m_sizeChunk == PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE) {
+					if (!(_emitChunk())) {
+						return sl_false;
+					}
+				}
+			}
+			return sl_true;
+		}
+		
+		sl_bool _flush()
+		{
+			for (;;) {
+				if (!(_prepareChunk())) {
+					return sl_false;
+				}
+				sl_uint32 sizeOutputUsed = 0;
+				sl_int32 iRet = m_zlib.flush((sl_uint8*)(m_chunk.getData()) + m_sizeChunk, PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE - m_sizeChunk, sizeOutputUsed);
+				if (iRet < 0) {
+					return sl_false;
+				}
+				m_sizeChunk += sizeOutputUsed;
+				if (!(_emitChunk())) {
+					return sl_false;
+				}
+				if (!iRet) {
+					return sl_true;
+				}
+			}
+		}
+		
+		sl_bool _finish()
+		{
+			for (;;) {
+				if (!(_prepareChunk())) {
+					return sl_false;
+				}
+				sl_uint32 sizeInputPassed = 0;
+				sl_uint32 sizeOutputUsed = 0;
+				sl_int32 iRet = m_zlib.compress(sl_null, 0, sizeInputPassed, (sl_uint8*)(m_chunk.getData()) + m_sizeChunk, PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE - m_sizeChunk, sizeOutputUsed, sl_true);
+				if (iRet < 0) {
+					return sl_false;
+				}
+				m_sizeChunk += sizeOutputUsed;
+				if (!iRet || m_sizeChunk == PRIV_SLIB_HTTP_GZIP_CHUNK_SIZE) {
+					if (!(_emitChunk())) {
+						return sl_false;
+					}
+				}
+				if (!iRet) {
+					return _writeLastChunk();
+				}
+			}
+		}
+		
+	};
+
+	/*
+		The body (memory, stream and file) is compressed while it is written to the connection, and framed in chunked transfer encoding.
+		HTTP/1.0 clients can not receive chunked body, so their responses are not compressed.
+	*/
+	void HttpServiceContext::_compressResponse(const HttpServiceParam& param)
+	{
+		if (!(param.flagCompressResponse)) {
+			return;
+		}
+		sl_uint64 sizeBody = getOutputLength();
+		if (!sizeBody || sizeBody < param.minCompressResponseSize) {
+			return;
+		}
+		if (getResponseCode() != HttpStatus::OK) {
+			return;
+		}
+		if (containsResponseHeader(HttpHeaders::ContentEncoding) || containsResponseHeader(HttpHeaders::ContentRange) || isChunkedResponse()) {
+			return;
+		}
+		if (!(_HttpService_isCompressibleContentType(getResponseContentType()))) {
+			return;
+		}
+		if (!(containsResponseHeader(HttpHeaders::Vary))) {
+			setResponseHeader(HttpHeaders::Vary, HttpHeaders::AcceptEncoding);
+		}
+		if (!(_HttpService_acceptsGzip(getRequestHeader(HttpHeaders::AcceptEncoding)))) {
+			return;
+		}
+		if (getRequestVersion() == "HTTP/1.0") {
+			return;
+		}
+		if (getMethod() != HttpMethod::HEAD) {
+			// the body of HEAD response is not sent, only the headers are same as GET
+			Ref<HttpService> service = getService();
+			if (service.isNull()) {
+				return;
+			}
+			Ref<ThreadPool> threadPool = service->getThreadPool();
+			if (threadPool.isNull()) {
+				return;
+			}
+			Ref<_HttpService_GzipStream> stream = _HttpService_GzipStream::create(m_bufferOutput, param.compressResponseLevel, threadPool);
+			if (stream.isNull()) {
+				return;
+			}
+			if (!(m_bufferOutput.copyFrom(stream.get(), SLIB_UINT64_MAX))) {
+				// the body is lost (out of memory)
+				setResponseCode(HttpStatus::InternalServerError);
+				return;
+			}
+		}
+		setResponseContentEncoding("gzip");
+		setResponseTransferEncoding("chunked");
+		removeResponseHeader(HttpHeaders::ContentLength);
+		// the entity tag of the identity content can not be a strong validator of the compressed content
+		String etag = getResponseHeader(HttpHeaders::ETag);
+		if (etag.startsWith('"')) {
+			setResponseHeader(HttpHeaders::ETag, "W/" + etag);
+		}
+	}
+
+	const Map<String, String>& HttpServiceContext::getPathParameters() const
+	{
+		return m_pathParameters;
+	}
+
+	String HttpServiceContext::getPathParameter(const String& name) const
+	{
+		return m_pathParameters.getValue_NoLock(name, String::null());
+	}
+
+	void HttpServiceContext::setPathParameter(const String& name, const String& value)
+	{
+		m_pathParameters.put_NoLock(name, value);
+	}
+
 /******************************************************
 			HttpServiceConnection
 ******************************************************/
@@ -159,6 +650,13 @@ namespace slib
 	{
 		m_flagClosed = sl_true;
 		m_flagReading = sl_false;
+		
+		m_nRequests = 0;
+		m_flagAcceptingRequests = sl_true;
+		m_flagClosingAfterOutput = sl_false;
+		m_flagOutputWriting = sl_false;
+		
+		m_tickLastActive = 0;
 	}
 
 	HttpServiceConnection::~HttpServiceConnection()
@@ -169,7 +667,7 @@ namespace slib
 	Ref<HttpServiceConnection> HttpServiceConnection::create(HttpService* service, AsyncStream* io)
 	{
 		if (service && io) {
-			Memory bufRead = Memory::create(SIZE_READ_BUF);
+			Memory bufRead = MemoryPool::create(SIZE_READ_BUF);
 			if (bufRead.isNotEmpty()) {
 				Ref<HttpServiceConnection> ret = new HttpServiceConnection;
 				if (ret.isNotNull()) {
@@ -204,6 +702,11 @@ namespace slib
 		if (service.isNotNull()) {
 			service->closeConnection(this);
 		}
+		Ref<TimerWheelTask> task = m_taskIdle;
+		if (task.isNotNull()) {
+			task->cancel();
+			m_taskIdle.setNull();
+		}
 		m_io->close();
 		m_output->close();
 	}
@@ -211,6 +714,13 @@ namespace slib
 	void HttpServiceConnection::start(const void* data, sl_uint32 size)
 	{
 		m_contextCurrent.setNull();
+		m_tickLastActive = System::getTickCount();
+		if (m_taskIdle.isNull()) {
+			Ref<HttpService> service = m_service;
+			if (service.isNotNull()) {
+				_setIdleTimeout(service->getParam().keepAliveTimeout);
+			}
+		}
 		if (data && size > 0) {
 			_processInput(data, size);
 		} else {
@@ -255,29 +765,51 @@ namespace slib
 		if (service.isNull()) {
 			return;
 		}
-		if (m_flagClosed) {
-			return;
-		}
 		
 		const HttpServiceParam& param = service->getParam();
 		sl_uint64 maxRequestHeadersSize = param.maxRequestHeadersSize;
 		sl_uint64 maxRequestBodySize = param.maxRequestBodySize;
 
 		char* data = (char*)_data;
-		Ref<HttpServiceContext> _context = m_contextCurrent;
-		if (_context.isNull()) {
-			_context = HttpServiceContext::create(this);
-			if (_context.isNull()) {
-				sendResponse_ServerError();
+		for (;;) {
+			if (m_flagClosed) {
 				return;
 			}
-			m_contextCurrent = _context;
-			_context->setProcessingByThread(param.flagProcessByThreads);
-		}
-		HttpServiceContext* context = _context.get();
-		if (context->m_requestHeader.isEmpty()) {
-			sl_size posBody;
-			if (context->m_requestHeaderReader.add(data, size, posBody)) {
+			if (!m_flagAcceptingRequests) {
+				// the input following the last request is ignored
+				return;
+			}
+			Ref<HttpServiceContext> _context = m_contextCurrent;
+			if (_context.isNull()) {
+				if (size == 0) {
+					break;
+				}
+				if (param.maxPipelinedRequests > 0) {
+					MutexLocker lock(&m_lockResponses);
+					if (m_queueContexts.getCount() >= param.maxPipelinedRequests) {
+						// resumed by `_completeResponse()`
+						m_dataPending = MemoryPool::create(data, size);
+						return;
+					}
+				}
+				_context = HttpServiceContext::create(this);
+				if (_context.isNull()) {
+					sendResponse_ServerError();
+					return;
+				}
+				m_contextCurrent = _context;
+				_context->setProcessingByThread(param.flagProcessByThreads);
+			}
+			HttpServiceContext* context = _context.get();
+			if (context->m_requestHeader.isEmpty()) {
+				sl_size posBody;
+				if (!(context->m_requestHeaderReader.add(data, size, posBody))) {
+					if (context->m_requestHeaderReader.getHeaderSize() > maxRequestHeadersSize) {
+						sendResponse_BadRequest();
+						return;
+					}
+					break;
+				}
 				context->m_requestHeader = context->m_requestHeaderReader.mergeHeader();
 				if (context->m_requestHeader.isEmpty()) {
 					sendResponse_ServerError();
@@ -289,73 +821,133 @@ namespace slib
 				}
 				context->m_requestHeaderReader.clear();
 				Memory header = context->getRawRequestHeader();
-				sl_reg iRet = context->parseRequestPacket(header.getData(), header.getSize());
+				sl_reg iRet = context->parseRequestPacket(header);
 				if (iRet != (sl_reg)(context->m_requestHeader.getSize())) {
 					sendResponse_BadRequest();
 					return;
 				}
+				{
+					// conflicting Content-Length fields make the message framing ambiguous (RFC 7230, 3.3.2)
+					ListElements<String> lengths(context->getRequestHeaderValues(HttpHeaders::ContentLength));
+					for (sl_size i = 1; i < lengths.count; i++) {
+						if (lengths[i] != lengths[0]) {
+							sendResponse_BadRequest();
+							return;
+						}
+					}
+				}
 				context->m_requestContentLength = context->getRequestContentLengthHeader();
 				if (context->m_requestContentLength > maxRequestBodySize) {
 					sendResponse_BadRequest();
 					return;
 				}
-				context->m_requestBody = Memory::create(data + posBody, size - (sl_uint32)posBody);
-				if (!(context->m_requestBodyBuffer.add(context->m_requestBody))) {
-					sendResponse_ServerError();
-					return;
-				}
+				data += posBody;
+				size -= (sl_uint32)posBody;
+				context->m_requestBody = MemoryPool::create(data, size);
 				context->applyQueryToParameters();
 				if (service->preprocessRequest(context)) {
 					return;
 				}
-			} else {
-				if (context->m_requestHeaderReader.getHeaderSize() > maxRequestHeadersSize) {
-					sendResponse_BadRequest();
+			}
+			sl_uint64 sizeBodyRemain = context->m_requestContentLength - context->m_requestBodyBuffer.getSize();
+			if (size > 0 && sizeBodyRemain > 0) {
+				// the bytes after the body belong to the next request
+				sl_uint32 n = size;
+				if (n > sizeBodyRemain) {
+					n = (sl_uint32)sizeBodyRemain;
+				}
+				if (!(context->m_requestBodyBuffer.addNew(data, n))) {
+					sendResponse_ServerError();
 					return;
 				}
+				data += n;
+				size -= n;
 			}
-		} else {
-			if (!(context->m_requestBodyBuffer.add(Memory::create(data, size)))) {
+			if (context->m_requestBodyBuffer.getSize() < context->m_requestContentLength) {
+				break;
+			}
+			
+			m_contextCurrent.setNull();
+
+			context->m_requestBody = context->m_requestBodyBuffer.merge();
+			if (context->m_requestContentLength > 0 && context->m_requestBody.isEmpty()) {
 				sendResponse_ServerError();
 				return;
 			}
-		}
-		if (context->m_requestHeader.isNotEmpty()) {
-			if (context->m_requestBodyBuffer.getSize() >= context->m_requestContentLength) {
-
-				m_contextCurrent.setNull();
+			context->m_requestBodyBuffer.clear();
 
-				context->m_requestBody = context->m_requestBodyBuffer.merge();
-				if (context->m_requestContentLength > 0 && context->m_requestBody.isEmpty()) {
-					sendResponse_ServerError();
-					return;
-				}
-				context->m_requestBodyBuffer.clear();
-
-				if (context->getMethod() == HttpMethod::POST) {
-					String reqContentType = context->getRequestContentTypeNoParams();
-					if (reqContentType == ContentTypes::WebForm) {
-						Memory body = context->getRequestBody();
-						context->applyPostParameters(body.getData(), body.getSize());
-					}
-				}
-				
-				if (context->isProcessingByThread()) {
-					Ref<ThreadPool> threadPool = service->getThreadPool();
-					if (threadPool.isNotNull()) {
-						threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServiceConnection, _processContext, this, _context));
-					} else {
-						sendResponse_ServerError();
-						return;
-					}
-				} else {
-					_processContext(context);
+			if (context->getMethod() == HttpMethod::POST) {
+				String reqContentType = context->getRequestContentTypeNoParams();
+				if (reqContentType == ContentTypes::WebForm) {
+					Memory body = context->getRequestBody();
+					context->applyPostParameters(body.getData(), body.getSize());
 				}
 			}
+			
+			if (!(_dispatchContext(_context))) {
+				sendResponse_ServerError();
+				return;
+			}
 		}
 		_read();
 	}
 
+	void HttpServiceConnection::_resumeInput()
+	{
+		Memory data;
+		{
+			MutexLocker lock(&m_lockResponses);
+			data = m_dataPending;
+			m_dataPending.setNull();
+		}
+		if (data.isNotNull()) {
+			_processInput(data.getData(), (sl_uint32)(data.getSize()));
+		}
+	}
+
+	sl_bool HttpServiceConnection::_dispatchContext(const Ref<HttpServiceContext>& context)
+	{
+		Ref<HttpService> service = m_service;
+		if (service.isNull()) {
+			return sl_false;
+		}
+		const HttpServiceParam& param = service->getParam();
+		
+		m_nRequests++;
+		sl_bool flagKeepAlive;
+		String connection = context->getRequestHeader(HttpHeaders::Connection);
+		if (context->getRequestVersion() == "HTTP/1.0") {
+			flagKeepAlive = connection.equalsIgnoreCase("keep-alive");
+		} else {
+			flagKeepAlive = !(connection.equalsIgnoreCase("close"));
+		}
+		if (param.maxRequestsPerConnection > 0 && m_nRequests >= param.maxRequestsPerConnection) {
+			flagKeepAlive = sl_false;
+		}
+		if (!flagKeepAlive) {
+			context->setClosingConnection(sl_true);
+			m_flagAcceptingRequests = sl_false;
+		}
+		
+		{
+			MutexLocker lock(&m_lockResponses);
+			if (!(m_queueContexts.push_NoLock(context))) {
+				return sl_false;
+			}
+		}
+		
+		if (context->isProcessingByThread()) {
+			Ref<ThreadPool> threadPool = service->getThreadPool();
+			if (threadPool.isNull()) {
+				return sl_false;
+			}
+			threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServiceConnection, _processContext, this, context));
+		} else {
+			_processContext(context);
+		}
+		return sl_true;
+	}
+
 	void HttpServiceConnection::_processContext(const Ref<HttpServiceContext>& context)
 	{
 		Ref<HttpService> service = getService();
@@ -363,7 +955,7 @@ namespace slib
 			return;
 		}
 		if (context->getMethod() == HttpMethod::CONNECT) {
-			sendConnectResponse_Failed();
+			sendConnectResponse_Failed(context.get());
 			return;
 		}
 		service->processRequest(context.get());
@@ -374,28 +966,136 @@ namespace slib
 
 	void HttpServiceConnection::_completeResponse(HttpServiceContext* context)
 	{
-		context->setResponseHeader(HttpHeaders::ContentLength, String::fromUint64(context->getResponseContentLength()));
+		Ref<HttpService> service = m_service;
+		if (service.isNull()) {
+			return;
+		}
 		String oldResponseContentType = context->getResponseContentType();
 		if (oldResponseContentType.isEmpty()) {
 			context->setResponseContentType(ContentTypes::TextHtml_Utf8);
 		}
+		context->_compressResponse(service->getParam());
+		if (!(context->isChunkedResponse())) {
+			context->setResponseHeader(HttpHeaders::ContentLength, String::fromUint64(context->getResponseContentLength()));
+		}
+		if (context->getMethod() == HttpMethod::HEAD) {
+			// the headers are same as GET, but the body is not sent
+			context->m_bufferOutput.clearOutput();
+		}
+		if (context->isClosingConnection()) {
+			SLIB_STATIC_STRING(s, "close");
+			context->setResponseHeader(HttpHeaders::Connection, s);
+		} else if (context->getRequestVersion() == "HTTP/1.0") {
+			SLIB_STATIC_STRING(s, "keep-alive");
+			context->setResponseHeader(HttpHeaders::Connection, s);
+		}
 		Memory header = context->makeResponsePacket();
 		if (header.isEmpty()) {
 			close();
 			return;
 		}
-		if (!(m_output->write(header))) {
+		{
+			MutexLocker lock(&m_lockResponses);
+			context->m_responsePacket = header;
+			context->m_flagResponseCompleted = sl_true;
+		}
+		_writeResponses();
+	}
+
+	void HttpServiceConnection::_writeResponses()
+	{
+		Ref<HttpService> service = m_service;
+		if (service.isNull()) {
+			return;
+		}
+		sl_bool flagWrite = sl_false;
+		sl_bool flagError = sl_false;
+		sl_bool flagResume = sl_false;
+		{
+			MutexLocker lock(&m_lockResponses);
+			// responses are written in the order of the requests
+			Ref<HttpServiceContext> front;
+			while (m_queueContexts.getFirstItem_NoLock(&front) && front->m_flagResponseCompleted) {
+				m_queueContexts.pop_NoLock();
+				ObjectLocker lockOutput(m_output.get());
+				if (!(m_output->write(front->m_responsePacket))) {
+					flagError = sl_true;
+					break;
+				}
+				m_output->mergeBuffer(&(front->m_bufferOutput));
+				front->m_responsePacket.setNull();
+				flagWrite = sl_true;
+				m_flagOutputWriting = sl_true;
+				if (front->isClosingConnection()) {
+					m_flagAcceptingRequests = sl_false;
+					m_flagClosingAfterOutput = sl_true;
+					m_queueContexts.removeAll_NoLock();
+					m_dataPending.setNull();
+					break;
+				}
+			}
+			if (m_dataPending.isNotNull() && m_queueContexts.getCount() < service->getParam().maxPipelinedRequests) {
+				flagResume = sl_true;
+			}
+		}
+		if (flagError) {
 			close();
 			return;
 		}
-		m_output->mergeBuffer(&(context->m_bufferOutput));
-		m_output->startWriting();
-		start();
+		if (flagWrite) {
+			m_output->startWriting();
+		}
+		if (flagResume) {
+			// the input is processed on the loop thread
+			Ref<AsyncIoLoop> loop = m_io->getIoLoop();
+			if (loop.isNull() || !(loop->addTask(SLIB_FUNCTION_WEAKREF(HttpServiceConnection, _resumeInput, this)))) {
+				close();
+			}
+		}
+	}
+
+	void HttpServiceConnection::_setIdleTimeout(sl_uint32 timeout)
+	{
+		if (timeout == 0) {
+			return;
+		}
+		Ref<AsyncIoLoop> loop = m_io->getIoLoop();
+		if (loop.isNotNull()) {
+			m_taskIdle = loop->setTimeout(SLIB_FUNCTION_WEAKREF(HttpServiceConnection, _onIdleTimeout, this), timeout);
+		}
+	}
+
+	void HttpServiceConnection::_onIdleTimeout()
+	{
+		if (m_flagClosed) {
+			return;
+		}
+		Ref<HttpService> service = m_service;
+		if (service.isNull()) {
+			return;
+		}
+		sl_uint32 timeout = service->getParam().keepAliveTimeout;
+		sl_bool flagBusy;
+		{
+			MutexLocker lock(&m_lockResponses);
+			flagBusy = m_queueContexts.getCount() > 0 || m_flagOutputWriting;
+		}
+		if (flagBusy) {
+			_setIdleTimeout(timeout);
+			return;
+		}
+		sl_uint32 elapsed = System::getTickCount() - m_tickLastActive;
+		if (elapsed >= timeout) {
+			close();
+		} else {
+			_setIdleTimeout(timeout - elapsed);
+		}
 	}
 
 	void HttpServiceConnection::onReadStream(AsyncStreamResult* result)
 	{
 		m_flagReading = sl_false;
+		m_tickLastActive = System::getTickCount();
 		if (result->flagError) {
 			close();
 		} else {
@@ -405,6 +1105,11 @@ namespace slib
 
 	void HttpServiceConnection::onAsyncOutputComplete(AsyncOutput* output)
 	{
+		m_tickLastActive = System::getTickCount();
+		m_flagOutputWriting = sl_false;
+		if (m_flagClosingAfterOutput) {
+			close();
+		}
 	}
 
 	void HttpServiceConnection::onAsyncOutputError(AsyncOutput* output)
@@ -465,14 +1170,48 @@ namespace slib
 
 	void HttpServiceConnection::sendResponse_BadRequest()
 	{
-		SLIB_STATIC_STRING(s, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n");
-		sendResponseAndRestart(Memory::create(s.getData(), s.getLength()));
+		// the framing of the following input is unknown, so the connection is not reused
+		SLIB_STATIC_STRING(s, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+		_sendErrorResponse(sl_null, s, sl_true);
 	}
 
 	void HttpServiceConnection::sendResponse_ServerError()
 	{
-		SLIB_STATIC_STRING(s, "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n");
-		sendResponseAndRestart(Memory::create(s.getData(), s.getLength()));
+		SLIB_STATIC_STRING(s, "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+		_sendErrorResponse(sl_null, s, sl_true);
+	}
+
+	void HttpServiceConnection::_sendErrorResponse(HttpServiceContext* context, const String& packet, sl_bool flagClose)
+	{
+		// queued behind the pipelined responses which are not written yet
+		Ref<HttpServiceContext> contextNew;
+		if (!context) {
+			contextNew = HttpServiceContext::create(this);
+			if (contextNew.isNull()) {
+				close();
+				return;
+			}
+			context = contextNew.get();
+		}
+		if (flagClose) {
+			context->setClosingConnection(sl_true);
+			m_contextCurrent.setNull();
+		}
+		{
+			MutexLocker lock(&m_lockResponses);
+			if (flagClose) {
+				m_flagAcceptingRequests = sl_false;
+			}
+			context->m_bufferOutput.clearOutput();
+			context->m_responsePacket = Memory::create(packet.getData(), packet.getLength());
+			context->m_flagResponseCompleted = sl_true;
+			if (context->m_responsePacket.isNull() || (contextNew.isNotNull() && !(m_queueContexts.push_NoLock(contextNew)))) {
+				lock.unlock();
+				close();
+				return;
+			}
+		}
+		_writeResponses();
 	}
 
 	void HttpServiceConnection::sendConnectResponse_Successed()
@@ -481,16 +1220,16 @@ namespace slib
 		sendResponse(Memory::create(s.getData(), s.getLength()));
 	}
 
-	void HttpServiceConnection::sendConnectResponse_Failed()
+	void HttpServiceConnection::sendConnectResponse_Failed(HttpServiceContext* context)
 	{
-		SLIB_STATIC_STRING(s, "HTTP/1.1 500 Tunneling is not supported\r\n\r\n");
-		sendResponseAndClose(Memory::create(s.getData(), s.getLength()));
+		SLIB_STATIC_STRING(s, "HTTP/1.1 500 Tunneling is not supported\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+		_sendErrorResponse(context, s, sl_true);
 	}
 
-	void HttpServiceConnection::sendProxyResponse_Failed()
+	void HttpServiceConnection::sendProxyResponse_Failed(HttpServiceContext* context)
 	{
 		SLIB_STATIC_STRING(s, "HTTP/1.1 500 Internal Error\r\nContent-Length: 0\r\n\r\n");
-		sendResponseAndRestart(Memory::create(s.getData(), s.getLength()));
+		_sendErrorResponse(context, s, sl_false);
 	}
 
 /******************************************************
@@ -518,12 +1257,16 @@ namespace slib
 	class _DefaultHttpServiceConnectionProvider : public HttpServiceConnectionProvider, public IAsyncTcpServerListener
 	{
 	public:
-		Ref<AsyncTcpServer> m_server;
-		Ref<AsyncIoLoop> m_loop;
+		CList< Ref<AsyncTcpServer> > m_servers;
+		Ref<AsyncIoLoopGroup> m_loops;
+		AsyncIoLoopSelection m_selection;
+		sl_bool m_flagListenPerIoLoop;
 
 	public:
 		_DefaultHttpServiceConnectionProvider()
 		{
+			m_selection = AsyncIoLoopSelection::RoundRobin;
+			m_flagListenPerIoLoop = sl_false;
 		}
 
 		~_DefaultHttpServiceConnectionProvider()
@@ -534,21 +1277,36 @@ namespace slib
 	public:
 		static Ref<HttpServiceConnectionProvider> create(HttpService* service, const SocketAddress& addressListen)
 		{
-			Ref<AsyncIoLoop> loop = service->getAsyncIoLoop();
-			if (loop.isNotNull()) {
+			Ref<AsyncIoLoopGroup> loops = service->getAsyncIoLoopGroup();
+			if (loops.isNotNull()) {
 				Ref<_DefaultHttpServiceConnectionProvider> ret = new _DefaultHttpServiceConnectionProvider;
 				if (ret.isNotNull()) {
-					ret->m_loop = loop;
+					const HttpServiceParam& param = service->getParam();
+					ret->m_loops = loops;
+					ret->m_selection = param.ioLoopSelection;
 					ret->setService(service);
-					AsyncTcpServerParam sp;
-					sp.bindAddress = addressListen;
-					sp.listener.setWeak(ret);
-					sp.ioLoop = loop;
-					Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
-					if (server.isNotNull()) {
-						ret->m_server = server;
-						return ret;
+					sl_uint32 nListeners = 1;
+#if defined(SUPPORT_LISTEN_PER_IO_LOOP)
+					if (param.flagListenPerIoLoop && loops->getLoopsCount() > 1) {
+						// the kernel balances the incoming connections over the listeners
+						ret->m_flagListenPerIoLoop = sl_true;
+						nListeners = loops->getLoopsCount();
+					}
+#endif
+					for (sl_uint32 i = 0; i < nListeners; i++) {
+						AsyncTcpServerParam sp;
+						sp.bindAddress = addressListen;
+						sp.listener.setWeak(ret);
+						sp.ioLoop = loops->getLoop(i);
+						sp.flagReusePort = ret->m_flagListenPerIoLoop;
+						Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
+						if (server.isNull()) {
+							ret->release();
+							return sl_null;
+						}
+						ret->m_servers.add_NoLock(server);
 					}
+					return ret;
 				}
 			}
 			return sl_null;
@@ -557,8 +1315,9 @@ namespace slib
 		void release()
 		{
 			ObjectLocker lock(this);
-			if (m_server.isNotNull()) {
-				m_server->close();
+			ListElements< Ref<AsyncTcpServer> > servers(m_servers);
+			for (sl_size i = 0; i < servers.count; i++) {
+				servers[i]->close();
 			}
 		}
 
@@ -566,10 +1325,20 @@ namespace slib
 		{
 			Ref<HttpService> service = getService();
 			if (service.isNotNull()) {
-				Ref<AsyncIoLoop> loop = m_loop;
+				Ref<AsyncIoLoop> loop;
+				if (m_flagListenPerIoLoop) {
+					loop = socketListen->getIoLoop();
+				} else {
+					Ref<AsyncIoLoopGroup> loops = m_loops;
+					if (loops.isNotNull()) {
+						loop = loops->selectLoop(m_selection);
+					}
+				}
 				if (loop.isNull()) {
 					return;
 				}
+				// the header and the content are written separately; waiting for the delayed ACK would stall the keep-alive clients
+				socketAccept->setOption_TcpNoDelay(sl_true);
 				AsyncTcpSocketParam cp;
 				cp.socket = socketAccept;
 				cp.ioLoop = loop;
@@ -607,11 +1376,26 @@ namespace slib
 		maxThreadsCount = 32;
 		flagProcessByThreads = sl_true;
 		
+		ioLoopsCount = 1;
+		ioLoopSelection = AsyncIoLoopSelection::RoundRobin;
+		flagListenPerIoLoop = sl_false;
+		flagPinIoLoopsToCpus = sl_false;
+		
 		flagUseAsset = sl_false;
 		
+		flagUseFileCache = sl_false;
+		
 		maxRequestHeadersSize = 0x10000; // 64KB
 		maxRequestBodySize = 0x2000000; // 32MB
 		
+		keepAliveTimeout = 60000;
+		maxRequestsPerConnection = 0;
+		maxPipelinedRequests = 16;
+		
+		flagCompressResponse = sl_false;
+		minCompressResponseSize = 1024;
+		compressResponseLevel = 6;
+		
 		flagAllowCrossOrigin = sl_false;
 		flagAlwaysRespondAcceptRangesHeader = sl_true;
 		
@@ -639,15 +1423,22 @@ namespace slib
 
 	sl_bool HttpService::_init(const HttpServiceParam& param)
 	{
-		Ref<AsyncIoLoop> ioLoop = AsyncIoLoop::create(sl_false);
-		if (ioLoop.isNotNull()) {
+		Ref<AsyncIoLoopGroup> ioLoops = AsyncIoLoopGroup::create(param.ioLoopsCount, sl_false);
+		if (ioLoops.isNotNull()) {
+			if (param.flagPinIoLoopsToCpus) {
+				ioLoops->pinLoopsToCpus();
+			}
 			Ref<ThreadPool> threadPool = ThreadPool::create();
 			if (threadPool.isNotNull()) {
 				threadPool->setMaximumThreadsCount(param.maxThreadsCount);
 				
-				m_ioLoop = ioLoop;
+				m_ioLoopGroup = ioLoops;
+				m_ioLoop = ioLoops->getLoop(0);
 				m_threadPool = threadPool;
 				m_param = param;
+				if (param.flagUseFileCache) {
+					m_fileCache = HttpFileCache::create(param.fileCacheParam);
+				}
 				if (param.port) {
 					if (! (addHttpService(param.addressBind, param.port))) {
 						return sl_false;
@@ -657,7 +1448,7 @@ namespace slib
 					addProcessor(param.processor);
 				}
 				
-				ioLoop->start();
+				ioLoops->start();
 
 				return sl_true;
 			}
@@ -694,18 +1485,22 @@ namespace slib
 		}
 		m_connectionProviders.removeAll();
 		
-		Ref<AsyncIoLoop> ioLoop = m_ioLoop;
-		if (ioLoop.isNotNull()) {
-			ioLoop->release();
-			m_ioLoop.setNull();
+		Ref<AsyncIoLoopGroup> ioLoops = m_ioLoopGroup;
+		if (ioLoops.isNotNull()) {
+			ioLoops->release();
+			m_ioLoopGroup.setNull();
 		}
+		m_ioLoop.setNull();
 		Ref<ThreadPool> threadPool = m_threadPool;
 		if (threadPool.isNotNull()) {
 			threadPool->release();
 			m_threadPool.setNull();
 		}
 		
+		// the connections remove themselves from the map when they are destroyed
+		List< Ref<HttpServiceConnection> > connections = m_connections.getAllValues();
 		m_connections.removeAll();
+		connections.setNull();
 	}
 
 	sl_bool HttpService::isRunning()
@@ -718,6 +1513,11 @@ namespace slib
 		return m_ioLoop;
 	}
 
+	Ref<AsyncIoLoopGroup> HttpService::getAsyncIoLoopGroup()
+	{
+		return m_ioLoopGroup;
+	}
+
 	Ref<ThreadPool> HttpService::getThreadPool()
 	{
 		return m_threadPool;
@@ -829,15 +1629,84 @@ namespace slib
 		return sl_false;
 	}
 
+	static sl_bool _HttpService_matchETag(const String& header, const String& etag)
+	{
+		if (header.isEmpty() || etag.isEmpty()) {
+			return sl_false;
+		}
+		if (header.trim() == "*") {
+			return sl_true;
+		}
+		// weak comparison (RFC 7232)
+		ListElements<String> tags(header.split(","));
+		for (sl_size i = 0; i < tags.count; i++) {
+			String tag = tags[i].trim();
+			if (tag.startsWith("W/")) {
+				tag = tag.substring(2);
+			}
+			if (tag == etag) {
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	// sets Last-Modified, and responds 304 by If-None-Match (when `etag` is given) or If-Modified-Since (RFC 7232)
+	static sl_bool _HttpService_checkNotModified(const Ref<HttpServiceContext>& context, const String* etag, const Time& timeModified)
+	{
+		sl_bool flagValidTime = timeModified.toInt() > 0;
+		if (flagValidTime) {
+			context->setResponseHeader(HttpHeaders::LastModified, HttpHeaders::formatDate(timeModified));
+		}
+		String ifNoneMatch = context->getRequestHeader(HttpHeaders::IfNoneMatch);
+		if (ifNoneMatch.isNotEmpty()) {
+			if (etag && _HttpService_matchETag(ifNoneMatch, *etag)) {
+				context->setResponseCode(HttpStatus::NotModified);
+				return sl_true;
+			}
+			// If-Modified-Since is ignored when If-None-Match is present
+			return sl_false;
+		}
+		if (flagValidTime) {
+			String ifModifiedSince = context->getRequestHeader(HttpHeaders::IfModifiedSince);
+			Time time;
+			if (ifModifiedSince.isNotEmpty() && HttpHeaders::parseDate(ifModifiedSince, &time)) {
+				// one second resolution
+				if (timeModified.toInt() / 1000000 <= time.toInt() / 1000000) {
+					context->setResponseCode(HttpStatus::NotModified);
+					return sl_true;
+				}
+			}
+		}
+		return sl_false;
+	}
+
 	sl_bool HttpService::processFile(const Ref<HttpServiceContext>& context, const String& path)
 	{
 		if (context->getMethod() != HttpMethod::GET) {
 			return sl_false;
 		}
 
-		if (File::exists(path) && !(File::isDirectory(path))) {
+		sl_uint64 totalSize = 0;
+		Time timeModified;
+		if (m_fileCache.isNotNull()) {
+			Ref<HttpFileCacheEntry> entry = m_fileCache->get(path, &totalSize, &timeModified);
+			if (entry.isNotNull()) {
+				return processCachedFile(context, entry);
+			}
+		}
+
+		// `totalSize` is known when the cache remembers the file as too big
+		if (totalSize || (File::exists(path) && !(File::isDirectory(path)))) {
 
-			sl_uint64 totalSize = File::getSize(path);
+			if (!totalSize) {
+				totalSize = File::getSize(path);
+				timeModified = File::getModifiedTime(path);
+			}
+			
+			if (_HttpService_checkNotModified(context, sl_null, timeModified)) {
+				return sl_true;
+			}
 
 			String ext = File::getFileExtension(path);
 			
@@ -861,10 +1730,9 @@ namespace slib
 				
 				if (processRangeRequest(context, totalSize, rangeHeader, start, len)) {
 
-					Ref<AsyncFile> file = AsyncFile::openForRead(path, m_threadPool);
+					Ref<File> file = File::openForRead(path);
 					if (file.isNotNull()) {
-						file->seek(start);
-						context->copyFrom(file.get(), len);
+						context->sendFile(file, start, len);
 						return sl_true;
 					}
 					
@@ -874,8 +1742,11 @@ namespace slib
 				
 			} else {
 				if (totalSize > 100000) {
-					context->copyFromFile(path, m_threadPool);
-					return sl_true;
+					Ref<File> file = File::openForRead(path);
+					if (file.isNotNull()) {
+						context->sendFile(file, 0, totalSize);
+						return sl_true;
+					}
 				} else {
 					Memory mem = File::readAllBytes(path);
 					if (mem.isNotEmpty()) {
@@ -891,6 +1762,57 @@ namespace slib
 		
 	}
 
+	sl_bool HttpService::processCachedFile(const Ref<HttpServiceContext>& context, const Ref<HttpFileCacheEntry>& entry)
+	{
+		if (context->getResponseContentType().isEmpty()) {
+			ContentType contentType = ContentTypes::getFromFileExtension(File::getFileExtension(entry->path));
+			if (contentType == ContentType::Unknown) {
+				contentType = ContentType::OctetStream;
+			}
+			context->setResponseContentType(contentType);
+		}
+		context->setResponseAcceptRanges(sl_true);
+		
+		String rangeHeader = context->getRequestRange();
+		
+		// ranges are served from the identity content
+		sl_bool flagGzip = sl_false;
+		if (entry->contentGzip.isNotNull()) {
+			context->setResponseHeader(HttpHeaders::Vary, HttpHeaders::AcceptEncoding);
+			if (rangeHeader.isEmpty() && _HttpService_acceptsGzip(context->getRequestHeader(HttpHeaders::AcceptEncoding))) {
+				flagGzip = sl_true;
+			}
+		}
+		const String& etag = flagGzip ? entry->etagGzip : entry->etag;
+		context->setResponseHeader(HttpHeaders::ETag, etag);
+		
+		if (_HttpService_checkNotModified(context, &etag, entry->timeModified)) {
+			return sl_true;
+		}
+		
+		if (rangeHeader.isNotEmpty()) {
+			sl_uint64 start;
+			sl_uint64 len;
+			if (processRangeRequest(context, entry->content.getSize(), rangeHeader, start, len)) {
+				context->write(entry->content.sub((sl_size)start, (sl_size)len));
+			}
+			return sl_true;
+		}
+		
+		if (flagGzip) {
+			context->setResponseContentEncoding("gzip");
+			context->write(entry->contentGzip);
+		} else {
+			context->write(entry->content);
+		}
+		return sl_true;
+	}
+
+	Ref<HttpFileCache> HttpService::getFileCache()
+	{
+		return m_fileCache;
+	}
+
 	sl_bool HttpService::processRangeRequest(const Ref<HttpServiceContext>& context, sl_uint64 totalLength, const String& range, sl_uint64& outStart, sl_uint64& outLength)
 	{
 		if (range.getLength() < 2 || !(range.startsWith("bytes="))) {
@@ -918,18 +1840,17 @@ namespace slib
 				return sl_false;
 			}
 		}
-		if (indexSplit == 0) {
+		if (s1.isEmpty()) {
+			// suffix range: last n2 bytes
 			if (n2 == 0) {
 				context->setResponseCode(HttpStatus::NoContent);
 				return sl_false;
 			}
 			if (n2 > totalLength) {
-				context->setResponseCode(HttpStatus::RequestRangeNotSatisfiable);
-				context->setResponseContentRangeUnsatisfied(totalLength);
-				return sl_false;
+				n2 = totalLength;
 			}
 			outStart = totalLength - n2;
-			outLength = totalLength - 1;
+			outLength = n2;
 		} else {
 			if (n1 >= totalLength) {
 				context->setResponseCode(HttpStatus::RequestRangeNotSatisfiable);
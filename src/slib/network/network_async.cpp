@@ -23,6 +23,9 @@ namespace slib
 	{
 		m_flagRequestConnect = sl_false;
 		m_flagSupportingConnect = sl_true;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		m_flagUsingUring = sl_false;
+#endif
 	}
 
 	AsyncTcpSocketInstance::~AsyncTcpSocketInstance()
@@ -46,6 +49,13 @@ namespace slib
 		return sl_true;
 	}
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	void AsyncTcpSocketInstance::setUsingUring(sl_bool flag)
+	{
+		m_flagUsingUring = flag;
+	}
+#endif
+
 	void AsyncTcpSocketInstance::_onReceive(AsyncStreamRequest* req, sl_uint32 size, sl_bool flagError)
 	{
 		Ref<AsyncTcpSocket> object = Ref<AsyncTcpSocket>::from(getObject());
@@ -140,9 +150,16 @@ namespace slib
 					return sl_null;
 				}
 			}
+			AsyncIoMode mode = AsyncIoMode::InOut;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			if (loop->isUringEnabled()) {
+				instance->setUsingUring(sl_true);
+				mode = AsyncIoMode::None;
+			}
+#endif
 			Ref<AsyncTcpSocket> ret = new AsyncTcpSocket;
 			if (ret.isNotNull()) {
-				if (ret->_initialize(instance.get(), AsyncIoMode::InOut, loop)) {
+				if (ret->_initialize(instance.get(), mode, loop)) {
 					ret->m_listener = param.listener;
 					ret->m_onConnect = param.onConnect;
 					ret->m_onError = param.onError;
@@ -346,6 +363,7 @@ namespace slib
 		
 		flagAutoStart = sl_true;
 		flagLogError = sl_true;
+		flagReusePort = sl_false;
 	}
 
 	AsyncTcpServerParam::~AsyncTcpServerParam()
@@ -391,6 +409,14 @@ namespace slib
 			 */
 			socket->setOption_ReuseAddress(sl_true);
 #endif
+			if (param.flagReusePort) {
+				if (!(socket->setOption_ReusePort(sl_true))) {
+					if (param.flagLogError) {
+						LogError(TAG, "AsyncTcpServer failed to set SO_REUSEPORT: %s", socket->getLastErrorMessage());
+					}
+					return sl_null;
+				}
+			}
 
 			if (!(socket->bind(param.bindAddress))) {
 				if (param.flagLogError) {
@@ -502,6 +528,7 @@ namespace slib
 	AsyncUdpSocketInstance::AsyncUdpSocketInstance()
 	{
 		m_flagRunning = sl_false;
+		m_batchCount = 1;
 	}
 
 	AsyncUdpSocketInstance::~AsyncUdpSocketInstance()
@@ -535,13 +562,14 @@ namespace slib
 
 #define UDP_QUEUE_MAX_SIZE 1024000
 
-	sl_bool AsyncUdpSocketInstance::sendTo(const SocketAddress& addressTo, const Memory& data)
+	sl_bool AsyncUdpSocketInstance::sendTo(const SocketAddress& addressTo, const Memory& data, sl_uint32 segmentSize)
 	{
 		if (isOpened()) {
 			if (data.isNotEmpty()) {
 				SendRequest request;
 				request.addressTo = addressTo;
 				request.data = data;
+				request.segmentSize = segmentSize;
 				if (m_queueSendRequests.getCount() < UDP_QUEUE_MAX_SIZE) {
 					if (m_queueSendRequests.push(request)) {
 						return sl_true;
@@ -553,10 +581,56 @@ namespace slib
 	}
 
 	void AsyncUdpSocketInstance::_onReceive(const SocketAddress& address, sl_uint32 size)
+	{
+		SocketDatagram datagram;
+		datagram.address = address;
+		datagram.data = m_buffer.getData();
+		datagram.size = size;
+		_onReceive(&datagram, 1);
+	}
+
+	void AsyncUdpSocketInstance::_onReceive(SocketDatagram* datagrams, sl_uint32 count)
 	{
 		Ref<AsyncUdpSocket> object = Ref<AsyncUdpSocket>::from(getObject());
-		if (object.isNotNull()) {
-			object->_onReceive(address, m_buffer.getData(), size);
+		if (object.isNull()) {
+			return;
+		}
+		sl_uint32 i;
+		for (i = 0; i < count; i++) {
+			if (datagrams[i].segmentSize) {
+				break;
+			}
+		}
+		if (i == count) {
+			object->_onReceive(datagrams, count);
+			return;
+		}
+		SocketDatagram split[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+		sl_uint32 n = 0;
+		for (i = 0; i < count; i++) {
+			SocketDatagram& datagram = datagrams[i];
+			sl_uint32 segmentSize = datagram.segmentSize;
+			if (segmentSize == 0) {
+				segmentSize = datagram.size;
+			}
+			for (sl_uint32 offset = 0; offset < datagram.size; offset += segmentSize) {
+				if (n == SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT) {
+					object->_onReceive(split, n);
+					n = 0;
+				}
+				SocketDatagram& item = split[n];
+				item.address = datagram.address;
+				item.data = (sl_uint8*)(datagram.data) + offset;
+				item.size = datagram.size - offset;
+				if (item.size > segmentSize) {
+					item.size = segmentSize;
+				}
+				item.segmentSize = 0;
+				n++;
+			}
+		}
+		if (n) {
+			object->_onReceive(split, n);
 		}
 	}
 
@@ -569,6 +643,13 @@ namespace slib
 	{
 	}
 
+	void IAsyncUdpSocketListener::onReceiveBatch(AsyncUdpSocket* socket, SocketDatagram* datagrams, sl_uint32 count)
+	{
+		for (sl_uint32 i = 0; i < count; i++) {
+			onReceiveFrom(socket, datagrams[i].address, datagrams[i].data, datagrams[i].size);
+		}
+	}
+
 	AsyncUdpSocketParam::AsyncUdpSocketParam()
 	{
 		flagIPv6 = sl_false;
@@ -576,6 +657,8 @@ namespace slib
 		flagAutoStart = sl_false;
 		flagLogError = sl_false;
 		packetSize = 65536;
+		batchCount = 1;
+		flagGro = sl_false;
 	}
 
 	AsyncUdpSocketParam::~AsyncUdpSocketParam()
@@ -635,7 +718,24 @@ namespace slib
 			socket->setOption_Broadcast(sl_true);
 		}
 		
-		Ref<AsyncUdpSocketInstance> instance = _createInstance(socket, param.packetSize);
+		sl_uint32 packetSize = param.packetSize;
+		if (param.flagGro) {
+			if (socket->setOption_UdpGro(sl_true)) {
+				// the coalesced datagrams are truncated by a smaller buffer
+				if (packetSize < 65536) {
+					packetSize = 65536;
+				}
+			}
+		}
+		sl_uint32 batchCount = param.batchCount;
+		if (batchCount < 1) {
+			batchCount = 1;
+		}
+		if (batchCount > SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT) {
+			batchCount = SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT;
+		}
+		
+		Ref<AsyncUdpSocketInstance> instance = _createInstance(socket, packetSize, batchCount);
 		if (instance.isNotNull()) {
 			Ref<AsyncIoLoop> loop = param.ioLoop;
 			if (loop.isNull()) {
@@ -648,6 +748,7 @@ namespace slib
 			if (ret.isNotNull()) {
 				ret->m_listener = param.listener;
 				ret->m_onReceiveFrom = param.onReceiveFrom;
+				ret->m_onReceiveBatch = param.onReceiveBatch;
 				instance->setObject(ret.get());
 				ret->setIoInstance(instance.get());
 				ret->setIoLoop(loop);
@@ -729,6 +830,11 @@ namespace slib
 	}
 
 	sl_bool AsyncUdpSocket::sendTo(const SocketAddress& addressTo, const Memory& mem)
+	{
+		return sendSegments(addressTo, mem, 0);
+	}
+
+	sl_bool AsyncUdpSocket::sendSegments(const SocketAddress& addressTo, const Memory& mem, sl_uint32 segmentSize)
 	{
 		Ref<AsyncIoLoop> loop = getIoLoop();
 		if (loop.isNull()) {
@@ -736,7 +842,7 @@ namespace slib
 		}
 		Ref<AsyncUdpSocketInstance> instance = _getIoInstance();
 		if (instance.isNotNull()) {
-			if (instance->sendTo(addressTo, mem)) {
+			if (instance->sendTo(addressTo, mem, segmentSize)) {
 				loop->requestOrder(instance.get());
 				return sl_true;
 			}
@@ -749,13 +855,18 @@ namespace slib
 		return Ref<AsyncUdpSocketInstance>::from(AsyncIoObject::getIoInstance());
 	}
 
-	void AsyncUdpSocket::_onReceive(const SocketAddress& address, void* data, sl_uint32 sizeReceived)
+	void AsyncUdpSocket::_onReceive(SocketDatagram* datagrams, sl_uint32 count)
 	{
 		PtrLocker<IAsyncUdpSocketListener> listener(m_listener);
 		if (listener.isNotNull()) {
-			listener->onReceiveFrom(this, address, data, sizeReceived);
+			listener->onReceiveBatch(this, datagrams, count);
+		}
+		m_onReceiveBatch(this, datagrams, count);
+		if (m_onReceiveFrom.isNotNull()) {
+			for (sl_uint32 i = 0; i < count; i++) {
+				m_onReceiveFrom(this, datagrams[i].address, datagrams[i].data, datagrams[i].size);
+			}
 		}
-		m_onReceiveFrom(this, address, data, sizeReceived);
 	}
 
 }
@@ -37,6 +37,11 @@ namespace slib
 	public:
 		sl_bool connect(const SocketAddress& address);
 		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// transfers are completed on the io_uring of the loop, instead of waiting the readiness on epoll
+		void setUsingUring(sl_bool flag);
+#endif
+		
 	protected:
 		void _onReceive(AsyncStreamRequest* req, sl_uint32 size, sl_bool flagError);
 		
@@ -51,6 +56,10 @@ namespace slib
 		sl_bool m_flagRequestConnect;
 		SocketAddress m_addressRequestConnect;
 		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		sl_bool m_flagUsingUring;
+#endif
+		
 	};
 
 	class SLIB_EXPORT AsyncTcpServerInstance : public AsyncIoInstance
@@ -97,21 +106,27 @@ namespace slib
 		
 		Ref<Socket> getSocket();
 		
-		sl_bool sendTo(const SocketAddress& address, const Memory& data);
+		sl_bool sendTo(const SocketAddress& address, const Memory& data, sl_uint32 segmentSize = 0);
 		
 	protected:
 		void _onReceive(const SocketAddress& address, sl_uint32 size);
 		
+		// splits the datagrams coalesced by GRO
+		void _onReceive(SocketDatagram* datagrams, sl_uint32 count);
+		
 	protected:
 		AtomicRef<Socket> m_socket;
 
 		sl_bool m_flagRunning;
 		Memory m_buffer;
+		// `m_buffer` is divided to `m_batchCount` packets
+		sl_uint32 m_batchCount;
 		
 		struct SendRequest
 		{
 			SocketAddress addressTo;
 			Memory data;
+			sl_uint32 segmentSize;
 		};
 		LinkedQueue<SendRequest> m_queueSendRequests;
 		
@@ -14,6 +14,12 @@
 
 #include "network_async.h"
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+#include <poll.h>
+#include <errno.h>
+#include <sys/sendfile.h>
+#endif
+
 namespace slib
 {
 
@@ -26,11 +32,20 @@ namespace slib
 		
 		sl_bool m_flagConnecting;
 		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		sl_bool m_flagUringReading;
+		sl_bool m_flagUringWriting;
+#endif
+		
 	public:
 		_Unix_AsyncTcpSocketInstance()
 		{
 			m_sizeWritten = 0;
 			m_flagConnecting = sl_false;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			m_flagUringReading = sl_false;
+			m_flagUringWriting = sl_false;
+#endif
 		}
 		
 		~_Unix_AsyncTcpSocketInstance()
@@ -60,6 +75,15 @@ namespace slib
 		
 		void close()
 		{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			if (m_flagUringReading || m_flagUringWriting || m_flagConnecting) {
+				// completes the pending operations of the ring, which are holding the socket file
+				Ref<Socket> socket = m_socket;
+				if (socket.isNotNull()) {
+					socket->shutdown(SocketShutdownMode::Both);
+				}
+			}
+#endif
 			setHandle(SLIB_FILE_INVALID_HANDLE);
 			m_socket.setNull();
 		}
@@ -126,8 +150,7 @@ namespace slib
 						return;
 					}
 				}
-				sl_uint32 size = request->size - m_sizeWritten;
-				sl_int32 n = socket->send((char*)(request->data) + m_sizeWritten, size);
+				sl_int32 n = _send(socket.get(), request.get());
 				if (n > 0) {
 					m_sizeWritten += n;
 					if (m_sizeWritten >= request->size) {
@@ -150,6 +173,75 @@ namespace slib
 			}
 		}
 		
+		// same as Socket::send(): 0 when the socket would block
+		sl_int32 _send(Socket* socket, AsyncStreamRequest* request)
+		{
+			if (request->queue.isNotNull()) {
+				return _sendVector(socket, request);
+			}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			if (request->file.isNotNull()) {
+				return _sendFile(request);
+			}
+#endif
+			return socket->send((char*)(request->data) + m_sizeWritten, request->size - m_sizeWritten);
+		}
+		
+		sl_bool writev(MemoryQueue& queue, const Function<void(AsyncStreamResult*)>& callback) override
+		{
+			Ref<AsyncStreamRequest> req = AsyncStreamRequest::createWriteVector(queue, callback);
+			if (req.isNotNull()) {
+				return addWriteRequest(req);
+			}
+			return sl_false;
+		}
+		
+		// the sent bytes are removed from the queue of the request, so a partial write is resumed from the front
+		sl_int32 _sendVector(Socket* socket, AsyncStreamRequest* request)
+		{
+			MemoryQueue* queue = request->queue.get();
+			MemoryData chunks[SLIB_SOCKET_SEND_VECTOR_MAX_COUNT];
+			sl_uint32 nChunks = queue->getChunks_NoLock(chunks, SLIB_SOCKET_SEND_VECTOR_MAX_COUNT);
+			sl_int32 n = socket->sendVector(chunks, nChunks);
+			if (n > 0) {
+				queue->skip_NoLock(n);
+			}
+			return n;
+		}
+		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback) override
+		{
+			if (size == 0 || file.isNull()) {
+				return sl_false;
+			}
+			Ref<AsyncStreamRequest> req = AsyncStreamRequest::createSendFile(file, offset, size, callback);
+			if (req.isNotNull()) {
+				return addWriteRequest(req);
+			}
+			return sl_false;
+		}
+		
+		// same as Socket::send(): 0 when the socket would block
+		sl_int32 _sendFile(AsyncStreamRequest* request)
+		{
+			sl_file handle = getHandle();
+			if (handle == SLIB_FILE_INVALID_HANDLE) {
+				return -1;
+			}
+			off_t offset = (off_t)(request->offsetFile + m_sizeWritten);
+			ssize_t n = ::sendfile((int)handle, (int)(request->file->getHandle()), &offset, request->size - m_sizeWritten);
+			if (n > 0) {
+				return (sl_int32)n;
+			}
+			if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+				return 0;
+			}
+			// error, or the file is shorter than the request
+			return -1;
+		}
+#endif
+		
 		void onOrder()
 		{
 			Ref<Socket> socket = m_socket;
@@ -163,15 +255,235 @@ namespace slib
 				m_flagRequestConnect = sl_false;
 				if (socket->connect(m_addressRequestConnect)) {
 					m_flagConnecting = sl_true;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+					if (m_flagUsingUring) {
+						Ref<AsyncIoLoop> loop = getLoop();
+						if (loop.isNull() || !(loop->submitUringPoll(getHandle(), POLLOUT, SLIB_BIND_WEAKREF(void(sl_int32), _Unix_AsyncTcpSocketInstance, _onUringConnect, this)))) {
+							m_flagConnecting = sl_false;
+							_onConnect(sl_true);
+						}
+					}
+#endif
 				} else {
 					_onConnect(sl_true);
 				}
 				return;
 			}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			if (m_flagUsingUring) {
+				processUringRead();
+				processUringWrite();
+				return;
+			}
+#endif
 			processRead(sl_false);
 			processWrite(sl_false);
 		}
 		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		void processUringRead()
+		{
+			if (m_flagUringReading) {
+				return;
+			}
+			Ref<AsyncStreamRequest> request;
+			if (popReadRequest(request)) {
+				if (request.isNotNull()) {
+					_submitUringRead(request);
+				}
+			}
+		}
+		
+		void _submitUringRead(const Ref<AsyncStreamRequest>& request)
+		{
+			Ref<AsyncIoLoop> loop = getLoop();
+			m_flagUringReading = sl_true;
+			if (loop.isNull() || !(loop->submitUringRead(getHandle(), request->data, request->size, -1, SLIB_BIND_WEAKREF(void(sl_int32), _Unix_AsyncTcpSocketInstance, _onUringRead, this, request)))) {
+				m_flagUringReading = sl_false;
+				_onReceive(request.get(), 0, sl_true);
+			}
+		}
+		
+		// the socket is non-blocking, so the operation can complete with -EAGAIN: waits on a ring poll and submits again
+		static sl_bool _isUringRetry(sl_int32 result)
+		{
+			return result == -EAGAIN || result == -EWOULDBLOCK || result == -EINTR;
+		}
+		
+		void _waitUringRead(const Ref<AsyncStreamRequest>& request)
+		{
+			Ref<AsyncIoLoop> loop = getLoop();
+			m_flagUringReading = sl_true;
+			if (loop.isNull() || !(loop->submitUringPoll(getHandle(), POLLIN, SLIB_BIND_WEAKREF(void(sl_int32), _Unix_AsyncTcpSocketInstance, _onUringReadReady, this, request)))) {
+				m_flagUringReading = sl_false;
+				_onReceive(request.get(), 0, sl_true);
+			}
+		}
+		
+		void _onUringReadReady(const Ref<AsyncStreamRequest>& request, sl_int32 result)
+		{
+			m_flagUringReading = sl_false;
+			if (getHandle() == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (result < 0 && !(_isUringRetry(result))) {
+				_onReceive(request.get(), 0, sl_true);
+			} else {
+				// POLLERR, POLLHUP: the read reports the error or the end of the stream
+				_submitUringRead(request);
+				return;
+			}
+			requestOrder();
+		}
+		
+		void processUringWrite()
+		{
+			if (m_flagUringWriting) {
+				return;
+			}
+			Ref<AsyncStreamRequest> request;
+			if (popWriteRequest(request)) {
+				if (request.isNotNull()) {
+					m_sizeWritten = 0;
+					if (request->file.isNotNull() || request->queue.isNotNull()) {
+						_processUringSendDirect(request);
+					} else {
+						_submitUringWrite(request);
+					}
+				}
+			}
+		}
+		
+		// io_uring has no sendfile operation (and the chunks of writev are not pinned): sends directly, and waits on a ring poll while the socket buffer is full
+		void _processUringSendDirect(const Ref<AsyncStreamRequest>& request)
+		{
+			Ref<Socket> socket = m_socket;
+			if (socket.isNull()) {
+				_onSend(request.get(), m_sizeWritten, sl_true);
+				return;
+			}
+			while (m_sizeWritten < request->size) {
+				sl_int32 n = _send(socket.get(), request.get());
+				if (n > 0) {
+					m_sizeWritten += n;
+				} else if (n == 0) {
+					Ref<AsyncIoLoop> loop = getLoop();
+					m_flagUringWriting = sl_true;
+					if (loop.isNull() || !(loop->submitUringPoll(getHandle(), POLLOUT, SLIB_BIND_WEAKREF(void(sl_int32), _Unix_AsyncTcpSocketInstance, _onUringSendDirectReady, this, request)))) {
+						m_flagUringWriting = sl_false;
+						_onSend(request.get(), m_sizeWritten, sl_true);
+					}
+					return;
+				} else {
+					_onSend(request.get(), m_sizeWritten, sl_true);
+					return;
+				}
+			}
+			_onSend(request.get(), request->size, sl_false);
+		}
+		
+		void _onUringSendDirectReady(const Ref<AsyncStreamRequest>& request, sl_int32 result)
+		{
+			m_flagUringWriting = sl_false;
+			if (getHandle() == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (result < 0 || (result & POLLERR)) {
+				_onSend(request.get(), m_sizeWritten, sl_true);
+			} else {
+				_processUringSendDirect(request);
+			}
+			requestOrder();
+		}
+		
+		void _submitUringWrite(const Ref<AsyncStreamRequest>& request)
+		{
+			Ref<AsyncIoLoop> loop = getLoop();
+			m_flagUringWriting = sl_true;
+			if (loop.isNull() || !(loop->submitUringWrite(getHandle(), (char*)(request->data) + m_sizeWritten, request->size - m_sizeWritten, -1, SLIB_BIND_WEAKREF(void(sl_int32), _Unix_AsyncTcpSocketInstance, _onUringWrite, this, request)))) {
+				m_flagUringWriting = sl_false;
+				_onSend(request.get(), m_sizeWritten, sl_true);
+			}
+		}
+		
+		void _onUringRead(const Ref<AsyncStreamRequest>& request, sl_int32 result)
+		{
+			m_flagUringReading = sl_false;
+			if (getHandle() == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (result > 0) {
+				_onReceive(request.get(), result, sl_false);
+			} else if (_isUringRetry(result)) {
+				_waitUringRead(request);
+				return;
+			} else {
+				// 0: closed by the peer
+				_onReceive(request.get(), 0, sl_true);
+			}
+			requestOrder();
+		}
+		
+		void _onUringWrite(const Ref<AsyncStreamRequest>& request, sl_int32 result)
+		{
+			m_flagUringWriting = sl_false;
+			if (getHandle() == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (result > 0) {
+				m_sizeWritten += result;
+				if (m_sizeWritten >= request->size) {
+					_onSend(request.get(), request->size, sl_false);
+				} else {
+					_submitUringWrite(request);
+					return;
+				}
+			} else if (_isUringRetry(result)) {
+				Ref<AsyncIoLoop> loop = getLoop();
+				m_flagUringWriting = sl_true;
+				if (loop.isNull() || !(loop->submitUringPoll(getHandle(), POLLOUT, SLIB_BIND_WEAKREF(void(sl_int32), _Unix_AsyncTcpSocketInstance, _onUringWriteReady, this, request)))) {
+					m_flagUringWriting = sl_false;
+					_onSend(request.get(), m_sizeWritten, sl_true);
+				} else {
+					return;
+				}
+			} else {
+				_onSend(request.get(), m_sizeWritten, sl_true);
+			}
+			requestOrder();
+		}
+		
+		void _onUringWriteReady(const Ref<AsyncStreamRequest>& request, sl_int32 result)
+		{
+			m_flagUringWriting = sl_false;
+			if (getHandle() == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (result < 0 && !(_isUringRetry(result))) {
+				_onSend(request.get(), m_sizeWritten, sl_true);
+			} else {
+				// POLLERR: the write reports the error
+				_submitUringWrite(request);
+				return;
+			}
+			requestOrder();
+		}
+		
+		void _onUringConnect(sl_int32 result)
+		{
+			m_flagConnecting = sl_false;
+			if (getHandle() == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (result < 0 || (result & (POLLERR | POLLHUP))) {
+				_onConnect(sl_true);
+			} else {
+				_onConnect(sl_false);
+			}
+			requestOrder();
+		}
+#endif
+		
 		void onEvent(EventDesc* pev)
 		{
 			sl_bool flagProcessed = sl_false;
@@ -292,6 +604,9 @@ namespace slib
 		return _Unix_AsyncTcpServerInstance::create(socket);
 	}
 
+// milliseconds
+#define UDP_SEND_RETRY_DELAY 1
+
 	class _Unix_AsyncUdpSocketInstance : public AsyncUdpSocketInstance
 	{
 	public:
@@ -305,7 +620,7 @@ namespace slib
 		}
 		
 	public:
-		static Ref<_Unix_AsyncUdpSocketInstance> create(const Ref<Socket>& socket, const Memory& buffer)
+		static Ref<_Unix_AsyncUdpSocketInstance> create(const Ref<Socket>& socket, const Memory& buffer, sl_uint32 batchCount)
 		{
 			Ref<_Unix_AsyncUdpSocketInstance> ret;
 			if (socket.isNotNull()) {
@@ -317,6 +632,7 @@ namespace slib
 							ret->m_socket = socket;
 							ret->setHandle(handle);
 							ret->m_buffer = buffer;
+							ret->m_batchCount = batchCount;
 							return ret;
 						}
 					}
@@ -354,16 +670,55 @@ namespace slib
 			if (!(socket->isOpened())) {
 				return;
 			}
+			SendRequest requests[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			SocketDatagram datagrams[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
 			while (Thread::isNotStoppingCurrent()) {
-				SendRequest request;
-				if (m_queueSendRequests.pop(&request)) {
-					socket->sendTo(request.addressTo, request.data.getData(), (sl_uint32)(request.data.getSize()));
-				} else {
+				sl_uint32 n = 0;
+				while (n < m_batchCount && m_queueSendRequests.pop(requests + n)) {
+					SocketDatagram& datagram = datagrams[n];
+					datagram.address = requests[n].addressTo;
+					datagram.data = requests[n].data.getData();
+					datagram.size = (sl_uint32)(requests[n].data.getSize());
+					datagram.segmentSize = requests[n].segmentSize;
+					n++;
+				}
+				if (!n) {
 					break;
 				}
+				sl_uint32 k = 0;
+				while (k < n) {
+					sl_int32 m = socket->sendToBatch(datagrams + k, n - k);
+					if (m > 0) {
+						k += m;
+					} else if (!m) {
+						// the send buffer is full: the rest is kept in order, and sent later
+						break;
+					} else {
+						// the datagram can never be sent (invalid address or too large), same as the unbatched `sendTo()`
+						k++;
+					}
+				}
+				if (k < n) {
+					for (sl_uint32 i = n; i > k; i--) {
+						m_queueSendRequests.pushFront(requests[i - 1]);
+					}
+					Ref<AsyncIoLoop> loop = getLoop();
+					if (loop.isNotNull()) {
+						loop->setTimeout(SLIB_FUNCTION_WEAKREF(_Unix_AsyncUdpSocketInstance, onRetrySend, this), UDP_SEND_RETRY_DELAY);
+					}
+					return;
+				}
+				for (k = 0; k < n; k++) {
+					requests[k].data.setNull();
+				}
 			}
 		}
 		
+		void onRetrySend()
+		{
+			requestOrder();
+		}
+		
 		void processReceive()
 		{
 			Ref<Socket> socket = m_socket;
@@ -373,13 +728,19 @@ namespace slib
 			if (!(socket->isOpened())) {
 				return;
 			}
-			void* buf = m_buffer.getData();
-			sl_uint32 sizeBuf = (sl_uint32)(m_buffer.getSize());
+			sl_uint8* buf = (sl_uint8*)(m_buffer.getData());
+			sl_uint32 nBatch = m_batchCount;
+			sl_uint32 sizePacket = (sl_uint32)(m_buffer.getSize() / nBatch);
+			SocketDatagram datagrams[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
 			while (Thread::isNotStoppingCurrent()) {
-				SocketAddress addr;
-				sl_int32 n = socket->receiveFrom(addr, buf, sizeBuf);
+				for (sl_uint32 i = 0; i < nBatch; i++) {
+					datagrams[i].data = buf + i * sizePacket;
+					datagrams[i].size = sizePacket;
+				}
+				// also receives the segment size of UDP GRO
+				sl_int32 n = socket->receiveFromBatch(datagrams, nBatch);
 				if (n > 0) {
-					_onReceive(addr, n);
+					_onReceive(datagrams, n);
 				} else {
 					break;
 				}
@@ -388,11 +749,11 @@ namespace slib
 
 	};
 
-	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(const Ref<Socket>& socket, sl_uint32 packetSize)
+	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(const Ref<Socket>& socket, sl_uint32 packetSize, sl_uint32 batchCount)
 	{
-		Memory buffer = Memory::create(packetSize);
+		Memory buffer = Memory::create((sl_size)packetSize * batchCount);
 		if (buffer.isNotEmpty()) {
-			return _Unix_AsyncUdpSocketInstance::create(socket, buffer);
+			return _Unix_AsyncUdpSocketInstance::create(socket, buffer, batchCount);
 		}
 		return sl_null;
 	}
@@ -545,7 +545,13 @@ namespace slib
 			while (Thread::isNotStoppingCurrent()) {
 				SendRequest request;
 				if (m_queueSendRequests.pop(&request)) {
-					socket->sendTo(request.addressTo, request.data.getData(), (sl_uint32)(request.data.getSize()));
+					SocketDatagram datagram;
+					datagram.address = request.addressTo;
+					datagram.data = request.data.getData();
+					datagram.size = (sl_uint32)(request.data.getSize());
+					datagram.segmentSize = request.segmentSize;
+					// splits the segments
+					socket->sendToBatch(&datagram, 1);
 				} else {
 					break;
 				}
@@ -593,7 +599,8 @@ namespace slib
 
 	};
 
-	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(const Ref<Socket>& socket, sl_uint32 packetSize)
+	// overlapped receiving is not batched
+	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(const Ref<Socket>& socket, sl_uint32 packetSize, sl_uint32 batchCount)
 	{
 		Memory buffer = Memory::create(packetSize);
 		if (buffer.isNotEmpty()) {
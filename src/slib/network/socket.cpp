@@ -14,6 +14,7 @@
 #include "slib/core/log.h"
 #include "slib/core/event.h"
 #include "slib/core/file.h"
+#include "slib/core/memory.h"
 
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
 #	include <winsock2.h>
@@ -22,11 +23,13 @@
 #else
 #	include <unistd.h>
 #	include <sys/socket.h>
+#	include <sys/uio.h>
 #	if defined(SLIB_PLATFORM_IS_LINUX)
 #		include <linux/tcp.h>
 #		include <linux/if.h>
 #		include <linux/if_packet.h>
 #		include <sys/ioctl.h>
+#		include <netinet/udp.h>
 #	else
 #		include <netinet/tcp.h>
 #	endif
@@ -67,6 +70,14 @@ namespace slib
 	}
 
 
+	SocketDatagram::SocketDatagram()
+	{
+		data = sl_null;
+		size = 0;
+		segmentSize = 0;
+	}
+
+
 	SLIB_INLINE static sl_uint32 _Socket_apply_address(SocketType type, sockaddr_storage& addr, SocketAddress in)
 	{
 		if (in.ip.isIPv4() && (type == SocketType::Tcp || type == SocketType::Udp || type == SocketType::Raw)) {
@@ -530,6 +541,80 @@ namespace slib
 		}
 	}
 
+	sl_int32 Socket::sendVector(const MemoryData* buffers, sl_uint32 count)
+	{
+		if (isOpened()) {
+			if (count > SLIB_SOCKET_SEND_VECTOR_MAX_COUNT) {
+				count = SLIB_SOCKET_SEND_VECTOR_MAX_COUNT;
+			}
+			if (m_type != SocketType::Tcp && m_type != SocketType::TcpIPv6) {
+				_setError(SocketError::SendIsNotSupported);
+				return -1;
+			}
+#if defined(SLIB_PLATFORM_IS_WINDOWS)
+			WSABUF v[SLIB_SOCKET_SEND_VECTOR_MAX_COUNT];
+#else
+			struct iovec v[SLIB_SOCKET_SEND_VECTOR_MAX_COUNT];
+#endif
+			// the result should fit in sl_int32
+			sl_size sizeRemain = 0x40000000;
+			sl_uint32 n = 0;
+			for (sl_uint32 i = 0; i < count && sizeRemain > 0; i++) {
+				sl_size size = buffers[i].size;
+				if (size == 0) {
+					continue;
+				}
+				if (size > sizeRemain) {
+					size = sizeRemain;
+				}
+#if defined(SLIB_PLATFORM_IS_WINDOWS)
+				v[n].buf = (CHAR*)(buffers[i].data);
+				v[n].len = (ULONG)size;
+#else
+				v[n].iov_base = buffers[i].data;
+				v[n].iov_len = size;
+#endif
+				sizeRemain -= size;
+				n++;
+			}
+			if (n == 0) {
+				return 0;
+			}
+#if defined(SLIB_PLATFORM_IS_WINDOWS)
+			DWORD dwSent = 0;
+			sl_int32 ret = -1;
+			if (WSASend((SOCKET)(m_socket), v, n, &dwSent, 0, NULL, NULL) == 0) {
+				ret = (sl_int32)dwSent;
+			}
+#else
+			struct msghdr msg;
+			Base::zeroMemory(&msg, sizeof(msg));
+			msg.msg_iov = v;
+			msg.msg_iovlen = n;
+#	if defined(SLIB_PLATFORM_IS_LINUX)
+			sl_int32 ret = (sl_int32)(::sendmsg((SOCKET)(m_socket), &msg, MSG_NOSIGNAL));
+#	else
+			sl_int32 ret = (sl_int32)(::sendmsg((SOCKET)(m_socket), &msg, 0));
+#	endif
+#endif
+			if (ret >= 0) {
+				if (ret == 0) {
+					ret = -1;
+				}
+				return ret;
+			} else {
+				if (_checkError() == SocketError::WouldBlock) {
+					return 0;
+				} else {
+					return -1;
+				}
+			}
+		} else {
+			_setClosedError();
+			return -1;
+		}
+	}
+
 	sl_int32 Socket::receive(void* buf, sl_uint32 size)
 	{
 		if (isOpened()) {
@@ -631,6 +716,195 @@ namespace slib
 		}
 	}
 
+	sl_int32 Socket::receiveFromBatch(SocketDatagram* datagrams, sl_uint32 count)
+	{
+		if (isOpened()) {
+			if (count == 0) {
+				return 0;
+			}
+			if (m_type != SocketType::Udp && m_type != SocketType::UdpIPv6 && m_type != SocketType::Raw && m_type != SocketType::RawIPv6) {
+				_setError(SocketError::ReceiveFromIsNotSupported);
+				return -1;
+			}
+			if (count > SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT) {
+				count = SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT;
+			}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			mmsghdr msgs[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			iovec iovs[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			sockaddr_storage addrs[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			// receives UDP_GRO segment size
+			char controls[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT][CMSG_SPACE(sizeof(int))];
+			Base::zeroMemory(msgs, sizeof(mmsghdr) * count);
+			sl_uint32 i;
+			for (i = 0; i < count; i++) {
+				iovs[i].iov_base = datagrams[i].data;
+				iovs[i].iov_len = datagrams[i].size;
+				msgs[i].msg_hdr.msg_name = addrs + i;
+				msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+				msgs[i].msg_hdr.msg_iov = iovs + i;
+				msgs[i].msg_hdr.msg_iovlen = 1;
+				msgs[i].msg_hdr.msg_control = controls[i];
+				msgs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+			}
+			sl_int32 ret = (sl_int32)(::recvmmsg((SOCKET)(m_socket), msgs, count, 0, sl_null));
+			if (ret > 0) {
+				for (i = 0; i < (sl_uint32)ret; i++) {
+					SocketDatagram& datagram = datagrams[i];
+					datagram.address.setSystemSocketAddress(addrs + i);
+					datagram.size = msgs[i].msg_len;
+					datagram.segmentSize = 0;
+#if defined(UDP_GRO)
+					for (cmsghdr* cmsg = CMSG_FIRSTHDR(&(msgs[i].msg_hdr)); cmsg; cmsg = CMSG_NXTHDR(&(msgs[i].msg_hdr), cmsg)) {
+						if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+							int segmentSize = 0;
+							Base::copyMemory(&segmentSize, CMSG_DATA(cmsg), sizeof(int));
+							if (segmentSize > 0 && (sl_uint32)segmentSize < datagram.size) {
+								datagram.segmentSize = (sl_uint32)segmentSize;
+							}
+						}
+					}
+#endif
+				}
+				return ret;
+			} else {
+				if (_checkError() == SocketError::WouldBlock) {
+					return 0;
+				} else {
+					return -1;
+				}
+			}
+#else
+			for (sl_uint32 i = 0; i < count; i++) {
+				SocketDatagram& datagram = datagrams[i];
+				sl_int32 n = receiveFrom(datagram.address, datagram.data, datagram.size);
+				if (n > 0) {
+					datagram.size = n;
+					datagram.segmentSize = 0;
+				} else {
+					if (i > 0) {
+						return i;
+					}
+					return n;
+				}
+			}
+			return count;
+#endif
+		} else {
+			_setClosedError();
+			return -1;
+		}
+	}
+
+	/*
+		splits the segments without the kernel offload.
+		returns 1 when the first segment is sent (the datagram is consumed, and the rest segments failed to send are lost as the dropped packets),
+		otherwise the result of `sendTo()`
+	*/
+	static sl_int32 _Socket_sendSegments(Socket* socket, const SocketDatagram& datagram)
+	{
+		sl_uint32 segmentSize = datagram.segmentSize;
+		if (segmentSize == 0 || segmentSize > datagram.size) {
+			segmentSize = datagram.size;
+		}
+		for (sl_uint32 offset = 0; offset < datagram.size; offset += segmentSize) {
+			sl_uint32 n = datagram.size - offset;
+			if (n > segmentSize) {
+				n = segmentSize;
+			}
+			sl_int32 m = socket->sendTo(datagram.address, (char*)(datagram.data) + offset, n);
+			if (m <= 0) {
+				if (offset) {
+					return 1;
+				}
+				return m;
+			}
+		}
+		return 1;
+	}
+
+	sl_int32 Socket::sendToBatch(const SocketDatagram* datagrams, sl_uint32 count)
+	{
+		if (isOpened()) {
+			if (count == 0) {
+				return 0;
+			}
+			if (m_type != SocketType::Udp && m_type != SocketType::UdpIPv6 && m_type != SocketType::Raw && m_type != SocketType::RawIPv6) {
+				_setError(SocketError::SendToIsNotSupported);
+				return -1;
+			}
+			if (count > SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT) {
+				count = SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT;
+			}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			mmsghdr msgs[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			iovec iovs[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			sockaddr_storage addrs[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT];
+			// sends UDP_SEGMENT size
+			char controls[SLIB_SOCKET_DATAGRAM_BATCH_MAX_COUNT][CMSG_SPACE(sizeof(sl_uint16))];
+			Base::zeroMemory(msgs, sizeof(mmsghdr) * count);
+			for (sl_uint32 i = 0; i < count; i++) {
+				const SocketDatagram& datagram = datagrams[i];
+				sl_uint32 sizeAddress = _Socket_apply_address(m_type, addrs[i], datagram.address);
+				if (!sizeAddress) {
+					if (i == 0) {
+						_setError(SocketError::SendToInvalidAddress);
+						return -1;
+					}
+					count = i;
+					break;
+				}
+				iovs[i].iov_base = datagram.data;
+				iovs[i].iov_len = datagram.size;
+				msgs[i].msg_hdr.msg_name = addrs + i;
+				msgs[i].msg_hdr.msg_namelen = sizeAddress;
+				msgs[i].msg_hdr.msg_iov = iovs + i;
+				msgs[i].msg_hdr.msg_iovlen = 1;
+#if defined(UDP_SEGMENT)
+				if (datagram.segmentSize > 0 && datagram.segmentSize < datagram.size) {
+					msgs[i].msg_hdr.msg_control = controls[i];
+					msgs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+					cmsghdr* cmsg = CMSG_FIRSTHDR(&(msgs[i].msg_hdr));
+					cmsg->cmsg_level = IPPROTO_UDP;
+					cmsg->cmsg_type = UDP_SEGMENT;
+					cmsg->cmsg_len = CMSG_LEN(sizeof(sl_uint16));
+					sl_uint16 segmentSize = (sl_uint16)(datagram.segmentSize);
+					Base::copyMemory(CMSG_DATA(cmsg), &segmentSize, sizeof(sl_uint16));
+				}
+#endif
+			}
+			sl_int32 ret = (sl_int32)(::sendmmsg((SOCKET)(m_socket), msgs, count, 0));
+			if (ret > 0) {
+				return ret;
+			}
+			if (_checkError() == SocketError::WouldBlock) {
+				return 0;
+			}
+#if defined(UDP_SEGMENT)
+			if (datagrams->segmentSize > 0 && datagrams->segmentSize < datagrams->size) {
+				// the kernel rejected the offload (too many segments, too large, or no GSO support on the device)
+				return _Socket_sendSegments(this, *datagrams);
+			}
+#endif
+			return -1;
+#else
+			for (sl_uint32 i = 0; i < count; i++) {
+				sl_int32 m = _Socket_sendSegments(this, datagrams[i]);
+				if (m <= 0) {
+					if (i > 0) {
+						return i;
+					}
+					return m;
+				}
+			}
+			return count;
+#endif
+		} else {
+			_setClosedError();
+			return -1;
+		}
+	}
+
 	sl_int32 Socket::sendPacket(const void* buf, sl_uint32 size, const L2PacketInfo& info)
 	{
 #if defined(SLIB_PLATFORM_IS_LINUX)
@@ -975,6 +1249,16 @@ namespace slib
 	}
 
 
+	sl_bool Socket::setOption_UdpGro(sl_bool flagEnable)
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX) && defined(UDP_GRO)
+		return setOption(IPPROTO_UDP, UDP_GRO, flagEnable ? 1 : 0);
+#else
+		return sl_false;
+#endif
+	}
+
+
 	sl_bool Socket::setOption_IpTTL(sl_uint32 ttl)
 	{
 		if (ttl > 255) {
@@ -583,6 +583,11 @@ namespace slib
 		return m_flagError;
 	}
 	
+	String UrlRequest::getLastErrorMessage()
+	{
+		return m_lastErrorMessage;
+	}
+	
 	sl_bool UrlRequest::isClosed()
 	{
 		return m_flagClosed;
@@ -725,7 +730,7 @@ namespace slib
 			if (mem.isNotEmpty()) {
 				m_bufResponseContent.add(mem);
 			} else {
-				m_bufResponseContent.add(Memory::create(data, len));
+				m_bufResponseContent.addNew(data, len);
 			}
 			m_sizeContentReceived = m_bufResponseContent.getSize();
 		} else {
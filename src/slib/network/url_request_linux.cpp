@@ -0,0 +1,208 @@
+/*
+ *  Copyright (c) 2008-2017 SLIBIO. All Rights Reserved.
+ *
+ *  This file is part of the SLib.io project.
+ *
+ *  This Source Code Form is subject to the terms of the Mozilla Public
+ *  License, v. 2.0. If a copy of the MPL was not distributed with this
+ *  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "slib/core/definition.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX) && !defined(SLIB_PLATFORM_IS_ANDROID) && !defined(SLIB_PLATFORM_IS_TIZEN)
+
+#include "slib/network/url_request.h"
+
+#include "slib/network/http_client.h"
+#include "slib/network/url.h"
+#include "slib/core/file.h"
+#include "slib/core/log.h"
+
+#define MAX_REDIRECTS 10
+
+namespace slib
+{
+
+	class UrlRequest_Impl : public UrlRequest
+	{
+	public:
+		AtomicRef<HttpClientContext> m_context;
+		String m_urlCurrent;
+		HttpMethod m_methodCurrent;
+		Memory m_bodyCurrent;
+		sl_uint32 m_nRedirects;
+		String m_urlRedirect;
+		Ref<File> m_fileDownload;
+
+	public:
+		UrlRequest_Impl()
+		{
+			m_methodCurrent = HttpMethod::GET;
+			m_nRedirects = 0;
+		}
+
+		~UrlRequest_Impl()
+		{
+		}
+
+	public:
+		static Ref<UrlRequest_Impl> create(const UrlRequestParam& param, const String& url)
+		{
+			Ref<UrlRequest_Impl> ret = new UrlRequest_Impl;
+			if (ret.isNotNull()) {
+				ret->_init(param, url);
+				ret->m_urlCurrent = url;
+				ret->m_methodCurrent = param.method;
+				ret->m_bodyCurrent = param.requestBody;
+				return ret;
+			}
+			return sl_null;
+		}
+
+		void _sendAsync() override
+		{
+			Ref<HttpClient> client = HttpClient::getDefault();
+			if (client.isNull()) {
+				onError();
+				return;
+			}
+			HttpClientRequestParam param;
+			param.method = m_methodCurrent;
+			param.url = m_urlCurrent;
+			for (auto& pair : m_requestHeaders) {
+				param.requestHeaders.put_NoLock(pair.key, pair.value, MapPutMode::AddAlways);
+			}
+			for (auto& pair : m_additionalRequestHeaders) {
+				param.requestHeaders.put_NoLock(pair.key, pair.value, MapPutMode::AddAlways);
+			}
+			param.requestBody = m_bodyCurrent;
+			// stored by UrlRequest
+			param.flagStoreResponseContent = sl_false;
+			param.onResponse = SLIB_FUNCTION_WEAKREF(UrlRequest_Impl, onClientResponse, this);
+			param.onReceiveContent = SLIB_FUNCTION_WEAKREF(UrlRequest_Impl, onClientReceiveContent, this);
+			param.onComplete = SLIB_FUNCTION_WEAKREF(UrlRequest_Impl, onClientComplete, this);
+			Ref<HttpClientContext> context = client->send(param);
+			if (context.isNull()) {
+				m_lastErrorMessage = "Not supported url";
+				LogError("UrlRequest", "Not supported url: %s", m_urlCurrent);
+				onError();
+				return;
+			}
+			m_context = context;
+		}
+
+		void _cancel() override
+		{
+			Ref<HttpClientContext> context = m_context;
+			if (context.isNotNull()) {
+				context->cancel();
+			}
+			m_fileDownload.setNull();
+		}
+
+		void onClientResponse(HttpClientContext* context)
+		{
+			if (m_flagClosed) {
+				return;
+			}
+			m_urlRedirect.setNull();
+			HttpStatus status = context->getResponseCode();
+			if (status == HttpStatus::MovedPermanently || status == HttpStatus::Found || status == HttpStatus::SeeOther || status == HttpStatus::TemporaryRedirect || status == HttpStatus::PermanentRedirect) {
+				String location = context->getResponseHeader(HttpHeaders::Location);
+				if (location.isNotEmpty() && m_nRedirects < MAX_REDIRECTS) {
+					m_urlRedirect = _resolveLocation(location);
+					return;
+				}
+			}
+			m_responseStatus = status;
+			m_responseMessage = context->getResponseMessage();
+			m_responseHeaders = context->getResponseHeaders();
+			if (context->containsResponseHeader(HttpHeaders::ContentLength) && context->getResponseContentEncoding().isEmpty()) {
+				m_sizeContentTotal = context->getResponseContentLengthHeader();
+			}
+			if (m_downloadFilePath.isNotEmpty()) {
+				m_fileDownload = File::openForWrite(m_downloadFilePath);
+			}
+			onResponse();
+		}
+
+		void onClientReceiveContent(HttpClientContext* context, const void* data, sl_size size)
+		{
+			if (m_flagClosed || m_urlRedirect.isNotEmpty()) {
+				return;
+			}
+			if (m_downloadFilePath.isNotEmpty()) {
+				if (m_fileDownload.isNotNull()) {
+					sl_reg ret = m_fileDownload->write(data, size);
+					if (ret > 0) {
+						size = ret;
+					} else {
+						size = 0;
+					}
+				}
+				onDownloadContent(size);
+			} else {
+				onReceiveContent(data, size, sl_null);
+			}
+		}
+
+		void onClientComplete(HttpClientContext* context)
+		{
+			m_fileDownload.setNull();
+			if (m_flagClosed) {
+				return;
+			}
+			if (context->isError()) {
+				m_lastErrorMessage = context->getErrorMessage();
+				onError();
+				return;
+			}
+			if (m_urlRedirect.isNotEmpty()) {
+				m_nRedirects++;
+				m_urlCurrent = m_urlRedirect;
+				m_urlRedirect.setNull();
+				HttpStatus status = context->getResponseCode();
+				if (status == HttpStatus::SeeOther || ((status == HttpStatus::MovedPermanently || status == HttpStatus::Found) && m_methodCurrent == HttpMethod::POST)) {
+					m_methodCurrent = HttpMethod::GET;
+					m_bodyCurrent.setNull();
+				}
+				_sendAsync();
+				return;
+			}
+			onComplete();
+		}
+
+		String _resolveLocation(const String& location)
+		{
+			if (location.contains("://")) {
+				return location;
+			}
+			Url url;
+			url.parse(m_urlCurrent);
+			String scheme = url.scheme;
+			if (scheme.isEmpty()) {
+				scheme = "http";
+			}
+			String base = scheme + "://" + url.host;
+			if (location.startsWith('/')) {
+				return base + location;
+			}
+			String path = url.path;
+			sl_reg index = path.lastIndexOf('/');
+			if (index >= 0) {
+				return base + path.substring(0, index + 1) + location;
+			}
+			return base + "/" + location;
+		}
+
+	};
+
+	Ref<UrlRequest> UrlRequest::_create(const UrlRequestParam& param, const String& url)
+	{
+		return Ref<UrlRequest>::from(UrlRequest_Impl::create(param, url));
+	}
+
+}
+
+#endif
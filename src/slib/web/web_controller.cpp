@@ -12,16 +12,134 @@
 
 #include "slib/web/service.h"
 #include "slib/core/xml.h"
+#include "slib/network/url.h"
 
 namespace slib
 {
 
+#define WEB_ROUTE_MAX_PARAMS 32
+
+	class _WebRouteNode : public Referable
+	{
+	public:
+		String segment;
+		// exact segments, sorted by `_WebRoute_compareSegment()`
+		List< Ref<_WebRouteNode> > children;
+		Ref<_WebRouteNode> param;
+		
+		WebHandler handler;
+		List<String> paramNames;
+		
+		WebHandler handlerWildcard;
+		List<String> paramNamesWildcard;
+		
+	};
+
+	struct _WebRouteCapture
+	{
+		const sl_char8* data;
+		sl_size length;
+	};
+
+	SLIB_INLINE static sl_int32 _WebRoute_compareSegment(const String& segment, const sl_char8* s, sl_size len)
+	{
+		sl_size n = segment.getLength();
+		if (n != len) {
+			return n < len ? -1 : 1;
+		}
+		return Base::compareMemory((const sl_uint8*)(segment.getData()), (const sl_uint8*)s, len);
+	}
+
+	// returns the index of the child, or the insert position as `-(index + 1)`
+	static sl_reg _WebRoute_findChild(const _WebRouteNode* node, const sl_char8* s, sl_size len)
+	{
+		Ref<_WebRouteNode>* children = node->children.getData();
+		sl_size start = 0;
+		sl_size end = node->children.getCount();
+		while (start < end) {
+			sl_size mid = (start + end) >> 1;
+			sl_int32 c = _WebRoute_compareSegment(children[mid]->segment, s, len);
+			if (c == 0) {
+				return mid;
+			} else if (c < 0) {
+				start = mid + 1;
+			} else {
+				end = mid;
+			}
+		}
+		return -((sl_reg)start + 1);
+	}
+
+	/*
+		`s`: start of the current segment (after '/'), or null when the whole path is consumed
+		returns the node holding the matched handler
+	*/
+	static const _WebRouteNode* _WebRoute_match(const _WebRouteNode* node, const sl_char8* s, const sl_char8* end, _WebRouteCapture* captures, sl_uint32 nCaptures, sl_uint32& outCount, sl_bool& outWildcard)
+	{
+		if (!s) {
+			if (node->handler.isNotNull()) {
+				outCount = nCaptures;
+				outWildcard = sl_false;
+				return node;
+			}
+			if (node->handlerWildcard.isNotNull() && nCaptures < WEB_ROUTE_MAX_PARAMS) {
+				captures[nCaptures].data = end;
+				captures[nCaptures].length = 0;
+				outCount = nCaptures + 1;
+				outWildcard = sl_true;
+				return node;
+			}
+			return sl_null;
+		}
+		const sl_char8* e = (const sl_char8*)(Base::findMemory(s, '/', end - s));
+		const sl_char8* next;
+		if (e) {
+			next = e + 1;
+		} else {
+			e = end;
+			next = sl_null;
+		}
+		sl_size len = e - s;
+		if (node->children.getCount()) {
+			sl_reg index = _WebRoute_findChild(node, s, len);
+			if (index >= 0) {
+				const _WebRouteNode* ret = _WebRoute_match(node->children.getData()[index].get(), next, end, captures, nCaptures, outCount, outWildcard);
+				if (ret) {
+					return ret;
+				}
+			}
+		}
+		if (nCaptures >= WEB_ROUTE_MAX_PARAMS) {
+			return sl_null;
+		}
+		if (len > 0 && node->param.isNotNull()) {
+			captures[nCaptures].data = s;
+			captures[nCaptures].length = len;
+			const _WebRouteNode* ret = _WebRoute_match(node->param.get(), next, end, captures, nCaptures + 1, outCount, outWildcard);
+			if (ret) {
+				return ret;
+			}
+		}
+		if (node->handlerWildcard.isNotNull()) {
+			captures[nCaptures].data = s;
+			captures[nCaptures].length = end - s;
+			outCount = nCaptures + 1;
+			outWildcard = sl_true;
+			return node;
+		}
+		return sl_null;
+	}
+
 	SLIB_DEFINE_OBJECT(WebController, Object)
 
 	WebController::WebController()
 	{
 	}
 
+	WebController::~WebController()
+	{
+	}
+
 	Ref<WebController> WebController::create()
 	{
 		return new WebController;
@@ -29,46 +147,141 @@ namespace slib
 
 	void WebController::registerHandler(HttpMethod method, const String& path, const WebHandler& handler)
 	{
-		if (handler.isNotNull()) {
-			String sig = _getHandlerSignature(method, path);
-			m_handlers.put(sig, handler);
+		if (handler.isNull()) {
+			return;
+		}
+		sl_uint32 indexMethod = (sl_uint32)method;
+		if (indexMethod >= sizeof(m_routes) / sizeof(m_routes[0])) {
+			return;
+		}
+		ObjectLocker lock(this);
+		Ref<_WebRouteNode> node = m_routes[indexMethod];
+		if (node.isNull()) {
+			node = new _WebRouteNode;
+			if (node.isNull()) {
+				return;
+			}
+			m_routes[indexMethod] = node;
+		}
+		List<String> paramNames;
+		// the leading '/' doesn't make a segment
+		String strSegments = path.startsWith('/') ? path.substring(1) : path;
+		List<String> listSegments;
+		if (strSegments.isEmpty()) {
+			listSegments.add_NoLock(String::getEmpty());
+		} else {
+			listSegments = strSegments.split("/");
+		}
+		ListElements<String> segments(listSegments);
+		for (sl_size i = 0; i < segments.count; i++) {
+			String& segment = segments[i];
+			sl_char8 first = segment.getLength() > 0 ? segment.getData()[0] : 0;
+			if (first == '*') {
+				paramNames.add_NoLock(segment.substring(1));
+				if (paramNames.getCount() > WEB_ROUTE_MAX_PARAMS) {
+					return;
+				}
+				node->handlerWildcard = handler;
+				node->paramNamesWildcard = paramNames;
+				return;
+			}
+			if (first == ':') {
+				paramNames.add_NoLock(segment.substring(1));
+				if (paramNames.getCount() > WEB_ROUTE_MAX_PARAMS) {
+					return;
+				}
+				if (node->param.isNull()) {
+					node->param = new _WebRouteNode;
+					if (node->param.isNull()) {
+						return;
+					}
+				}
+				node = node->param;
+			} else {
+				sl_reg index = _WebRoute_findChild(node.get(), segment.getData(), segment.getLength());
+				if (index >= 0) {
+					node = node->children.getData()[index];
+				} else {
+					Ref<_WebRouteNode> child = new _WebRouteNode;
+					if (child.isNull()) {
+						return;
+					}
+					child->segment = segment;
+					if (!(node->children.insert_NoLock(-(index + 1), child))) {
+						return;
+					}
+					node = child;
+				}
+			}
 		}
+		node->handler = handler;
+		node->paramNames = paramNames;
 	}
 
 	sl_bool WebController::onHttpRequest(const Ref<HttpServiceContext>& context)
 	{
 		HttpMethod method = context->getMethod();
+		sl_uint32 indexMethod = (sl_uint32)method;
+		if (indexMethod >= sizeof(m_routes) / sizeof(m_routes[0])) {
+			return sl_false;
+		}
+		_WebRouteNode* root = m_routes[indexMethod].get();
+		if (!root) {
+			return sl_false;
+		}
 		String path = context->getPath();
-		String sig = _getHandlerSignature(method, path);
+		const sl_char8* s = path.getData();
+		const sl_char8* end = s + path.getLength();
+		if (!s) {
+			s = "";
+			end = s;
+		} else if (s < end && *s == '/') {
+			s++;
+		}
+		_WebRouteCapture captures[WEB_ROUTE_MAX_PARAMS];
+		sl_uint32 nCaptures = 0;
+		sl_bool flagWildcard = sl_false;
+		const _WebRouteNode* node = _WebRoute_match(root, s, end, captures, 0, nCaptures, flagWildcard);
+		if (!node) {
+			return sl_false;
+		}
 		WebHandler handler;
-		if (m_handlers.get(sig, &handler)) {
-			Variant ret(handler(context, method, path));
-			if (ret.isNotNull()) {
-				if (ret.isObject()) {
-					Ref<Referable> obj = ret.getObject();
-					if (obj.isNotNull()) {
-						if (IsInstanceOf< Map<String, Variant> >(obj)) {
-							context->write(ret.toJsonString());
-						} else if (XmlDocument* xml = CastInstance<XmlDocument>(obj.get())) {
-							context->write(xml->toString());
-						} else if (CMemory* mem = CastInstance<CMemory>(obj.get())) {
-							context->write(mem);
-						}
+		if (nCaptures > 0) {
+			ListElements<String> names(flagWildcard ? node->paramNamesWildcard : node->paramNames);
+			for (sl_uint32 i = 0; i < nCaptures && i < names.count; i++) {
+				String value = String::fromUtf8(captures[i].data, captures[i].length);
+				if (Base::findMemory(captures[i].data, '%', captures[i].length)) {
+					value = Url::decodeUriComponentByUTF8(value);
+				}
+				context->setPathParameter(names[i], value);
+			}
+		}
+		if (flagWildcard) {
+			handler = node->handlerWildcard;
+		} else {
+			handler = node->handler;
+		}
+		Variant ret(handler(context, method, path));
+		if (ret.isNotNull()) {
+			if (ret.isObject()) {
+				Ref<Referable> obj = ret.getObject();
+				if (obj.isNotNull()) {
+					if (IsInstanceOf< Map<String, Variant> >(obj)) {
+						context->write(ret.toJsonString());
+					} else if (XmlDocument* xml = CastInstance<XmlDocument>(obj.get())) {
+						context->write(xml->toString());
+					} else if (CMemory* mem = CastInstance<CMemory>(obj.get())) {
+						context->write(mem);
 					}
-				} else {
-					context->write(ret.getString());
 				}
-				return sl_true;
+			} else {
+				context->write(ret.getString());
 			}
+			return sl_true;
 		}
 		return sl_false;
 	}
 
-	String WebController::_getHandlerSignature(HttpMethod method, const String& path)
-	{
-		return HttpMethods::toString(method) + " " + path;
-	}
-
 
 	WebModule::WebModule(const String& path)
 	: m_path(path)